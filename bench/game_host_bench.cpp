@@ -0,0 +1,213 @@
+/**
+ * Project: catan
+ * @file game_host_bench.cpp
+ * @brief commands/s of GameHost against its num of workers, commands pushed by several connection threads
+ *        to games pinned to the workers
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include "game_host.hpp"
+#include "map_file_io.hpp"
+#include "board_layout.hpp"
+#include "logger.hpp"
+#include "utility.hpp"
+#include "vertex.hpp"
+#include "edge.hpp"
+
+constexpr size_t NUM_GAMES = 64U;
+constexpr size_t NUM_PLAYERS = 4U;
+constexpr size_t NUM_PRODUCERS = 4U;
+constexpr uint64_t SEED = 2024U;
+
+struct Workload_t
+{
+    std::string name;
+    std::string command;
+    size_t numCommands;
+    bool isOpening;     // the command is sent in the first two rounds, otherwise after them, i.e., to CommandDispatcher
+};
+
+static void waitFor(const std::atomic<size_t>& aCounter, const size_t aTarget)
+{
+    while (aCounter.load(std::memory_order_acquire) < aTarget)
+    {
+        std::this_thread::yield();
+    }
+}
+
+// a point of the terrain that is not claimed by a neighbour, nor {0, 0}, i.e., a click on it
+static Point_t pointOf(const BoardLayout& aLayout, const Terrain* const aTerrain)
+{
+    for (const Point_t& point : aTerrain->getAllPoints())
+    {
+        if (aLayout.getTerrain(point) == aTerrain && point != Point_t{0, 0})
+        {
+            return point;
+        }
+    }
+    return aTerrain->getTopLeft();
+}
+
+static bool contains(const std::vector<std::string>& aMsgs, const std::string& aText)
+{
+    return std::any_of(aMsgs.begin(), aMsgs.end(), [&aText](const std::string& aMsg) {
+            return aMsg.find(aText) != std::string::npos;
+        });
+}
+
+/** @return the msgs of the response */
+static std::vector<std::string> actAndWait(GameHost& aHost, const uint64_t aGameId, const Point_t aPoint)
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool isDone = false;
+    std::vector<std::string> msgs;
+    aHost.act(aGameId, "", aPoint, [&](const uint64_t, const GameHost::Result, std::vector<std::string>& aMsgs) {
+            std::lock_guard<std::mutex> lock(mutex);
+            msgs.swap(aMsgs);
+            isDone = true;
+            cv.notify_one();
+        });
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&isDone]() { return isDone; });
+    return msgs;
+}
+
+// click through the first two rounds of aGameId, every settlement on the first free vertex, its road on the first free edge
+static void playOpening(GameHost& aHost, const BoardLayout& aLayout, const uint64_t aGameId)
+{
+    for (const Vertex* const pVertex : aLayout.getVertices())
+    {
+        if (!contains(actAndWait(aHost, aGameId, pointOf(aLayout, pVertex)), "placed a settlement"))
+        {
+            continue;
+        }
+        for (const Edge* const pEdge : pVertex->getAdjacentEdges())
+        {
+            const std::vector<std::string> msgs = actAndWait(aHost, aGameId, pointOf(aLayout, pEdge));
+            if (contains(msgs, "First two rounds completed"))
+            {
+                return;
+            }
+            if (contains(msgs, "placed a road"))
+            {
+                break;
+            }
+        }
+    }
+}
+
+/** @return commands/s */
+static double bench(const size_t aNumWorkers, const BoardLayout& aLayout, const Workload_t& aWorkload)
+{
+    GameHost host(aNumWorkers, "", SEED);
+    std::atomic<size_t> numDone(0U);
+    const GameHost::Callback_t callback = [&numDone](const uint64_t, const GameHost::Result, std::vector<std::string>&) {
+        numDone.fetch_add(1U, std::memory_order_release);
+    };
+
+    std::vector<uint64_t> gameIds;
+    for (size_t game = 0U; game < NUM_GAMES; ++game)
+    {
+        gameIds.push_back(host.createGame(NUM_PLAYERS, callback));
+    }
+    waitFor(numDone, NUM_GAMES);
+    numDone = 0U;
+    if (!aWorkload.isOpening)
+    {
+        // the clicks on occupied vertices are warned about, muted while setting up, before the clock starts
+        std::streambuf* const pCoutBuffer = std::cout.rdbuf(nullptr);
+        for (const uint64_t gameId : gameIds)
+        {
+            playOpening(host, aLayout, gameId);
+        }
+        std::cout.clear();
+        std::cout.rdbuf(pCoutBuffer);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (size_t producer = 0U; producer < NUM_PRODUCERS; ++producer)
+    {
+        producers.emplace_back([&, producer]() {
+            for (size_t command = producer; command < aWorkload.numCommands; command += NUM_PRODUCERS)
+            {
+                host.act(gameIds[command % NUM_GAMES], aWorkload.command, Point_t{0, 0}, callback);
+            }
+        });
+    }
+    for (std::thread& producer : producers)
+    {
+        producer.join();
+    }
+    waitFor(numDone, aWorkload.numCommands);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return aWorkload.numCommands / elapsed.count();
+}
+
+int main(int argc, char** argv)
+{
+    const size_t numCores = std::max(std::thread::hardware_concurrency(), 1U);
+    const size_t maxWorkers = (argc > 1) ? std::max<size_t>(std::strtoull(argv[1], nullptr, 10), 1U) : numCores;
+    std::vector<size_t> numWorkers;
+    for (size_t workers = 1U; workers < maxWorkers; workers *= 2U)
+    {
+        numWorkers.push_back(workers);
+    }
+    numWorkers.push_back(maxWorkers);
+
+    const std::vector<Workload_t> workloads = {
+        // the instructions of the current command, i.e., mostly the cost of the host itself
+        {"help", "help", 200000U, true},
+        // the same through CommandDispatcher, as any command past the first two rounds
+        {"help/turn", "help", 200000U, false},
+        // the opening optimiser, milliseconds of work per command
+        {"suggest", "suggest", 400U, true},
+    };
+
+    // as in catan-server, every log line is written behind a single lock, INFO would serialize the workers on it
+    Logger::setInfoEnabled(false);
+    // the games are played on the default map, the clicks of the first two rounds are found on its layout
+    const std::shared_ptr<const BoardLayout> pLayout = MapIO("").readLayout();
+    if (pLayout == nullptr)
+    {
+        return 1;
+    }
+    std::vector<std::vector<double> > results(workloads.size());
+    for (size_t workload = 0U; workload < workloads.size(); ++workload)
+    {
+        for (const size_t workers : numWorkers)
+        {
+            results[workload].push_back(bench(workers, *pLayout, workloads[workload]));
+        }
+    }
+
+    std::cout << NUM_GAMES << " games of " << NUM_PLAYERS << " players, " << NUM_PRODUCERS << " connection threads, " \
+        << numCores << " cores" << std::endl;
+    for (size_t workload = 0U; workload < workloads.size(); ++workload)
+    {
+        for (size_t ii = 0U; ii < numWorkers.size(); ++ii)
+        {
+            std::cout << std::left << std::setw(12) << workloads[workload].name << std::right \
+                << std::setw(4) << numWorkers[ii] << " workers" << std::fixed << std::setprecision(0) \
+                << std::setw(12) << results[workload][ii] << " commands/s" \
+                << std::setw(10) << std::setprecision(2) << results[workload][ii] / results[workload].front() << "x" \
+                << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,189 @@
+/**
+ * Project: catan
+ * @file lockstep_bench.cpp
+ * @brief turns/s of LockstepEngine (8 and 16 games per batch) against the scalar paths,
+ *        GameMap driven by MapAgentDriver and headless GameRules, one game at a time
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include "game_map.hpp"
+#include "map_file_io.hpp"
+#include "board_topology.hpp"
+#include "game_rules.hpp"
+#include "agent.hpp"
+#include "map_agent_driver.hpp"
+#include "lockstep_engine.hpp"
+#include "vertex.hpp"
+#include "edge.hpp"
+
+constexpr size_t DEFAULT_NUM_GAMES = 1024U;
+constexpr size_t GAME_MAP_GAMES_DIVISOR = 16U;  // the GameMap path is too slow to play as many games
+constexpr size_t NUM_PLAYERS = 4U;
+constexpr uint64_t SEED = 2024U;
+
+struct BenchResult_t
+{
+    size_t numGames;
+    size_t numTurns;
+    double turnsPerSecond;
+};
+
+template<typename PlayFunc>
+static BenchResult_t bench(PlayFunc aPlay)
+{
+    BenchResult_t result = BenchResult_t{0U, 0U, 0.0};
+    const auto start = std::chrono::steady_clock::now();
+    aPlay(result);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    result.turnsPerSecond = result.numTurns / elapsed.count();
+    return result;
+}
+
+static void report(const std::string& aName, const BenchResult_t& aResult, const double aBaseline)
+{
+    std::cout << std::left << std::setw(36) << aName << std::right << std::fixed << std::setprecision(1) \
+        << std::setw(8) << aResult.numGames << " games" \
+        << std::setw(12) << aResult.turnsPerSecond / 1e3 << " K turns/s" \
+        << std::setw(10) << std::setprecision(2) << aResult.turnsPerSecond / aBaseline << "x" \
+        << "    mean " << std::setprecision(1) << static_cast<double>(aResult.numTurns) / aResult.numGames << " turns/game" \
+        << std::endl;
+}
+
+// the setup of the greedy agent, mirrored on aMap, every path starts from the resulting state
+static int setUpGame(GameMap& aMap, const GameRules& aRules, GameState_t& aState)
+{
+    if (aMap.exportGameState(aState) != 0)
+    {
+        return 1;
+    }
+    aState.phase = GamePhase::SETUP_SETTLEMENT;
+    aState.setupStep = 0U;
+    aState.currentPlayer = 0U;
+
+    GreedyAgent agent;
+    RandomEngine engine(SEED);
+    std::vector<GameAction_t> actions;
+    aRules.getLegalActions(aState, actions);
+    while (aState.phase == GamePhase::SETUP_SETTLEMENT || aState.phase == GamePhase::SETUP_ROAD)
+    {
+        const GameAction_t action = actions[agent.chooseAction(aRules, aState, actions, engine)];
+        while (aMap.currentPlayer() != aState.currentPlayer)
+        {
+            aMap.nextPlayer();
+        }
+        const int rc = (action.type == GameActionType::BUILD_ROAD) ? \
+            aMap.buildRoad(aMap.getEdges().at(action.id)->getTopLeft(), false) : \
+            aMap.buildColony(aMap.getVertices().at(action.id)->getTopLeft(), ColonyType::SETTLEMENT, false, false);
+        if (rc != 0)
+        {
+            return 1;
+        }
+        aRules.applyAction(aState, action, engine);
+        aRules.getLegalActions(aState, actions);
+    }
+    while (aMap.currentPlayer() != aState.currentPlayer)
+    {
+        aMap.nextPlayer();
+    }
+    // the players of GameMap hold resources of their own, the map is the reference
+    return aMap.exportGameState(aState);
+}
+
+template<size_t LANES>
+static BenchResult_t benchLockstep(const std::shared_ptr<BoardTopology>& aTopology, const GameState_t& aStart, const size_t aNumGames)
+{
+    LockstepEngine<LANES> engine(aTopology);
+    return bench([&](BenchResult_t& aResult) {
+        engine.reset(aStart, SEED);
+        aResult.numTurns = engine.run(aNumGames);
+        aResult.numGames = engine.getNumGames();
+    });
+}
+
+int main(int argc, char** argv)
+{
+    const size_t numGames = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : DEFAULT_NUM_GAMES;
+
+    const std::shared_ptr<const BoardLayout> pLayout = MapIO("").readLayout();
+    if (pLayout == nullptr)
+    {
+        return 1;
+    }
+    GameMap gameMap(pLayout, SEED);
+    gameMap.addPlayer(NUM_PLAYERS);
+    std::shared_ptr<BoardTopology> topology = std::make_shared<BoardTopology>();
+    if (gameMap.initMap() != 0 || topology->init(gameMap) != 0)
+    {
+        return 1;
+    }
+    const GameRules rules(topology);
+    GameState_t start;
+    if (setUpGame(gameMap, rules, start) != 0)
+    {
+        return 1;
+    }
+    std::vector<uint8_t> mapState;
+    gameMap.exportState(mapState);
+
+    // GameMap logs every build to stdout, muted while it plays
+    std::streambuf* const pCoutBuffer = std::cout.rdbuf(nullptr);
+    const BenchResult_t baseline = bench([&](BenchResult_t& aResult) {
+        MapAgentDriver driver(topology, SEED);
+        GreedyAgent agent;
+        std::vector<std::string> messages;
+        GameState_t state;
+        for (; aResult.numGames < std::max<size_t>(numGames / GAME_MAP_GAMES_DIVISOR, 1U); ++aResult.numGames)
+        {
+            gameMap.importState(mapState);
+            bool isOver = false;
+            for (size_t turn = 0U; turn < constant::MAX_TURNS && !isOver; ++turn)
+            {
+                driver.playTurn(gameMap, agent, messages);
+                messages.clear();
+                ++aResult.numTurns;
+                gameMap.exportGameState(state);
+                for (size_t playerId = 0U; playerId < NUM_PLAYERS; ++playerId)
+                {
+                    isOver = isOver || (rules.getVictoryPoint(state, playerId) >= constant::WINNING_VICTORY_POINT);
+                }
+            }
+        }
+    });
+    std::cout.clear();
+    std::cout.rdbuf(pCoutBuffer);
+
+    std::cout << NUM_PLAYERS << " players, greedy policies, from the same position after the setup" << std::endl;
+    report("GameMap + MapAgentDriver", baseline, baseline.turnsPerSecond);
+
+    report("GameRules + GreedyAgent", bench([&](BenchResult_t& aResult) {
+        GreedyAgent agent;
+        std::vector<GameAction_t> actions;
+        actions.reserve(GameRules::MAX_LEGAL_ACTIONS);
+        for (; aResult.numGames < numGames; ++aResult.numGames)
+        {
+            RandomEngine engine(SEED + aResult.numGames);
+            GameState_t state = start;
+            rules.getLegalActions(state, actions);
+            while (!actions.empty())
+            {
+                rules.applyAction(state, actions[agent.chooseAction(rules, state, actions, engine)], engine);
+                rules.getLegalActions(state, actions);
+            }
+            aResult.numTurns += state.turn - start.turn;
+        }
+    }), baseline.turnsPerSecond);
+
+    report("LockstepEngine<8>", benchLockstep<8U>(topology, start, numGames), baseline.turnsPerSecond);
+    report("LockstepEngine<16>", benchLockstep<16U>(topology, start, numGames), baseline.turnsPerSecond);
+    return 0;
+}
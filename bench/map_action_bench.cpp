@@ -0,0 +1,357 @@
+/**
+ * Project: catan
+ * @file map_action_bench.cpp
+ * @brief ns per action of MapActionExecutor against the same actions typed as commands and clicks through UserInterface,
+ *        on the same game replayed from the same snapshot
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include "game_map.hpp"
+#include "map_file_io.hpp"
+#include "board_topology.hpp"
+#include "game_rules.hpp"
+#include "agent.hpp"
+#include "map_action.hpp"
+#include "command_handlers.hpp"
+#include "user_interface.hpp"
+#include "vertex.hpp"
+#include "edge.hpp"
+#include "land.hpp"
+
+constexpr size_t DEFAULT_NUM_REPEATS = 20U;
+constexpr size_t NUM_PLAYERS = 4U;
+constexpr size_t NUM_TURNS = 200U;
+constexpr uint64_t SEED = 2024U;
+
+static const std::vector<std::string> OPCODE_NAMES = {
+    "ROLL_DICE", "PLACE_SETTLEMENT", "PLACE_ROAD", "BUILD_ROAD", "BUILD_SETTLEMENT", "BUILD_CITY", "BUY_DEV_CARD",
+    "MOVE_ROBBER", "PLAY_KNIGHT", "PLAY_ROAD_BUILDING", "PLAY_YEAR_OF_PLENTY", "PLAY_MONOPOLY", "END_TURN",
+};
+
+struct UiInput_t
+{
+    std::string input;
+    Point_t point;
+};
+
+// an action of the game, and the same action as typed in the UI
+struct Step_t
+{
+    MapAction_t action;
+    std::vector<UiInput_t> inputs;
+};
+
+// a point of the terrain that is not claimed by a neighbour, nor {0, 0}, i.e., a click on it, see RobberMoveHandler
+static Point_t pointOf(const GameMap& aMap, const Terrain* const aTerrain)
+{
+    for (const Point_t& point : aTerrain->getAllPoints())
+    {
+        if (aMap.getTerrain(point) == aTerrain && point != Point_t{0, 0})
+        {
+            return point;
+        }
+    }
+    return aTerrain->getTopLeft();
+}
+
+// the vertex the UI clicks to rob aVictim, a vertex of nobody for NO_PLAYER, nullptr if the land has none
+static const Vertex* robbedVertex(const GameMap& aMap, const GameAction_t& aAction)
+{
+    const int owner = (aAction.aux == NO_PLAYER) ? -1 : aAction.aux;
+    for (const Vertex* const pVertex : aMap.getLands().at(aAction.id)->getAdjacentVertices())
+    {
+        if (pVertex->getOwner(aMap.getBoardState()) == owner)
+        {
+            return pVertex;
+        }
+    }
+    return nullptr;
+}
+
+static Step_t toStep(const GameMap& aMap, const GameAction_t& aAction)
+{
+    switch (aAction.type)
+    {
+    case GameActionType::ROLL_DICE:
+        return Step_t{MapAction_t{MapActionOpcode::ROLL_DICE, 0U, 0U}, {{"roll", Point_t{0, 0}}}};
+    case GameActionType::BUILD_ROAD:
+        return Step_t{MapAction_t{MapActionOpcode::BUILD_ROAD, 0U, aAction.id}, \
+            {{"build road", Point_t{0, 0}}, {"", pointOf(aMap, aMap.getEdges().at(aAction.id))}}};
+    case GameActionType::BUILD_SETTLEMENT:
+        return Step_t{MapAction_t{MapActionOpcode::BUILD_SETTLEMENT, 0U, aAction.id}, \
+            {{"build settlement", Point_t{0, 0}}, {"", pointOf(aMap, aMap.getVertices().at(aAction.id))}}};
+    case GameActionType::BUILD_CITY:
+        return Step_t{MapAction_t{MapActionOpcode::BUILD_CITY, 0U, aAction.id}, \
+            {{"build city", Point_t{0, 0}}, {"", pointOf(aMap, aMap.getVertices().at(aAction.id))}}};
+    case GameActionType::BUY_DEV_CARD:
+        return Step_t{MapAction_t{MapActionOpcode::BUY_DEV_CARD, 0U, 0U}, {{"development_card buy", Point_t{0, 0}}}};
+    case GameActionType::MOVE_ROBBER:
+    case GameActionType::PLAY_KNIGHT:
+    {
+        Step_t step = Step_t{MapAction_t{MapActionOpcode::MOVE_ROBBER, aAction.aux, aAction.id}, {}};
+        if (aAction.type == GameActionType::PLAY_KNIGHT)
+        {
+            step.action.opcode = MapActionOpcode::PLAY_KNIGHT;
+            step.inputs.push_back(UiInput_t{"development_card play knight", Point_t{0, 0}});
+        }
+        step.inputs.push_back(UiInput_t{"", pointOf(aMap, aMap.getLands().at(aAction.id))});
+        step.inputs.push_back(UiInput_t{"", pointOf(aMap, robbedVertex(aMap, aAction))});
+        return step;
+    }
+    case GameActionType::END_TURN:
+    case GameActionType::BANK_TRADE:
+    default:
+        return Step_t{MapAction_t{MapActionOpcode::END_TURN, 0U, 0U}, {{"next", Point_t{0, 0}}}};
+    }
+}
+
+// the setup of the greedy agent, placed with MapActionExecutor
+static int setUpGame(GameMap& aMap, const GameRules& aRules, MapActionExecutor& aExecutor)
+{
+    GameState_t state;
+    if (aMap.exportGameState(state) != 0)
+    {
+        return 1;
+    }
+    state.phase = GamePhase::SETUP_SETTLEMENT;
+    state.setupStep = 0U;
+    state.currentPlayer = 0U;
+
+    GreedyAgent agent;
+    RandomEngine engine(SEED);
+    std::vector<GameAction_t> actions;
+    aRules.getLegalActions(state, actions);
+    while (state.phase == GamePhase::SETUP_SETTLEMENT || state.phase == GamePhase::SETUP_ROAD)
+    {
+        const GameAction_t action = actions[agent.chooseAction(aRules, state, actions, engine)];
+        while (aMap.currentPlayer() != state.currentPlayer)
+        {
+            aMap.nextPlayer();
+        }
+        // the second settlement of every player collects the resources next to it
+        const MapAction_t placement = (action.type == GameActionType::BUILD_ROAD) ? \
+            MapAction_t{MapActionOpcode::PLACE_ROAD, 0U, action.id} : \
+            MapAction_t{MapActionOpcode::PLACE_SETTLEMENT, static_cast<uint8_t>(state.setupStep >= NUM_PLAYERS), action.id};
+        if (aExecutor.execute(aMap, placement).rc != 0)
+        {
+            return 1;
+        }
+        aRules.applyAction(state, action, engine);
+        aRules.getLegalActions(state, actions);
+    }
+    while (aMap.currentPlayer() != state.currentPlayer)
+    {
+        aMap.nextPlayer();
+    }
+    return 0;
+}
+
+/**
+ * play NUM_TURNS turns of greedy agents on aMap with aExecutor, and record every action taken,
+ * bank trades are left out, the UI has no command for them, and so are the robber moves the UI cannot click
+ */
+static int recordGame(GameMap& aMap, const GameRules& aRules, MapActionExecutor& aExecutor, std::vector<Step_t>& aScript)
+{
+    GreedyAgent agent;
+    RandomEngine engine(SEED);
+    std::vector<GameAction_t> actions;
+    GameState_t state;
+    for (size_t turn = 0U; turn < NUM_TURNS; ++turn)
+    {
+        // GameMap does not track the turn, the per-turn fields are kept here, see MapAgentDriver
+        GameState_t turnState = GameState_t();
+        turnState.phase = GamePhase::ROLL;
+        while (true)
+        {
+            aMap.exportGameState(state);
+            for (size_t playerId = 0U; playerId < NUM_PLAYERS; ++playerId)
+            {
+                if (aRules.getVictoryPoint(state, playerId) >= constant::WINNING_VICTORY_POINT)
+                {
+                    return 0;
+                }
+            }
+            state.phase = turnState.phase;
+            state.actionsThisTurn = turnState.actionsThisTurn;
+            state.newKnights = turnState.newKnights;
+            state.devCardPlayed = turnState.devCardPlayed;
+            aRules.getLegalActions(state, actions);
+            actions.erase(std::remove_if(actions.begin(), actions.end(), [&aMap](const GameAction_t& aAction) {
+                    return aAction.type == GameActionType::BANK_TRADE || \
+                        ((aAction.type == GameActionType::MOVE_ROBBER || aAction.type == GameActionType::PLAY_KNIGHT) && \
+                         robbedVertex(aMap, aAction) == nullptr);
+                }), actions.end());
+            const GameAction_t action = actions.empty() ? GameAction_t{GameActionType::END_TURN, 0U, 0U} : \
+                actions[agent.chooseAction(aRules, state, actions, engine)];
+
+            aScript.push_back(toStep(aMap, action));
+            const MapActionResult_t result = aExecutor.execute(aMap, aScript.back().action);
+            if (result.rc != 0)
+            {
+                return 1;
+            }
+            if (turnState.phase == GamePhase::MAIN)
+            {
+                ++turnState.actionsThisTurn;
+            }
+            switch (action.type)
+            {
+            case GameActionType::ROLL_DICE:
+                turnState.phase = (result.value == 7U) ? GamePhase::MOVE_ROBBER : GamePhase::MAIN;
+                break;
+            case GameActionType::MOVE_ROBBER:
+                turnState.phase = GamePhase::MAIN;
+                break;
+            case GameActionType::PLAY_KNIGHT:
+                turnState.devCardPlayed = true;
+                break;
+            case GameActionType::BUY_DEV_CARD:
+                turnState.newKnights += (result.value == static_cast<uint8_t>(DevelopmentCardTypes::KNIGHT)) ? 1U : 0U;
+                break;
+            default:
+                break;
+            }
+            if (action.type == GameActionType::END_TURN)
+            {
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t numRepeats = (argc > 1) ? std::max<size_t>(std::strtoull(argv[1], nullptr, 10), 1U) : DEFAULT_NUM_REPEATS;
+
+    const std::shared_ptr<const BoardLayout> pLayout = MapIO("").readLayout();
+    if (pLayout == nullptr)
+    {
+        return 1;
+    }
+    GameMap executorMap(pLayout, SEED);
+    GameMap uiMap(pLayout, SEED);
+    executorMap.addPlayer(NUM_PLAYERS);
+    uiMap.addPlayer(NUM_PLAYERS);
+    std::shared_ptr<BoardTopology> topology = std::make_shared<BoardTopology>();
+    if (executorMap.initMap() != 0 || uiMap.initMap() != 0 || topology->init(executorMap) != 0)
+    {
+        return 1;
+    }
+    const GameRules rules(topology);
+    MapActionExecutor executor;
+    MapActionExecutor wireExecutor;    // the stats of executor are of execute() alone
+
+    // GameMap logs every build to stdout, muted while it plays
+    std::streambuf* const pCoutBuffer = std::cout.rdbuf(nullptr);
+    std::vector<uint8_t> snapshot;
+    std::vector<Step_t> script;
+    if (setUpGame(executorMap, rules, executor) != 0)
+    {
+        return 1;
+    }
+    executorMap.exportSnapshot(snapshot);
+    if (recordGame(executorMap, rules, executor, script) != 0)
+    {
+        return 1;
+    }
+
+    std::vector<uint8_t> wire;
+    for (const Step_t& step : script)
+    {
+        MapActionExecutor::encode(step.action, wire);
+    }
+
+    executor.resetStats();
+    std::vector<MapActionStats_t> uiStats(MAP_ACTION_OPCODE_SIZE, MapActionStats_t{0U, 0U, UINT64_MAX, 0U});
+    std::vector<std::string> messages;
+    std::vector<uint8_t> results;
+    double wireNs = 0.0;
+    for (size_t repeat = 0U; repeat < numRepeats; ++repeat)
+    {
+        executorMap.importSnapshot(snapshot);
+        for (const Step_t& step : script)
+        {
+            executor.execute(executorMap, step.action);
+        }
+
+        executorMap.importSnapshot(snapshot);
+        results.clear();
+        const auto wireStart = std::chrono::steady_clock::now();
+        if (wireExecutor.executeWire(executorMap, wire, results) != script.size())
+        {
+            return 1;
+        }
+        wireNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - wireStart).count();
+
+        uiMap.importSnapshot(snapshot);
+        UserInterface ui(createTopLevelCommands());
+        for (const Step_t& step : script)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            for (const UiInput_t& input : step.inputs)
+            {
+                ui.act(uiMap, input.input, input.point, messages);
+            }
+            const uint64_t elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            messages.clear();
+            MapActionStats_t& stats = uiStats[static_cast<size_t>(step.action.opcode)];
+            ++stats.count;
+            stats.totalNs += elapsedNs;
+            stats.minNs = std::min(stats.minNs, elapsedNs);
+            stats.maxNs = std::max(stats.maxNs, elapsedNs);
+        }
+    }
+    std::cout.clear();
+    std::cout.rdbuf(pCoutBuffer);
+
+    // both paths call the same GameMap APIs in the same order, they must end in the same state
+    std::vector<uint8_t> executorState;
+    std::vector<uint8_t> uiState;
+    executorMap.exportState(executorState);
+    uiMap.exportState(uiState);
+
+    std::cout << NUM_PLAYERS << " players, greedy policies, " << script.size() << " actions replayed " << numRepeats \
+        << " times from the same snapshot, mean / max ns per action" << std::endl;
+    std::cout << std::left << std::setw(20) << "opcode" << std::right << std::setw(8) << "count" \
+        << std::setw(26) << "MapActionExecutor" << std::setw(26) << "UserInterface" << std::setw(10) << "speedup" << std::endl;
+    uint64_t executorTotalNs = 0U;
+    uint64_t uiTotalNs = 0U;
+    for (size_t opcode = 0U; opcode < MAP_ACTION_OPCODE_SIZE; ++opcode)
+    {
+        const MapActionStats_t& stats = executor.getStats(static_cast<MapActionOpcode>(opcode));
+        const MapActionStats_t& ui = uiStats[opcode];
+        if (stats.count == 0U || ui.count == 0U)
+        {
+            continue;
+        }
+        executorTotalNs += stats.totalNs;
+        uiTotalNs += ui.totalNs;
+        const double executorMean = static_cast<double>(stats.totalNs) / stats.count;
+        const double uiMean = static_cast<double>(ui.totalNs) / ui.count;
+        std::cout << std::left << std::setw(20) << OPCODE_NAMES[opcode] << std::right << std::fixed << std::setprecision(0) \
+            << std::setw(8) << stats.count / numRepeats \
+            << std::setw(14) << executorMean << " / " << std::setw(9) << stats.maxNs \
+            << std::setw(14) << uiMean << " / " << std::setw(9) << ui.maxNs \
+            << std::setw(9) << std::setprecision(1) << uiMean / executorMean << "x" << std::endl;
+    }
+    const double numActions = static_cast<double>(script.size() * numRepeats);
+    std::cout << std::left << std::setw(20) << "all" << std::right << std::fixed << std::setprecision(0) \
+        << std::setw(8) << script.size() << std::setw(14) << executorTotalNs / numActions << std::setw(26) << uiTotalNs / numActions \
+        << std::setw(9) << std::setprecision(1) << static_cast<double>(uiTotalNs) / executorTotalNs << "x" << std::endl;
+    std::cout << "executeWire(), " << script.size() * MapActionExecutor::ACTION_SIZE << " bytes per batch: " \
+        << std::setprecision(0) << wireNs / numActions << " ns per action" << std::endl;
+    std::cout << "state after the script: " << ((executorState == uiState) ? "identical" : "DIFFERENT") << std::endl;
+    return (executorState == uiState) ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+/**
+ * Project: catan
+ * @file rng_bench.cpp
+ * @brief dice throughput of the random engines in random_engine.hpp
+ *        against the std::default_random_engine + std::uniform_int_distribution used before
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include "random_engine.hpp"
+
+constexpr size_t DEFAULT_NUM_ROLLS = 50000000U;
+
+struct BenchResult_t
+{
+    double rollsPerSecond;
+    uint64_t checksum;  // sum of all dice, keeps the rolls from being optimized away
+};
+
+template<typename RollFunc>
+static BenchResult_t bench(const size_t aNumRolls, RollFunc aRoll)
+{
+    uint64_t checksum = 0U;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t ii = 0U; ii < aNumRolls; ++ii)
+    {
+        checksum += aRoll();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return BenchResult_t{aNumRolls / elapsed.count(), checksum};
+}
+
+static void report(const std::string& aName, const size_t aNumRolls, const BenchResult_t& aResult, const double aBaseline)
+{
+    std::cout << std::left << std::setw(36) << aName << std::right << std::fixed << std::setprecision(1) \
+        << std::setw(10) << aResult.rollsPerSecond / 1e6 << " M rolls/s" \
+        << std::setw(8) << std::setprecision(2) << aResult.rollsPerSecond / aBaseline << "x" \
+        << "    mean " << std::setprecision(4) << static_cast<double>(aResult.checksum) / aNumRolls << std::endl;
+}
+
+// the way GameMap::rollDice() rolls, one bounded draw for both dice
+template<typename Engine>
+static BenchResult_t benchEngine(const size_t aNumRolls)
+{
+    Engine engine(2024U, static_cast<uint32_t>(RandomStream::DICE));
+    return bench(aNumRolls, [&engine]() {
+        const uint32_t outcome = uniformBelow(engine, 36U);
+        return static_cast<int>(outcome / 6U + outcome % 6U) + 2;
+    });
+}
+
+int main(int argc, char** argv)
+{
+    const size_t numRolls = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : DEFAULT_NUM_ROLLS;
+    std::cout << "rolling 2 dice " << numRolls << " times" << std::endl;
+
+    // before: what GameMap::rollDice() used to do
+    std::default_random_engine defaultEngine(2024U);
+    std::uniform_int_distribution<int> distribution(1, 6);
+    const BenchResult_t baseline = bench(numRolls, [&]() {
+        return distribution(defaultEngine) + distribution(defaultEngine);
+    });
+    report("std::default_random_engine", numRolls, baseline, baseline.rollsPerSecond);
+
+    report("Philox4x32 + uniformBelow", numRolls, benchEngine<Philox4x32>(numRolls), baseline.rollsPerSecond);
+    report("Pcg32 + uniformBelow", numRolls, benchEngine<Pcg32>(numRolls), baseline.rollsPerSecond);
+    report("Xoshiro256StarStar + uniformBelow", numRolls, benchEngine<Xoshiro256StarStar>(numRolls), baseline.rollsPerSecond);
+    return 0;
+}
@@ -0,0 +1,190 @@
+/**
+ * Project: catan
+ * @file action_journal.hpp
+ * @brief append-only binary journal of the state-changing actions on GameMap
+ *        and the replay engine that re-applies the journal to a GameMap
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_ACTION_JOURNAL_HPP
+#define INCLUDE_ACTION_JOURNAL_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <array>
+#include <fstream>
+#include <utility>
+#include "constant.hpp"
+
+class GameMap;
+
+/**
+ * the outcome of every random action (dice, dev card drawn, card robbed) is recorded
+ * in the event itself, so replaying a journal does not depend on the random engine
+ */
+enum class JournalEventType : uint8_t
+{
+    NEXT_PLAYER = 0,    // aux: -,                       id: -
+    ROLL_DICE,          // aux: dice rolled,             id: -
+    BUILD_ROAD,         // aux: JOURNAL_FLAG_*,          id: edge ID
+    BUILD_SETTLEMENT,   // aux: JOURNAL_FLAG_*,          id: vertex ID
+    BUILD_CITY,         // aux: JOURNAL_FLAG_*,          id: vertex ID
+    MOVE_ROBBER,        // aux: land ID before the move, id: land ID
+    ROB_VERTEX,         // aux: ResourceTypes robbed,    id: vertex ID
+    BUY_DEV_CARD,       // aux: DevelopmentCardTypes,    id: -
+    CONSUME_DEV_CARD,   // aux: DevelopmentCardTypes,    id: -
+    MONOPOLY,           // aux: ResourceTypes,           id: -
+    ADD_RESOURCE,       // aux: ResourceTypes,           id: -
+    CHECKPOINT,         // aux: -,                       id: num of 4-byte words of the state that follows
+
+    /* end of JournalEventType */
+    JOURNAL_EVENT_TYPE_END,
+};
+
+// flags in JournalEvent_t::aux of the BUILD_* events
+constexpr uint8_t JOURNAL_FLAG_CONSUME_RESOURCE = 0x01U;
+// JournalEvent_t::aux of MOVE_ROBBER when the robber was on no land before the move, e.g., a map without desert
+constexpr uint8_t JOURNAL_NO_LAND = 0xFFU;
+
+struct JournalEvent_t
+{
+    JournalEventType type;
+    uint8_t aux;
+    uint16_t id;
+};
+static_assert(sizeof(JournalEvent_t) == 4U, "JournalEvent_t is expected to be 4 bytes");
+
+// file offsets (in bytes) of the first event of a turn and of the latest checkpoint before it
+struct JournalTurnIndex_t
+{
+    uint64_t eventOffset;
+    uint64_t checkpointOffset;
+};
+static_assert(sizeof(JournalTurnIndex_t) == 16U, "JournalTurnIndex_t is expected to be 16 bytes");
+
+/**
+ * @brief
+ * ActionJournal is attached to a GameMap via GameMap::setJournal(),
+ * GameMap then records every successful state-changing action.
+ *
+ * File layout (the integers of the header and the trailer are little-endian, see little_endian.hpp,
+ *              the events and the turn index are in host byte order):
+ *   header  - magic, version, number of players, board (see GameMap::exportBoard())
+ *   body    - JournalEvent_t, 4 bytes each,
+ *             every mCheckpointInterval events, a CHECKPOINT event followed by the state (see GameMap::exportState())
+ *   trailer - written on close(), JournalTurnIndex_t of every turn, turn 0 is the start of the game,
+ *             then end-of-body offset, num of events, num of turns and INDEX_MAGIC
+ *
+ * events are buffered and written in blocks, the buffer is flushed on close() / destruction
+ * a journal without trailer (e.g., the game crashed) is still valid, the index is rebuilt when loaded
+ */
+class ActionJournal
+{
+private:
+    static constexpr size_t BUFFER_SIZE = 1024U;   // num of events buffered before writing to file
+
+    std::ofstream mFile;
+    std::array<JournalEvent_t, BUFFER_SIZE> mBuffer;
+    size_t mBufferIndex;
+    size_t mNumEvents;
+
+    // checkpoint & index related
+    const GameMap* mMap;
+    const size_t mCheckpointInterval;
+    size_t mEventsSinceCheckpoint;
+    uint64_t mOffset;           // file offset of the next event, including the buffered ones
+    uint64_t mLastCheckpoint;   // file offset of the latest CHECKPOINT event
+    std::vector<JournalTurnIndex_t> mTurnIndex;
+    std::vector<uint8_t> mState;
+
+    void append(const void* const aData, const size_t aNumWords);
+    void checkpoint();
+
+public:
+    static constexpr uint32_t MAGIC = 0x4A4E5443U; // "CTNJ"
+    static constexpr uint32_t INDEX_MAGIC = 0x49544E43U; // "CNTI"
+    // 3: aux of MOVE_ROBBER is the land before the move, GameMap::revertEvent() relies on it
+    static constexpr uint16_t VERSION = 3U;
+
+    /**
+     * create (truncate) aFilename and write the header for aMap
+     * aMap must be initialized and have its players added, and must outlive the journal
+     * the state of aMap is checkpointed right after the header
+     * @return 0: ok, 1: failed to open file
+     */
+    int open(const std::string& aFilename, const GameMap& aMap);
+    void record(const JournalEventType aType, const uint8_t aAux = 0U, const uint16_t aId = 0U);
+    void flush();
+    /** flush the buffer and write the trailer */
+    void close();
+    bool isOpen() const;
+    size_t getNumEvents() const;
+
+    /** @param aCheckpointInterval num of events between two checkpoints */
+    ActionJournal(const size_t aCheckpointInterval = constant::JOURNAL_CHECKPOINT_INTERVAL);
+    ~ActionJournal();
+    ActionJournal(const ActionJournal&) = delete;
+    ActionJournal& operator=(const ActionJournal&) = delete;
+};
+
+/**
+ * @brief
+ * ReplayEngine loads a journal and re-applies it directly to GameMap,
+ * no CommandDispatcher, CommandHandler or UserInterface is involved
+ */
+class ReplayEngine
+{
+private:
+    size_t mNumPlayers;
+    size_t mNumEvents;
+    std::vector<uint8_t> mBoard;
+    std::vector<JournalEvent_t> mRecords;   // the body, events and checkpoints
+    std::vector<std::pair<size_t, size_t> > mTurnIndex; // index in mRecords: <first event of turn, checkpoint>
+
+    int loadIndex(std::istream& aFile, const std::streamoff aBodyStart, const std::streamoff aFileSize, std::streamoff& aBodyEnd);
+    void rebuildIndex();
+
+    /**
+     * apply the events in mRecords[aBegin, aEnd), checkpoints are skipped
+     * @return 0: ok, 1: failed to apply an event, aNumEvents is the num of events applied
+     */
+    int replayRange(GameMap& aMap, const size_t aBegin, const size_t aEnd, size_t& aNumEvents) const;
+
+public:
+    /**
+     * @return 0: ok, 1: failed to open file, 2: incorrect header
+     */
+    int load(const std::string& aFilename);
+
+    /**
+     * add players to aMap and restore the board recorded in the journal
+     * aMap must be initialized (GameMap::initMap()) using the same map file as the recorded game
+     * @return 0: ok, otherwise the board does not match
+     */
+    int prepareMap(GameMap& aMap) const;
+
+    /**
+     * apply all events to a prepared map
+     * @return number of events applied
+     */
+    size_t replay(GameMap& aMap) const;
+
+    /**
+     * restore a prepared map to the beginning of aTurn,
+     * the nearest checkpoint is restored and only the events after it are applied
+     * @return 0: ok, 1: aTurn out of range, 2: incorrect checkpoint, 3: failed to apply an event
+     */
+    int seek(GameMap& aMap, const size_t aTurn, size_t& aNumEvents) const;
+
+    size_t getNumPlayers() const;
+    size_t getNumEvents() const;
+    size_t getNumTurns() const;
+
+    ReplayEngine();
+};
+
+#endif /* INCLUDE_ACTION_JOURNAL_HPP */
@@ -0,0 +1,93 @@
+/**
+ * Project: catan
+ * @file agent.hpp
+ * @brief pluggable players of headless games (see GameRules) and of GameMap (see MapAgentDriver)
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_AGENT_HPP
+#define INCLUDE_AGENT_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "game_rules.hpp"
+
+/**
+ * one decision of a batch, see Agent::chooseActions()
+ * the pointers are owned by the caller and stay valid for the duration of the call
+ */
+struct AgentQuery_t
+{
+    const GameState_t* state;
+    const std::vector<GameAction_t>* actions;   // legal actions of state, never empty
+    RandomEngine* engine;                       // the random engine of the game of state
+};
+
+/**
+ * @brief
+ * an Agent decides for the seats it is given, the state it sees is the read-only GameState_t
+ * together with the legal actions generated by GameRules, it must not keep references to either,
+ * each thread owns its agents, i.e., an Agent does not need to be thread-safe
+ *
+ * to add an agent, implement chooseAction() and register its name in Agent::create(),
+ * override chooseActions() if the agent can evaluate many states at once cheaper than one by one
+ */
+class Agent
+{
+public:
+    /**
+     * @param aActions legal actions of aState, never empty
+     * @param aEngine the random engine of the game, an agent must draw from it (not from its own engine)
+     *                so that a game plays the same regardless of how the decisions are batched
+     * @return index in aActions of the action to take
+     */
+    virtual size_t chooseAction(const GameRules& aRules, const GameState_t& aState,
+                                const std::vector<GameAction_t>& aActions, RandomEngine& aEngine) = 0;
+
+    /**
+     * decide for many games at once, the games are independent and may be at different phases
+     * aChoices is resized to aQueries.size(), aChoices[i] is the index in aQueries[i].actions
+     * the default implementation calls chooseAction() for each query
+     */
+    virtual void chooseActions(const GameRules& aRules, const std::vector<AgentQuery_t>& aQueries, std::vector<size_t>& aChoices);
+
+    virtual std::string getName() const = 0;
+
+    /** @return nullptr if aName is not a known agent, known agents: "random", "greedy",
+     *  "mcts[:iterations[:trees[:threads per tree[:time limit ms]]]]" (see MctsAgent) */
+    static std::unique_ptr<Agent> create(const std::string& aName);
+
+    virtual ~Agent();
+};
+
+// uniformly random legal action
+class RandomAgent : public Agent
+{
+public:
+    size_t chooseAction(const GameRules& aRules, const GameState_t& aState,
+                        const std::vector<GameAction_t>& aActions, RandomEngine& aEngine) override;
+    std::string getName() const override;
+};
+
+/**
+ * one-ply greedy, build in the order city > settlement > development card > road,
+ * places colonies on the most productive vertices (by pips) and robs the leader
+ */
+class GreedyAgent : public Agent
+{
+private:
+    int scoreAction(const GameRules& aRules, const GameState_t& aState, const GameAction_t& aAction) const;
+    int scoreVertex(const GameRules& aRules, const GameState_t& aState, const size_t aVertexId) const;
+    int scoreRobber(const GameRules& aRules, const GameState_t& aState, const GameAction_t& aAction) const;
+
+public:
+    size_t chooseAction(const GameRules& aRules, const GameState_t& aState,
+                        const std::vector<GameAction_t>& aActions, RandomEngine& aEngine) override;
+    std::string getName() const override;
+};
+
+#endif /* INCLUDE_AGENT_HPP */
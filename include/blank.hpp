@@ -21,7 +21,8 @@ private:
     Blank(const int aId, const Point_t aTopLeft);
 public:
     static Blank* getBlank();
-    char getCharRepresentation(const size_t aPointX, const size_t aPointY, const bool aUseId = false) const override;
+    char getCharRepresentation(const size_t aPointX, const size_t aPointY, const BoardState_t& aState, \
+                               const bool aUseId = false) const override;
     std::string getStringId() const override;
     virtual ~Blank();
 };
@@ -0,0 +1,121 @@
+/**
+ * Project: catan
+ * @file board_layout.hpp
+ * @brief the immutable part of a board, i.e., the terrains, their adjacency, the harbour positions and the 2D grid
+ *        drawn on the screen, read from a map file once and shared (read-only) by every game played on that map
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_BOARD_LAYOUT_HPP
+#define INCLUDE_BOARD_LAYOUT_HPP
+
+#include <vector>
+#include <deque>
+#include "common.hpp"
+#include "terrain.hpp"
+#include "vertex.hpp"
+#include "edge.hpp"
+#include "land.hpp"
+#include "harbour.hpp"
+#include "random_engine.hpp"
+
+/**
+ * @brief
+ * the layout is built by MapIO (or by hand through addVertex(), addEdge() and addLand()), then initLayout()
+ * links the terrains and places the harbours, after which the layout never changes,
+ * i.e., any number of games (see GameMap) on any number of threads may share it through a std::shared_ptr<const BoardLayout>
+ *
+ * nothing a game changes lives here, the owners, the resources and dice of the lands, the robber and the resources of the harbours
+ * are in the BoardState_t of every game, the terrains read them from there, e.g., Vertex::getOwner(aState)
+ */
+class BoardLayout
+{
+private:
+    // harbour positions of user defined maps are random, yet the same for every game on the same map
+    static constexpr uint64_t HARBOUR_SEED = 0x43415441ULL;
+
+    size_t mSizeHorizontal;
+    size_t mSizeVertical;
+    size_t mNumHarbour;
+    bool mInitialized;
+
+    std::deque< std::deque<Terrain*> > mGameMap;
+
+    std::vector<Vertex*> mVertices;
+    std::vector<Edge*> mEdges;
+    std::vector<Land*> mLands;
+    std::vector<Harbour*> mHarbours;
+
+    Harbour* addHarbour(const int aId1, const int aId2);
+
+    inline bool boundaryCheck(const int x, const int y) const;
+    int populateMap();
+    int checkOverlap() const;
+    [[deprecated]] void fillInBlank();  // no longer used, kept here for reference
+
+    /**
+     * @param aUseDefaultPosition
+     *      randomize the position of the harbours, though the harbours tend to not evenly distributed,
+     *      useful when using user defined map
+     */
+    int populateHarbours(bool aUseDefaultPosition);
+    int createHarboursDefault();
+    int createHarboursRandom(RandomEngine& aEngine);
+
+    Terrain* _getTerrain(const int x, const int y) const;
+    void clearTerrains();
+
+public:
+    BoardLayout(const int aSizeHorizontal = 0, const int aSizeVertical = 0);
+
+    int clearAndResize(const int aSizeHorizontal, const int aSizeVertical);
+
+    int getSizeHorizontal() const;
+    int getSizeVertical() const;
+
+    const Terrain* getTerrain(const int x, const int y) const;
+    const Terrain* getTerrain(const Point_t& aPoint) const;
+
+    template<typename T>
+    static inline bool isTerrain(const Terrain* const aTerrain)
+    {
+        return dynamic_cast<const T* const>(aTerrain);
+    };
+
+    template<typename T>
+    inline bool isTerrain(const Point_t& aPoint) const
+    {
+        return isTerrain<T>(getTerrain(aPoint));
+    };
+
+    const Vertex* addVertex(const size_t aTopLeftX, const size_t aTopLeftY);
+    const Edge* addEdge(const size_t aTopLeftX, const size_t aTopLeftY, const char aPattern);
+    const Land* addLand(const size_t aTopLeftX, const size_t aTopLeftY, const ResourceTypes aPresetResource);
+
+    int setTerrainColor(const int x, const int y, ColorPairIndex aColorIndex);
+
+    int registerTerrain(const std::vector<Point_t>& aPoints, Terrain* const aTerrain);
+    int registerTerrain(const Point_t& aPoint, Terrain* const aTerrain);
+    int registerTerrain(const int x, const int y, Terrain* const aTerrain);
+
+    void setNumOfHarbour(const size_t aNum);
+
+    /** link the terrains and place the harbours, the layout is read-only afterwards */
+    int initLayout();
+    bool isInitialized() const;
+
+    const std::deque< std::deque<Terrain*> >& getTerrainMap() const;
+    const std::vector<Vertex*>& getVertices() const;
+    const std::vector<Edge*>& getEdges() const;
+    const std::vector<Land*>& getLands() const;
+    const std::vector<Harbour*>& getHarbours() const;
+
+    BoardLayout(const BoardLayout &) = delete;
+    BoardLayout& operator=(const BoardLayout&) = delete;
+    ~BoardLayout();
+};
+
+#endif /* INCLUDE_BOARD_LAYOUT_HPP */
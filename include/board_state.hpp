@@ -0,0 +1,49 @@
+/**
+ * Project: catan
+ * @file board_state.hpp
+ * @brief the mutable part of a board, i.e., what a single game owns on top of the shared BoardLayout
+ *        indexed by the IDs of the terrains of the layout
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_BOARD_STATE_HPP
+#define INCLUDE_BOARD_STATE_HPP
+
+#include <vector>
+#include <cstdint>
+#include "common.hpp"
+
+struct BoardState_t
+{
+    std::vector<int8_t> vertexOwner;        // -1: no owner
+    std::vector<uint8_t> colony;            // ColonyType
+    std::vector<int8_t> edgeOwner;          // -1: no owner
+    std::vector<int8_t> landResource;       // ResourceTypes, drawn per game unless preset by the map file
+    std::vector<uint8_t> landDice;          // 0 for desert
+    std::vector<int8_t> harbourResource;    // ResourceTypes
+    int robLandId;                          // -1 until the resources and dice are assigned
+
+    /** no owner, no resource, no dice, no robber, sized for the given num of terrains */
+    void reset(const size_t aNumVertices, const size_t aNumEdges, const size_t aNumLands, const size_t aNumHarbours)
+    {
+        vertexOwner.assign(aNumVertices, -1);
+        colony.assign(aNumVertices, static_cast<uint8_t>(ColonyType::NONE));
+        edgeOwner.assign(aNumEdges, -1);
+        landResource.assign(aNumLands, static_cast<int8_t>(ResourceTypes::NONE));
+        landDice.assign(aNumLands, 0U);
+        harbourResource.assign(aNumHarbours, static_cast<int8_t>(ResourceTypes::NONE));
+        robLandId = -1;
+    }
+
+    /** bytes of the state, the arrays included */
+    size_t getMemoryUsage() const
+    {
+        return sizeof(BoardState_t) + vertexOwner.capacity() + colony.capacity() + edgeOwner.capacity() + \
+            landResource.capacity() + landDice.capacity() + harbourResource.capacity();
+    }
+};
+
+#endif /* INCLUDE_BOARD_STATE_HPP */
@@ -0,0 +1,91 @@
+/**
+ * Project: catan
+ * @file board_topology.hpp
+ * @brief immutable adjacency of an initialized GameMap, indexed by terrain ID
+ *        built once and shared (read-only) by every headless game, see GameRules
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_BOARD_TOPOLOGY_HPP
+#define INCLUDE_BOARD_TOPOLOGY_HPP
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include "common.hpp"
+
+class GameMap;
+
+class BoardTopology
+{
+public:
+    static constexpr uint8_t NO_ID = 0xFFU;    // unused slot in the adjacency arrays
+
+    struct VertexInfo_t
+    {
+        std::array<uint8_t, 3> vertices;    // adjacent vertices, NO_ID if fewer than 3 (coastal)
+        std::array<uint8_t, 3> edges;
+        std::array<uint8_t, 3> lands;
+        int8_t harbour;                     // ResourceTypes of the harbour, NONE if no harbour
+    };
+
+    struct EdgeInfo_t
+    {
+        std::array<uint8_t, 2> vertices;
+    };
+
+    struct LandInfo_t
+    {
+        std::array<uint8_t, 6> vertices;
+        int8_t resource;    // ResourceTypes of the land on the template map
+        uint8_t dice;       // dice num of the land on the template map, 0 for desert
+    };
+
+private:
+    std::vector<VertexInfo_t> mVertices;
+    std::vector<EdgeInfo_t> mEdges;
+    std::vector<LandInfo_t> mLands;
+
+public:
+    /**
+     * copy the adjacency out of aMap, aMap must be initialized (GameMap::initMap())
+     * and is not referenced afterwards
+     * @return 0: ok, 1: the map exceeds the capacity of GameState_t
+     */
+    int init(const GameMap& aMap);
+
+    size_t getNumVertices() const;
+    size_t getNumEdges() const;
+    size_t getNumLands() const;
+    const VertexInfo_t& getVertex(const size_t aId) const;
+    const EdgeInfo_t& getEdge(const size_t aId) const;
+    const LandInfo_t& getLand(const size_t aId) const;
+
+    /** @return the other end of aEdgeId, NO_ID if aVertexId is not an end of aEdgeId */
+    uint8_t getOtherVertex(const size_t aEdgeId, const size_t aVertexId) const;
+
+    /**
+     * put aId in the first NO_ID slot of aArray, e.g., to fill the adjacency arrays
+     * @return 0: ok, 1: aArray is full
+     */
+    template<size_t N>
+    static int appendId(std::array<uint8_t, N>& aArray, const int aId)
+    {
+        for (uint8_t& slot : aArray)
+        {
+            if (slot == NO_ID)
+            {
+                slot = static_cast<uint8_t>(aId);
+                return 0;
+            }
+        }
+        return 1;
+    }
+
+    BoardTopology();
+};
+
+#endif /* INCLUDE_BOARD_TOPOLOGY_HPP */
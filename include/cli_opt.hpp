@@ -15,6 +15,8 @@
 #include <array>
 #include <cstring>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include "logger.hpp"
 #include "constant.hpp"
 
@@ -45,6 +47,25 @@ enum CliOptIndex
     DEBUG_LEVEL = 0,
     HELP_MANUAL,
     MAP_FILE_PATH,
+    JOURNAL_FILE_PATH,
+    REPLAY_FILE_PATH,
+    REPLAY_SEEK_TURN,
+    RANDOM_SEED,
+    SIM_NUM_GAMES,
+    SIM_NUM_THREADS,
+    SIM_AGENTS,
+    SERVER_SOCKET_PATH,
+    SERVER_PORT,
+    SERVER_IO_THREADS,
+    SERVER_HIBERNATE_STORE,
+    SERVER_HIBERNATE_IDLE_MS,
+    SERVER_REHYDRATE_BUDGET_US,
+    SERVER_TURN_MS,
+    SERVER_ROBBER_MS,
+    SERVER_VERBOSE,
+    LOAD_CLIENTS,
+    LOAD_TURNS,
+    LOAD_SCRIPT,
 
     /* end of CliOptIndex */
     CLI_OPT_INDEX_END,
@@ -54,7 +75,8 @@ class CliOpt {
 
 public:
 
-    using CliOptList_t = std::tuple<int, bool, std::string>;
+    using CliOptList_t = std::tuple<int, bool, std::string, std::string, std::string, int, uint64_t, int, int, std::string, \
+                                    std::string, int, int, std::string, int, int, int, int, bool, int, int, std::string>;
 
     template<CliOptIndex Index>
     using TYPE_AT = typename std::tuple_element<Index, CliOptList_t >::type;
@@ -67,6 +89,47 @@ public:
         getOpt<CliOptIndex::HELP_MANUAL>() = false;
         cliOptNames.at(CliOptIndex::MAP_FILE_PATH) = "--map";
         getOpt<CliOptIndex::MAP_FILE_PATH>() = "";
+        cliOptNames.at(CliOptIndex::JOURNAL_FILE_PATH) = "--journal";
+        getOpt<CliOptIndex::JOURNAL_FILE_PATH>() = "";
+        cliOptNames.at(CliOptIndex::REPLAY_FILE_PATH) = "--replay";
+        getOpt<CliOptIndex::REPLAY_FILE_PATH>() = "";
+        cliOptNames.at(CliOptIndex::REPLAY_SEEK_TURN) = "--seek";
+        getOpt<CliOptIndex::REPLAY_SEEK_TURN>() = -1;
+        cliOptNames.at(CliOptIndex::RANDOM_SEED) = "--seed";
+        getOpt<CliOptIndex::RANDOM_SEED>() = 0U;    // 0: seed from system clock
+        // catan-sim only, --threads also sets the num of game workers of catan-server
+        cliOptNames.at(CliOptIndex::SIM_NUM_GAMES) = "--games";
+        getOpt<CliOptIndex::SIM_NUM_GAMES>() = 1000;
+        cliOptNames.at(CliOptIndex::SIM_NUM_THREADS) = "--threads";
+        getOpt<CliOptIndex::SIM_NUM_THREADS>() = 0;  // 0: one thread per core
+        cliOptNames.at(CliOptIndex::SIM_AGENTS) = "--agents";
+        getOpt<CliOptIndex::SIM_AGENTS>() = "greedy,random,random,random";
+        // catan-server only
+        cliOptNames.at(CliOptIndex::SERVER_SOCKET_PATH) = "--socket";
+        getOpt<CliOptIndex::SERVER_SOCKET_PATH>() = "";
+        cliOptNames.at(CliOptIndex::SERVER_PORT) = "--port";
+        getOpt<CliOptIndex::SERVER_PORT>() = 0;     // 0: Unix-domain socket only
+        cliOptNames.at(CliOptIndex::SERVER_IO_THREADS) = "--io-threads";
+        getOpt<CliOptIndex::SERVER_IO_THREADS>() = 1;
+        cliOptNames.at(CliOptIndex::SERVER_HIBERNATE_STORE) = "--hibernate";
+        getOpt<CliOptIndex::SERVER_HIBERNATE_STORE>() = "";  // empty: games are never hibernated
+        cliOptNames.at(CliOptIndex::SERVER_HIBERNATE_IDLE_MS) = "--idle-ms";
+        getOpt<CliOptIndex::SERVER_HIBERNATE_IDLE_MS>() = 60000;
+        cliOptNames.at(CliOptIndex::SERVER_REHYDRATE_BUDGET_US) = "--rehydrate-budget";
+        getOpt<CliOptIndex::SERVER_REHYDRATE_BUDGET_US>() = 5000;
+        cliOptNames.at(CliOptIndex::SERVER_TURN_MS) = "--turn-ms";
+        getOpt<CliOptIndex::SERVER_TURN_MS>() = 0;      // 0: no time limit
+        cliOptNames.at(CliOptIndex::SERVER_ROBBER_MS) = "--robber-ms";
+        getOpt<CliOptIndex::SERVER_ROBBER_MS>() = 0;    // 0: no time limit
+        cliOptNames.at(CliOptIndex::SERVER_VERBOSE) = "--verbose";
+        getOpt<CliOptIndex::SERVER_VERBOSE>() = false;  // false: no INFO logs, see Logger::setInfoEnabled()
+        // catan-load only, --games, --threads and the options of catan-server above apply too
+        cliOptNames.at(CliOptIndex::LOAD_CLIENTS) = "--clients";
+        getOpt<CliOptIndex::LOAD_CLIENTS>() = 4;
+        cliOptNames.at(CliOptIndex::LOAD_TURNS) = "--turns";
+        getOpt<CliOptIndex::LOAD_TURNS>() = 20;
+        cliOptNames.at(CliOptIndex::LOAD_SCRIPT) = "--script";
+        getOpt<CliOptIndex::LOAD_SCRIPT>() = "turn";
     }
 
     int processArg(const int argc, const char* const *argv)
@@ -91,6 +154,63 @@ public:
                     case CliOptIndex::MAP_FILE_PATH:
                         extractValue<CliOptIndex::MAP_FILE_PATH>(argc, argv, ii);
                         break;
+                    case CliOptIndex::JOURNAL_FILE_PATH:
+                        extractValue<CliOptIndex::JOURNAL_FILE_PATH>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::REPLAY_FILE_PATH:
+                        extractValue<CliOptIndex::REPLAY_FILE_PATH>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::REPLAY_SEEK_TURN:
+                        extractValue<CliOptIndex::REPLAY_SEEK_TURN>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::RANDOM_SEED:
+                        extractValue<CliOptIndex::RANDOM_SEED>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::SIM_NUM_GAMES:
+                        extractValue<CliOptIndex::SIM_NUM_GAMES>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::SIM_NUM_THREADS:
+                        extractValue<CliOptIndex::SIM_NUM_THREADS>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::SIM_AGENTS:
+                        extractValue<CliOptIndex::SIM_AGENTS>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::SERVER_SOCKET_PATH:
+                        extractValue<CliOptIndex::SERVER_SOCKET_PATH>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::SERVER_PORT:
+                        extractValue<CliOptIndex::SERVER_PORT>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::SERVER_IO_THREADS:
+                        extractValue<CliOptIndex::SERVER_IO_THREADS>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::SERVER_HIBERNATE_STORE:
+                        extractValue<CliOptIndex::SERVER_HIBERNATE_STORE>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::SERVER_HIBERNATE_IDLE_MS:
+                        extractValue<CliOptIndex::SERVER_HIBERNATE_IDLE_MS>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::SERVER_REHYDRATE_BUDGET_US:
+                        extractValue<CliOptIndex::SERVER_REHYDRATE_BUDGET_US>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::SERVER_TURN_MS:
+                        extractValue<CliOptIndex::SERVER_TURN_MS>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::SERVER_ROBBER_MS:
+                        extractValue<CliOptIndex::SERVER_ROBBER_MS>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::SERVER_VERBOSE:
+                        getOpt<CliOptIndex::SERVER_VERBOSE>() = true;
+                        break;
+                    case CliOptIndex::LOAD_CLIENTS:
+                        extractValue<CliOptIndex::LOAD_CLIENTS>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::LOAD_TURNS:
+                        extractValue<CliOptIndex::LOAD_TURNS>(argc, argv, ii);
+                        break;
+                    case CliOptIndex::LOAD_SCRIPT:
+                        extractValue<CliOptIndex::LOAD_SCRIPT>(argc, argv, ii);
+                        break;
                     default:
                         ERROR_LOG("Unhandled cli option: " + cliOptNames.at(optIndex) + ", index: ", optIndex);
                         break;
@@ -118,7 +238,10 @@ private:
     {
         return extractValueImpl<optIndex>(argc, argv, aIndex, \
             [](const char* str, const char** endptr) {
-                return static_cast< TYPE_AT<optIndex> >(std::strtol(str, const_cast<char**>(endptr), 10));
+                // strtol is 32-bit on Windows, too narrow for e.g. a 64-bit seed
+                return std::is_unsigned<T>::value ? \
+                    static_cast< TYPE_AT<optIndex> >(std::strtoull(str, const_cast<char**>(endptr), 10)) : \
+                    static_cast< TYPE_AT<optIndex> >(std::strtoll(str, const_cast<char**>(endptr), 10));
             });
     }
 
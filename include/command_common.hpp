@@ -52,6 +52,12 @@ class UserInterface;
  *
  * In addition, because StatefulCommandHandler provides an instruction() api,
  * it has a better use experience than the stateless CommandHandler.
+ *
+ **
+ * CoroutineCmd
+ * A StatefulCommandHandler whose parameters are read by a single function, resume(), that awaits
+ * each parameter where it needs it, instead of a state machine spread over onParameterReceive(),
+ * parameterComplete(), resetParameters() and instruction(). See CoroutineCommandHandler
  */
 
 class CommandHandler
@@ -204,4 +210,81 @@ public:
     virtual ~StatefulCommandHandler() = default;
 };
 
+/**
+ * the body of CoroutineCommandHandler::resume()
+ * COROUTINE_BEGIN() and COROUTINE_END() enclose the whole body,
+ * AWAIT_PARAMETER(lines of instruction) suspends the body until the next parameter (aParam or aPoint of resume()),
+ * instruction() prints the lines meanwhile
+ */
+#define COROUTINE_BEGIN() switch (mResumePoint) { case COROUTINE_START:
+#define AWAIT_PARAMETER(...) \
+    do \
+    { \
+        mInstruction = std::vector<std::string>{__VA_ARGS__}; \
+        mResumePoint = __LINE__; \
+        return ActionStatus::PARAM_REQUIRED; \
+        case __LINE__: ; \
+    } while (0)
+#define COROUTINE_END() } mResumePoint = COROUTINE_DONE; return ActionStatus::SUCCESS
+
+/**
+ * CoroutineCommandHandler base class
+ * a stackless coroutine that reads the parameters of a StatefulCommandHandler, i.e., C++14 has no co_await,
+ * resume() is re-entered at the AWAIT_PARAMETER() it was suspended at (a switch on the line of the await),
+ * e.g.,
+ *     COROUTINE_BEGIN();
+ *     mBuildType = "";
+ *     AWAIT_PARAMETER("What do you want to build:", "road | settlement | city");
+ *     if (indexInVector(aParam, mBuildTypeMatchingPool) < 0)
+ *     {
+ *         return ActionStatus::FAILED;    // rejected, awaits again at the same place
+ *     }
+ *     mBuildType = aParam;
+ *     AWAIT_PARAMETER("Please click on the map where you want to build");
+ *     ...
+ *     COROUTINE_END();
+ *
+ * a suspended command is its resume point and its members, no stack and no thread, so that any number of games
+ * may be waiting in the middle of a command, e.g., in GameHost
+ * what is to survive an await must be a member, a local must be declared in a block that ends before the next await
+ * statefulRun() is called once the body reaches COROUTINE_END(), then the coroutine starts over from the top
+ */
+class CoroutineCommandHandler : public StatefulCommandHandler
+{
+protected:
+    static constexpr int COROUTINE_START = 0;
+    static constexpr int COROUTINE_DONE = -1;
+
+    int mResumePoint;
+    size_t mNumParameters;                  // accepted since the start
+    std::vector<std::string> mInstruction;  // of the await the body is suspended at
+
+    /**
+     * run the body from its resume point to the next AWAIT_PARAMETER() or to COROUTINE_END()
+     * @return PARAM_REQUIRED: suspended at an await, SUCCESS: done,
+     *         FAILED: the parameter is rejected, the body stays at the same await
+     */
+    virtual ActionStatus resume(GameMap& aMap, const std::string& aParam, const Point_t aPoint, std::vector<std::string>& aReturnMsg) = 0;
+
+    virtual ActionStatus onParameterReceive(GameMap& aMap, const std::string& aParam, Point_t aPoint, std::vector<std::string>& aReturnMsg) override final;
+    virtual ActionStatus onStringParametersReceive(GameMap& aMap, const std::vector<std::string>& aArgs, std::vector<std::string>& aReturnMsg) override final;
+    virtual bool parameterComplete() const override final;
+
+public:
+    /**
+     * run the body from the top to its first await, so that instruction() has something to print,
+     * by the command that pushes a CommandParameterReader of this handler, e.g., RollHandler and DevelopmentCardHandler
+     * the first parameter received starts the coroutine if nobody did
+     */
+    void start(GameMap& aMap);
+
+    /** the num of parameters accepted, i.e., of the awaits passed */
+    virtual size_t currentParamIndex() const override final;
+    virtual void resetParameters() override final;
+    virtual void instruction(std::vector<std::string>& aReturnMsg) const override final;
+
+    CoroutineCommandHandler();
+    virtual ~CoroutineCommandHandler() = default;
+};
+
 #endif /* INCLUDE_COMMAND_COMMON_HPP */
@@ -15,6 +15,8 @@
 #include "command_dispatcher.hpp"
 #include "command_common.hpp"
 #include "game_map.hpp"
+#include "map_agent_driver.hpp"
+#include "opening_optimiser.hpp"
 #include "user_interface.hpp"
 #include "utility.hpp"
 #include "logger.hpp"
@@ -61,7 +63,7 @@ class PassHandler: public NextHandler // alias of NextHandler
     virtual std::string command() const override final;
 };
 
-class BuildHandler: public StatefulCommandHandler
+class BuildHandler: public CoroutineCommandHandler
 {
 protected:
     Point_t mPoint;
@@ -69,16 +71,12 @@ protected:
     const static std::vector<std::string> mBuildTypeMatchingPool; // possible values of mBuildType
 protected:
     virtual ActionStatus statefulRun(GameMap& aMap, UserInterface& aUi, std::vector<std::string>& aReturnMsg) override final;
-    virtual ActionStatus onParameterReceive(GameMap& aMap, const std::string& aParam, Point_t aPoint, std::vector<std::string>& aReturnMsg) override final;
-    virtual bool parameterComplete() const override final;
+    virtual ActionStatus resume(GameMap& aMap, const std::string& aParam, const Point_t aPoint, std::vector<std::string>& aReturnMsg) override final;
 public:
     virtual std::string command() const override final;
     virtual std::string description() const override final;
     virtual const std::vector<std::string>& paramAutoFillPool(size_t aParamIndex) const override final;
 
-    virtual void resetParameters() override final;
-    virtual void instruction(std::vector<std::string>& aReturnMsg) const override final;
-
     BuildHandler();
 };
 
@@ -101,7 +99,7 @@ public:
 };
 
 // for year_of_plenty development_card
-class YearOfPlentyHandler: public StatefulCommandHandler
+class YearOfPlentyHandler: public CoroutineCommandHandler
 {
 private:
     ResourceTypes mResource1;
@@ -109,63 +107,55 @@ private:
     const static std::vector<std::string>& mResourceTypeMatchingPool; // possible values of mBuildType
 protected:
     virtual ActionStatus statefulRun(GameMap& aMap, UserInterface& aUi, std::vector<std::string>& aReturnMsg) override final;
-    virtual ActionStatus onParameterReceive(GameMap& aMap, const std::string& aParam, Point_t aPoint, std::vector<std::string>& aReturnMsg) override final;
-    virtual bool parameterComplete() const override final;
+    virtual ActionStatus resume(GameMap& aMap, const std::string& aParam, const Point_t aPoint, std::vector<std::string>& aReturnMsg) override final;
 public:
     virtual std::string command() const override final;
     virtual const std::vector<std::string>& paramAutoFillPool(size_t aParamIndex) const override final;
-    virtual size_t currentParamIndex() const override final;
-
-    virtual void resetParameters() override;
-    virtual void instruction(std::vector<std::string>& aReturnMsg) const override final;
 
     YearOfPlentyHandler();
 };
 
 // for monopoly development_card
-class MonopolyHandler: public StatefulCommandHandler
+class MonopolyHandler: public CoroutineCommandHandler
 {
 private:
     ResourceTypes mResource;
 protected:
     virtual ActionStatus statefulRun(GameMap& aMap, UserInterface& aUi, std::vector<std::string>& aReturnMsg) override final;
-    virtual ActionStatus onParameterReceive(GameMap& aMap, const std::string& aParam, Point_t aPoint, std::vector<std::string>& aReturnMsg) override final;
-    virtual bool parameterComplete() const override final;
+    virtual ActionStatus resume(GameMap& aMap, const std::string& aParam, const Point_t aPoint, std::vector<std::string>& aReturnMsg) override final;
 public:
     virtual std::string command() const override final;
     virtual const std::vector<std::string>& paramAutoFillPool(size_t aParamIndex) const override final;
 
-    virtual void resetParameters() override;
-    virtual void instruction(std::vector<std::string>& aReturnMsg) const override final;
-
     MonopolyHandler();
 };
 
-// Singleton object
-// should only be used by RollHandler, DevelopmentCardHandler
-class RobberMoveHandler: public StatefulCommandHandler
+// owned by RollHandler and DevelopmentCardHandler, i.e., one of each per game
+class RobberMoveHandler: public CoroutineCommandHandler
 {
 private:
     Point_t mRobberDestination;
     Point_t mRobbingVertex;
-    RobberMoveHandler();
 protected:
     virtual ActionStatus statefulRun(GameMap& aMap, UserInterface& aUi, std::vector<std::string>& aReturnMsg) override final;
-    virtual ActionStatus onParameterReceive(GameMap& aMap, const std::string& aParam, Point_t aPoint, std::vector<std::string>& aReturnMsg) override final;
-    virtual bool parameterComplete() const override final;
+    virtual ActionStatus resume(GameMap& aMap, const std::string& aParam, const Point_t aPoint, std::vector<std::string>& aReturnMsg) override final;
 public:
     virtual std::string command() const override final;
 
-    virtual void instruction(std::vector<std::string>& aReturnMsg) const override final;
-    virtual void resetParameters() override final;
+    /**
+     * the clicks still missing to move the robber on behalf of the current player, e.g., when the player times out:
+     * the land costing the opponents the most and the current player the least,
+     * then the opponent with the most cards next to it
+     */
+    void defaultClicks(const GameMap& aMap, std::vector<Point_t>& aClicks) const;
 
-    static RobberMoveHandler& getRobberHandler();
+    RobberMoveHandler();
 };
 
 class RollHandler: public StatelessCommandHandler
 {
 private:
-    RobberMoveHandler& mRobberMoveHandler;
+    RobberMoveHandler mRobberMoveHandler;
 protected:
     virtual ActionStatus statelessRun(GameMap& aMap, UserInterface& aUi, const std::vector<std::string>& aArgs, std::vector<std::string>& aReturnMsg) override final;
 public:
@@ -179,7 +169,7 @@ class DevelopmentCardHandler: public StatefulCommandHandler
 private:
     std::string mAction;
     int mDevCard;
-    RobberMoveHandler& mRobberMoveHandler;
+    RobberMoveHandler mRobberMoveHandler;
     RoadBuildingHandler mRoadBuilder;
     YearOfPlentyHandler mYearOfPlentyHandler;
     MonopolyHandler mMonopolyHandler;
@@ -210,6 +200,20 @@ public:
     virtual std::string description() const override final;
 };
 
+class AgentHandler: public StatelessCommandHandler
+{
+private:
+    static const std::vector<std::string> mAgentNames;
+    std::unique_ptr<MapAgentDriver> mDriver;    // created on first use, the map must be initialized by then
+    std::unique_ptr<ExpectimaxSearch> mSearch;  // "expectimax", kept between turns for its transposition table
+protected:
+    virtual ActionStatus statelessRun(GameMap& aMap, UserInterface& aUi, const std::vector<std::string>& aArgs, std::vector<std::string>& aReturnMsg) override final;
+public:
+    virtual std::string command() const override final;
+    virtual std::string description() const override final;
+    virtual const std::vector<std::string>& paramAutoFillPool(size_t aParamIndex) const override final;
+};
+
 class FirstTwoRoundHandler: public StatefulCommandHandler
 {
 private:
@@ -217,8 +221,14 @@ private:
     size_t mIndex;  // current index of mOrder
     Point_t mSettelment;
     Point_t mRoad;
-    const std::vector<int> mOrder;
+    const std::vector<int> mOrder;  // player of every placement, snake order, see GameMap::getFirstTwoRoundOrder()
     std::unique_ptr<CommandHelper> mTopLevelCmdDispatcher;  // when first two rounds is finished, push this to UI cmdHelper stack
+    std::unique_ptr<OpeningOptimiser> mOptimiser;   // "suggest", created on first use
+    static const std::vector<std::string> mParamPool;
+
+    void suggestOpenings(GameMap& aMap, std::vector<std::string>& aReturnMsg);
+    ActionStatus placeSettlement(GameMap& aMap, const Point_t aPoint, std::vector<std::string>& aReturnMsg);
+    ActionStatus placeRoad(GameMap& aMap, const Point_t aPoint, std::vector<std::string>& aReturnMsg);
 protected:
     virtual ActionStatus statefulRun(GameMap& aMap, UserInterface& aUi, std::vector<std::string>& aReturnMsg) override final;
     virtual ActionStatus onParameterReceive(GameMap& aMap, const std::string& aParam, Point_t aPoint, std::vector<std::string>& aReturnMsg) override final;
@@ -226,6 +236,7 @@ protected:
 
 public:
     virtual std::string command() const override final;
+    virtual const std::vector<std::string>& paramAutoFillPool(size_t aParamIndex) const override final;
 
     virtual void resetParameters() override final;
     virtual void instruction(std::vector<std::string>& aReturnMsg) const override final;
@@ -233,6 +244,15 @@ public:
     FirstTwoRoundHandler(const std::vector<int>& aOrder, std::unique_ptr<CommandHelper> aCmdDispatcher);
 };
 
+/**
+ * the commands of a new game on aMap, the first two rounds, then every command of the game
+ * aMap must be initialized and have its players, every call creates its own handlers,
+ * i.e., games hosted side by side do not share any command state
+ */
+extern std::unique_ptr<CommandHelper> createGameCommands(GameMap& aMap);
+/** every command of the game, without the first two rounds, e.g., to resume a game past them */
+extern std::unique_ptr<CommandHelper> createTopLevelCommands();
+
 ////////////////////////////////////////////////////////////////////////////////////
 // the commands below are meant to be used for testing in development.
 // they should not be built when RELEASE=1
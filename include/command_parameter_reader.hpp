@@ -31,6 +31,9 @@ public:
     CommandParameterReader(CommandHandler* const aCmd);
     virtual ~CommandParameterReader() = default;
 
+    /** the command whose parameters are being read */
+    const CommandHandler* getCommandHandler() const;
+
     virtual std::vector<std::string> getPossibleInputs(const std::string& aInput, std::string* const aAutoFillString = nullptr) const override;
 
     virtual ActionStatus act(GameMap& aMap, UserInterface& aUi, std::string aInput, \
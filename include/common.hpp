@@ -53,6 +53,18 @@ enum ColonyType
     CITY = 2
 };
 
+// color pair of a terrain on the map, the colors themselves are defined by CursesUserInterface
+enum ColorPairIndex
+{
+    COLOR_PAIR_INDEX_RESERVED = 0,  // 0 is reserved by PDCurses
+    GAME_WIN,
+    INPUT_WIN,
+    OUTPUT_WIN,
+    GAME_WIN_BORDER,
+    PLAYER_START,
+    PLAYER_END = PLAYER_START + 6,
+};
+
 enum class ActionStatus
 {
     SUCCESS = 0,
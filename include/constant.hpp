@@ -11,6 +11,7 @@
 #ifndef INCLUDE_CONSTANT_HPP
 #define INCLUDE_CONSTANT_HPP
 
+#include <array>
 #include <cstdint>
 
 constexpr uint32_t VER_MAJOR = 0;
@@ -42,8 +43,57 @@ constexpr size_t NUM_DICE_3_TO_11 = 2U;
 constexpr size_t NUM_DICE_2_OR_12 = 1U;
 constexpr size_t NUM_DICE_7       = 0U;
 
+// of the 36 rolls of two dice, num of the rolls that total each dice num (0 to 12), i.e., the pips of a land
+constexpr size_t NUM_DICE_ROLLS = 36U;
+constexpr std::array<uint8_t, 13> DICE_PIPS = {{0, 0, 1, 2, 3, 4, 5, 6, 5, 4, 3, 2, 1}};
+
+/** @return the pips of aDice, 0 if aDice is not 2 to 12 */
+constexpr int dicePips(const size_t aDice)
+{
+    return (aDice < DICE_PIPS.size()) ? DICE_PIPS[aDice] : 0;
+}
+
+/** @return chance to roll aDice with two dice, 0 if aDice is not 2 to 12 */
+constexpr double diceChance(const size_t aDice)
+{
+    return dicePips(aDice) / static_cast<double>(NUM_DICE_ROLLS);
+}
+
+constexpr size_t NUM_DEV_CARD_KNIGHT            = 14U;
+constexpr size_t NUM_DEV_CARD_ROAD_BUILDING     = 2U;
+constexpr size_t NUM_DEV_CARD_YEAR_OF_PLENTY    = 2U;
+constexpr size_t NUM_DEV_CARD_MONOPOLY          = 2U;
+constexpr size_t NUM_DEV_CARD_ONE_VICTORY_POINT = 5U;
+constexpr size_t NUM_DEV_CARDS = NUM_DEV_CARD_KNIGHT + NUM_DEV_CARD_ROAD_BUILDING + NUM_DEV_CARD_YEAR_OF_PLENTY + \
+                                 NUM_DEV_CARD_MONOPOLY + NUM_DEV_CARD_ONE_VICTORY_POINT;
+
 constexpr size_t MAX_HISTORY_SIZE = 10U; // number of history command recorded
 
+// game rules
+constexpr size_t WINNING_VICTORY_POINT = 10U;
+constexpr size_t MAX_SETTLEMENTS = 5U;  // per player
+constexpr size_t MAX_CITIES = 4U;
+constexpr size_t MAX_ROADS = 15U;
+constexpr size_t MAX_HAND_ON_SEVEN = 7U;    // players holding more cards discard half when 7 is rolled
+constexpr size_t BANK_TRADE_RATIO = 4U;
+constexpr size_t HARBOUR_ANY_TRADE_RATIO = 3U;
+constexpr size_t HARBOUR_RESOURCE_TRADE_RATIO = 2U;
+constexpr size_t LARGEST_ARMY_MIN_KNIGHTS = 3U;
+constexpr size_t LONGEST_ROAD_MIN_LENGTH = 5U;
+
+// capacity of GameState_t, the default map has 54 vertices, 72 edges and 19 lands
+constexpr size_t MAX_NUM_PLAYERS = 6U;
+constexpr size_t MAX_NUM_VERTICES = 128U;
+constexpr size_t MAX_NUM_EDGES = 192U;
+constexpr size_t MAX_NUM_LANDS = 64U;
+
+// headless games
+constexpr size_t MAX_TURNS = 1000U;             // the game is a draw if nobody wins within MAX_TURNS
+constexpr size_t MAX_ACTIONS_PER_TURN = 32U;    // only END_TURN is legal afterwards
+
+constexpr size_t JOURNAL_CHECKPOINT_INTERVAL = 1024U; // num of journaled events between two state checkpoints
+constexpr size_t DELTA_KEYFRAME_INTERVAL = 256U;      // num of deltas between two keyframes of a DeltaStream
+
 #ifdef RELEASE
 constexpr int DEFAULT_DEBUG_LEVEL = 5;
 #else
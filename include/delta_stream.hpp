@@ -0,0 +1,115 @@
+/**
+ * Project: catan
+ * @file delta_stream.hpp
+ * @brief compact binary stream of what every state-changing action on GameMap changed, with periodic keyframes,
+ *        for renderers and analytics that follow a game without reading the whole board after each action
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_DELTA_STREAM_HPP
+#define INCLUDE_DELTA_STREAM_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "common.hpp"
+#include "constant.hpp"
+#include "action_journal.hpp"
+
+class GameMap;
+
+/**
+ * a delta is the new value of what changed, not the action that changed it (see JournalEventType),
+ * i.e., a consumer needs neither the rules nor the random streams to follow the game
+ * a player nibble is the player ID, 0xF: no owner
+ */
+enum class DeltaType : uint8_t
+{
+    KEYFRAME = 0,       // aux: -,                                   value: num of 4-byte words that follow
+    CURRENT_PLAYER,     // aux: player,                              value: -
+    DICE,               // aux: dice rolled,                         value: -
+    VERTEX,             // aux: owner nibble | ColonyType << 4,      value: vertex ID
+    EDGE,               // aux: owner nibble,                        value: edge ID
+    ROBBER,             // aux: -,                                   value: land ID
+    RESOURCE,           // aux: player | ResourceTypes << 4,         value: change of the amount, int16
+    DEV_CARD,           // aux: player | DevelopmentCardTypes << 4,  value: change of the amount, int16
+    USED_DEV_CARD,      // aux: player | DevelopmentCardTypes << 4,  value: change of the amount, int16
+    AWARDS,             // aux: player,                              value: largest army | longest road << 1
+
+    /* end of DeltaType */
+    DELTA_TYPE_END,
+};
+
+/**
+ * @brief
+ * DeltaStream is attached to a GameMap via GameMap::setDeltaStream(), GameMap then hands it every successful
+ * state-changing action, and the stream encodes what the action changed, read back from the map
+ *
+ * Stream layout (little endian, whatever the host):
+ *   a delta is 4 bytes, [type: u8] [aux: u8] [value: u16], see DeltaType
+ *   a KEYFRAME is followed by GameMap::exportBoard() then GameMap::exportState(), padded to whole words,
+ *   the deltas after a keyframe are relative to it
+ *
+ * the first bytes of a stream are a keyframe, another one follows every mKeyframeInterval deltas,
+ * i.e., a consumer may join at any keyframe and drop everything before it
+ * the cards of the players are compared with what the stream last sent after every action, so that what changes them
+ * without a journaled action (e.g., a trade) is sent along with the next action, or with sync()
+ */
+class DeltaStream
+{
+private:
+    struct PlayerCards_t
+    {
+        std::array<size_t, CONSUMABLE_RESOURCE_SIZE> resources;
+        std::array<size_t, DEVELOPMENT_CARD_TYPE_SIZE> devCards;
+        std::array<size_t, DEVELOPMENT_CARD_TYPE_SIZE> usedDevCards;
+        uint8_t awards;
+    };
+
+    const size_t mKeyframeInterval;
+    size_t mDeltasSinceKeyframe;
+    size_t mNumDeltas;
+    size_t mNumKeyframes;
+    std::vector<uint8_t> mBuffer;           // encoded, not taken yet
+    std::vector<PlayerCards_t> mPlayers;    // as last sent
+    std::vector<uint8_t> mBoard;            // scratch of keyframe()
+    std::vector<uint8_t> mState;
+
+    void push(const DeltaType aType, const uint8_t aAux, const uint16_t aValue);
+    /** the changes of the cards of every player since last sent */
+    void diffPlayers(const GameMap& aMap);
+
+public:
+    static constexpr size_t DELTA_SIZE = 4U;
+    static constexpr uint8_t NO_OWNER = 0x0FU;
+
+    /** @param aKeyframeInterval num of deltas between two keyframes */
+    explicit DeltaStream(const size_t aKeyframeInterval = constant::DELTA_KEYFRAME_INTERVAL);
+
+    /** encode the whole board and state of aMap, the deltas that follow are relative to it */
+    void keyframe(const GameMap& aMap);
+    /** called by GameMap after the action is applied, see GameMap::setDeltaStream() */
+    void onEvent(const GameMap& aMap, const JournalEventType aType, const uint8_t aAux, const uint16_t aId);
+    /** send what changed aMap outside the journaled actions, e.g., before taking the bytes of a request */
+    void sync(const GameMap& aMap);
+
+    /** move the bytes encoded so far to the end of aBytes */
+    void take(std::vector<uint8_t>& aBytes);
+    bool empty() const;
+
+    size_t getNumDeltas() const;
+    size_t getNumKeyframes() const;
+
+    /**
+     * the consumer side, apply whole deltas to the board and state of the latest keyframe,
+     * a keyframe replaces aBoard and aState, a DICE changes neither,
+     * the result may be read directly or passed to GameMap::importBoard() and GameMap::importState()
+     * @return 0: ok, 1: truncated delta, 2: delta before any keyframe, 3: incorrect delta
+     */
+    static int apply(const std::vector<uint8_t>& aDeltas, std::vector<uint8_t>& aBoard, std::vector<uint8_t>& aState);
+};
+
+#endif /* INCLUDE_DELTA_STREAM_HPP */
@@ -0,0 +1,77 @@
+/**
+ * Project: catan
+ * @file dev_card_deck.hpp
+ * @brief the 25 development cards of the bank, shuffled once, drawn from the top
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_DEV_CARD_DECK_HPP
+#define INCLUDE_DEV_CARD_DECK_HPP
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include "common.hpp"
+#include "constant.hpp"
+#include "random_engine.hpp"
+
+/**
+ * @brief
+ * cards[0, size) are the cards left, the top of the deck is cards[size - 1], remaining counts them per type,
+ * a draw pops the top, an undone draw pushes the card back on the top, both O(1)
+ * plain and fixed-size like GameState_t, copying a deck is a memcpy
+ *
+ * the order of the cards is hidden information, a player only knows remaining (minus the cards of the others),
+ * a simulation from the point of view of a player calls shuffle() on its copy to resample the cards not seen
+ */
+struct DevCardDeck_t
+{
+    std::array<uint8_t, constant::NUM_DEV_CARDS> cards;         // DevelopmentCardTypes
+    std::array<uint8_t, DEVELOPMENT_CARD_TYPE_SIZE> remaining;  // per DevelopmentCardTypes
+    uint8_t size;
+
+    /** the full deck, sorted by type, shuffle() it before the first draw */
+    void reset();
+    /** the full deck but aDrawn, i.e., the cards held or played by the players, sorted by type */
+    template<typename Count>
+    void reset(const std::array<Count, DEVELOPMENT_CARD_TYPE_SIZE>& aDrawn)
+    {
+        reset();
+        for (size_t card = 0U; card < DEVELOPMENT_CARD_TYPE_SIZE; ++card)
+        {
+            for (Count drawn = 0U; drawn < aDrawn[card]; ++drawn)
+            {
+                if (take(static_cast<DevelopmentCardTypes>(card)) != 0)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    /** shuffle the cards left */
+    template<typename Engine>
+    void shuffle(Engine& aEngine)
+    {
+        randomShuffle(cards.begin(), cards.begin() + size, aEngine);
+    }
+
+    bool empty() const;
+    /** @return the card on the top, -1 if the deck is empty */
+    int draw();
+    /** undo draw(), aCard goes back on the top */
+    void putBack(const DevelopmentCardTypes aCard);
+    /**
+     * remove a card of type aCard wherever it is, e.g., replaying a journal on a deck shuffled differently, O(size)
+     * @return 0: ok, 1: no such card left
+     */
+    int take(const DevelopmentCardTypes aCard);
+    /** @return chance that the next draw is aCard, 0 if the deck is empty */
+    double getDrawChance(const DevelopmentCardTypes aCard) const;
+};
+static_assert(std::is_trivially_copyable<DevCardDeck_t>::value, "DevCardDeck_t must stay trivially copyable");
+
+#endif /* INCLUDE_DEV_CARD_DECK_HPP */
@@ -23,26 +23,27 @@ class Edge : public Terrain
 {
 private:
     Point_t mOtherEnd; // the end other than mTopLeft
-    int mOwner;
     char mDirection;
 
     std::set<const Vertex*> mAdjacentVertices;
     std::set<const Edge*> mAdjacentEdges;
 
     std::pair<Point_t, Point_t> getAdjacentVertexPoints() const;
-    int addAdjacency(GameMap& aMap, const Point_t aPoint);
+    int addAdjacency(BoardLayout& aLayout, const Point_t aPoint);
 public:
     static constexpr int HORIZONTAL_LENGTH = 9;
     std::vector<Point_t> getAllPoints() const override;
-    const Vertex* getOtherVertex(const GameMap& aMap, const Vertex& aVertex) const; //get connected vertex that is not the input
-    int populateAdjacencies(GameMap& aMap) override;
-    char getCharRepresentation(const size_t aPointX, const size_t aPointY, const bool aUseId = false) const override;
+    const Vertex* getOtherVertex(const BoardLayout& aLayout, const Vertex& aVertex) const; //get connected vertex that is not the input
+    const std::set<const Vertex*>& getAdjacentVertices() const;
+    int populateAdjacencies(BoardLayout& aLayout) override;
+    char getCharRepresentation(const size_t aPointX, const size_t aPointY, const BoardState_t& aState, \
+                               const bool aUseId = false) const override;
+    ColorPairIndex getColorIndex(const BoardState_t& aState) const override;
     std::string getStringId() const override;
 
-    bool isAvailable(const int aPlayerId) const;
+    bool isAvailable(const BoardState_t& aState, const int aPlayerId) const;
 
-    int setOwner(int aPlayerId);
-    int getOwner() const;
+    int getOwner(const BoardState_t& aState) const;
 
     Edge(const int aId, const Point_t aTopLeft, const char aDirection);
     virtual ~Edge();
@@ -0,0 +1,122 @@
+/**
+ * Project: catan
+ * @file expectimax_search.hpp
+ * @brief expectimax search for two-player games, moves are made and unmade in place on a GameMap
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_EXPECTIMAX_SEARCH_HPP
+#define INCLUDE_EXPECTIMAX_SEARCH_HPP
+
+#include <array>
+#include <chrono>
+#include <vector>
+#include "game_state.hpp"
+#include "action_journal.hpp"
+
+class GameMap;
+
+/**
+ * @brief
+ * the current player maximizes, the opponent minimizes, the value is from the point of view of the current player
+ * ending the turn leads to a chance node over the 11 dice outcomes, weighted by their probability,
+ * 7 leads to a robber node where the roller moves the robber
+ * chance nodes are pruned with Star2, i.e., alpha-beta windows derived from the bounds of the evaluation,
+ * tightened by probing one move of every outcome first
+ * iterative deepening, the transposition table is keyed by Zobrist hashing and kept between searches
+ *
+ * moves are applied with GameMap::replayEvent() and reverted with GameMap::revertEvent(), the map is left as it was
+ * the moves searched are building roads, settlements and cities, ending the turn and moving the robber,
+ * buying and playing development cards and robbing a player are left out, so are trades
+ */
+class ExpectimaxSearch
+{
+private:
+    enum class Bound : uint8_t
+    {
+        EXACT,
+        LOWER,  // the true value is at least the value stored
+        UPPER,  // the true value is at most the value stored
+    };
+
+    struct TableEntry_t
+    {
+        uint64_t key;
+        float value;
+        uint8_t depth;
+        Bound bound;
+        GameAction_t bestAction;
+    };
+
+    static constexpr size_t MAX_KEYED_RESOURCES = 32U;  // resource counts above this share a key
+
+    const size_t mMaxDepth;
+    const size_t mTimeLimitMs;
+    std::vector<TableEntry_t> mTable;
+    uint64_t mTableMask;
+
+    // Zobrist keys, created for the size of the map
+    std::vector<uint64_t> mVertexKeys;      // [vertex][player][colony - 1]
+    std::vector<uint64_t> mEdgeKeys;        // [edge][player]
+    std::vector<uint64_t> mRobberKeys;      // [land]
+    std::array<uint64_t, 2U * CONSUMABLE_RESOURCE_SIZE * MAX_KEYED_RESOURCES> mResourceKeys; // [player][resource][amount]
+    uint64_t mPlayerKey;        // player#1 to move
+    uint64_t mRobberPhaseKey;   // the robber is to be moved
+    uint64_t mRootKey;          // player#1 is the root player, values are relative to the root player
+
+    // search state
+    uint64_t mBoardKey;         // vertices, edges, robber and current player, updated on make / unmake
+    size_t mRootPlayer;
+    size_t mNumNodes;
+    size_t mDepthReached;
+    bool mIsAborted;
+    std::chrono::steady_clock::time_point mDeadline;
+    GameAction_t mRootAction;
+    std::vector<std::vector<GameAction_t> > mActions;   // per ply, reserved up front
+
+    void initKeys(const GameMap& aMap);
+    uint64_t computeBoardKey(const GameMap& aMap) const;
+    uint64_t getKey(const GameMap& aMap, const bool aIsRobberPhase) const;
+    uint64_t getEventKey(const JournalEvent_t& aEvent, const size_t aPlayer) const;
+    void makeEvent(GameMap& aMap, const JournalEvent_t& aEvent);
+    void unmakeEvent(GameMap& aMap, const JournalEvent_t& aEvent);
+
+    void generateActions(const GameMap& aMap, const bool aIsRobberPhase, std::vector<GameAction_t>& aActions) const;
+    double evaluate(const GameMap& aMap) const;
+    bool isGameOver(const GameMap& aMap, double& aValue) const;
+
+    double searchDecision(GameMap& aMap, const size_t aDepth, double aAlpha, double aBeta,
+                          const bool aIsRobberPhase, const size_t aPly);
+    double searchAction(GameMap& aMap, const GameAction_t& aAction, const size_t aDepth,
+                        const double aAlpha, const double aBeta, const size_t aPly);
+    double searchChance(GameMap& aMap, const size_t aDepth, const double aAlpha, const double aBeta, const size_t aPly);
+    // value of one move of the node after rolling aDice, a bound of the value of the node
+    double probe(GameMap& aMap, const size_t aDepth, const int aDice, const size_t aPly);
+
+public:
+    /**
+     * @param aMaxDepth max num of moves (of either player) to look ahead, chance nodes are not counted
+     * @param aTimeLimitMs deepening stops when the time is up, the search of depth 1 always completes, 0: no limit
+     * @param aTableSizeLog2 the transposition table has 2^aTableSizeLog2 entries
+     */
+    ExpectimaxSearch(const size_t aMaxDepth, const size_t aTimeLimitMs, const size_t aTableSizeLog2 = 18U);
+
+    /**
+     * search the best move of the current player of aMap, whose dice are already rolled
+     * aMap is modified during the search, and is restored before returning
+     * @param aIsRobberPhase 7 was rolled and the robber is to be moved
+     * @param aAction BUILD_ROAD, BUILD_SETTLEMENT, BUILD_CITY, END_TURN or (aIsRobberPhase) MOVE_ROBBER,
+     *                the victim of MOVE_ROBBER is the opponent if it can be robbed at the land
+     * @return 0: ok, 1: aMap does not have 2 players
+     */
+    int search(GameMap& aMap, const bool aIsRobberPhase, GameAction_t& aAction);
+
+    // statistics of the latest search
+    size_t getNumNodes() const;
+    size_t getDepthReached() const;
+};
+
+#endif /* INCLUDE_EXPECTIMAX_SEARCH_HPP */
@@ -0,0 +1,291 @@
+/**
+ * Project: catan
+ * @file game_host.hpp
+ * @brief headless host of many games in one process, every game is pinned to one worker thread
+ *        and fed through the lock-free command queue of that worker
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_GAME_HOST_HPP
+#define INCLUDE_GAME_HOST_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "game_map.hpp"
+#include "user_interface.hpp"
+#include "mpsc_queue.hpp"
+#include "hibernation_store.hpp"
+#include "timer_wheel.hpp"
+
+struct HibernationConfig_t
+{
+    std::string storePath;      // file of the hibernated games, empty: games are never hibernated
+    uint64_t idleMs;            // a game idle for longer is hibernated
+    uint64_t rehydrateBudgetUs; // a game whose rehydration is expected to take longer stays in memory
+};
+
+struct TurnTimerConfig_t
+{
+    uint64_t turnMs;            // a turn not ended within is ended for the player, 0: no limit
+    uint64_t robberMs;          // a robber (after a 7 or a knight) not moved within is moved for the player, 0: no limit
+};
+
+/**
+ * @brief
+ * game N lives on worker N % getNumWorkers() for its whole life, i.e., its GameMap and its command handlers
+ * are only ever touched by that thread and need no locking.
+ * any thread may call createGame(), act() and describe(), they push a request to the MpscQueue of the worker
+ * and return at once; the worker runs the requests of its queue in order and answers through the callback,
+ * i.e., the requests to one game from one thread are answered in the order they were made
+ *
+ * a worker with an empty queue sleeps on a condition variable, the mutex is only taken to sleep and to wake it up,
+ * never while the worker has requests to run
+ *
+ * with a HibernationConfig_t, the worker also looks for its games idle for longer than idleMs, serialises them
+ * into a record of a few hundred bytes, frees them and hands the record to the HibernationStore,
+ * whose I/O thread writes it, i.e., the worker never waits on the disk to hibernate a game.
+ * the next request to the game reads the record back and rehydrates it before running the request
+ *   - a game past the first two rounds, waiting for a new command, is a snapshot of its map (GameMap::exportSnapshot()),
+ *     resumed exactly where it stopped, random streams included
+ *   - a game in the first two rounds is the seed and the clicks placed so far, replayed on a new game of the same seed,
+ *     only if replaying them is expected to fit in rehydrateBudgetUs
+ *   - a game in the middle of a command (e.g., a build waiting for its click) stays in memory until the command is over
+ *
+ * with a TurnTimerConfig_t, the worker keeps the deadline of each of its games past the first two rounds
+ * in a TimerWheel, re-armed after every request that changes the current player or leaves the robber waiting,
+ * i.e., a deadline costs O(1) to set and to cancel and the worker sleeps until the first one, however many games.
+ * on expiry the worker acts for the stalled player through the command handlers, exactly as the player would:
+ *   - the robber waiting is moved with the clicks of RobberMoveHandler::defaultClicks()
+ *   - a turn over time is unwound with "exit" down to the top-level commands, then ended with "next"
+ * a hibernated game is rehydrated to time out, what the timeouts did is sent along with the next answer of the game
+ *
+ * any number of watchers (e.g., the connection threads of a server, each with its own spectators) may watch() a game,
+ * the worker encodes every change of the game once into an immutable, reference-counted Frame_t and hands the same
+ * frame to every watcher, a game nobody watches is never encoded
+ *   - an update: what a request or a timeout did, i.e., the input and the msgs of the game
+ *   - a keyframe: the whole board as drawn on the screen and the current player, a spectator may start from it,
+ *     sent to a new watcher, and to every watcher after each KEYFRAME_INTERVAL updates for the spectators
+ *     that dropped updates to catch up
+ * a watched game has a DeltaStream attached to its map, an update carries what the request changed as a line
+ * "delta <hex>" of the stream, a keyframe carries a line "state <hex>" of a stream that starts with it,
+ * i.e., a client may follow the game from the bytes alone (see DeltaStream::apply()) and skip the text
+ */
+class GameHost
+{
+public:
+    enum class Result
+    {
+        SUCCESS = 0,
+        NO_GAME,        // no such game, never created or already over
+        GAME_OVER,      // the last command of the game exited, the game is removed
+        FAILED,         // the game cannot be created, or threw and is removed
+    };
+
+    /**
+     * called on the thread of the worker, must be thread-safe and quick, e.g., post the msgs to the thread of the caller
+     * aMsgs is what the game returned, the callback may move from it
+     */
+    using Callback_t = std::function<void(const uint64_t aGameId, const Result aResult, std::vector<std::string>& aMsgs)>;
+
+    static constexpr size_t KEYFRAME_INTERVAL = 32U;
+
+    struct Frame_t
+    {
+        uint64_t gameId;
+        uint64_t seq;           // num of updates of the game since it was first watched, a keyframe is the state after update seq
+        bool isKeyframe;
+        bool isLast;            // the game is over, no frame follows
+        std::shared_ptr<const std::string> data;    // a block of lines ending with a line of a single "." (see GameServer)
+    };
+
+    /** called on the thread of the worker, must be thread-safe and quick, the frame is shared by every watcher */
+    using FrameCallback_t = std::function<void(const Frame_t& aFrame)>;
+
+    /**
+     * append aMsg to a block of lines, i.e., a frame or a response of GameServer, a msg may hold several lines,
+     * a line beginning with '.' gets another '.' in front so that it cannot end the block
+     */
+    static void appendLines(std::string& aBlock, const std::string& aMsg);
+
+private:
+    enum class RequestType
+    {
+        CREATE,
+        ACT,
+        DESCRIBE,
+        WATCH,
+        UNWATCH,
+        HIBERNATED,     // from the I/O thread of the store, the record of the game is written
+    };
+
+    struct HibernatedGame_t
+    {
+        uint64_t recordId;      // of the worker, a game may be hibernated again before its last record is written
+        std::shared_ptr<const std::vector<uint8_t> > record;    // until written to the store
+        uint64_t offset;        // in the store, HibernationStore::WRITE_FAILED if the record is not written
+        size_t size;
+    };
+
+    struct Request_t
+    {
+        RequestType type;
+        uint64_t gameId;
+        size_t numOfPlayers;    // CREATE only
+        std::string input;      // ACT only
+        Point_t point;          // ACT only
+        Callback_t callback;
+        HibernatedGame_t written;   // HIBERNATED only, where the record is written
+        uint64_t watcherId;         // WATCH and UNWATCH only
+        FrameCallback_t onFrame;    // WATCH only
+    };
+
+    struct HostedGame_t
+    {
+        std::unique_ptr<GameMap> map;
+        std::unique_ptr<UserInterface> ui;
+        std::chrono::steady_clock::time_point lastActive;
+        bool isOpening;                         // in the first two rounds
+        std::vector<Point_t> openingClicks;     // the clicks of the first two rounds, nothing else changes the game
+        uint64_t openingCostUs;                 // time spent on the clicks, i.e., to replay them
+    };
+
+
+    struct GameTimer_t
+    {
+        TimerWheel::Handle_t handle;
+        uint64_t deadline;          // tick of the handle, 0: none
+        size_t turnPlayer;          // the player whose turn is timed
+        uint64_t turnDeadline;      // 0: none
+        uint64_t robberDeadline;    // 0: the robber is not waiting
+        std::vector<std::string> msgs;  // what the timeouts did, not sent yet
+    };
+
+    struct GameWatch_t
+    {
+        uint64_t seq;
+        size_t numUpdates;          // since the last keyframe
+        std::vector<std::pair<uint64_t, FrameCallback_t> > watchers;
+        std::unique_ptr<DeltaStream> deltas;    // attached to the map of the game whenever it is in memory
+    };
+
+    struct Worker_t
+    {
+        MpscQueue<Request_t> queue;
+        std::unordered_map<uint64_t, HostedGame_t> games;  // only touched by the worker thread
+        std::unordered_map<uint64_t, HibernatedGame_t> hibernatedGames;  // only touched by the worker thread
+        std::chrono::steady_clock::time_point lastScan;
+        uint64_t numRecords;
+        TimerWheel timers;          // ticks of 1 ms since the construction of the host, payload: game ID
+        std::unordered_map<uint64_t, GameTimer_t> gameTimers;   // kept while the game hibernates
+        std::unordered_map<uint64_t, GameWatch_t> watches;      // kept while the game hibernates
+        std::atomic<bool> isSleeping;
+        std::mutex sleepMutex;
+        std::condition_variable wakeCondition;
+        std::atomic<size_t> numRequests;
+        std::thread thread;
+    };
+
+    const std::shared_ptr<const BoardLayout> mLayout;  // read once, shared by every game
+    const uint64_t mSeed;
+    const HibernationConfig_t mHibernation;
+    const TurnTimerConfig_t mTurnTimer;
+    const std::chrono::steady_clock::time_point mStartTime;
+    std::unique_ptr<HibernationStore> mStore;   // nullptr: games are never hibernated
+    std::atomic<size_t> mNumHibernations;
+    std::atomic<size_t> mNumRehydrations;
+    std::atomic<uint64_t> mMaxRehydrationUs;
+    std::atomic<size_t> mNumTimeouts;
+    std::vector<std::unique_ptr<Worker_t> > mWorkers;
+    std::atomic<uint64_t> mNumGamesCreated;
+    std::atomic<bool> mIsStopping;
+
+    static std::shared_ptr<const BoardLayout> loadLayout(const std::string& aMapFile);
+    void post(const uint64_t aGameId, Request_t&& aRequest);
+    void wake(Worker_t& aWorker);
+    void workerLoop(const size_t aWorker);
+    void run(Worker_t& aWorker, Request_t& aRequest);
+    Result create(Worker_t& aWorker, const uint64_t aGameId, const size_t aNumOfPlayers, std::vector<std::string>& aReturnMsg);
+    /** a new game of aNumOfPlayers, with the given seed, its commands not started yet */
+    int newGame(const uint64_t aSeed, const size_t aNumOfPlayers, HostedGame_t& aGame, std::vector<std::string>& aReturnMsg) const;
+
+    void hibernateIdleGames(Worker_t& aWorker);
+    bool hibernate(Worker_t& aWorker, const uint64_t aGameId, HostedGame_t& aGame);
+    void onHibernated(Worker_t& aWorker, const Request_t& aRequest);
+    /** @return nullptr if the game cannot be rehydrated, it is dropped */
+    HostedGame_t* rehydrate(Worker_t& aWorker, const uint64_t aGameId, std::vector<std::string>& aReturnMsg);
+
+    /** ms since construction, the ticks of the timer wheels */
+    uint64_t nowMs() const;
+    /** set the deadline of the game for its current player and robber, after every request that may change them */
+    void armTimer(Worker_t& aWorker, const uint64_t aGameId, const HostedGame_t& aGame);
+    void dropTimer(Worker_t& aWorker, const uint64_t aGameId);
+    void expireTimers(Worker_t& aWorker);
+    void timeOut(Worker_t& aWorker, const uint64_t aGameId);
+    void addWatcher(Worker_t& aWorker, const Request_t& aRequest, const HostedGame_t& aGame);
+    void removeWatcher(Worker_t& aWorker, const uint64_t aGameId, const uint64_t aWatcherId);
+    /** nobody watches the game any more, its map stops encoding deltas */
+    void eraseWatch(Worker_t& aWorker, const uint64_t aGameId);
+    /** the frames of what aInput did to the game, the last one if the game is over, nothing if the game is not watched */
+    void publish(Worker_t& aWorker, const uint64_t aGameId, const HostedGame_t* const aGame, const std::string& aInput,
+                 const std::vector<std::string>& aMsgs, const bool aIsLast);
+    static Frame_t encodeKeyframe(const uint64_t aGameId, const uint64_t aSeq, const HostedGame_t& aGame);
+
+    /** move what the timeouts of the game did to the front of aReturnMsg */
+    static void takeTimeoutMsgs(Worker_t& aWorker, const uint64_t aGameId, std::vector<std::string>& aReturnMsg);
+
+public:
+    /**
+     * @param aNumWorkers 0: one per core
+     * @param aMapFile map of every game, empty: default map
+     * @param aSeed game N is seeded with aSeed + N, 0: system clock
+     * @param aHibernation where and when idle games are hibernated, see HibernationConfig_t
+     * @param aTurnTimer how long a player may take, see TurnTimerConfig_t
+     */
+    GameHost(const size_t aNumWorkers, const std::string& aMapFile, const uint64_t aSeed,
+             const HibernationConfig_t& aHibernation = HibernationConfig_t{"", 0U, 0U},
+             const TurnTimerConfig_t& aTurnTimer = TurnTimerConfig_t{0U, 0U});
+    /** runs the requests already queued, then stops the workers */
+    ~GameHost();
+
+    /** @return the ID of the new game, the callback tells whether it is created */
+    uint64_t createGame(const size_t aNumOfPlayers, Callback_t aCallback);
+    /** a line of text or a click on the map, exactly as in the terminal */
+    void act(const uint64_t aGameId, const std::string& aInput, const Point_t aPoint, Callback_t aCallback);
+    /** "game <game ID>" followed by the status of the current player */
+    void describe(const uint64_t aGameId, Callback_t aCallback);
+    /**
+     * aOnFrame receives the frames of the game from now on, a keyframe first (after aCallback),
+     * watching again with the same aWatcherId replaces aOnFrame and sends another keyframe
+     */
+    void watch(const uint64_t aGameId, const uint64_t aWatcherId, FrameCallback_t aOnFrame, Callback_t aCallback);
+    void unwatch(const uint64_t aGameId, const uint64_t aWatcherId);
+
+    size_t getNumWorkers() const;
+    /** num of requests run by each worker, since construction */
+    std::vector<size_t> getNumRequests() const;
+
+    /** num of times games are hibernated and rehydrated, and the longest rehydration, since construction */
+    size_t getNumHibernations() const;
+    size_t getNumRehydrations() const;
+    uint64_t getMaxRehydrationUs() const;
+    /** bytes of the hibernated games on disk, 0 if games are never hibernated */
+    uint64_t getStoreBytes() const;
+    /** num of turns ended and robbers moved for players who timed out, since construction */
+    size_t getNumTimeouts() const;
+
+    GameHost(const GameHost&) = delete;
+    GameHost& operator=(const GameHost&) = delete;
+};
+
+#endif /* INCLUDE_GAME_HOST_HPP */
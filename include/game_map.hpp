@@ -1,7 +1,7 @@
 /**
  * Project: catan
  * @file game_map.hpp
- * @brief 2D array, represents the game map
+ * @brief one game on a BoardLayout, i.e., the players, the state of the board and the rules that change them
  *
  * @author Zonghao Huang <kyle0923@qq.com>
  *
@@ -13,75 +13,76 @@
 
 #include <vector>
 #include <deque>
-#include <random>
+#include <array>
+#include <memory>
 #include "common.hpp"
 #include "sequence_config.hpp"
-#include "terrain.hpp"
-#include "vertex.hpp"
-#include "edge.hpp"
-#include "land.hpp"
-#include "harbour.hpp"
+#include "board_layout.hpp"
+#include "board_state.hpp"
 #include "player.hpp"
-#include "user_interface.hpp"
-
-struct SequenceConfig_t;
+#include "action_journal.hpp"
+#include "delta_stream.hpp"
+#include "game_state.hpp"
+#include "dev_card_deck.hpp"
+#include "random_engine.hpp"
+#include "income_model.hpp"
 
 class GameMap
 {
 private:
-    size_t mSizeHorizontal;
-    size_t mSizeVertical;
-    size_t mNumHarbour;
     size_t mCurrentPlayer;
-    int mRobLandId;
     bool mInitialized;
 
     // random generator related
-    const unsigned mSeed;
-    std::default_random_engine mEngine;
-
-    std::deque< std::deque<Terrain*> > mGameMap;
+    const uint64_t mSeed;
+    std::array<RandomEngine, RANDOM_STREAM_SIZE> mEngines;   // indexed by RandomStream
 
-    std::vector<Vertex*> mVertices;
-    std::vector<Edge*> mEdges;
-    std::vector<Land*> mLands;
-    std::vector<Harbour*> mHarbours;
+    std::shared_ptr<const BoardLayout> mLayout; // shared by every game on the same map
+    BoardState_t mState;                        // what this game changes on the layout
     std::vector<Player*> mPlayers;
 
-    Harbour* addHarbour(const int aId1, const int aId2);
+    ActionJournal* mJournal;    // not owned, nullptr if journal is not recorded
+    DeltaStream* mDeltaStream;  // not owned, nullptr if nobody follows the deltas
+    // nullptr until the income is first queried, then follows every colony and robber placed, see getIncomeModel()
+    mutable std::unique_ptr<IncomeModel> mIncomeModel;
+    DevCardDeck_t mDevCardDeck; // shuffled by initMap(), rebuilt from the cards of the players by importState()
 
     inline bool boundaryCheck(const int x, const int y) const;
-    int populateMap();
     int assignResourceAndDice(); // assign resources and dice number to lands
-    int checkOverlap() const;
-    [[deprecated]] void fillInBlank();  // no longer used, kept here for reference
 
     /**
-     * @param aUseDefaultPosition
-     *      randomize the position of the harbours, though the harbours tend to not evenly distributed,
-     *      useful when using user defined map
      * @param aUseDefaultResourceType
      *      by default, 1 ANY harbour is placed between 2 Resource harbours (where possible)
      *      set this to false to lift that restriction
      */
-    int populateHarbours(bool aUseDefaultPosition, bool aUseDefaultResourceType);
-    int createHarboursDefault();
-    int createHarboursRandom();
+    int assignHarbourResources(bool aUseDefaultResourceType);
 
     /**
      * @param aConfig
-     * a SequenceConfig_t  whose value represents the num of occurrences of the index in the output
-     * e.g., aConfig[BRICK] = 2, means there should be 2 BRICK in the returned vector
+     * a SequenceConfig_t  whose value represents the num of occurrences of the index
+     * e.g., aConfig[BRICK] = 2, means there are 2 BRICK to draw from
+     * @param aStream the random stream to draw from
+     * @return the index drawn (and decremented in aConfig), -1 if aConfig is empty
      */
-    std::vector<int> randomizeResource(SequenceConfig_t aConfig);
-
-    Terrain* _getTerrain(const int x, const int y) const;
-    Terrain* _getTerrain(const Point_t& aPoint) const;
+    int drawFromConfig(SequenceConfig_t& aConfig, const RandomStream aStream);
+    inline RandomEngine& getEngine(const RandomStream aStream);
+
+    // the actual mutations, no validation, no logging
+    // shared by the validated public APIs and replayEvent()
+    void produceResources(const int aDice, const bool aRevert = false);    // aRevert: take back what aDice produced
+    void placeColony(const Vertex* const aVertex, const ColonyType aColony, const bool aConsumeResource);
+    void placeRoad(const Edge* const aEdge, const bool aConsumeResource);
+    void placeRobber(const int aLandId);
+    size_t monopolize(const ResourceTypes aResource);
+    inline void recordEvent(const JournalEventType aType, const uint8_t aAux = 0U, const uint16_t aId = 0U);
 
 public:
-    GameMap(const int aSizeHorizontal = 0, const int aSizeVertical = 0);
-
-    int clearAndResize(const int aSizeHorizontal, const int aSizeVertical);
+    /**
+     * @param aLayout the board, initialized (BoardLayout::initLayout()), may be shared by any number of games
+     * @param aSeed seed of all random streams, the same seed generates the same board, dice, etc
+     *              0: seed from system clock
+     */
+    GameMap(std::shared_ptr<const BoardLayout> aLayout, const uint64_t aSeed = 0U);
 
     int getSizeHorizontal() const;
     int getSizeVertical() const;
@@ -92,7 +93,7 @@ public:
     template<typename T>
     static inline bool isTerrain(const Terrain* const aTerrain)
     {
-        return dynamic_cast<const T* const>(aTerrain);
+        return BoardLayout::isTerrain<T>(aTerrain);
     };
 
     template<typename T>
@@ -101,38 +102,33 @@ public:
         return isTerrain<T>(getTerrain(aPoint));
     };
 
-    const Vertex* addVertex(const size_t aTopLeftX, const size_t aTopLeftY);
-    const Edge* addEdge(const size_t aTopLeftX, const size_t aTopLeftY, const char aPattern);
-    const Land* addLand(const size_t aTopLeftX, const size_t aTopLeftY, const ResourceTypes aResource);
-
-    int setTerrainColor(const int x, const int y, ColorPairIndex aColorIndex);
-
-    // /* add a vertex to be a condidate of harbour
-    //  * a condidate must be coastal
-    //  * a pair of connected candidates is considered a valid habour and will be assign a harbour
-    //  * for a dangling condidate, GameMap will try to find a adjacent vertex to form a pair
-    //  * for three connected candidates, the rightmost / bottommost will be treated as dangling
-    //  */
-    // int addHarbourCandidate(Vertex* const aVertex); //TODO: not supported currently
-
-    int registerTerrain(const std::vector<Point_t>& aPoints, Terrain* const aTerrain);
-    int registerTerrain(const Point_t& aPoint, Terrain* const aTerrain);
-    int registerTerrain(const int x, const int y, Terrain* const aTerrain);
-
-    void setNumOfHarbour(const size_t aNum);
+    /** the point as drawn on the screen in this game, see Terrain::getCharRepresentation() */
+    char getCharRepresentation(const int x, const int y, const bool aUseId = false) const;
+    ColorPairIndex getColorIndex(const int x, const int y) const;
 
+    /** draw the resources, dice and harbours of this game on the layout */
     int initMap();
+    uint64_t getSeed() const;
     void logMap(bool aUseId = false);  // std::cout implementation, convenient in development
-    const std::deque< std::deque<Terrain*> >& getTerrainMap() const;
+    const std::shared_ptr<const BoardLayout>& getLayout() const;
+    /** pass it to the terrains of the layout to read what they are in this game, e.g., Vertex::getOwner() */
+    const BoardState_t& getBoardState() const;
+    const std::vector<Vertex*>& getVertices() const;
+    const std::vector<Edge*>& getEdges() const;
+    const std::vector<Land*>& getLands() const;
+    const std::vector<Player*>& getPlayers() const;
 
     /**
      * first two rounds, players will place their first two settlements and roads
      * and they will get the resources next to the second settlement
+     * @return the player of every placement, in snake order, i.e., a shuffled order then the same order reversed,
+     *         the first player of the shuffled order starts the game
      */
     std::vector<int> getFirstTwoRoundOrder();
 
     // Player related
     int addPlayer(size_t aNumOfPlayer);
+    size_t getNumOfPlayers() const;
     size_t nextPlayer();
     size_t currentPlayer() const;
     bool currentPlayerHasResourceForRoad() const;
@@ -141,13 +137,15 @@ public:
     bool currentPlayerHasResourceForDevCard() const;
     /**
      * @return 0: ok, aDevCard returns the DevCard got
-     * @return 1: insufficent resources/dev_card
+     * @return 1: insufficent resources/dev_card, or no development card left in the deck
      * @brief:
      *   buy: update player's devCard status and remove player's resource
      *   consume: ONLY modify player's devCard status, no other action is performed
      */
     int currentPlayerBuyDevCard(DevelopmentCardTypes& aDevCard);
     int currentPlayerConsumeDevCard(const DevelopmentCardTypes aDevCard);
+    /** the cards left in the bank, see DevCardDeck_t::getDrawChance() */
+    const DevCardDeck_t& getDevCardDeck() const;
 
     /**
      * @return amount of the resource got
@@ -157,10 +155,18 @@ public:
     /**
      * @brief for StatusHandler command, stringify player's status,
      * @param aPlayerId - player ID, or -1 for current player ID
+     * @param aNumRolls - the current player also gets the chance to afford each build within aNumRolls rolls,
+     *                    0 for one round, i.e., num of players rolls
      */
-    void summarizePlayerStatus(int aPlayerId, std::vector<std::string>& aReturnMsg) const;
+    void summarizePlayerStatus(int aPlayerId, std::vector<std::string>& aReturnMsg, const size_t aNumRolls = 0U) const;
 
     void currentPlayerAddResource(const ResourceTypes aResource);
+    /**
+     * give the current player one resource of every land next to aVertex, desert excluded,
+     * i.e., what the second settlement of the first two rounds collects
+     * @return num of resources collected
+     */
+    size_t currentPlayerCollectResources(const Point_t aVertex);
 
     // roll dice, assign resources, move robber if rolled 7
     // return the dice
@@ -192,6 +198,76 @@ public:
     int buildColony(const Point_t aPoint, const ColonyType aColony, const bool aEdgeCheck = true, const bool aConsumeResource = true);
     int buildRoad(const Point_t aPoint, const bool aConsumeResource = true);
 
+    // journal & replay related
+    /**
+     * record every successful state-changing action to aJournal, nullptr to stop recording
+     * GameMap does not take ownership of aJournal
+     */
+    void setJournal(ActionJournal* const aJournal);
+    /**
+     * encode what every successful state-changing action changed to aDeltaStream, nullptr to stop,
+     * may be set along with a journal, GameMap does not take ownership of aDeltaStream
+     */
+    void setDeltaStream(DeltaStream* const aDeltaStream);
+
+    /**
+     * the board is the result of the randomization in initMap(), i.e., resource and dice of lands and robber position
+     * harbours are not included, no journaled action depends on them
+     */
+    void exportBoard(std::vector<uint8_t>& aBoard) const;
+    /** @return 0: ok, 1: the board does not match the current map */
+    int importBoard(const std::vector<uint8_t>& aBoard);
+
+    /**
+     * the state is everything a journaled action may change, i.e., owners of vertices and edges,
+     * robber position, current player and players' resources and development cards
+     * the board (see exportBoard()) must be imported before importState()
+     */
+    void exportState(std::vector<uint8_t>& aState) const;
+    /** @return 0: ok, 1: the state does not match the current map */
+    int importState(const std::vector<uint8_t>& aState);
+
+    /**
+     * the board, the state, the positions of the random streams and the order of the deck,
+     * i.e., everything to carry on with the game exactly where it stopped, see GameHost hibernation
+     * the streams and the deck are copied as they are in memory, a snapshot is only valid for the build that made it
+     */
+    void exportSnapshot(std::vector<uint8_t>& aSnapshot) const;
+    /**
+     * the map must be initialized with the seed of the snapshot and have its players added
+     * @return 0: ok, 1: the snapshot does not match the current map
+     */
+    int importSnapshot(const std::vector<uint8_t>& aSnapshot);
+
+    /**
+     * re-apply a journaled event, the event is trusted, i.e., only IDs are range checked
+     * @return 0: ok, 1: incorrect event
+     */
+    int replayEvent(const JournalEvent_t& aEvent);
+    /**
+     * undo an event applied by replayEvent() or by the public APIs, events are to be reverted newest first,
+     * e.g., to make and unmake moves in place during a search, the revert is not journaled
+     * MONOPOLY cannot be reverted (the amount taken from each player is not recorded)
+     * @return 0: ok, 1: incorrect event or the event is not the latest one applied
+     */
+    int revertEvent(const JournalEvent_t& aEvent);
+
+    // GameRules related
+    size_t getRobLandId() const;
+    /**
+     * income of every player on this map, always up to date, see IncomeModel
+     * the model is built on the first call and kept from then on, i.e., a game never queried carries none of it
+     */
+    const IncomeModel& getIncomeModel() const;
+    /**
+     * fill aState with the current map and players, so that GameRules can play on (and be checked against) this map,
+     * lands, vertices and edges keep their IDs, see BoardTopology
+     * GameMap does not track the phase of the turn nor the turn number,
+     * aState.phase is set to ROLL and the per-turn fields are zeroed, the caller is to set them
+     * @return 0: ok, 1: the map exceeds the capacity of GameState_t
+     */
+    int exportGameState(GameState_t& aState) const;
+
     GameMap(const GameMap &) = delete;
     GameMap& operator=(const GameMap&) = delete;
     ~GameMap();
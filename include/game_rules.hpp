@@ -0,0 +1,95 @@
+/**
+ * Project: catan
+ * @file game_rules.hpp
+ * @brief rules of a headless game on GameState_t, no GameMap, Player or logging involved
+ *        a GameRules is immutable once constructed and can be shared by any number of threads
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_GAME_RULES_HPP
+#define INCLUDE_GAME_RULES_HPP
+
+#include <memory>
+#include <vector>
+#include "game_state.hpp"
+#include "board_topology.hpp"
+#include "sequence_config.hpp"
+#include "random_engine.hpp"
+
+/**
+ * @brief
+ * simplifications compared to the interactive game:
+ *   - the bank never runs out, the 25 development cards do (see DevCardDeck_t)
+ *   - the only development card that can be played is KNIGHT, ONE_VICTORY_POINT counts towards victory
+ *   - when 7 is rolled, players holding more than MAX_HAND_ON_SEVEN cards discard half of them at random
+ *   - no trade between players, only with the bank (or harbours)
+ */
+class GameRules
+{
+private:
+    std::shared_ptr<const BoardTopology> mTopology;
+    SequenceConfig_t mResourceConfig;   // the lands of the template map, shuffled for every new game
+    SequenceConfig_t mDiceConfig;
+
+    void produceResources(GameState_t& aState, const size_t aDice) const;
+    void discardHalf(GameState_t& aState, RandomEngine& aEngine) const;
+    void moveRobber(GameState_t& aState, const GameAction_t& aAction, RandomEngine& aEngine) const;
+    void endTurn(GameState_t& aState) const;
+    void updateLargestArmy(GameState_t& aState) const;
+    void updateLongestRoad(GameState_t& aState) const;
+    void checkWinner(GameState_t& aState) const;
+
+    void appendRobberActions(const GameState_t& aState, const GameActionType aType, std::vector<GameAction_t>& aActions) const;
+    bool canPlayKnight(const GameState_t& aState) const;
+    bool isVertexFree(const GameState_t& aState, const size_t aVertexId) const;  // vertex and its neighbours unoccupied
+    bool isRoadConnected(const GameState_t& aState, const size_t aEdgeId, const int aPlayerId) const;
+    size_t longestRoadFrom(const GameState_t& aState, const size_t aVertexId, const int aPlayerId,
+                           std::array<bool, constant::MAX_NUM_EDGES>& aVisited) const;
+
+public:
+    // upper bound of the num of legal actions of any state, e.g., to reserve the action list up front
+    static constexpr size_t MAX_LEGAL_ACTIONS = constant::MAX_NUM_EDGES + constant::MAX_NUM_VERTICES + \
+        constant::MAX_NUM_LANDS * constant::MAX_NUM_PLAYERS + CONSUMABLE_RESOURCE_SIZE * CONSUMABLE_RESOURCE_SIZE + 2U;
+
+    /** @param aTopology must be initialized, see BoardTopology::init() */
+    GameRules(std::shared_ptr<const BoardTopology> aTopology);
+
+    const BoardTopology& getTopology() const;
+
+    /** reset aState to a new game of aNumPlayers on a freshly shuffled board */
+    void newGame(GameState_t& aState, const size_t aNumPlayers, RandomEngine& aEngine) const;
+
+    /**
+     * aActions is cleared then filled with every legal action of the current player,
+     * empty if and only if the game is over
+     */
+    void getLegalActions(const GameState_t& aState, std::vector<GameAction_t>& aActions) const;
+
+    /**
+     * aAction must be one of getLegalActions(aState), it is not validated
+     * aEngine provides the outcome of dice and robbing, development cards are drawn from aState.devCardDeck
+     */
+    void applyAction(GameState_t& aState, const GameAction_t& aAction, RandomEngine& aEngine) const;
+    /**
+     * ROLL_DICE with aDice rolled instead of drawn from aEngine, e.g., to follow the dice of a GameMap,
+     * aEngine still picks the cards discarded on 7
+     */
+    void applyDice(GameState_t& aState, const size_t aDice, RandomEngine& aEngine) const;
+
+    size_t getVictoryPoint(const GameState_t& aState, const size_t aPlayerId) const;
+    /** num of aResource to give for 1 resource in a bank trade */
+    size_t getTradeRatio(const GameState_t& aState, const size_t aPlayerId, const ResourceTypes aResource) const;
+    size_t getNumResources(const GameState_t& aState, const size_t aPlayerId) const;
+    /**
+     * @return true if the outcome of aAction is random, i.e., rolling the dice, buying a development card
+     *         and robbing a player (with MOVE_ROBBER or PLAY_KNIGHT)
+     */
+    static bool isChanceAction(const GameAction_t& aAction);
+    /** @return the player to place in setup step aStep, the order snakes back in the second round */
+    static size_t getSetupPlayer(const size_t aNumPlayers, const size_t aStep);
+};
+
+#endif /* INCLUDE_GAME_RULES_HPP */
@@ -0,0 +1,195 @@
+/**
+ * Project: catan
+ * @file game_server.hpp
+ * @brief catan-server, hosts many games in one process behind a Unix-domain and / or a loopback TCP socket
+ *        Linux only (epoll, eventfd)
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_GAME_SERVER_HPP
+#define INCLUDE_GAME_SERVER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "game_host.hpp"
+#include "mpsc_queue.hpp"
+
+struct ServerConfig_t
+{
+    std::string socketPath;     // Unix-domain socket, empty: no Unix-domain socket
+    uint16_t port;              // TCP port on 127.0.0.1, 0: no TCP socket
+    size_t numWorkers;          // game workers of the GameHost, 0: one per core
+    size_t numIoWorkers;        // connection threads, 0: one
+    std::string mapFile;        // empty: default map
+    uint64_t seed;              // game N is seeded with seed + N, 0: system clock
+    HibernationConfig_t hibernation;    // empty store path: games are never hibernated
+    TurnTimerConfig_t turnTimer;        // 0: no time limit
+};
+
+class ServerWorker;
+
+/**
+ * @brief
+ * line-based protocol, one request per line, every response is a block of lines terminated by a line of a single "."
+ * (a line of the response beginning with "." is sent with an extra leading ".")
+ *
+ *   new [num of players]   create a game and join it, the response begins with "game <game ID>"
+ *   join <game ID>         join an existing game, e.g., a second client watching or playing the same game
+ *   watch <game ID>        spectate a game: the frames of the game (see GameHost::Frame_t) are pushed to the connection,
+ *                          a keyframe first, then an update per change; the connection cannot act on the game
+ *   leave                  leave the current game, or stop watching it, the game keeps running as long as it has not exited
+ *   quit                   close the connection
+ *   click <x> <y>          a click on the map at column x, row y
+ *   anything else          passed to the current command of the game, exactly as typed into the terminal
+ *
+ * the connection threads (ServerWorker) own the sockets, each runs its own epoll loop,
+ * the listening sockets are shared by all of them (EPOLLEXCLUSIVE wakes up one of them per connection).
+ * they hand the game requests to the GameHost, i.e., to the lock-free queue of the worker the game is pinned to,
+ * and the GameHost worker posts the response back to the lock-free queue of the connection thread
+ *
+ * a connection thread watches a game for all its spectators of that game, i.e., a frame is encoded once by the
+ * GameHost worker and posted once to every connection thread watching the game, which queues the same buffer
+ * on each spectator and writes the queue of a connection with a single scatter-gather send,
+ * nothing is copied per spectator. a spectator whose backlog exceeds MAX_SPECTATOR_BACKLOG drops the frames it has
+ * not started to send and skips the updates until the next keyframe, i.e., a slow spectator costs bounded memory
+ */
+class GameServer
+{
+private:
+    const ServerConfig_t mConfig;
+    std::vector<int> mListenFds;
+    std::unique_ptr<GameHost> mHost;
+    std::vector<std::unique_ptr<ServerWorker> > mWorkers;
+
+    int listenUnix();
+    int listenTcp();
+    void closeListenFds();
+
+public:
+    static constexpr size_t DEFAULT_NUM_PLAYERS = 4U;
+    /** longest request, a client sending a longer line is disconnected */
+    static constexpr size_t MAX_LINE_LENGTH = 4096U;
+    /** bytes queued to a spectator beyond which it drops to the next keyframe */
+    static constexpr size_t MAX_SPECTATOR_BACKLOG = 64U * 1024U;
+
+    explicit GameServer(const ServerConfig_t& aConfig);
+    ~GameServer();
+
+    /** open the sockets and start the workers, @return 0 on success */
+    int start();
+    /** stop the workers, close every connection and drop every game */
+    void stop();
+
+    const std::vector<int>& getListenFds() const;
+    GameHost& getHost();
+    size_t getNumIoWorkers() const;
+    size_t getNumWorkers() const;
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+};
+
+/**
+ * @brief one connection thread, an epoll loop over its connections
+ * a connection has at most one request in the GameHost at a time, the lines following it wait in its input,
+ * i.e., the responses go out in the order of the requests even when they are run by different workers
+ */
+class ServerWorker
+{
+private:
+    static constexpr uint64_t NO_GAME = UINT64_MAX;
+
+    struct OutputBuffer_t
+    {
+        std::shared_ptr<const std::string> data;    // a response of its own, or a frame shared by the spectators
+        bool isFrame;           // may be dropped if not started
+    };
+
+    struct Connection_t
+    {
+        int fd;
+        uint64_t connectionId;  // tells a connection from a later one on the same fd
+        uint64_t gameId;        // NO_GAME if not in a game
+        uint64_t watchedGameId; // NO_GAME if not a spectator
+        uint64_t lastSeq;       // of the last frame queued
+        bool isSkipping;        // waiting for a keyframe, the updates are dropped
+        std::string input;      // received but not processed yet, i.e., an incomplete line or lines queued behind a request
+        std::deque<OutputBuffer_t> output;  // not written to the socket yet
+        size_t outputOffset;    // bytes of the front buffer already written
+        size_t outputBytes;     // bytes of output not written yet
+        bool isAwaitingResponse;
+        bool isClosing;         // close once output is drained
+        bool isWaitingWritable; // EPOLLOUT registered, i.e., output did not fit into the socket buffer
+    };
+
+    /** what the GameHost answered to a request of a connection, or a frame of a watched game (frame.data set) */
+    struct Response_t
+    {
+        int fd;
+        uint64_t connectionId;
+        uint64_t gameId;
+        GameHost::Result result;
+        std::vector<std::string> msgs;
+        GameHost::Frame_t frame;
+    };
+
+    GameServer& mServer;
+    const size_t mWorkerIndex;
+    int mEpollFd;
+    int mWakeFd;                // eventfd, signalled by stop() and post()
+    std::atomic<bool> mIsStopping;
+    std::thread mThread;
+
+    std::unordered_map<int, Connection_t> mConnections;
+    uint64_t mNumConnections;
+    std::unordered_map<uint64_t, std::vector<int> > mSpectators;   // fds of the spectators of each game watched
+
+    // filled by the GameHost workers, a wake-up is only signalled when none is pending
+    MpscQueue<Response_t> mResponses;
+    std::atomic<bool> mIsWakeUpPending;
+
+    void loop();
+    void acceptConnections(const int aListenFd);
+    void receiveResponses();
+    void onResponse(Response_t& aResponse);
+    void onReadable(const int aFd);
+    void onWritable(const int aFd);
+    void processInput(Connection_t& aConnection);
+    void handleLine(Connection_t& aConnection, const std::string& aLine);
+    GameHost::Callback_t responseCallback(const Connection_t& aConnection);
+    void reply(Connection_t& aConnection, const std::vector<std::string>& aMsgs);
+    void startWatching(Connection_t& aConnection, const uint64_t aGameId);
+    void stopWatching(Connection_t& aConnection);
+    void onFrame(const GameHost::Frame_t& aFrame);
+    void queueFrame(Connection_t& aConnection, const GameHost::Frame_t& aFrame);
+    void queueOutput(Connection_t& aConnection, std::shared_ptr<const std::string> aData, const bool aIsFrame);
+    void flushOrClose(Connection_t& aConnection);
+    void closeConnection(const int aFd);
+
+    /** called by the GameHost workers */
+    void post(Response_t&& aResponse);
+
+public:
+    ServerWorker(GameServer& aServer, const size_t aWorkerIndex);
+    ~ServerWorker();
+
+    /** @return 0 on success */
+    int start();
+    /** signal the loop to exit, join() waits for it */
+    void stop();
+    void join();
+
+    ServerWorker(const ServerWorker&) = delete;
+    ServerWorker& operator=(const ServerWorker&) = delete;
+};
+
+#endif /* INCLUDE_GAME_SERVER_HPP */
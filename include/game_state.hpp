@@ -0,0 +1,91 @@
+/**
+ * Project: catan
+ * @file game_state.hpp
+ * @brief plain, fixed-size state of a headless game, see GameRules
+ *        copying a GameState_t is a memcpy, no pointer into the state or the map
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_GAME_STATE_HPP
+#define INCLUDE_GAME_STATE_HPP
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include "common.hpp"
+#include "constant.hpp"
+#include "dev_card_deck.hpp"
+
+constexpr uint8_t NO_PLAYER = 0xFFU;
+
+enum class GamePhase : uint8_t
+{
+    SETUP_SETTLEMENT = 0,   // first two rounds, free settlement
+    SETUP_ROAD,             // first two rounds, free road next to the settlement just placed
+    ROLL,                   // beginning of a turn, roll the dice (or play a knight first)
+    MOVE_ROBBER,            // 7 was rolled
+    MAIN,                   // build, buy, trade, play a knight or end the turn
+    GAME_OVER,
+};
+
+enum class GameActionType : uint8_t
+{
+    ROLL_DICE = 0,      // aux: -,                                   id: -
+    BUILD_ROAD,         // aux: -,                                   id: edge ID
+    BUILD_SETTLEMENT,   // aux: -,                                   id: vertex ID
+    BUILD_CITY,         // aux: -,                                   id: vertex ID
+    BUY_DEV_CARD,       // aux: -,                                   id: -
+    MOVE_ROBBER,        // aux: player to rob or NO_PLAYER,          id: land ID
+    PLAY_KNIGHT,        // aux: player to rob or NO_PLAYER,          id: land ID
+    BANK_TRADE,         // aux: resource given << 4 | resource got,  id: -
+    END_TURN,           // aux: -,                                   id: -
+};
+
+struct GameAction_t
+{
+    GameActionType type;
+    uint8_t aux;
+    uint16_t id;
+};
+
+struct PlayerState_t
+{
+    std::array<uint16_t, CONSUMABLE_RESOURCE_SIZE> resources;
+    std::array<uint8_t, DEVELOPMENT_CARD_TYPE_SIZE> devCards;       // on hand
+    std::array<uint8_t, DEVELOPMENT_CARD_TYPE_SIZE> devCardsUsed;
+    uint8_t numSettlements;
+    uint8_t numCities;
+    uint8_t numRoads;
+    uint8_t longestRoad;    // length of the longest road of this player
+};
+
+struct GameState_t
+{
+    std::array<int8_t, constant::MAX_NUM_VERTICES> vertexOwner;     // -1: no owner
+    std::array<uint8_t, constant::MAX_NUM_VERTICES> colony;         // ColonyType
+    std::array<int8_t, constant::MAX_NUM_EDGES> edgeOwner;          // -1: no owner
+    std::array<int8_t, constant::MAX_NUM_LANDS> landResource;       // ResourceTypes
+    std::array<uint8_t, constant::MAX_NUM_LANDS> landDice;
+    std::array<PlayerState_t, constant::MAX_NUM_PLAYERS> players;
+
+    uint16_t turn;
+    uint8_t numPlayers;
+    uint8_t currentPlayer;
+    uint8_t robLandId;
+    GamePhase phase;
+    uint8_t setupStep;          // 0 to 2 * numPlayers - 1 during setup, snake order
+    uint8_t setupVertex;        // the settlement just placed in setup, the road must be next to it
+    uint8_t actionsThisTurn;
+    uint8_t newKnights;         // knights bought this turn, not playable until next turn
+    bool devCardPlayed;         // one development card per turn
+    uint8_t largestArmyOwner;   // NO_PLAYER if nobody
+    uint8_t longestRoadOwner;   // NO_PLAYER if nobody
+    uint8_t winner;             // NO_PLAYER if nobody (yet, or the game is a draw)
+    DevCardDeck_t devCardDeck;  // hidden information, the last member so that it can be left out of a hash
+};
+static_assert(std::is_trivially_copyable<GameState_t>::value, "GameState_t must stay trivially copyable");
+
+#endif /* INCLUDE_GAME_STATE_HPP */
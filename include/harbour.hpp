@@ -15,23 +15,27 @@
 
 class Harbour : public Terrain
 {
+public:
+    static constexpr size_t LABEL_WIDTH = 5U;   // wide enough for the name of any resource
+
 private:
-    ResourceTypes mResourceType;
     Point_t mVertex1;   //the vertex with smaller y or x
     Point_t mVertex2;
     std::vector<Point_t> mLinks; // the points of the links to vertices
+    bool mIsRightAligned;   // the label is left to the vertices
 public:
     // based on vertex1 and vertex2, calculate points that belongs to this harbour
-    int calculatePoints(GameMap& aMap);
+    int calculatePoints(BoardLayout& aLayout);
 
-    ResourceTypes getResourceType();
-    void setResourceType(ResourceTypes aResource);
+    ResourceTypes getResourceType(const BoardState_t& aState) const;
 
     std::string getStringId() const override;
-    char getCharRepresentation(const size_t aPointX, const size_t aPointY, const bool aUseId = false) const override;
+    /** the label takes LABEL_WIDTH points whatever the resource is, the resource is drawn per game */
+    char getCharRepresentation(const size_t aPointX, const size_t aPointY, const BoardState_t& aState, \
+                               const bool aUseId = false) const override;
     std::vector<Point_t> getAllPoints() const override;
 
-    Harbour(const int aId, const ResourceTypes aResource, const Point_t aVertex1, const Point_t aVertex2);
+    Harbour(const int aId, const Point_t aVertex1, const Point_t aVertex2);
     virtual ~Harbour();
 };
 
@@ -0,0 +1,92 @@
+/**
+ * Project: catan
+ * @file hibernation_store.hpp
+ * @brief append-only file of the records of the games hibernated by GameHost,
+ *        written in batches by a background I/O thread so that the game workers never wait on the disk
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_HIBERNATION_STORE_HPP
+#define INCLUDE_HIBERNATION_STORE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mpsc_queue.hpp"
+
+/**
+ * @brief
+ * any thread may write() a record, it is queued and the call returns at once;
+ * the I/O thread takes every record queued so far, appends them with a single write, flushes,
+ * then tells each writer where its record is through the callback, on the I/O thread
+ *
+ * a record is read back with read() once its callback has run, and release()d when it is no longer needed,
+ * the file is truncated as soon as it holds no record in use, i.e., the store does not grow while games
+ * keep going to sleep and waking up
+ *
+ * the store lives as long as its host, the file is removed on destruction
+ */
+class HibernationStore
+{
+public:
+    static constexpr uint64_t WRITE_FAILED = UINT64_MAX;
+
+    /** the offset of the record in the store, WRITE_FAILED if it cannot be written, the record stays with its writer */
+    using OnWritten_t = std::function<void(const uint64_t aOffset)>;
+
+private:
+    struct Write_t
+    {
+        std::shared_ptr<const std::vector<uint8_t> > record;
+        OnWritten_t onWritten;
+    };
+
+    const std::string mPath;
+    std::FILE* mWriteFile;  // only touched by the I/O thread once constructed
+    std::FILE* mReadFile;   // guarded by mReadMutex
+    std::mutex mReadMutex;
+    uint64_t mEnd;          // only touched by the I/O thread once constructed
+    std::atomic<uint64_t> mLiveBytes;
+    std::atomic<size_t> mNumBatches;
+
+    MpscQueue<Write_t> mWrites;
+    std::atomic<bool> mIsSleeping;
+    std::mutex mSleepMutex;
+    std::condition_variable mWakeCondition;
+    std::atomic<bool> mIsStopping;
+    std::thread mThread;
+
+    void ioLoop();
+    void writeBatch(std::vector<Write_t>& aBatch);
+
+public:
+    explicit HibernationStore(const std::string& aPath);
+    /** writes the records already queued, then removes the file */
+    ~HibernationStore();
+
+    bool isOpen() const;
+
+    void write(std::shared_ptr<const std::vector<uint8_t> > aRecord, OnWritten_t aOnWritten);
+    /** @return 0: ok, 1: cannot read aSize bytes at aOffset */
+    int read(const uint64_t aOffset, const size_t aSize, std::vector<uint8_t>& aRecord);
+    /** the record of aSize bytes is no longer needed */
+    void release(const size_t aSize);
+
+    /** bytes of the records written and not released */
+    uint64_t getLiveBytes() const;
+    size_t getNumBatches() const;
+
+    HibernationStore(const HibernationStore&) = delete;
+    HibernationStore& operator=(const HibernationStore&) = delete;
+};
+
+#endif /* INCLUDE_HIBERNATION_STORE_HPP */
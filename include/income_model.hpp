@@ -0,0 +1,118 @@
+/**
+ * Project: catan
+ * @file income_model.hpp
+ * @brief exact per-roll resource income of each player, from the colonies, the dice and the robber,
+ *        and the chance to afford a build within a number of rolls, cached and updated incrementally
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_INCOME_MODEL_HPP
+#define INCLUDE_INCOME_MODEL_HPP
+
+#include <array>
+#include <unordered_map>
+#include "common.hpp"
+#include "game_state.hpp"
+#include "board_topology.hpp"
+
+class GameMap;
+
+enum class IncomeTarget : uint8_t
+{
+    ROAD = 0,
+    SETTLEMENT,
+    CITY,
+    DEV_CARD,
+};
+constexpr size_t INCOME_TARGET_SIZE = static_cast<size_t>(IncomeTarget::DEV_CARD) + 1U;
+
+/**
+ * @brief
+ * the income of a player is a joint distribution over the 11 outcomes of the dice (2 to 12),
+ * each outcome produces a fixed vector of resources: 1 per settlement and 2 per city next to a land
+ * of that dice, except the land under the robber, i.e., the distribution per roll is exact
+ *
+ * the chance to afford a build within k rolls convolves the per-roll distribution k times,
+ * counts are capped at what the build still misses, so the convolution never tracks more than
+ * 2 ^ 4 states (settlement), whatever k is
+ * a roll is the turn of any player, every player produces on every roll, a round is num of players rolls
+ * the convolution assumes the board stays as it is, i.e., no trade, no discard on 7, no robbery and no build
+ *
+ * the model keeps its own copy of the board (owners and colonies of vertices, lands and robber),
+ * the income of a player is recomputed on the first query after a change next to one of its colonies,
+ * the chances are memoized per player until then, both are mutable caches behind the const queries
+ * an IncomeModel is not thread-safe, not even its const queries
+ */
+class IncomeModel
+{
+public:
+    static constexpr size_t NUM_DICE_OUTCOMES = 11U;    // 2 to 12
+    using ResourceCount_t = std::array<size_t, CONSUMABLE_RESOURCE_SIZE>;
+
+    struct Income_t
+    {
+        std::array<std::array<uint8_t, CONSUMABLE_RESOURCE_SIZE>, NUM_DICE_OUTCOMES> perDice;  // [dice - 2][resource]
+        std::array<double, CONSUMABLE_RESOURCE_SIZE> expected;                                  // per roll
+    };
+
+private:
+    std::array<std::array<uint8_t, 6>, constant::MAX_NUM_LANDS> mLandVertices;     // NO_ID if fewer than 6
+    std::array<int8_t, constant::MAX_NUM_LANDS> mLandResource;                      // ResourceTypes
+    std::array<uint8_t, constant::MAX_NUM_LANDS> mLandDice;                         // 0 for desert
+    std::array<int8_t, constant::MAX_NUM_VERTICES> mVertexOwner;                    // -1: no owner
+    std::array<uint8_t, constant::MAX_NUM_VERTICES> mColony;                        // ColonyType
+    size_t mNumVertices;
+    size_t mNumLands;
+    size_t mRobLandId;
+
+    mutable std::array<Income_t, constant::MAX_NUM_PLAYERS> mIncome;
+    mutable uint32_t mDirtyPlayers;     // bit N: the income of Player#N is to be recomputed
+    mutable std::array<std::unordered_map<uint64_t, double>, constant::MAX_NUM_PLAYERS> mChances;
+
+    void clearBoard();
+    void invalidatePlayer(const int aPlayerId);
+    void invalidateLand(const size_t aLandId);
+    void updateIncome(const size_t aPlayerId) const;
+
+public:
+    IncomeModel();
+
+    /**
+     * copy the adjacency, lands, colonies and robber out of aMap, aMap must be initialized
+     * @return 0: ok, 1: the map exceeds the capacity of GameState_t
+     */
+    int init(const GameMap& aMap);
+    /**
+     * copy the adjacency out of aTopology, every vertex is free, see sync() for the rest of the board
+     * @return 0: ok, 1: aTopology is not initialized
+     */
+    int init(const BoardTopology& aTopology);
+
+    // incremental updates, only the players next to the change are invalidated
+    void setLand(const size_t aLandId, const ResourceTypes aResource, const int aDice);
+    void setColony(const size_t aVertexId, const int aOwner, const ColonyType aColony);
+    void setRobber(const size_t aLandId);
+    /** diff aState (of the board init() was given) against the model, i.e., cheap for a bot to call every move */
+    void sync(const GameState_t& aState);
+
+    const Income_t& getIncome(const size_t aPlayerId) const;
+
+    /**
+     * @param aHand resources already held
+     * @param aNumRolls num of rolls to come, 0: aHand only
+     * @return chance that aHand plus the income of aNumRolls rolls covers the cost of aTarget
+     */
+    double getAffordChance(const size_t aPlayerId, const ResourceCount_t& aHand, const IncomeTarget aTarget,
+                           const size_t aNumRolls) const;
+
+    /** @return chance to roll aDice with two dice, 0 if aDice is not 2 to 12 */
+    static double getDiceChance(const int aDice);
+    static const ResourceCount_t& getCost(const IncomeTarget aTarget);
+};
+
+extern std::string incomeTargetToStr(const IncomeTarget aTarget);
+
+#endif /* INCLUDE_INCOME_MODEL_HPP */
@@ -16,27 +16,24 @@
 class Land : public Terrain
 {
 private:
-    ResourceTypes mResourceType;
-    int mDiceNum;
-    bool mIsUnderRobber;
+    ResourceTypes mPresetResourceType;  // given by the map file, NONE: drawn per game
     std::vector<const Vertex*> mAdjacentVertices;
 
-    int addAdjacency(GameMap& aMap, bool aIsVertex, const int aPointX, const int aPointY, const char aPattern = '.');
+    int addAdjacency(BoardLayout& aLayout, bool aIsVertex, const int aPointX, const int aPointY, const char aPattern = '.');
 
 public:
     std::vector<Point_t> getAllPoints() const override;
-    int populateAdjacencies(GameMap& aMap) override;
-
-    Land(const int aId, const Point_t aTopLeft, const ResourceTypes aResourceType);
-    void setResourceType(ResourceTypes aResourceType);
-    ResourceTypes getResourceType();
-    void setDiceNum(int aDice);
-    int getDiceNum();
-    void rob(bool aIsRob);
-    bool isUnderRobber() const;
+    int populateAdjacencies(BoardLayout& aLayout) override;
+
+    Land(const int aId, const Point_t aTopLeft, const ResourceTypes aPresetResourceType);
+    ResourceTypes getPresetResourceType() const;
+    ResourceTypes getResourceType(const BoardState_t& aState) const;
+    int getDiceNum(const BoardState_t& aState) const;
+    bool isUnderRobber(const BoardState_t& aState) const;
     const std::vector<const Vertex*>& getAdjacentVertices() const;
 
-    char getCharRepresentation(const size_t aPointX, const size_t aPointY, const bool aUseId = false) const override;
+    char getCharRepresentation(const size_t aPointX, const size_t aPointY, const BoardState_t& aState, \
+                               const bool aUseId = false) const override;
     std::string getStringId() const override;
 
     virtual ~Land();
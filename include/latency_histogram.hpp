@@ -0,0 +1,68 @@
+/**
+ * Project: catan
+ * @file latency_histogram.hpp
+ * @brief HDR histogram of latencies, constant relative precision from nanoseconds to minutes in fixed memory
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_LATENCY_HISTOGRAM_HPP
+#define INCLUDE_LATENCY_HISTOGRAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief
+ * the layout of HdrHistogram: the values below 2 * mSubBucketHalf are counted one by one, above that,
+ * every power of 2 is a bucket of mSubBucketHalf sub-buckets of equal width, i.e., a value is counted within
+ * 1 / mSubBucketHalf of itself, e.g., 3 significant digits keep 1024 sub-buckets per bucket, 0.1%
+ * recording is an index computation and an increment, no allocation, no search
+ *
+ * a value above the highest trackable one is counted as the highest, the min and max are exact
+ * not thread-safe, keep one per thread and merge() them
+ */
+class LatencyHistogram
+{
+private:
+    size_t mSubBucketBits;      // bits of 2 * mSubBucketHalf
+    uint64_t mSubBucketHalf;
+    uint64_t mHighestTrackable;
+    std::vector<uint64_t> mCounts;
+    uint64_t mTotalCount;
+    uint64_t mMin;
+    uint64_t mMax;
+    double mSum;
+
+    size_t indexOf(const uint64_t aValue) const;
+    /** the highest value counted in the same sub-bucket as aIndex */
+    uint64_t highestEquivalent(const size_t aIndex) const;
+
+public:
+    /**
+     * @param aHighestTrackable e.g., 60 s in ns
+     * @param aSignificantDigits 1 to 5, the precision of the recorded values
+     */
+    LatencyHistogram(const uint64_t aHighestTrackable, const size_t aSignificantDigits);
+
+    void record(const uint64_t aValue);
+    /** aOther must have the same highest trackable value and significant digits */
+    void merge(const LatencyHistogram& aOther);
+    void reset();
+
+    uint64_t getTotalCount() const;
+    /** 0 if empty */
+    uint64_t getMin() const;
+    uint64_t getMax() const;
+    double getMean() const;
+    /**
+     * @param aPercentile 0 to 100, e.g., 99.9
+     * @return the highest value equivalent to the value at aPercentile, i.e., not below it, 0 if empty
+     */
+    uint64_t getValueAtPercentile(const double aPercentile) const;
+};
+
+#endif /* INCLUDE_LATENCY_HISTOGRAM_HPP */
@@ -0,0 +1,83 @@
+/**
+ * Project: catan
+ * @file little_endian.hpp
+ * @brief unsigned integers to and from bytes, least significant byte first,
+ *        shared by the serialized boards, states, journals, deltas and hibernation records
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_LITTLE_ENDIAN_HPP
+#define INCLUDE_LITTLE_ENDIAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+/** @return the aNumBytes at aBytes as an unsigned integer */
+inline uint64_t loadUint(const uint8_t* const aBytes, const size_t aNumBytes)
+{
+    uint64_t value = 0U;
+    for (size_t byte = 0U; byte < aNumBytes; ++byte)
+    {
+        value |= static_cast<uint64_t>(aBytes[byte]) << (8U * byte);
+    }
+    return value;
+}
+
+/** overwrite the aNumBytes at aBytes with the low aNumBytes of aValue */
+inline void storeUint(uint8_t* const aBytes, const uint64_t aValue, const size_t aNumBytes)
+{
+    for (size_t byte = 0U; byte < aNumBytes; ++byte)
+    {
+        aBytes[byte] = static_cast<uint8_t>(aValue >> (8U * byte));
+    }
+}
+
+/** append the low aNumBytes of aValue to aBuffer */
+inline void pushUint(std::vector<uint8_t>& aBuffer, const uint64_t aValue, const size_t aNumBytes)
+{
+    for (size_t byte = 0U; byte < aNumBytes; ++byte)
+    {
+        aBuffer.push_back(static_cast<uint8_t>(aValue >> (8U * byte)));
+    }
+}
+
+/** read aNumBytes at aIndex of aBuffer, aIndex is advanced past them, the caller checks the size of aBuffer */
+inline uint64_t readUint(const std::vector<uint8_t>& aBuffer, size_t& aIndex, const size_t aNumBytes)
+{
+    const uint64_t value = loadUint(aBuffer.data() + aIndex, aNumBytes);
+    aIndex += aNumBytes;
+    return value;
+}
+
+/** write aValue to aStream in sizeof(T) bytes */
+template<typename T>
+inline void writeUint(std::ostream& aStream, const T aValue)
+{
+    static_assert(std::is_unsigned<T>::value, "only unsigned integers are serialized");
+    uint8_t bytes[sizeof(T)];
+    storeUint(bytes, aValue, sizeof(T));
+    aStream.write(reinterpret_cast<const char*>(bytes), sizeof(T));
+}
+
+/** @return false if aStream ends before sizeof(T) bytes, aValue is then left as is */
+template<typename T>
+inline bool readUint(std::istream& aStream, T& aValue)
+{
+    static_assert(std::is_unsigned<T>::value, "only unsigned integers are serialized");
+    uint8_t bytes[sizeof(T)];
+    if (!aStream.read(reinterpret_cast<char*>(bytes), sizeof(T)))
+    {
+        return false;
+    }
+    aValue = static_cast<T>(loadUint(bytes, sizeof(T)));
+    return true;
+}
+
+#endif /* INCLUDE_LITTLE_ENDIAN_HPP */
@@ -0,0 +1,180 @@
+/**
+ * Project: catan
+ * @file lockstep_engine.hpp
+ * @brief structure-of-arrays engine advancing a batch of independent games in lockstep on the same board,
+ *        dice, production and affordability run as SIMD lanes, one game per lane
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_LOCKSTEP_ENGINE_HPP
+#define INCLUDE_LOCKSTEP_ENGINE_HPP
+
+#include <array>
+#include <memory>
+#include "game_state.hpp"
+#include "board_topology.hpp"
+
+/**
+ * @brief
+ * lane vectors of the supported batch sizes, GCC/clang vector extensions, i.e., SSE2/AVX2/NEON as available
+ * the vectors are aligned to their size, new does not honour it before C++17,
+ * i.e., keep an engine on the stack or as a member rather than on the heap
+ */
+template<size_t LANES>
+struct LockstepLanes_t;
+
+template<>
+struct LockstepLanes_t<8U>
+{
+    typedef uint16_t Vector_t __attribute__((vector_size(16)));
+    typedef uint32_t WideVector_t __attribute__((vector_size(32)));
+};
+
+template<>
+struct LockstepLanes_t<16U>
+{
+    typedef uint16_t Vector_t __attribute__((vector_size(32)));
+    typedef uint32_t WideVector_t __attribute__((vector_size(64)));
+};
+
+/**
+ * @brief
+ * every lane is a game, all lanes share the board (topology, resources and dice of the lands) and the turn order,
+ * i.e., step() plays the turn of the same player in every lane that is still playing
+ * per lane state is kept as vectors across the lanes (resources, production, pieces, robber, winner),
+ * the per lane board (owners of vertices and edges) is only touched by the placement decisions
+ *
+ * every lane plays the same fixed greedy policy, divergent decisions are masked:
+ *   - dice, production, discarding on 7, 4:1 bank trades and the affordability of builds are vector ops on all lanes
+ *   - the robber and the placement of colonies and roads run per lane, on the lanes selected by the masks only
+ *
+ * simplifications compared to GameRules:
+ *   - no development cards, no harbours (4:1 bank trades only), no longest road nor largest army,
+ *     i.e., victory points are settlements + 2 * cities
+ *   - players holding more than MAX_HAND_ON_SEVEN cards discard half, most plentiful resource first
+ *   - the robber steals the most plentiful resource of the richest opponent on the land
+ *   - the dice of a game come from its own xorshift32 stream, see reset()
+ */
+template<size_t LANES>
+class LockstepEngine
+{
+public:
+    using LaneMask_t = uint32_t;    // bit N: lane N
+    static constexpr size_t NUM_LANES = LANES;
+
+private:
+    using Vector_t = typename LockstepLanes_t<LANES>::Vector_t;
+    using WideVector_t = typename LockstepLanes_t<LANES>::WideVector_t;
+
+    struct LaneBoard_t
+    {
+        std::array<int8_t, constant::MAX_NUM_VERTICES> vertexOwner;     // -1: no owner
+        std::array<uint8_t, constant::MAX_NUM_VERTICES> colony;         // ColonyType
+        std::array<int8_t, constant::MAX_NUM_EDGES> edgeOwner;          // -1: no owner
+    };
+
+    // shared by all lanes, the adjacency is copied out of the topology to keep the placement loops inline
+    std::array<BoardTopology::VertexInfo_t, constant::MAX_NUM_VERTICES> mVertices;
+    std::array<BoardTopology::EdgeInfo_t, constant::MAX_NUM_EDGES> mEdges;
+    size_t mNumVertices;
+    size_t mNumEdges;
+    size_t mNumLands;
+    GameState_t mInitialState;  // of reset(), every game starts from it
+    std::array<std::array<uint16_t, constant::MAX_NUM_LANDS>, constant::MAX_NUM_PLAYERS> mInitialProduction;
+    std::array<uint8_t, constant::MAX_NUM_VERTICES> mVertexPips;    // sum of the pips of the adjacent lands
+    std::array<uint8_t, constant::MAX_NUM_VERTICES> mVertexOrder;   // vertex IDs, most pips first
+    size_t mNumPlayers;
+    size_t mCurrentPlayer;
+    size_t mTurn;           // num of step() since reset()
+    uint16_t mTurnLimit;    // a game is a draw once it has played mTurnLimit turns
+    uint64_t mSeed;
+
+    // a vector per quantity, a lane per game
+    std::array<std::array<Vector_t, CONSUMABLE_RESOURCE_SIZE>, constant::MAX_NUM_PLAYERS> mResources;
+    std::array<std::array<Vector_t, constant::MAX_NUM_LANDS>, constant::MAX_NUM_PLAYERS> mProduction;  // settlement 1, city 2
+    std::array<Vector_t, constant::MAX_NUM_PLAYERS> mSettlements;
+    std::array<Vector_t, constant::MAX_NUM_PLAYERS> mCities;
+    std::array<Vector_t, constant::MAX_NUM_PLAYERS> mRoads;
+    Vector_t mRobLandId;
+    Vector_t mWinner;       // NO_PLAYER while playing or for a draw
+    Vector_t mNumTurns;     // turns played by the game of each lane
+    Vector_t mParked;       // the lane has no game, e.g., the game is over and run() has counted it
+    Vector_t mDice;
+    WideVector_t mRandomState;
+    std::array<LaneBoard_t, LANES> mBoards;
+
+    // games counted by run()
+    size_t mNumGames;
+    size_t mNumDraws;
+    std::array<size_t, constant::MAX_NUM_PLAYERS> mNumWins;
+
+    void startGame(const size_t aLane, const size_t aGameIndex);
+    void getActiveLanes(Vector_t& aActive) const;
+    void rollDice();
+    void produceResources(const Vector_t& aActive);
+    void discardHalf(const Vector_t& aSevens);
+    void moveRobber(const size_t aLane);
+    void tradeWithBank(const Vector_t& aActive);
+    bool buildOnce(const Vector_t& aActive);
+    void addColony(const size_t aLane, const size_t aVertexId, const ColonyType aColony);
+
+    bool isVertexFree(const LaneBoard_t& aBoard, const size_t aVertexId) const;
+    bool isRoadConnected(const LaneBoard_t& aBoard, const size_t aEdgeId, const int aPlayerId) const;
+    /** @return the best vertex (edge for road) to build on, BoardTopology::NO_ID if none */
+    size_t findCity(const size_t aLane) const;
+    size_t findSettlement(const size_t aLane) const;
+    size_t findRoad(const size_t aLane) const;
+
+public:
+    /** @param aTopology must be initialized, see BoardTopology::init(), it is not referenced afterwards */
+    LockstepEngine(std::shared_ptr<const BoardTopology> aTopology);
+
+    /**
+     * start a game from aState in every lane, aState must be past the setup (phase ROLL)
+     * game N rolls from a stream seeded by aSeed and N, lane N plays game N
+     * resources, colonies, roads and the robber are taken from aState, development cards and harbours are ignored
+     * @return 0: ok, 1: aState is not past the setup
+     */
+    int reset(const GameState_t& aState, const uint64_t aSeed);
+
+    /**
+     * play the turn of the current player in every lane still playing, from rolling the dice to passing to the next player
+     * @return the lanes still playing afterwards, 0 once every game is over
+     */
+    LaneMask_t step();
+
+    /**
+     * step() until aNumGames games are over, the games of reset() included, call once after reset()
+     * a lane whose game is over starts the next game from the state of reset() as soon as the turn
+     * comes back to the first player of that state, i.e., the lanes are not left idle until the longest game ends
+     * @return num of turns played, summed over the games
+     */
+    size_t run(const size_t aNumGames);
+
+    LaneMask_t getPlayingLanes() const;
+    size_t getTurn() const;
+    /** NO_PLAYER while the game of aLane is being played or if it is a draw */
+    uint8_t getWinner(const size_t aLane) const;
+    size_t getNumTurns(const size_t aLane) const;
+    size_t getVictoryPoint(const size_t aLane, const size_t aPlayerId) const;
+    size_t getResource(const size_t aLane, const size_t aPlayerId, const ResourceTypes aResource) const;
+
+    /** games counted by run() since reset() */
+    size_t getNumGames() const;
+    size_t getNumDraws() const;
+    size_t getNumWins(const size_t aPlayerId) const;
+
+    /**
+     * fill aState with the game of aLane, e.g., to continue it with GameRules,
+     * the fields the engine does not track are those of the state of reset()
+     */
+    void exportLane(const size_t aLane, GameState_t& aState) const;
+};
+
+extern template class LockstepEngine<8U>;
+extern template class LockstepEngine<16U>;
+
+#endif /* INCLUDE_LOCKSTEP_ENGINE_HPP */
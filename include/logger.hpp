@@ -18,14 +18,17 @@
 #include <set>
 #include <deque>
 #include <stdexcept>
+#include <mutex>
+#include <atomic>
 
 #ifndef RELEASE
 #define TEMP_LOG(...) \
     Logger::info(__FILE__ ":", __LINE__, ": ", __VA_ARGS__)
 #endif /* RELEASE */
 
+// the arguments are not evaluated while INFO is disabled, e.g., no string is built
 #define INFO_LOG(...) \
-    Logger::info(__FILE__ ":", __LINE__, ": ", __VA_ARGS__)
+    (Logger::isInfoEnabled() ? Logger::info(__FILE__ ":", __LINE__, ": ", __VA_ARGS__) : (void)0)
 #define WARN_LOG(...) \
     Logger::warn(__FILE__ ":", __LINE__, ": ", __VA_ARGS__)
 #define ERROR_LOG(...) \
@@ -86,6 +89,8 @@ private:
         std::stringstream strstream;
         _formatString(strstream, aArgs...);
         std::string logMessage = strstream.str();
+        // games of catan-server log from several threads
+        std::lock_guard<std::mutex> lock(mMutex);
         if (mLogger)
         {
             mLogger->mLogFile << logMessage << std::endl;
@@ -125,7 +130,9 @@ private:
     };
 #endif // RECURSION
     static int mDebugLevel;
+    static std::atomic<bool> mInfoEnabled;
     static Logger* mLogger;
+    static std::mutex mMutex;
     std::ofstream mLogFile;
     Logger();
     ~Logger();
@@ -137,6 +144,15 @@ public:
      * set higher level to filter out generic message
      */
     static void setDebugLevel(int aDebugLevel);
+    /**
+     * INFO is enabled by default, a process serving many games from several threads disables it,
+     * every log line is written behind a single lock, i.e., the games would serialize on it
+     */
+    static void setInfoEnabled(bool aEnabled);
+    static bool isInfoEnabled()
+    {
+        return mInfoEnabled.load(std::memory_order_relaxed);
+    };
     static void initLogger(std::string aLogFilename = "log.txt");
     template<typename... Targs>
     static std::string formatString(Targs... aArgs)
@@ -0,0 +1,132 @@
+/**
+ * Project: catan
+ * @file map_action.hpp
+ * @brief typed actions on GameMap, an opcode and fixed-size operands addressed by the IDs of the terrains,
+ *        for bots and drivers that have no use of the command strings and the clicks of the UI
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_MAP_ACTION_HPP
+#define INCLUDE_MAP_ACTION_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "common.hpp"
+#include "game_state.hpp"
+
+class GameMap;
+
+/**
+ * one opcode per public state-changing API of GameMap, or per step of a command of the UI built on them,
+ * vertex, edge and land: the ID of the terrain, i.e., the index in GameMap::getVertices(), getEdges() and getLands()
+ */
+enum class MapActionOpcode : uint8_t
+{
+    ROLL_DICE = 0,          // aux: -,                                          id: -
+    PLACE_SETTLEMENT,       // aux: 1: collect the resources next to it,        id: vertex      first two rounds, free
+    PLACE_ROAD,             // aux: -,                                          id: edge        first two rounds and road building, free
+    BUILD_ROAD,             // aux: -,                                          id: edge
+    BUILD_SETTLEMENT,       // aux: -,                                          id: vertex
+    BUILD_CITY,             // aux: -,                                          id: vertex
+    BUY_DEV_CARD,           // aux: -,                                          id: -
+    MOVE_ROBBER,            // aux: player to rob, NO_PLAYER: none,             id: land
+    PLAY_KNIGHT,            // as MOVE_ROBBER
+    PLAY_ROAD_BUILDING,     // aux: -,                                          id: -           the two roads are PLACE_ROAD
+    PLAY_YEAR_OF_PLENTY,    // aux: ResourceTypes | ResourceTypes << 4,         id: -
+    PLAY_MONOPOLY,          // aux: ResourceTypes,                              id: -
+    END_TURN,               // aux: -,                                          id: -
+
+    /* end of MapActionOpcode */
+    OPCODE_END,
+};
+constexpr size_t MAP_ACTION_OPCODE_SIZE = static_cast<size_t>(MapActionOpcode::OPCODE_END);
+
+struct MapAction_t
+{
+    MapActionOpcode opcode;
+    uint8_t aux;
+    uint16_t id;
+};
+
+/**
+ * rc: 0: ok, INCORRECT_ACTION: unknown opcode, ID out of range or incorrect aux, nothing is applied,
+ *     otherwise the rc of the GameMap API that failed
+ * value and amount, by opcode:
+ *   ROLL_DICE: value: the dice
+ *   PLACE_SETTLEMENT: amount: num of resources collected
+ *   BUY_DEV_CARD: value: DevelopmentCardTypes bought
+ *   MOVE_ROBBER, PLAY_KNIGHT: value: ResourceTypes robbed, NO_RESOURCE if nobody was robbed or the player had none
+ *   PLAY_MONOPOLY: amount: num of resources got
+ *   END_TURN: value: the new current player
+ */
+struct MapActionResult_t
+{
+    uint8_t rc;
+    uint8_t value;
+    uint16_t amount;
+};
+
+struct MapActionStats_t
+{
+    uint64_t count;
+    uint64_t totalNs;
+    uint64_t minNs;
+    uint64_t maxNs;
+};
+
+/**
+ * @brief
+ * MapActionExecutor applies MapAction_t to a GameMap with the same APIs as the command handlers, e.g.,
+ * GameMap::buildRoad() for BUILD_ROAD, GameMap::buildColony() without the edge check and free of charge
+ * for PLACE_SETTLEMENT, i.e., the actions are journaled and streamed as any other
+ * like GameMap, it does not check the phase of the turn, e.g., that the dice are rolled before building,
+ * this is left to the caller, see GameRules
+ *
+ * Wire format (little endian, whatever the host):
+ *   an action is 4 bytes, [opcode: u8] [aux: u8] [id: u16]
+ *   a result is 4 bytes,  [rc: u8] [value: u8] [amount: u16]
+ *
+ * the wall time of every action is measured with std::chrono::steady_clock and kept per opcode, in nanoseconds
+ * one executor per thread, it may serve any number of maps
+ */
+class MapActionExecutor
+{
+private:
+    std::array<MapActionStats_t, MAP_ACTION_OPCODE_SIZE> mStats;
+
+    MapActionResult_t dispatch(GameMap& aMap, const MapAction_t& aAction) const;
+    /** move the robber to the land aId, then rob the vertex of aVictim next to it */
+    MapActionResult_t robLand(GameMap& aMap, const uint16_t aId, const uint8_t aVictim, const bool aPlayKnight) const;
+
+public:
+    static constexpr size_t ACTION_SIZE = 4U;
+    static constexpr size_t RESULT_SIZE = 4U;
+    static constexpr uint8_t INCORRECT_ACTION = 0xFFU;
+    static constexpr uint8_t NO_RESOURCE = 0xFFU;
+
+    MapActionExecutor();
+
+    MapActionResult_t execute(GameMap& aMap, const MapAction_t& aAction);
+    /**
+     * execute the whole actions of aActions in order, and append their results to aResults,
+     * the actions after a failed one are not executed, i.e., a batch may rely on the success of its previous actions
+     * @return num of actions executed, the failed one included
+     */
+    size_t executeWire(GameMap& aMap, const std::vector<uint8_t>& aActions, std::vector<uint8_t>& aResults);
+
+    static void encode(const MapAction_t& aAction, std::vector<uint8_t>& aBytes);
+    static void encode(const MapActionResult_t& aResult, std::vector<uint8_t>& aBytes);
+    /** @param aBytes at least ACTION_SIZE or RESULT_SIZE bytes */
+    static MapAction_t decodeAction(const uint8_t* const aBytes);
+    static MapActionResult_t decodeResult(const uint8_t* const aBytes);
+
+    /** count 0 if the opcode has never been executed */
+    const MapActionStats_t& getStats(const MapActionOpcode aOpcode) const;
+    void resetStats();
+};
+
+#endif /* INCLUDE_MAP_ACTION_HPP */
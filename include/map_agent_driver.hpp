@@ -0,0 +1,63 @@
+/**
+ * Project: catan
+ * @file map_agent_driver.hpp
+ * @brief seat an Agent on a GameMap, e.g., to let an agent play a turn in the interactive game
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_MAP_AGENT_DRIVER_HPP
+#define INCLUDE_MAP_AGENT_DRIVER_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "agent.hpp"
+#include "expectimax_search.hpp"
+#include "game_rules.hpp"
+#include "random_engine.hpp"
+
+class GameMap;
+
+/**
+ * @brief
+ * the agent sees the map through GameMap::exportGameState() and the legal actions from GameRules,
+ * the action chosen is applied with the public (journaled) APIs of GameMap, i.e., rollDice(), buildRoad(), etc.
+ * bank trades are not offered to the agent, GameMap has no API for them
+ */
+class MapAgentDriver
+{
+private:
+    GameRules mRules;
+    RandomEngine mEngine;   // for the decisions of the agent only, dice etc. are drawn by GameMap
+    std::vector<GameAction_t> mActions;
+
+    /** @return 0: ok, otherwise the rc of the GameMap API */
+    int applyToMap(GameMap& aMap, const GameAction_t& aAction, GameState_t& aState, std::vector<std::string>& aReturnMsg);
+    int robLand(GameMap& aMap, const GameAction_t& aAction, std::vector<std::string>& aReturnMsg);
+
+public:
+    /**
+     * @param aTopology the topology of the map to drive, see BoardTopology::init()
+     * @param aSeed seed of the decisions of the agent
+     */
+    MapAgentDriver(std::shared_ptr<const BoardTopology> aTopology, const uint64_t aSeed);
+
+    /**
+     * let aAgent play the whole turn of the current player of aMap, from rolling the dice to passing to the next player
+     * aMap must be past the first two rounds
+     * @param aReturnMsg a line per action taken
+     * @return 0: ok, 1: failed to export the state of aMap, 2: failed to apply an action to aMap, the turn is left unfinished
+     */
+    int playTurn(GameMap& aMap, Agent& aAgent, std::vector<std::string>& aReturnMsg);
+
+    /**
+     * let aSearch play the whole turn of the current player of aMap, aSearch decides on aMap itself
+     * @return 0: ok, 1: aSearch does not support aMap, 2: failed to apply an action to aMap
+     */
+    int playTurn(GameMap& aMap, ExpectimaxSearch& aSearch, std::vector<std::string>& aReturnMsg);
+};
+
+#endif /* INCLUDE_MAP_AGENT_DRIVER_HPP */
@@ -14,7 +14,8 @@
 #include <string>
 #include <fstream>
 #include <deque>
-#include "game_map.hpp"
+#include <memory>
+#include "board_layout.hpp"
 
 class MapIO
 {
@@ -25,8 +26,13 @@ private:
     static std::deque<std::string> getDefaultMap();
 public:
     MapIO(std::string aFilename);
-    int readMap(GameMap& aGameMap);
-    int saveMap(GameMap* const aGameMap);
+    int readMap(BoardLayout& aLayout);
+    /**
+     * read the map and initialize its layout (BoardLayout::initLayout()),
+     * @return the layout to share by every game on this map, nullptr if the map is incorrect
+     */
+    std::shared_ptr<const BoardLayout> readLayout();
+    int saveMap(const BoardLayout& aLayout);
     ~MapIO();
 };
 
@@ -0,0 +1,67 @@
+/**
+ * Project: catan
+ * @file mcts_agent.hpp
+ * @brief Monte Carlo Tree Search agent, root and tree parallel
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_MCTS_AGENT_HPP
+#define INCLUDE_MCTS_AGENT_HPP
+
+#include <memory>
+#include <vector>
+#include "agent.hpp"
+
+class MctsTree; // defined in mcts_agent.cpp
+
+struct MctsConfig_t
+{
+    size_t iterations;      // num of iterations per tree, 0: unlimited (timeLimitMs must be set)
+    size_t timeLimitMs;     // wall clock budget per decision, 0: unlimited (iterations must be set)
+    size_t numTrees;        // root parallelization, independent trees whose root statistics are summed
+    size_t threadsPerTree;  // tree parallelization, threads sharing one tree, spread by virtual loss
+    double exploration;     // UCT exploration constant
+    size_t rolloutDepth;    // max num of actions of a rollout, the rollout is then scored by victory points
+    size_t arenaSize;       // num of nodes of the arena of each tree, the tree stops growing when it is full
+};
+
+/**
+ * @brief
+ * UCT over GameRules, every player maximizes its own reward (max^n)
+ *
+ * chance nodes: the child of an action whose outcome is random (see GameRules::isChanceAction()) is a chance node,
+ * its children are the outcomes met so far, keyed by the hash of the resulting state,
+ * i.e., outcomes are sampled with their natural probability (dice, development card, card robbed)
+ * and outcomes leading to the same state (e.g., dice producing nothing) share a node
+ * the order of the development card deck is not known to the player, every iteration reshuffles it (determinization)
+ * and it is left out of the hash
+ *
+ * parallelization: numTrees * threadsPerTree threads, the calling thread is one of them,
+ * threads sharing a tree add a virtual loss to the nodes on their path so that they spread over the tree
+ *
+ * memory: the nodes of a tree are taken from an arena allocated once by the agent and reset on each search,
+ * rollouts work on a copy of the state on the stack and on a pre-reserved action list, i.e., no heap allocation
+ *
+ * the result is deterministic given aEngine if and only if numTrees == threadsPerTree == 1 and timeLimitMs == 0
+ */
+class MctsAgent : public Agent
+{
+private:
+    const MctsConfig_t mConfig;
+    std::vector<std::unique_ptr<MctsTree> > mTrees;
+
+public:
+    static MctsConfig_t defaultConfig();
+
+    size_t chooseAction(const GameRules& aRules, const GameState_t& aState,
+                        const std::vector<GameAction_t>& aActions, RandomEngine& aEngine) override;
+    std::string getName() const override;
+
+    MctsAgent(const MctsConfig_t& aConfig = defaultConfig());
+    ~MctsAgent();
+};
+
+#endif /* INCLUDE_MCTS_AGENT_HPP */
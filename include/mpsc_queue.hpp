@@ -0,0 +1,95 @@
+/**
+ * Project: catan
+ * @file mpsc_queue.hpp
+ * @brief unbounded lock-free multi-producer single-consumer queue
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_MPSC_QUEUE_HPP
+#define INCLUDE_MPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief
+ * a linked list of nodes, producers swap themselves in at the head with a single atomic exchange
+ * and the consumer walks from the tail, i.e., push() never waits on another producer nor on the consumer
+ *
+ * the tail is always a node whose value is already consumed (the stub), the consumer frees it once it moves past
+ * a push() in progress between its exchange and its link is not visible to pop() yet,
+ * empty() sees it, i.e., empty() returns false while pop() may still return false for a moment
+ *
+ * any thread may push(), only one thread may pop() and empty()
+ */
+template<typename T>
+class MpscQueue
+{
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64U;
+
+    struct Node_t
+    {
+        std::atomic<Node_t*> next;
+        T value;
+    };
+
+    // producers and the consumer work on different cache lines
+    std::atomic<Node_t*> mHead;
+    char mHeadPadding[CACHE_LINE_SIZE - sizeof(std::atomic<Node_t*>)];
+    Node_t* mTail;
+
+public:
+    MpscQueue() :
+        mHead(new Node_t{{nullptr}, T()})
+    {
+        mTail = mHead.load(std::memory_order_relaxed);
+    }
+
+    ~MpscQueue()
+    {
+        while (mTail != nullptr)
+        {
+            Node_t* const pNext = mTail->next.load(std::memory_order_relaxed);
+            delete mTail;
+            mTail = pNext;
+        }
+    }
+
+    void push(T&& aValue)
+    {
+        Node_t* const pNode = new Node_t{{nullptr}, std::move(aValue)};
+        // sequentially consistent, a producer checking whether the consumer sleeps after push() relies on it
+        Node_t* const pPrev = mHead.exchange(pNode);
+        pPrev->next.store(pNode, std::memory_order_release);
+    }
+
+    /** consumer only, @return false if nothing is ready */
+    bool pop(T& aValue)
+    {
+        Node_t* const pNext = mTail->next.load(std::memory_order_acquire);
+        if (pNext == nullptr)
+        {
+            return false;
+        }
+        aValue = std::move(pNext->value);
+        delete mTail;
+        mTail = pNext;
+        return true;
+    }
+
+    /** consumer only, sequentially consistent with push(), see the class comment */
+    bool empty() const
+    {
+        return mHead.load() == mTail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+};
+
+#endif /* INCLUDE_MPSC_QUEUE_HPP */
@@ -0,0 +1,106 @@
+/**
+ * Project: catan
+ * @file opening_optimiser.hpp
+ * @brief best settlements of the first two rounds, pairs of vertices scored by pips, diversity and harbours,
+ *        searched against the responses of the opponents placing in between
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_OPENING_OPTIMISER_HPP
+#define INCLUDE_OPENING_OPTIMISER_HPP
+
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "game_state.hpp"
+#include "board_topology.hpp"
+
+struct Opening_t
+{
+    uint8_t first;      // vertex ID of the settlement to place now
+    uint8_t second;     // vertex ID of the second settlement expected, NO_ID if the first one is on the board already
+    double score;       // value of the pair once the opponents in between have responded
+};
+
+/**
+ * @brief
+ * the value of a player's settlements is the sum of the pips of the lands next to them,
+ * plus a bonus per distinct resource produced and per harbour (a 2:1 harbour is worth the pips of its resource)
+ *
+ * the player to place a first settlement expects every opponent placing before its second settlement
+ * to take one of the opponent's own best vertices, the one that hurts the player most (paranoid, but only among
+ * the numResponses best vertices of that opponent), then takes the best vertex left for its second settlement
+ * only the first 5 opponent placements branch, the later ones take their best vertex, i.e., a 6-player first round
+ * costs 3 ^ 5 lines per first settlement instead of 3 ^ 10
+ * pruning:
+ *   - a first settlement is bounded by its best pair on the current board, opponents can only take vertices away,
+ *     candidates are searched best bound first and the search stops once no bound can enter the best openings
+ *   - the responses to a candidate are cut as soon as one line drops it out of the best openings found so far,
+ *     or once the opponents still to place cannot take away enough vertices to lower the best pair left
+ * the placements are made and unmade in place on a copy of the state, a search does not allocate once warmed up
+ * an OpeningOptimiser is not thread-safe
+ */
+class OpeningOptimiser
+{
+public:
+    static constexpr size_t DEFAULT_NUM_RESPONSES = 3U;
+
+private:
+    std::shared_ptr<const BoardTopology> mTopology;
+    const size_t mNumResponses;
+    GameState_t mState;
+    std::vector<uint8_t> mOrder;
+    uint8_t mPlayer;
+    size_t mNumNodes;
+
+    // scratch of a search
+    std::array<std::array<uint8_t, CONSUMABLE_RESOURCE_SIZE>, constant::MAX_NUM_VERTICES> mProduction;    // pips
+    std::vector<std::vector<uint8_t> > mResponses;          // per step of mOrder
+    std::vector<std::pair<double, uint8_t> > mCandidates;   // bound and vertex of the first settlements
+    std::vector<std::pair<double, uint8_t> > mSeconds;      // pairs of the first settlement searched, best first
+
+    bool isVertexFree(const size_t aVertexId) const;
+    /** aFirst and aSecond may be NO_ID */
+    double scorePair(const size_t aFirst, const size_t aSecond) const;
+    /** @return the settlement of aPlayerId on the board, NO_ID if none */
+    uint8_t findSettlement(const size_t aPlayerId) const;
+    /** fill mSeconds with every vertex free once aFirst is on the board */
+    void rankSeconds(const size_t aFirst);
+    /**
+     * @param aNumPlacements num of opponent placements still to come before the second settlement
+     * @param aSecond the best second settlement free on the board, NO_ID if none
+     * @return the best pair on the board, aLower the worst it can become after aNumPlacements,
+     *         a placement takes at most a vertex and its 3 neighbours away
+     */
+    double boundSecond(const size_t aFirst, const size_t aNumPlacements, double& aLower, uint8_t& aSecond) const;
+    /**
+     * min over the responses of the opponent of mOrder[aStep] up to the second settlement of mPlayer
+     * @return at most aAlpha once a line is found at or below aAlpha
+     */
+    double searchResponses(const size_t aStep, const size_t aFirst, const double aAlpha, uint8_t& aSecond);
+
+public:
+    /** @param aTopology must be initialized, see BoardTopology::init() */
+    OpeningOptimiser(std::shared_ptr<const BoardTopology> aTopology, const size_t aNumResponses = DEFAULT_NUM_RESPONSES);
+
+    /**
+     * @param aState the lands, robber and settlements placed so far
+     * @param aOrder the players of the placements still to make, aOrder[0] places now, snake order
+     * @param aNumBest num of openings to return at most
+     * @param aBest best openings for aOrder[0], best first
+     * @return 0: ok, 1: aOrder is empty or aOrder[0] has placed both settlements
+     */
+    int search(const GameState_t& aState, const std::vector<uint8_t>& aOrder, const size_t aNumBest, std::vector<Opening_t>& aBest);
+
+    /** num of placements evaluated by the last search() */
+    size_t getNumNodes() const;
+
+    /** the placements still to make in the setup of aState, see GameRules::getSetupPlayer() */
+    static void getSetupOrder(const GameState_t& aState, std::vector<uint8_t>& aOrder);
+};
+
+#endif /* INCLUDE_OPENING_OPTIMISER_HPP */
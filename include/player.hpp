@@ -33,15 +33,31 @@ private:
 public:
     void drawDevelopmentCard(DevelopmentCardTypes aCard, size_t aAmount = 1);
     int consumeDevelopmentCard(DevelopmentCardTypes aCard);
+    /** undo drawDevelopmentCard() / consumeDevelopmentCard(), @return 1 if there is no such card to undo */
+    int returnDevelopmentCard(DevelopmentCardTypes aCard);
+    int unconsumeDevelopmentCard(DevelopmentCardTypes aCard);
     void addResources(ResourceTypes aResource, size_t aAmount);
     bool consumeResources(ResourceTypes aResource, size_t aAmount);
     void addColony(const Vertex& aVertex);
     void addRoad(const Edge& aEdge);
+    void removeColony(const Vertex& aVertex);
+    void removeRoad(const Edge& aEdge);
     void setLargestArmy(const bool aLargestArmy);
     void setLongestRoad(const bool aLongestRoad);
     size_t getPlayerLongestRoadSize() const;
+    bool hasLargestArmy() const;
+    bool hasLongestRoad() const;
     int getId() const;
 
+    /**
+     * restore the player from a checkpoint,
+     * colonies and roads are cleared, they are to be re-added by GameMap according to the owners of vertices and edges
+     */
+    void restore(const std::array<size_t, CONSUMABLE_RESOURCE_SIZE>& aResources, \
+                 const std::array<size_t, DEVELOPMENT_CARD_TYPE_SIZE>& aDevCard, \
+                 const std::array<size_t, DEVELOPMENT_CARD_TYPE_SIZE>& aDevCardUsed, \
+                 const bool aLargestArmy, const bool aLongestRoad);
+
     const std::array<size_t, CONSUMABLE_RESOURCE_SIZE>& getResources() const;
     const std::array<size_t, DEVELOPMENT_CARD_TYPE_SIZE>& getDevCards() const;
     const std::array<size_t, DEVELOPMENT_CARD_TYPE_SIZE>& getUsedDevCards() const;
@@ -49,8 +65,9 @@ public:
     bool hasResources(ResourceTypes aResource, size_t aAmount) const;
     bool hasResources(const std::map<ResourceTypes, size_t>& aResourceConfig) const;
 
+    // aState: the board of the game of this player, where the colonies are
     // aPublic: to show to public? when set to true, exclude devCard(Victory Point Card)
-    size_t getVictoryPoint(bool aPublic) const;
+    size_t getVictoryPoint(const BoardState_t& aState, bool aPublic) const;
 
     Player(int aId);
 };
@@ -0,0 +1,395 @@
+/**
+ * Project: catan
+ * @file random_engine.hpp
+ * @brief random engines and bias-free sampling, one independent stream per random subsystem of the game
+ *        the engine used by the game is selected at compile time, see RandomEngine at the bottom
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_RANDOM_ENGINE_HPP
+#define INCLUDE_RANDOM_ENGINE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <iterator>
+#include <utility>
+
+/**
+ * every random subsystem draws from its own stream,
+ * e.g., an extra development card drawn does not shift the dice of the rest of the game
+ */
+enum class RandomStream : uint32_t
+{
+    BOARD = 0,      // resources, dice numbers and harbours of the map
+    DICE,
+    DEV_CARD,
+    ROB,
+    PLAYER_ORDER,
+};
+constexpr size_t RANDOM_STREAM_SIZE = static_cast<size_t>(RandomStream::PLAYER_ORDER) + 1U;
+
+/**
+ * @brief
+ * Philox4x32-10, Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3"
+ * block N of stream S under seed K is a pure function of (K, S, N), hence
+ *   - streams of the same seed are independent
+ *   - jumping ahead (discard()) is O(1)
+ * meets the requirements of UniformRandomBitGenerator, usable with <random> distributions and std::shuffle
+ */
+class Philox4x32
+{
+private:
+    static constexpr uint32_t MULTIPLIER_0 = 0xD2511F53U;
+    static constexpr uint32_t MULTIPLIER_1 = 0xCD9E8D57U;
+    static constexpr uint32_t WEYL_0 = 0x9E3779B9U;
+    static constexpr uint32_t WEYL_1 = 0xBB67AE85U;
+    static constexpr size_t ROUNDS = 10U;
+    static constexpr size_t WORDS_PER_BLOCK = 4U;
+
+    std::array<uint32_t, 2> mKey;
+    std::array<uint32_t, 4> mCounter;   // [0]: block low, [1]: block high, [2]: stream, [3]: always 0
+    std::array<uint32_t, 4> mOutput;
+    size_t mOutputIndex;                // next word to return in mOutput, WORDS_PER_BLOCK if used up
+
+    inline uint64_t getBlock() const
+    {
+        return (static_cast<uint64_t>(mCounter[1]) << 32U) | mCounter[0];
+    }
+
+    inline void setBlock(const uint64_t aBlock)
+    {
+        mCounter[0] = static_cast<uint32_t>(aBlock);
+        mCounter[1] = static_cast<uint32_t>(aBlock >> 32U);
+    }
+
+    // encrypt mCounter into mOutput, then advance to the next block
+    void generate()
+    {
+        std::array<uint32_t, 4> counter = mCounter;
+        std::array<uint32_t, 2> key = mKey;
+        for (size_t round = 0U; round < ROUNDS; ++round)
+        {
+            const uint64_t product0 = static_cast<uint64_t>(MULTIPLIER_0) * counter[0];
+            const uint64_t product1 = static_cast<uint64_t>(MULTIPLIER_1) * counter[2];
+            counter = {
+                static_cast<uint32_t>(product1 >> 32U) ^ counter[1] ^ key[0],
+                static_cast<uint32_t>(product1),
+                static_cast<uint32_t>(product0 >> 32U) ^ counter[3] ^ key[1],
+                static_cast<uint32_t>(product0)
+            };
+            key[0] += WEYL_0;
+            key[1] += WEYL_1;
+        }
+        mOutput = counter;
+        mOutputIndex = 0U;
+        setBlock(getBlock() + 1U);
+    }
+
+public:
+    using result_type = uint32_t;
+
+    static constexpr result_type min()
+    {
+        return 0U;
+    }
+
+    static constexpr result_type max()
+    {
+        return UINT32_MAX;
+    }
+
+    result_type operator()()
+    {
+        if (mOutputIndex == WORDS_PER_BLOCK)
+        {
+            generate();
+        }
+        return mOutput[mOutputIndex++];
+    }
+
+    /** restart at the beginning of stream aStream of aSeed */
+    void seed(const uint64_t aSeed, const uint32_t aStream = 0U)
+    {
+        mKey = {static_cast<uint32_t>(aSeed), static_cast<uint32_t>(aSeed >> 32U)};
+        mCounter = {0U, 0U, aStream, 0U};
+        mOutputIndex = WORDS_PER_BLOCK;
+    }
+
+    /** skip the next aNumDraws numbers in O(1) */
+    void discard(uint64_t aNumDraws)
+    {
+        const uint64_t buffered = WORDS_PER_BLOCK - mOutputIndex;
+        if (aNumDraws <= buffered)
+        {
+            mOutputIndex += aNumDraws;
+            return;
+        }
+        aNumDraws -= buffered;
+        // the block at getBlock() is the next one to generate
+        setBlock(getBlock() + aNumDraws / WORDS_PER_BLOCK);
+        mOutputIndex = WORDS_PER_BLOCK;
+        if (aNumDraws % WORDS_PER_BLOCK != 0U)
+        {
+            generate();
+            mOutputIndex = aNumDraws % WORDS_PER_BLOCK;
+        }
+    }
+
+    Philox4x32(const uint64_t aSeed = 0U, const uint32_t aStream = 0U) :
+        mKey(),
+        mCounter(),
+        mOutput(),
+        mOutputIndex(WORDS_PER_BLOCK)
+    {
+        seed(aSeed, aStream);
+    }
+};
+
+/**
+ * @brief
+ * xoshiro256**, Blackman & Vigna, "Scrambled Linear Pseudorandom Number Generators"
+ * the fastest of the three, stream N starts 2^128 * N draws into the sequence of the seed (jump()),
+ * so streams never overlap; discard() is O(n)
+ */
+class Xoshiro256StarStar
+{
+private:
+    std::array<uint64_t, 4> mState;
+
+    static inline uint64_t rotl(const uint64_t aValue, const int aShift)
+    {
+        return (aValue << aShift) | (aValue >> (64 - aShift));
+    }
+
+    // seed expansion recommended by the authors
+    static inline uint64_t splitMix64(uint64_t& aState)
+    {
+        uint64_t value = (aState += 0x9E3779B97F4A7C15ULL);
+        value = (value ^ (value >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27U)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31U);
+    }
+
+public:
+    using result_type = uint64_t;
+
+    static constexpr result_type min()
+    {
+        return 0U;
+    }
+
+    static constexpr result_type max()
+    {
+        return UINT64_MAX;
+    }
+
+    result_type operator()()
+    {
+        const uint64_t result = rotl(mState[1] * 5U, 7) * 9U;
+        const uint64_t temp = mState[1] << 17U;
+        mState[2] ^= mState[0];
+        mState[3] ^= mState[1];
+        mState[1] ^= mState[2];
+        mState[0] ^= mState[3];
+        mState[2] ^= temp;
+        mState[3] = rotl(mState[3], 45);
+        return result;
+    }
+
+    /** equivalent to 2^128 calls to operator() */
+    void jump()
+    {
+        static constexpr std::array<uint64_t, 4> JUMP = {
+            0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+        };
+        std::array<uint64_t, 4> state = {0U, 0U, 0U, 0U};
+        for (const uint64_t jump : JUMP)
+        {
+            for (int bit = 0; bit < 64; ++bit)
+            {
+                if (jump & (1ULL << bit))
+                {
+                    for (size_t ii = 0U; ii < state.size(); ++ii)
+                    {
+                        state[ii] ^= mState[ii];
+                    }
+                }
+                operator()();
+            }
+        }
+        mState = state;
+    }
+
+    void seed(const uint64_t aSeed, const uint32_t aStream = 0U)
+    {
+        uint64_t splitMixState = aSeed;
+        for (uint64_t& state : mState)
+        {
+            state = splitMix64(splitMixState);
+        }
+        for (uint32_t stream = 0U; stream < aStream; ++stream)
+        {
+            jump();
+        }
+    }
+
+    void discard(uint64_t aNumDraws)
+    {
+        while (aNumDraws-- > 0U)
+        {
+            operator()();
+        }
+    }
+
+    Xoshiro256StarStar(const uint64_t aSeed = 0U, const uint32_t aStream = 0U) :
+        mState()
+    {
+        seed(aSeed, aStream);
+    }
+};
+
+/**
+ * @brief
+ * PCG32 (XSH-RR 64/32), O'Neill, "PCG: A Family of Simple Fast Space-Efficient Statistically Good Algorithms"
+ * streams are native (an odd increment per stream), discard() is O(log n)
+ */
+class Pcg32
+{
+private:
+    static constexpr uint64_t MULTIPLIER = 6364136223846793005ULL;
+
+    uint64_t mState;
+    uint64_t mIncrement;    // always odd
+
+    inline void step()
+    {
+        mState = mState * MULTIPLIER + mIncrement;
+    }
+
+public:
+    using result_type = uint32_t;
+
+    static constexpr result_type min()
+    {
+        return 0U;
+    }
+
+    static constexpr result_type max()
+    {
+        return UINT32_MAX;
+    }
+
+    result_type operator()()
+    {
+        const uint64_t state = mState;
+        step();
+        const uint32_t xorShifted = static_cast<uint32_t>(((state >> 18U) ^ state) >> 27U);
+        const uint32_t rotation = static_cast<uint32_t>(state >> 59U);
+        return (xorShifted >> rotation) | (xorShifted << ((0U - rotation) & 31U));
+    }
+
+    void seed(const uint64_t aSeed, const uint32_t aStream = 0U)
+    {
+        mState = 0U;
+        mIncrement = (static_cast<uint64_t>(aStream) << 1U) | 1U;
+        step();
+        mState += aSeed;
+        step();
+    }
+
+    /** Brown, "Random Number Generation with Arbitrary Strides" */
+    void discard(uint64_t aNumDraws)
+    {
+        uint64_t accMultiplier = 1U;
+        uint64_t accIncrement = 0U;
+        uint64_t multiplier = MULTIPLIER;
+        uint64_t increment = mIncrement;
+        while (aNumDraws > 0U)
+        {
+            if (aNumDraws & 1U)
+            {
+                accMultiplier *= multiplier;
+                accIncrement = accIncrement * multiplier + increment;
+            }
+            increment = (multiplier + 1U) * increment;
+            multiplier *= multiplier;
+            aNumDraws >>= 1U;
+        }
+        mState = accMultiplier * mState + accIncrement;
+    }
+
+    Pcg32(const uint64_t aSeed = 0U, const uint32_t aStream = 0U) :
+        mState(0U),
+        mIncrement(1U)
+    {
+        seed(aSeed, aStream);
+    }
+};
+
+// use `RANDOM_ENGINE=PHILOX|PCG|XOSHIRO make` to select the engine of the game, xoshiro256** by default
+#if defined(RANDOM_ENGINE_PHILOX)
+using RandomEngine = Philox4x32;
+#elif defined(RANDOM_ENGINE_PCG)
+using RandomEngine = Pcg32;
+#else
+using RandomEngine = Xoshiro256StarStar;
+#endif
+
+/**
+ * the high 32 bits of a draw, the high bits are the better ones of every engine above
+ */
+template<typename Engine>
+inline uint32_t nextUint32(Engine& aEngine)
+{
+    constexpr int SHIFT = 8 * sizeof(typename Engine::result_type) - 32;
+    return static_cast<uint32_t>(aEngine() >> SHIFT);
+}
+
+/**
+ * uniform integer in [0, aRange), aRange > 0, without modulo bias
+ * Lemire, "Fast Random Integer Generation in an Interval", no division in the common case
+ */
+template<typename Engine>
+inline uint32_t uniformBelow(Engine& aEngine, const uint32_t aRange)
+{
+    uint64_t product = static_cast<uint64_t>(nextUint32(aEngine)) * aRange;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < aRange)
+    {
+        const uint32_t threshold = (0U - aRange) % aRange;
+        while (low < threshold)
+        {
+            product = static_cast<uint64_t>(nextUint32(aEngine)) * aRange;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return static_cast<uint32_t>(product >> 32U);
+}
+
+/** uniform integer in [aMin, aMax] */
+template<typename Engine>
+inline int uniformInt(Engine& aEngine, const int aMin, const int aMax)
+{
+    return aMin + static_cast<int>(uniformBelow(aEngine, static_cast<uint32_t>(aMax - aMin) + 1U));
+}
+
+/**
+ * Fisher-Yates shuffle using uniformBelow(),
+ * unlike std::shuffle, the result is the same on every standard library
+ */
+template<typename RandomIt, typename Engine>
+void randomShuffle(RandomIt aFirst, RandomIt aLast, Engine& aEngine)
+{
+    const auto size = std::distance(aFirst, aLast);
+    for (auto index = size - 1; index > 0; --index)
+    {
+        using std::swap;
+        swap(aFirst[index], aFirst[uniformBelow(aEngine, static_cast<uint32_t>(index) + 1U)]);
+    }
+}
+
+#endif /* INCLUDE_RANDOM_ENGINE_HPP */
@@ -13,29 +13,83 @@
 #ifndef INCLUDE_SEQUENCE_CONFIG_HPP
 #define INCLUDE_SEQUENCE_CONFIG_HPP
 
-#include <vector>
 #include <array>
+#include <algorithm>
 #include "common.hpp"
+#include "random_engine.hpp"
 
 /* SequenceConfig_t is an array whose value represents the num of occurrences of the index in the output
  * e.g., aConfig[BRICK] = 2 means, there should be 2 BRICK in the returned vector
+ * the storage is fixed, randomizing a sequence does not allocate
  */
 
 struct SequenceConfig_t
 {
-    std::vector<size_t> mConfig;
+    static constexpr size_t MAX_SIZE = 16U;  // max num of distinct values, dice 0 to 12 is the largest in use
+    std::array<size_t, MAX_SIZE> mConfig;
+    size_t mSize;
+
     SequenceConfig_t(const size_t aSize);
-    SequenceConfig_t(const std::vector<size_t>& aVec);
     template<size_t N>
     SequenceConfig_t(const std::array<size_t, N>& aArray) :
-        mConfig(aArray.begin(), aArray.end())
+        mConfig({0}),
+        mSize(N)
     {
-        //empty
+        static_assert(N <= MAX_SIZE, "SequenceConfig_t supports up to MAX_SIZE values");
+        std::copy(aArray.begin(), aArray.end(), mConfig.begin());
     };
     size_t size() const;
     size_t& operator[](const size_t aIndex);
     size_t& operator[](const ResourceTypes aIndex);
     size_t sum() const;
+
+    /**
+     * draw one value without replacement, i.e., the count of the drawn value is decremented
+     * each remaining item is equally likely, picked by its position in the cumulative counts
+     * @return the value (index) drawn, -1 if there is nothing left
+     */
+    template<typename Engine>
+    int draw(Engine& aEngine)
+    {
+        const size_t total = sum();
+        if (total == 0U)
+        {
+            return -1;
+        }
+        size_t pick = uniformBelow(aEngine, total);
+        for (size_t index = 0U; index < mSize; ++index)
+        {
+            if (pick < mConfig[index])
+            {
+                --mConfig[index];
+                return index;
+            }
+            pick -= mConfig[index];
+        }
+        return -1;
+    }
+
+    /**
+     * write a random permutation of the sequence into aSequence, the config itself is not modified
+     * if aCapacity is smaller than sum(), aSequence gets the first aCapacity values of the permutation
+     * @return num of values written
+     */
+    template<typename Engine>
+    size_t shuffle(Engine& aEngine, int* const aSequence, const size_t aCapacity) const
+    {
+        SequenceConfig_t remaining = *this;
+        size_t count = 0U;
+        while (count < aCapacity)
+        {
+            const int value = remaining.draw(aEngine);
+            if (value == -1)
+            {
+                break;
+            }
+            aSequence[count++] = value;
+        }
+        return count;
+    }
 };
 
 #endif /* INCLUDE_SEQUENCE_CONFIG_HPP */
@@ -13,10 +13,9 @@
 
 #include <vector>
 #include "common.hpp"
-#include "curses.h"
-#include "user_interface.hpp"
+#include "board_state.hpp"
 
-class GameMap;
+class BoardLayout;
 
 class Terrain
 {
@@ -33,15 +32,20 @@ public:
 
     void setColor(ColorPairIndex aColorIndex);
 
-    // Register all points of current terrain to map
-    void registerToMap(GameMap& aMap);
+    // Register all points of current terrain to the layout
+    void registerToMap(BoardLayout& aLayout);
 
     virtual std::vector<Point_t> getAllPoints() const;
 
-    virtual int populateAdjacencies(GameMap& aMap);
+    virtual int populateAdjacencies(BoardLayout& aLayout);
 
-    virtual char getCharRepresentation(const size_t aPointX, const size_t aPointY, const bool aUseId = false) const = 0;
-    chtype getColorCharRepresentation(const size_t aPointX, const size_t aPointY, const bool aUseId = false) const;
+    /**
+     * a terrain belongs to the layout shared by many games,
+     * what it looks like in one game depends on aState, the state of that game
+     */
+    virtual char getCharRepresentation(const size_t aPointX, const size_t aPointY, const BoardState_t& aState, \
+                                       const bool aUseId = false) const = 0;
+    virtual ColorPairIndex getColorIndex(const BoardState_t& aState) const;
     virtual std::string getStringId() const = 0;
 
     virtual ~Terrain();
@@ -0,0 +1,89 @@
+/**
+ * Project: catan
+ * @file timer_wheel.hpp
+ * @brief hierarchical timing wheel, schedules and cancels deadlines in O(1) for many games on one thread
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_TIMER_WHEEL_HPP
+#define INCLUDE_TIMER_WHEEL_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief
+ * NUM_LEVELS wheels of NUM_SLOTS slots, a slot of level L spans NUM_SLOTS^L ticks,
+ * i.e., 4 levels of 64 slots cover 2^24 ticks, 4.6 hours of 1 ms ticks; a deadline further away waits in the last slot
+ * and is placed again when that slot is reached
+ *
+ * a timer is a node of a doubly linked list, the list of its slot, the nodes live in a vector and are reused
+ * through a free list, i.e., schedule() and cancel() neither search nor allocate once the vector has grown
+ * advance() moves the timers of a slot of level L down to the lower levels when the clock reaches that slot,
+ * each timer is moved at most NUM_LEVELS - 1 times in its life
+ *
+ * a Handle_t is the index of the node and the generation of the node, cancel() of an expired or cancelled timer
+ * is a no-op, even though its node is used by another timer by then
+ *
+ * not thread-safe, meant to be owned by a single thread, e.g., one per worker of GameHost
+ */
+class TimerWheel
+{
+public:
+    using Handle_t = uint64_t;
+    static constexpr Handle_t INVALID_HANDLE = UINT64_MAX;
+
+private:
+    static constexpr size_t SLOT_BITS = 6U;
+    static constexpr size_t NUM_SLOTS = 1U << SLOT_BITS;
+    static constexpr size_t NUM_LEVELS = 4U;
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Timer_t
+    {
+        uint64_t deadline;
+        uint64_t payload;
+        uint32_t prev;
+        uint32_t next;      // also the link of the free list
+        uint32_t generation;
+        uint32_t slot;      // level * NUM_SLOTS + slot, NIL if not scheduled
+    };
+
+    std::vector<Timer_t> mTimers;
+    uint32_t mFreeList;
+    std::array<uint32_t, NUM_LEVELS * NUM_SLOTS> mSlots;   // head of the list of each slot
+    std::array<uint64_t, NUM_LEVELS> mOccupied;            // bit N: slot N of the level is not empty
+    uint64_t mNow;
+    size_t mSize;
+
+    void link(const uint32_t aIndex);
+    void unlink(const uint32_t aIndex);
+    /** the tick at which the first non-empty slot is reached, UINT64_MAX if no timer */
+    uint64_t nextEvent() const;
+
+public:
+    explicit TimerWheel(const uint64_t aNow = 0U);
+
+    /** @return the handle of a timer expiring at aDeadline, a deadline not after the current tick expires on the next one */
+    Handle_t schedule(const uint64_t aDeadline, const uint64_t aPayload);
+    /** @return false if the timer has already expired or been cancelled */
+    bool cancel(const Handle_t aHandle);
+
+    /**
+     * move the clock to aNow, the payloads of the timers expired on the way are appended to aExpired,
+     * in the order of their deadlines
+     */
+    void advance(const uint64_t aNow, std::vector<uint64_t>& aExpired);
+
+    /** no timer expires before this tick, UINT64_MAX if no timer, i.e., how long the owner may sleep */
+    uint64_t getNextDeadline() const;
+    uint64_t getNow() const;
+    size_t size() const;
+};
+
+#endif /* INCLUDE_TIMER_WHEEL_HPP */
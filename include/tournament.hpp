@@ -0,0 +1,83 @@
+/**
+ * Project: catan
+ * @file tournament.hpp
+ * @brief round-robin tournament of two-player headless games between agents, rated by Elo and TrueSkill
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_TOURNAMENT_HPP
+#define INCLUDE_TOURNAMENT_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "game_rules.hpp"
+#include "agent.hpp"
+#include "work_stealing_pool.hpp"
+
+struct TournamentRating_t
+{
+    size_t numGames;
+    size_t numWins;
+    size_t numDraws;        // no winner in constant::MAX_TURNS turns
+    double elo;
+    double mu;              // TrueSkill
+    double sigma;
+};
+
+/**
+ * @brief
+ * every pair of agents plays the same num of games, the seats alternate from one game to the next
+ * game N of the tournament is seeded with aSeed + N and every decision draws from the engine of its game,
+ * the results are stored per game and rated in the order of the games once all are played,
+ * i.e., the ratings depend on the seed only, not on the num of threads nor on which thread played which game
+ *
+ * Elo: K = ELO_K, 0.5 for a draw
+ * TrueSkill: two-player update without draw margin, draws are not rated
+ */
+class Tournament
+{
+private:
+    struct GameResult_t
+    {
+        uint8_t winner;     // index of the winning agent, NO_PLAYER for a draw
+        uint16_t turns;
+    };
+
+    const GameRules& mRules;
+    const std::vector<std::string> mAgentNames;
+    std::vector<std::pair<size_t, size_t> > mPairs;     // agent indices, first < second
+    std::vector<GameResult_t> mResults;                 // indexed by game
+    std::vector<TournamentRating_t> mRatings;
+    std::vector<std::vector<size_t> > mWins;            // [winner][loser]
+    size_t mNumTurns;
+
+    void playGame(const size_t aGameIndex, const uint64_t aSeed, const size_t aGamesPerPair,
+                  std::vector<std::unique_ptr<Agent> >& aAgents, std::vector<GameAction_t>& aActions);
+    void rate(const size_t aGamesPerPair);
+
+public:
+    static constexpr double ELO_INITIAL = 1500.0;
+    static constexpr double ELO_K = 16.0;
+
+    /** @param aAgentNames at least 2, each a name known to Agent::create() */
+    Tournament(const GameRules& aRules, const std::vector<std::string>& aAgentNames);
+
+    /**
+     * play aGamesPerPair games for every pair of agents on aPool, then rate the agents
+     * @return 0: ok, 1: an agent name is unknown
+     */
+    int run(const size_t aGamesPerPair, const uint64_t aSeed, WorkStealingPool& aPool);
+
+    size_t getNumGames() const;
+    size_t getNumTurns() const;
+    /** indexed like the agent names */
+    const std::vector<TournamentRating_t>& getRatings() const;
+    /** num of games agent aWinner won against agent aLoser */
+    size_t getNumWins(const size_t aWinner, const size_t aLoser) const;
+};
+
+#endif /* INCLUDE_TOURNAMENT_HPP */
@@ -23,37 +23,38 @@ class Vertex : public Terrain
 private:
     bool mIsCoastal;
     Harbour* mHarbour;
-    int mOwner;
-    ColonyType mColony;
 
     std::set<const Vertex*> mAdjacentVertices;
     std::set<const Edge*> mAdjacentEdges;
 
-    int addAdjacency(GameMap& aMap, const size_t aPointX, const size_t aPointY);
+    int addAdjacency(BoardLayout& aLayout, const size_t aPointX, const size_t aPointY);
 public:
     const std::set<const Vertex*>& getAdjacentVertices() const;
+    const std::set<const Edge*>& getAdjacentEdges() const;
     std::set<const Edge*> getOtherEdges(const Edge& aEdge) const; //get connected edges that is not the input
 
-    int setOwner(int aPlayerId, ColonyType aColony);
-    int getOwner() const;
+    int getOwner(const BoardState_t& aState) const;
 
     /**
      * @return true if none of the adjacent vertex is occupied
      */
-    bool isAvailable() const;
+    bool isAvailable(const BoardState_t& aState) const;
 
     /**
      * @param aPlayerId the player who is about to buildColony on this vertex
      * @return true if at least one of the edge is owned by this player
      */
-    bool isConnected(const int aPlayerId) const;
+    bool isConnected(const BoardState_t& aState, const int aPlayerId) const;
 
-    ColonyType getColonyType() const;
+    ColonyType getColonyType(const BoardState_t& aState) const;
     bool isCoastal() const;
     bool hasHarbour() const;
+    const Harbour* getHarbour() const;
     int setHarbour(Harbour* const aHarbour);
-    int populateAdjacencies(GameMap& aMap) override;
-    char getCharRepresentation(const size_t aPointX, const size_t aPointY, const bool aUseId = false) const override;
+    int populateAdjacencies(BoardLayout& aLayout) override;
+    char getCharRepresentation(const size_t aPointX, const size_t aPointY, const BoardState_t& aState, \
+                               const bool aUseId = false) const override;
+    ColorPairIndex getColorIndex(const BoardState_t& aState) const override;
     std::string getStringId() const override;
     Vertex(const int aId, const Point_t aTopLeft);
     virtual ~Vertex();
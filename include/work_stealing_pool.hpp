@@ -0,0 +1,79 @@
+/**
+ * Project: catan
+ * @file work_stealing_pool.hpp
+ * @brief fixed-size thread pool, every worker has its own deque of tasks and steals from the others when it runs dry
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#ifndef INCLUDE_WORK_STEALING_POOL_HPP
+#define INCLUDE_WORK_STEALING_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief
+ * run() spreads the task indices [0, aNumTasks) over the deques of the workers in contiguous blocks,
+ * a worker pops from the back of its own deque and, once it is empty, steals from the front of the others,
+ * i.e., uneven tasks (e.g., games of very different lengths) keep every worker busy until the very end
+ *
+ * the calling thread of run() is worker 0, the pool starts getNumWorkers() - 1 threads
+ * which task runs on which worker depends on the timing, the tasks must not depend on it for their results
+ */
+class WorkStealingPool
+{
+public:
+    using Task_t = std::function<void(const size_t aTask, const size_t aWorker)>;
+
+private:
+    struct WorkerQueue_t
+    {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue_t> > mQueues;
+    std::vector<std::thread> mThreads;
+
+    // a run, protected by mMutex
+    std::mutex mMutex;
+    std::condition_variable mStartCondition;
+    std::condition_variable mDoneCondition;
+    const Task_t* mTask;
+    size_t mGeneration;     // incremented by every run, wakes up the workers
+    size_t mNumBusy;        // num of threads (other than the caller) still working on the current run
+    bool mIsStopping;
+
+    std::atomic<size_t> mNumSteals;
+
+    bool popOwn(const size_t aWorker, size_t& aTask);
+    bool steal(const size_t aWorker, size_t& aTask);
+    void drain(const size_t aWorker);
+    void workerLoop(const size_t aWorker);
+
+public:
+    /** @param aNumWorkers num of workers including the calling thread, 0: one per core */
+    WorkStealingPool(const size_t aNumWorkers);
+    ~WorkStealingPool();
+
+    /** run aTask for every task index in [0, aNumTasks), return when all are done */
+    void run(const size_t aNumTasks, const Task_t& aTask);
+
+    size_t getNumWorkers() const;
+    /** num of tasks taken from the deque of another worker, since construction */
+    size_t getNumSteals() const;
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+};
+
+#endif /* INCLUDE_WORK_STEALING_POOL_HPP */
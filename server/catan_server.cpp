@@ -0,0 +1,102 @@
+/**
+ * Project: catan
+ * @file catan_server.cpp
+ * @brief catan_server.exe entry point, hosts many games over a Unix-domain and / or a loopback TCP socket
+ *        until SIGINT or SIGTERM
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include <csignal>
+#include <iostream>
+#include <pthread.h>
+#include "cli_opt.hpp"
+#include "logger.hpp"
+#include "game_server.hpp"
+
+static void printUsage()
+{
+    std::cout << "Usage: catan_server [--socket=PATH] [--port=N] [--threads=N] [--io-threads=N] [--seed=N] [--map=FILE]\n" \
+        << "                   [--hibernate=FILE [--idle-ms=N] [--rehydrate-budget=N]] [--turn-ms=N] [--robber-ms=N] [--verbose] [--debug=N]\n" \
+        << "  --socket      path of the Unix-domain socket to listen on\n" \
+        << "  --port        TCP port to listen on, 127.0.0.1 only, default 0 (Unix-domain socket only)\n" \
+        << "  --threads     num of game workers, every game is pinned to one of them, default 0 (one per core)\n" \
+        << "  --io-threads  num of threads reading and writing the connections, default 1\n" \
+        << "  --seed        game N is seeded with seed + N, default 0 (system clock)\n" \
+        << "  --map         map file of every game, default map if not provided\n" \
+        << "  --hibernate   file to hibernate the idle games to, games are never hibernated if not provided\n" \
+        << "  --idle-ms     a game idle for longer is hibernated, default 60000\n" \
+        << "  --rehydrate-budget  max microseconds to rehydrate a game in the first two rounds, default 5000,\n" \
+        << "                a game expected to take longer stays in memory\n" \
+        << "  --turn-ms     a turn not ended within is ended for the player, default 0 (no limit)\n" \
+        << "  --robber-ms   a robber not moved within (after a 7 or a knight) is moved for the player, default 0 (no limit)\n" \
+        << "  --verbose     log INFO messages too, e.g., every command of every game, the games then serialize on the log\n" \
+        << "at least one of --socket and --port is required\n" \
+        << "\n" \
+        << "one request per line, every response is terminated by a line of a single '.':\n" \
+        << "  new [num of players]   create a game and join it\n" \
+        << "  join <game ID>         join an existing game\n" \
+        << "  watch <game ID>        spectate a game, its keyframe then its updates are pushed to the connection\n" \
+        << "  leave                  leave the current game, or stop watching it\n" \
+        << "  quit                   close the connection\n" \
+        << "  click <x> <y>          click on the map\n" \
+        << "  anything else          a command of the game, e.g., 'help'" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    Logger::initLogger();
+
+    CliOpt cliOpt;
+    cliOpt.processArg(argc, argv);
+    Logger::setDebugLevel(cliOpt.getOpt<CliOptIndex::DEBUG_LEVEL>());
+    Logger::setInfoEnabled(cliOpt.getOpt<CliOptIndex::SERVER_VERBOSE>());
+    if (cliOpt.getOpt<CliOptIndex::HELP_MANUAL>() || \
+        (cliOpt.getOpt<CliOptIndex::SERVER_SOCKET_PATH>() == "" && cliOpt.getOpt<CliOptIndex::SERVER_PORT>() == 0))
+    {
+        printUsage();
+        return 0;
+    }
+    if (cliOpt.getOpt<CliOptIndex::SERVER_PORT>() < 0 || cliOpt.getOpt<CliOptIndex::SERVER_PORT>() > UINT16_MAX)
+    {
+        WARN_LOG("Invalid port: ", cliOpt.getOpt<CliOptIndex::SERVER_PORT>());
+        return 1;
+    }
+
+    // block the signals before any worker starts so that only sigwait() below receives them
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    ServerConfig_t config;
+    config.socketPath = cliOpt.getOpt<CliOptIndex::SERVER_SOCKET_PATH>();
+    config.port = static_cast<uint16_t>(cliOpt.getOpt<CliOptIndex::SERVER_PORT>());
+    config.numWorkers = std::max(cliOpt.getOpt<CliOptIndex::SIM_NUM_THREADS>(), 0);
+    config.numIoWorkers = std::max(cliOpt.getOpt<CliOptIndex::SERVER_IO_THREADS>(), 1);
+    config.mapFile = cliOpt.getOpt<CliOptIndex::MAP_FILE_PATH>();
+    config.seed = cliOpt.getOpt<CliOptIndex::RANDOM_SEED>();
+    config.hibernation.storePath = cliOpt.getOpt<CliOptIndex::SERVER_HIBERNATE_STORE>();
+    config.hibernation.idleMs = std::max(cliOpt.getOpt<CliOptIndex::SERVER_HIBERNATE_IDLE_MS>(), 1);
+    config.hibernation.rehydrateBudgetUs = std::max(cliOpt.getOpt<CliOptIndex::SERVER_REHYDRATE_BUDGET_US>(), 0);
+    config.turnTimer.turnMs = std::max(cliOpt.getOpt<CliOptIndex::SERVER_TURN_MS>(), 0);
+    config.turnTimer.robberMs = std::max(cliOpt.getOpt<CliOptIndex::SERVER_ROBBER_MS>(), 0);
+
+    GameServer server(config);
+    if (server.start() != 0)
+    {
+        return 1;
+    }
+    std::cout << "catan-server running with " << server.getNumWorkers() << " game workers and " \
+        << server.getNumIoWorkers() << " connection threads, Ctrl-C to stop" << std::endl;
+
+    int signal = 0;
+    sigwait(&signals, &signal);
+    INFO_LOG("Signal ", signal, " received, stopping catan-server");
+    server.stop();
+    return 0;
+}
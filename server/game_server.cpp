@@ -0,0 +1,795 @@
+/**
+ * Project: catan
+ * @file game_server.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "game_server.hpp"
+#include "logger.hpp"
+#include "utility.hpp"
+
+namespace
+{
+
+constexpr int MAX_EVENTS = 64;
+// bounds the time a burst of new connections can hold up the games of a worker
+constexpr size_t MAX_ACCEPTS_PER_WAKEUP = 64U;
+constexpr size_t READ_BUFFER_SIZE = 4096U;
+constexpr uint32_t READ_EVENTS = EPOLLIN | EPOLLRDHUP;
+// buffers handed to a single sendmsg()
+constexpr size_t MAX_IOVECS = 64U;
+
+/** @return false if aString is not a non-negative decimal number */
+bool parseNumber(const std::string& aString, uint64_t& aValue)
+{
+    if (aString.empty() || aString.size() > 18U)
+    {
+        return false;
+    }
+    aValue = 0U;
+    for (const char ch : aString)
+    {
+        if (ch < '0' || ch > '9')
+        {
+            return false;
+        }
+        aValue = aValue * 10U + static_cast<uint64_t>(ch - '0');
+    }
+    return true;
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////
+GameServer::GameServer(const ServerConfig_t& aConfig) :
+    mConfig(aConfig)
+{
+    // empty
+}
+
+GameServer::~GameServer()
+{
+    stop();
+}
+
+int GameServer::listenUnix()
+{
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    if (mConfig.socketPath.size() >= sizeof(address.sun_path))
+    {
+        WARN_LOG("Socket path too long: " + mConfig.socketPath);
+        return 1;
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, mConfig.socketPath.c_str(), sizeof(address.sun_path) - 1U);
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        WARN_LOG("socket() failed: ", std::strerror(errno));
+        return 1;
+    }
+    // stale socket left by a previous run
+    ::unlink(mConfig.socketPath.c_str());
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, SOMAXCONN) != 0)
+    {
+        WARN_LOG("Cannot listen on " + mConfig.socketPath + ": ", std::strerror(errno));
+        ::close(fd);
+        return 1;
+    }
+    mListenFds.push_back(fd);
+    INFO_LOG("Listening on " + mConfig.socketPath);
+    return 0;
+}
+
+int GameServer::listenTcp()
+{
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(mConfig.port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        WARN_LOG("socket() failed: ", std::strerror(errno));
+        return 1;
+    }
+    const int enable = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, SOMAXCONN) != 0)
+    {
+        WARN_LOG("Cannot listen on 127.0.0.1:", mConfig.port, ": ", std::strerror(errno));
+        ::close(fd);
+        return 1;
+    }
+    mListenFds.push_back(fd);
+    INFO_LOG("Listening on 127.0.0.1:", mConfig.port);
+    return 0;
+}
+
+void GameServer::closeListenFds()
+{
+    for (const int fd : mListenFds)
+    {
+        ::close(fd);
+    }
+    if (!mListenFds.empty() && !mConfig.socketPath.empty())
+    {
+        ::unlink(mConfig.socketPath.c_str());
+    }
+    mListenFds.clear();
+}
+
+int GameServer::start()
+{
+    if (mConfig.socketPath.empty() && mConfig.port == 0U)
+    {
+        WARN_LOG("Neither a socket path nor a port is given");
+        return 1;
+    }
+    if ((!mConfig.socketPath.empty() && listenUnix() != 0) || (mConfig.port != 0U && listenTcp() != 0))
+    {
+        closeListenFds();
+        return 1;
+    }
+
+    mHost = std::make_unique<GameHost>(mConfig.numWorkers, mConfig.mapFile, mConfig.seed, mConfig.hibernation, mConfig.turnTimer);
+    const size_t numIoWorkers = std::max<size_t>(mConfig.numIoWorkers, 1U);
+    for (size_t worker = 0U; worker < numIoWorkers; ++worker)
+    {
+        mWorkers.push_back(std::make_unique<ServerWorker>(*this, worker));
+        if (mWorkers.back()->start() != 0)
+        {
+            stop();
+            return 1;
+        }
+    }
+    INFO_LOG("catan-server started with ", mHost->getNumWorkers(), " game workers and ", numIoWorkers, " connection threads");
+    return 0;
+}
+
+void GameServer::stop()
+{
+    for (std::unique_ptr<ServerWorker>& pWorker : mWorkers)
+    {
+        pWorker->stop();
+    }
+    for (std::unique_ptr<ServerWorker>& pWorker : mWorkers)
+    {
+        pWorker->join();
+    }
+    // the game workers may still post responses to the connection threads until they are stopped
+    mHost.reset();
+    mWorkers.clear();
+    closeListenFds();
+}
+
+const std::vector<int>& GameServer::getListenFds() const
+{
+    return mListenFds;
+}
+
+GameHost& GameServer::getHost()
+{
+    return *mHost;
+}
+
+size_t GameServer::getNumIoWorkers() const
+{
+    return mWorkers.size();
+}
+
+size_t GameServer::getNumWorkers() const
+{
+    return mHost ? mHost->getNumWorkers() : 0U;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+ServerWorker::ServerWorker(GameServer& aServer, const size_t aWorkerIndex) :
+    mServer(aServer),
+    mWorkerIndex(aWorkerIndex),
+    mEpollFd(-1),
+    mWakeFd(-1),
+    mIsStopping(false),
+    mNumConnections(0U),
+    mIsWakeUpPending(false)
+{
+    // empty
+}
+
+ServerWorker::~ServerWorker()
+{
+    stop();
+    join();
+    for (const auto& connection : mConnections)
+    {
+        ::close(connection.first);
+    }
+    if (mWakeFd >= 0)
+    {
+        ::close(mWakeFd);
+    }
+    if (mEpollFd >= 0)
+    {
+        ::close(mEpollFd);
+    }
+}
+
+int ServerWorker::start()
+{
+    mEpollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    mWakeFd = ::eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (mEpollFd < 0 || mWakeFd < 0)
+    {
+        WARN_LOG("Connection thread ", mWorkerIndex, ": cannot create epoll / eventfd: ", std::strerror(errno));
+        return 1;
+    }
+
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = mWakeFd;
+    if (::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mWakeFd, &event) != 0)
+    {
+        WARN_LOG("Connection thread ", mWorkerIndex, ": epoll_ctl() failed: ", std::strerror(errno));
+        return 1;
+    }
+    for (const int listenFd : mServer.getListenFds())
+    {
+        // a new connection wakes up one of the connection threads instead of all of them
+        event.events = EPOLLIN | EPOLLEXCLUSIVE;
+        event.data.fd = listenFd;
+        if (::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, listenFd, &event) != 0)
+        {
+            WARN_LOG("Connection thread ", mWorkerIndex, ": epoll_ctl() failed: ", std::strerror(errno));
+            return 1;
+        }
+    }
+
+    mThread = std::thread(&ServerWorker::loop, this);
+    return 0;
+}
+
+void ServerWorker::stop()
+{
+    mIsStopping = true;
+    if (mWakeFd >= 0)
+    {
+        const uint64_t one = 1U;
+        (void) !::write(mWakeFd, &one, sizeof(one));
+    }
+}
+
+void ServerWorker::join()
+{
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+}
+
+void ServerWorker::loop()
+{
+    const std::vector<int>& listenFds = mServer.getListenFds();
+    epoll_event events[MAX_EVENTS];
+    while (!mIsStopping)
+    {
+        const int numEvents = ::epoll_wait(mEpollFd, events, MAX_EVENTS, -1);
+        if (numEvents < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            WARN_LOG("Connection thread ", mWorkerIndex, ": epoll_wait() failed: ", std::strerror(errno));
+            break;
+        }
+
+        for (int ii = 0; ii < numEvents; ++ii)
+        {
+            const int fd = events[ii].data.fd;
+            if (fd == mWakeFd)
+            {
+                uint64_t count;
+                (void) !::read(mWakeFd, &count, sizeof(count));
+                receiveResponses();
+            }
+            else if (std::find(listenFds.begin(), listenFds.end(), fd) != listenFds.end())
+            {
+                acceptConnections(fd);
+            }
+            else
+            {
+                // a hang-up is detected by read() returning 0
+                if (events[ii].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+                {
+                    onReadable(fd);
+                }
+                if (events[ii].events & EPOLLOUT)
+                {
+                    onWritable(fd);
+                }
+            }
+        }
+    }
+    INFO_LOG("Connection thread ", mWorkerIndex, " exits with ", mConnections.size(), " connections");
+}
+
+void ServerWorker::acceptConnections(const int aListenFd)
+{
+    for (size_t ii = 0U; ii < MAX_ACCEPTS_PER_WAKEUP; ++ii)
+    {
+        const int fd = ::accept4(aListenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                WARN_LOG("Connection thread ", mWorkerIndex, ": accept() failed: ", std::strerror(errno));
+            }
+            return;
+        }
+
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = READ_EVENTS;
+        event.data.fd = fd;
+        if (::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            WARN_LOG("Connection thread ", mWorkerIndex, ": epoll_ctl() failed: ", std::strerror(errno));
+            ::close(fd);
+            continue;
+        }
+        mConnections[fd] = Connection_t{fd, mNumConnections++, NO_GAME, NO_GAME, 0U, false, {}, {}, 0U, 0U, false, false, false};
+    }
+}
+
+void ServerWorker::post(Response_t&& aResponse)
+{
+    mResponses.push(std::move(aResponse));
+    if (!mIsWakeUpPending.exchange(true))
+    {
+        const uint64_t one = 1U;
+        (void) !::write(mWakeFd, &one, sizeof(one));
+    }
+}
+
+void ServerWorker::receiveResponses()
+{
+    // cleared before draining, a response posted meanwhile is either drained below or signals again
+    mIsWakeUpPending = false;
+    Response_t response;
+    while (mResponses.pop(response))
+    {
+        if (response.frame.data)
+        {
+            onFrame(response.frame);
+        }
+        else
+        {
+            onResponse(response);
+        }
+    }
+    if (!mResponses.empty())
+    {
+        // a response half way through its push(), come back for it
+        mIsWakeUpPending = true;
+        const uint64_t one = 1U;
+        (void) !::write(mWakeFd, &one, sizeof(one));
+    }
+}
+
+void ServerWorker::onResponse(Response_t& aResponse)
+{
+    auto connectionIter = mConnections.find(aResponse.fd);
+    if (connectionIter == mConnections.end() || connectionIter->second.connectionId != aResponse.connectionId)
+    {
+        // the connection is gone
+        return;
+    }
+    Connection_t& connection = connectionIter->second;
+    connection.isAwaitingResponse = false;
+    if (connection.watchedGameId != NO_GAME)
+    {
+        // the answer to the watch, its keyframe follows
+        if (aResponse.result != GameHost::Result::SUCCESS)
+        {
+            stopWatching(connection);
+        }
+    }
+    else if (aResponse.result == GameHost::Result::SUCCESS)
+    {
+        // a new game or a join
+        connection.gameId = aResponse.gameId;
+    }
+    else if (connection.gameId == aResponse.gameId)
+    {
+        connection.gameId = NO_GAME;
+    }
+    reply(connection, aResponse.msgs);
+    processInput(connection);
+    flushOrClose(connection);
+}
+
+void ServerWorker::onReadable(const int aFd)
+{
+    auto connectionIter = mConnections.find(aFd);
+    if (connectionIter == mConnections.end())
+    {
+        // closed earlier in the same batch of events
+        return;
+    }
+    Connection_t& connection = connectionIter->second;
+
+    // one read per event, a client flooding the server does not starve the others
+    char buffer[READ_BUFFER_SIZE];
+    const ssize_t numBytes = ::read(aFd, buffer, sizeof(buffer));
+    if (numBytes == 0 || (numBytes < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+    {
+        closeConnection(aFd);
+        return;
+    }
+    if (numBytes < 0 || connection.isClosing)
+    {
+        return;
+    }
+
+    connection.input.append(buffer, numBytes);
+    processInput(connection);
+    flushOrClose(connection);
+}
+
+void ServerWorker::onWritable(const int aFd)
+{
+    auto connectionIter = mConnections.find(aFd);
+    if (connectionIter != mConnections.end())
+    {
+        flushOrClose(connectionIter->second);
+    }
+}
+
+void ServerWorker::processInput(Connection_t& aConnection)
+{
+    size_t lineEnd;
+    while (!aConnection.isClosing && !aConnection.isAwaitingResponse && \
+           (lineEnd = aConnection.input.find('\n')) <= GameServer::MAX_LINE_LENGTH)
+    {
+        std::string line = aConnection.input.substr(0U, lineEnd);
+        aConnection.input.erase(0U, lineEnd + 1U);
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        handleLine(aConnection, line);
+    }
+
+    if (!aConnection.isClosing && std::min(aConnection.input.find('\n'), aConnection.input.size()) > GameServer::MAX_LINE_LENGTH)
+    {
+        reply(aConnection, {"error: line longer than " + std::to_string(GameServer::MAX_LINE_LENGTH) + " bytes"});
+        aConnection.isClosing = true;
+    }
+    if (aConnection.isClosing)
+    {
+        aConnection.input.clear();
+    }
+}
+
+void ServerWorker::handleLine(Connection_t& aConnection, const std::string& aLine)
+{
+    const std::vector<std::string> params = splitString(aLine);
+    const std::string command = params.empty() ? "" : params.front();
+    GameHost& host = mServer.getHost();
+
+    if (command == "quit")
+    {
+        reply(aConnection, {"bye"});
+        aConnection.isClosing = true;
+    }
+    else if (command == "new")
+    {
+        uint64_t numOfPlayers = GameServer::DEFAULT_NUM_PLAYERS;
+        if (params.size() > 2U || (params.size() == 2U && !parseNumber(params[1], numOfPlayers)) || \
+            numOfPlayers < 2U || numOfPlayers > constant::MAX_NUM_PLAYERS)
+        {
+            reply(aConnection, {"error: usage: new [num of players, 2 to " + std::to_string(constant::MAX_NUM_PLAYERS) + "]"});
+            return;
+        }
+        aConnection.gameId = NO_GAME;
+        stopWatching(aConnection);
+        aConnection.isAwaitingResponse = true;
+        host.createGame(numOfPlayers, responseCallback(aConnection));
+    }
+    else if (command == "join")
+    {
+        uint64_t gameId;
+        if (params.size() != 2U || !parseNumber(params[1], gameId))
+        {
+            reply(aConnection, {"error: usage: join <game ID>"});
+            return;
+        }
+        aConnection.gameId = NO_GAME;
+        stopWatching(aConnection);
+        aConnection.isAwaitingResponse = true;
+        host.describe(gameId, responseCallback(aConnection));
+    }
+    else if (command == "watch")
+    {
+        uint64_t gameId;
+        if (params.size() != 2U || !parseNumber(params[1], gameId))
+        {
+            reply(aConnection, {"error: usage: watch <game ID>"});
+            return;
+        }
+        aConnection.gameId = NO_GAME;
+        stopWatching(aConnection);
+        startWatching(aConnection, gameId);
+        aConnection.isAwaitingResponse = true;
+        // the connection thread is the watcher of the game for all its spectators
+        host.watch(gameId, mWorkerIndex, [this](const GameHost::Frame_t& aFrame) {
+            post(Response_t{-1, 0U, aFrame.gameId, GameHost::Result::SUCCESS, {}, aFrame});
+        }, responseCallback(aConnection));
+    }
+    else if (command == "leave" && aConnection.watchedGameId != NO_GAME)
+    {
+        reply(aConnection, {"stopped watching game " + std::to_string(aConnection.watchedGameId)});
+        stopWatching(aConnection);
+    }
+    else if (command == "leave")
+    {
+        if (aConnection.gameId == NO_GAME)
+        {
+            reply(aConnection, {"error: not in a game"});
+            return;
+        }
+        reply(aConnection, {"left game " + std::to_string(aConnection.gameId)});
+        // the game keeps running without connections, it can be joined again
+        aConnection.gameId = NO_GAME;
+    }
+    else if (aConnection.watchedGameId != NO_GAME)
+    {
+        reply(aConnection, {"error: watching game " + std::to_string(aConnection.watchedGameId), "leave | quit"});
+    }
+    else if (aConnection.gameId == NO_GAME)
+    {
+        reply(aConnection, {"error: not in a game", "new [num of players] | join <game ID> | watch <game ID> | quit"});
+    }
+    else if (command == "click")
+    {
+        uint64_t x, y;
+        if (params.size() != 3U || !parseNumber(params[1], x) || !parseNumber(params[2], y))
+        {
+            reply(aConnection, {"error: usage: click <x> <y>"});
+            return;
+        }
+        aConnection.isAwaitingResponse = true;
+        host.act(aConnection.gameId, "", Point_t{static_cast<size_t>(x), static_cast<size_t>(y)}, responseCallback(aConnection));
+    }
+    else
+    {
+        aConnection.isAwaitingResponse = true;
+        host.act(aConnection.gameId, aLine, Point_t{0, 0}, responseCallback(aConnection));
+    }
+}
+
+GameHost::Callback_t ServerWorker::responseCallback(const Connection_t& aConnection)
+{
+    const int fd = aConnection.fd;
+    const uint64_t connectionId = aConnection.connectionId;
+    return [this, fd, connectionId](const uint64_t aGameId, const GameHost::Result aResult, std::vector<std::string>& aMsgs) {
+        post(Response_t{fd, connectionId, aGameId, aResult, std::move(aMsgs), {}});
+    };
+}
+
+void ServerWorker::reply(Connection_t& aConnection, const std::vector<std::string>& aMsgs)
+{
+    std::string response;
+    for (const std::string& msg : aMsgs)
+    {
+        GameHost::appendLines(response, msg);
+    }
+    response += ".\n";
+    queueOutput(aConnection, std::make_shared<const std::string>(std::move(response)), false);
+}
+
+void ServerWorker::startWatching(Connection_t& aConnection, const uint64_t aGameId)
+{
+    aConnection.watchedGameId = aGameId;
+    aConnection.lastSeq = 0U;
+    aConnection.isSkipping = true;
+    mSpectators[aGameId].push_back(aConnection.fd);
+}
+
+void ServerWorker::stopWatching(Connection_t& aConnection)
+{
+    if (aConnection.watchedGameId == NO_GAME)
+    {
+        return;
+    }
+    const auto spectatorsIter = mSpectators.find(aConnection.watchedGameId);
+    if (spectatorsIter != mSpectators.end())
+    {
+        std::vector<int>& fds = spectatorsIter->second;
+        fds.erase(std::remove(fds.begin(), fds.end(), aConnection.fd), fds.end());
+        if (fds.empty())
+        {
+            mSpectators.erase(spectatorsIter);
+            mServer.getHost().unwatch(aConnection.watchedGameId, mWorkerIndex);
+        }
+    }
+    aConnection.watchedGameId = NO_GAME;
+}
+
+void ServerWorker::onFrame(const GameHost::Frame_t& aFrame)
+{
+    const auto spectatorsIter = mSpectators.find(aFrame.gameId);
+    if (spectatorsIter == mSpectators.end())
+    {
+        // nobody watches any more, the unwatch is on its way
+        return;
+    }
+    // a spectator may be closed while flushing
+    const std::vector<int> fds = spectatorsIter->second;
+    if (aFrame.isLast)
+    {
+        mSpectators.erase(spectatorsIter);
+    }
+    for (const int fd : fds)
+    {
+        const auto connectionIter = mConnections.find(fd);
+        if (connectionIter == mConnections.end() || connectionIter->second.watchedGameId != aFrame.gameId)
+        {
+            continue;
+        }
+        Connection_t& connection = connectionIter->second;
+        queueFrame(connection, aFrame);
+        if (aFrame.isLast)
+        {
+            connection.watchedGameId = NO_GAME;
+        }
+        flushOrClose(connection);
+    }
+}
+
+void ServerWorker::queueFrame(Connection_t& aConnection, const GameHost::Frame_t& aFrame)
+{
+    // the frames before the answer to the watch are for the other spectators of this thread,
+    // an up-to-date spectator needs no keyframe, one waiting for a keyframe needs no update, but for the last one
+    if (aConnection.isAwaitingResponse)
+    {
+        return;
+    }
+    if (!aFrame.isLast && (aFrame.isKeyframe ? (!aConnection.isSkipping && aFrame.seq <= aConnection.lastSeq) : aConnection.isSkipping))
+    {
+        return;
+    }
+    if (aConnection.outputBytes > GameServer::MAX_SPECTATOR_BACKLOG)
+    {
+        // too slow, drop the frames not started, the responses to the connection stay
+        for (auto bufferIter = aConnection.output.begin() + (aConnection.outputOffset != 0U ? 1 : 0); \
+             bufferIter != aConnection.output.end();)
+        {
+            if (bufferIter->isFrame)
+            {
+                aConnection.outputBytes -= bufferIter->data->size();
+                bufferIter = aConnection.output.erase(bufferIter);
+            }
+            else
+            {
+                ++bufferIter;
+            }
+        }
+        if (!aFrame.isKeyframe && !aFrame.isLast)
+        {
+            aConnection.isSkipping = true;
+            return;
+        }
+    }
+    queueOutput(aConnection, aFrame.data, true);
+    aConnection.lastSeq = aFrame.seq;
+    if (aFrame.isKeyframe)
+    {
+        aConnection.isSkipping = false;
+    }
+}
+
+void ServerWorker::queueOutput(Connection_t& aConnection, std::shared_ptr<const std::string> aData, const bool aIsFrame)
+{
+    aConnection.outputBytes += aData->size();
+    aConnection.output.push_back(OutputBuffer_t{std::move(aData), aIsFrame});
+}
+
+void ServerWorker::flushOrClose(Connection_t& aConnection)
+{
+    while (!aConnection.output.empty())
+    {
+        // the buffers as they are, shared with the other spectators, in one call
+        iovec iovecs[MAX_IOVECS];
+        size_t numIovecs = 0U;
+        for (auto bufferIter = aConnection.output.begin(); bufferIter != aConnection.output.end() && numIovecs < MAX_IOVECS; \
+             ++bufferIter, ++numIovecs)
+        {
+            const size_t offset = (numIovecs == 0U) ? aConnection.outputOffset : 0U;
+            iovecs[numIovecs].iov_base = const_cast<char*>(bufferIter->data->data() + offset);
+            iovecs[numIovecs].iov_len = bufferIter->data->size() - offset;
+        }
+        msghdr message;
+        std::memset(&message, 0, sizeof(message));
+        message.msg_iov = iovecs;
+        message.msg_iovlen = numIovecs;
+
+        // sendmsg() rather than writev() for MSG_NOSIGNAL
+        const ssize_t numBytes = ::sendmsg(aConnection.fd, &message, MSG_NOSIGNAL);
+        if (numBytes > 0)
+        {
+            size_t numWritten = numBytes;
+            aConnection.outputBytes -= numWritten;
+            while (numWritten != 0U)
+            {
+                const size_t numLeft = aConnection.output.front().data->size() - aConnection.outputOffset;
+                if (numWritten < numLeft)
+                {
+                    aConnection.outputOffset += numWritten;
+                    break;
+                }
+                numWritten -= numLeft;
+                aConnection.output.pop_front();
+                aConnection.outputOffset = 0U;
+            }
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            break;
+        }
+        else if (errno != EINTR)
+        {
+            aConnection.output.clear();
+            aConnection.outputOffset = 0U;
+            aConnection.outputBytes = 0U;
+            aConnection.isClosing = true;
+        }
+    }
+    if (aConnection.isClosing && aConnection.output.empty())
+    {
+        closeConnection(aConnection.fd);
+        return;
+    }
+
+    const bool isWaitingWritable = !aConnection.output.empty();
+    if (isWaitingWritable != aConnection.isWaitingWritable)
+    {
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = isWaitingWritable ? (READ_EVENTS | EPOLLOUT) : READ_EVENTS;
+        event.data.fd = aConnection.fd;
+        ::epoll_ctl(mEpollFd, EPOLL_CTL_MOD, aConnection.fd, &event);
+        aConnection.isWaitingWritable = isWaitingWritable;
+    }
+}
+
+void ServerWorker::closeConnection(const int aFd)
+{
+    const auto connectionIter = mConnections.find(aFd);
+    if (connectionIter != mConnections.end())
+    {
+        stopWatching(connectionIter->second);
+    }
+    // close() removes the fd from the epoll set, a response still on its way is dropped by onResponse()
+    ::close(aFd);
+    mConnections.erase(aFd);
+}
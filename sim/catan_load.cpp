@@ -0,0 +1,459 @@
+/**
+ * Project: catan
+ * @file catan_load.cpp
+ * @brief catan_load.exe entry point, load generator of GameHost: simulated clients play many games at once
+ *        with command strings and clicks, reports the throughput and the latency histograms as JSON
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include "cli_opt.hpp"
+#include "logger.hpp"
+#include "utility.hpp"
+#include "game_host.hpp"
+#include "map_file_io.hpp"
+#include "board_layout.hpp"
+#include "latency_histogram.hpp"
+#include "random_engine.hpp"
+#include "vertex.hpp"
+#include "edge.hpp"
+#include "land.hpp"
+
+constexpr size_t NUM_PLAYERS = 4U;
+constexpr uint64_t HIGHEST_LATENCY_NS = 60ULL * 1000U * 1000U * 1000U;
+constexpr size_t LATENCY_DIGITS = 3U;
+constexpr size_t LATENCY_BY_REQUEST_DIGITS = 2U;
+constexpr size_t MAX_RANDOM_COMMANDS = 4U;  // per turn, between the roll and the end of the turn
+
+enum class RequestKind : size_t
+{
+    PLACE = 0,  // a click of the first two rounds
+    ROLL,
+    CLICK,      // where to build, where the robber goes and whom it robs
+    BUILD,
+    DEV_CARD,
+    STATUS,
+    HELP,
+    NEXT,
+
+    /* end of RequestKind */
+    REQUEST_KIND_END,
+};
+constexpr size_t REQUEST_KIND_SIZE = static_cast<size_t>(RequestKind::REQUEST_KIND_END);
+static const std::vector<std::string> REQUEST_KIND_NAMES = {"place", "roll", "click", "build", "development_card", "status", "help", "next"};
+
+struct Command_t
+{
+    std::string input;
+    RequestKind kind;
+};
+
+// the commands a random turn draws from, after the roll
+static const std::vector<Command_t> RANDOM_COMMANDS = {
+    {"status", RequestKind::STATUS},
+    {"help", RequestKind::HELP},
+    {"build road", RequestKind::BUILD},
+    {"build settlement", RequestKind::BUILD},
+    {"build city", RequestKind::BUILD},
+    {"development_card buy", RequestKind::DEV_CARD},
+};
+
+// what a client knows of the board, i.e., where to click, the same for every game
+struct Board_t
+{
+    std::vector<Point_t> vertices;
+    std::vector<Point_t> edges;
+    std::vector<Point_t> lands;
+    std::vector<std::vector<size_t> > edgesOfVertex;
+    std::vector<std::vector<size_t> > verticesOfLand;
+};
+
+struct LoadConfig_t
+{
+    size_t numTurns;
+    bool isRandom;
+    uint64_t seed;
+};
+
+struct LoadStats_t
+{
+    size_t numRequests;
+    size_t numErrors;
+    size_t numTurns;
+    LatencyHistogram latency;
+    std::vector<LatencyHistogram> latencyByKind;
+
+    LoadStats_t() :
+        numRequests(0U),
+        numErrors(0U),
+        numTurns(0U),
+        latency(HIGHEST_LATENCY_NS, LATENCY_DIGITS),
+        latencyByKind(REQUEST_KIND_SIZE, LatencyHistogram(HIGHEST_LATENCY_NS, LATENCY_BY_REQUEST_DIGITS))
+    {
+        // empty
+    }
+
+    void merge(const LoadStats_t& aOther)
+    {
+        numRequests += aOther.numRequests;
+        numErrors += aOther.numErrors;
+        numTurns += aOther.numTurns;
+        latency.merge(aOther.latency);
+        for (size_t kind = 0U; kind < REQUEST_KIND_SIZE; ++kind)
+        {
+            latencyByKind[kind].merge(aOther.latencyByKind[kind]);
+        }
+    }
+};
+
+// a game played by a client, one request in flight at a time
+struct LoadGame_t
+{
+    uint64_t gameId;
+    bool isOpening;             // in the first two rounds
+    size_t vertex;              // the vertex clicked last in the first two rounds
+    bool hasSettlement;         // the settlement of the vertex is placed, its road is next
+    size_t robberLand;
+    bool isBuildingRoad;        // the click of the build in flight is on an edge
+    size_t turn;
+    std::deque<Command_t> plan; // the commands left in the turn
+    RequestKind kind;           // of the request in flight
+};
+
+struct Response_t
+{
+    size_t game;                // index in the games of the client
+    GameHost::Result result;
+    uint64_t latencyNs;
+    std::vector<std::string> msgs;
+};
+
+// the responses of the games of a client, pushed by the workers of the host
+struct Inbox_t
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<Response_t> responses;
+};
+
+// a point of the terrain that is not claimed by a neighbour, nor {0, 0}, i.e., a click on it
+static Point_t pointOf(const BoardLayout& aLayout, const Terrain* const aTerrain)
+{
+    for (const Point_t& point : aTerrain->getAllPoints())
+    {
+        if (aLayout.getTerrain(point) == aTerrain && point != Point_t{0, 0})
+        {
+            return point;
+        }
+    }
+    return aTerrain->getTopLeft();
+}
+
+static void initBoard(const BoardLayout& aLayout, Board_t& aBoard)
+{
+    for (const Vertex* const pVertex : aLayout.getVertices())
+    {
+        aBoard.vertices.push_back(pointOf(aLayout, pVertex));
+    }
+    aBoard.edgesOfVertex.resize(aBoard.vertices.size());
+    for (const Edge* const pEdge : aLayout.getEdges())
+    {
+        for (const Vertex* const pVertex : pEdge->getAdjacentVertices())
+        {
+            aBoard.edgesOfVertex.at(pVertex->getId()).push_back(aBoard.edges.size());
+        }
+        aBoard.edges.push_back(pointOf(aLayout, pEdge));
+    }
+    for (const Land* const pLand : aLayout.getLands())
+    {
+        aBoard.lands.push_back(pointOf(aLayout, pLand));
+        aBoard.verticesOfLand.emplace_back();
+        for (const Vertex* const pVertex : pLand->getAdjacentVertices())
+        {
+            aBoard.verticesOfLand.back().push_back(pVertex->getId());
+        }
+    }
+}
+
+static bool contains(const std::vector<std::string>& aMsgs, const std::string& aText)
+{
+    return std::any_of(aMsgs.begin(), aMsgs.end(), [&aText](const std::string& aMsg) {
+            return aMsg.find(aText) != std::string::npos;
+        });
+}
+
+template<typename T>
+static const T& pick(const std::vector<T>& aValues, RandomEngine& aEngine)
+{
+    return aValues[uniformBelow(aEngine, static_cast<uint32_t>(aValues.size()))];
+}
+
+static void planTurn(const LoadConfig_t& aConfig, RandomEngine& aEngine, std::deque<Command_t>& aPlan)
+{
+    aPlan.push_back(Command_t{"roll", RequestKind::ROLL});
+    if (aConfig.isRandom)
+    {
+        for (size_t command = uniformBelow(aEngine, MAX_RANDOM_COMMANDS + 1U); command > 0U; --command)
+        {
+            aPlan.push_back(pick(RANDOM_COMMANDS, aEngine));
+        }
+    }
+    else
+    {
+        aPlan.push_back(Command_t{"status", RequestKind::STATUS});
+        aPlan.push_back(Command_t{"build road", RequestKind::BUILD});
+        aPlan.push_back(Command_t{"build settlement", RequestKind::BUILD});
+        aPlan.push_back(Command_t{"development_card buy", RequestKind::DEV_CARD});
+    }
+    aPlan.push_back(Command_t{"next", RequestKind::NEXT});
+}
+
+/**
+ * play every game of aGames until aConfig.numTurns turns are over, a request per game in flight,
+ * the latency of a request is from GameHost::act() to its callback
+ */
+static void runClient(GameHost& aHost, const Board_t& aBoard, const LoadConfig_t& aConfig, const size_t aClient,
+                      std::vector<LoadGame_t>& aGames, LoadStats_t& aStats)
+{
+    RandomEngine engine(aConfig.seed + aClient);
+    Inbox_t inbox;
+    const auto send = [&](const size_t aGame, const std::string& aInput, const Point_t aPoint, const RequestKind aKind) {
+        aGames[aGame].kind = aKind;
+        const auto sentAt = std::chrono::steady_clock::now();
+        aHost.act(aGames[aGame].gameId, aInput, aPoint, [&inbox, aGame, sentAt](const uint64_t, const GameHost::Result aResult, std::vector<std::string>& aMsgs) {
+                const uint64_t latencyNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sentAt).count();
+                std::lock_guard<std::mutex> lock(inbox.mutex);
+                inbox.responses.push_back(Response_t{aGame, aResult, latencyNs, std::move(aMsgs)});
+                inbox.cv.notify_one();
+            });
+        ++aStats.numRequests;
+    };
+    const auto clickVertex = [&](const size_t aGame) {
+        LoadGame_t& game = aGames[aGame];
+        game.vertex = uniformBelow(engine, static_cast<uint32_t>(aBoard.vertices.size()));
+        send(aGame, "", aBoard.vertices[game.vertex], RequestKind::PLACE);
+    };
+    const auto clickRoad = [&](const size_t aGame) {
+        send(aGame, "", aBoard.edges[pick(aBoard.edgesOfVertex[aGames[aGame].vertex], engine)], RequestKind::PLACE);
+    };
+
+    // the first two rounds are clicks on random vertices until one is free, then on the edges next to it
+    for (size_t game = 0U; game < aGames.size(); ++game)
+    {
+        clickVertex(game);
+    }
+
+    size_t numActive = aGames.size();
+    std::vector<Response_t> responses;
+    while (numActive > 0U)
+    {
+        {
+            std::unique_lock<std::mutex> lock(inbox.mutex);
+            inbox.cv.wait(lock, [&inbox]() { return !inbox.responses.empty(); });
+            responses.swap(inbox.responses);
+        }
+        for (Response_t& response : responses)
+        {
+            LoadGame_t& game = aGames[response.game];
+            aStats.latency.record(response.latencyNs);
+            aStats.latencyByKind[static_cast<size_t>(game.kind)].record(response.latencyNs);
+            if (response.result != GameHost::Result::SUCCESS)
+            {
+                ++aStats.numErrors;
+                --numActive;
+                continue;
+            }
+
+            const std::vector<std::string>& msgs = response.msgs;
+            if (game.isOpening && contains(msgs, "First two rounds completed"))
+            {
+                game.isOpening = false;
+                planTurn(aConfig, engine, game.plan);
+            }
+            if (game.isOpening)
+            {
+                // a failed click is clicked again elsewhere
+                game.hasSettlement = (game.hasSettlement || contains(msgs, "placed a settlement")) && !contains(msgs, "placed a road");
+                game.hasSettlement ? clickRoad(response.game) : clickVertex(response.game);
+            }
+            else if (contains(msgs, "robber to go"))
+            {
+                game.robberLand = uniformBelow(engine, static_cast<uint32_t>(aBoard.lands.size()));
+                send(response.game, "", aBoard.lands[game.robberLand], RequestKind::CLICK);
+            }
+            else if (contains(msgs, "you want the rob"))
+            {
+                send(response.game, "", aBoard.vertices[pick(aBoard.verticesOfLand[game.robberLand], engine)], RequestKind::CLICK);
+            }
+            else if (contains(msgs, "where you want to build"))
+            {
+                const Point_t point = game.isBuildingRoad ? pick(aBoard.edges, engine) : pick(aBoard.vertices, engine);
+                send(response.game, "", point, RequestKind::CLICK);
+            }
+            else
+            {
+                if (game.plan.empty())
+                {
+                    ++aStats.numTurns;
+                    if (++game.turn >= aConfig.numTurns)
+                    {
+                        --numActive;
+                        continue;
+                    }
+                    planTurn(aConfig, engine, game.plan);
+                }
+                const Command_t command = game.plan.front();
+                game.plan.pop_front();
+                game.isBuildingRoad = (command.input == "build road");
+                send(response.game, command.input, Point_t{0, 0}, command.kind);
+            }
+        }
+        responses.clear();
+    }
+}
+
+static void printLatency(std::ostream& aOut, const LatencyHistogram& aHistogram)
+{
+    aOut << "{\"count\": " << aHistogram.getTotalCount() \
+        << ", \"min\": " << aHistogram.getMin() \
+        << ", \"mean\": " << static_cast<uint64_t>(aHistogram.getMean()) \
+        << ", \"p50\": " << aHistogram.getValueAtPercentile(50.0) \
+        << ", \"p90\": " << aHistogram.getValueAtPercentile(90.0) \
+        << ", \"p99\": " << aHistogram.getValueAtPercentile(99.0) \
+        << ", \"p999\": " << aHistogram.getValueAtPercentile(99.9) \
+        << ", \"max\": " << aHistogram.getMax() << "}";
+}
+
+static void printUsage(std::ostream& aOut)
+{
+    aOut << "Usage: catan_load [--games=N] [--clients=N] [--turns=N] [--script=turn|random] [--threads=N] [--seed=N] [--map=FILE]\n" \
+        << "                 [--hibernate=FILE [--idle-ms=N] [--rehydrate-budget=N]] [--turn-ms=N] [--robber-ms=N] [--verbose] [--debug=N]\n" \
+        << "  --games     num of games played at once, default 1000\n" \
+        << "  --clients   num of client threads, the games are dealt to them, default 4\n" \
+        << "  --turns     num of turns every game plays after the first two rounds, default 20\n" \
+        << "  --script    turn: roll, status, build road, build settlement, buy a development card, next;\n" \
+        << "              random: roll, 0 to " << MAX_RANDOM_COMMANDS << " random commands, next; default turn\n" \
+        << "  --threads   num of game workers of the host, default 0 (one per core)\n" \
+        << "  --seed      game N is seeded with seed + N, the clients with seed + client, default 0 (system clock)\n" \
+        << "  the other options are those of catan_server\n" \
+        << "the results are printed to stdout as a single JSON object" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    // the logger and the games print to stdout, muted for good, the results go straight to the buffer of stdout,
+    // see log.txt for the logs
+    std::ostream out(std::cout.rdbuf(nullptr));
+    Logger::initLogger();
+
+    CliOpt cliOpt;
+    cliOpt.processArg(argc, argv);
+    Logger::setDebugLevel(cliOpt.getOpt<CliOptIndex::DEBUG_LEVEL>());
+    Logger::setInfoEnabled(cliOpt.getOpt<CliOptIndex::SERVER_VERBOSE>());
+    const std::string script = cliOpt.getOpt<CliOptIndex::LOAD_SCRIPT>();
+    if (cliOpt.getOpt<CliOptIndex::HELP_MANUAL>() || (script != "turn" && script != "random"))
+    {
+        printUsage(out);
+        return cliOpt.getOpt<CliOptIndex::HELP_MANUAL>() ? 0 : 1;
+    }
+    const size_t numGames = std::max(cliOpt.getOpt<CliOptIndex::SIM_NUM_GAMES>(), 1);
+    const size_t numClients = std::min<size_t>(std::max(cliOpt.getOpt<CliOptIndex::LOAD_CLIENTS>(), 1), numGames);
+    const uint64_t seed = (cliOpt.getOpt<CliOptIndex::RANDOM_SEED>() != 0U) ? cliOpt.getOpt<CliOptIndex::RANDOM_SEED>() : \
+        static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    const LoadConfig_t config = LoadConfig_t{static_cast<size_t>(std::max(cliOpt.getOpt<CliOptIndex::LOAD_TURNS>(), 1)), script == "random", seed};
+
+    const std::shared_ptr<const BoardLayout> pLayout = MapIO(cliOpt.getOpt<CliOptIndex::MAP_FILE_PATH>()).readLayout();
+    if (pLayout == nullptr)
+    {
+        return 1;
+    }
+    Board_t board;
+    initBoard(*pLayout, board);
+
+    GameHost host(std::max(cliOpt.getOpt<CliOptIndex::SIM_NUM_THREADS>(), 0), cliOpt.getOpt<CliOptIndex::MAP_FILE_PATH>(), seed,
+        HibernationConfig_t{cliOpt.getOpt<CliOptIndex::SERVER_HIBERNATE_STORE>(),
+            static_cast<uint64_t>(std::max(cliOpt.getOpt<CliOptIndex::SERVER_HIBERNATE_IDLE_MS>(), 1)),
+            static_cast<uint64_t>(std::max(cliOpt.getOpt<CliOptIndex::SERVER_REHYDRATE_BUDGET_US>(), 0))},
+        TurnTimerConfig_t{static_cast<uint64_t>(std::max(cliOpt.getOpt<CliOptIndex::SERVER_TURN_MS>(), 0)),
+            static_cast<uint64_t>(std::max(cliOpt.getOpt<CliOptIndex::SERVER_ROBBER_MS>(), 0))});
+
+    // game N is played by client N % num of clients
+    std::vector<std::vector<LoadGame_t> > games(numClients);
+    std::mutex createMutex;
+    std::condition_variable createCv;
+    size_t numCreated = 0U;
+    size_t numFailed = 0U;
+    for (size_t game = 0U; game < numGames; ++game)
+    {
+        const uint64_t gameId = host.createGame(NUM_PLAYERS, [&](const uint64_t, const GameHost::Result aResult, std::vector<std::string>&) {
+                std::lock_guard<std::mutex> lock(createMutex);
+                ++numCreated;
+                numFailed += (aResult == GameHost::Result::SUCCESS) ? 0U : 1U;
+                createCv.notify_one();
+            });
+        games[game % numClients].push_back(LoadGame_t{gameId, true, 0U, false, 0U, false, 0U, {}, RequestKind::PLACE});
+    }
+    {
+        std::unique_lock<std::mutex> lock(createMutex);
+        createCv.wait(lock, [&]() { return numCreated == numGames; });
+    }
+    if (numFailed > 0U)
+    {
+        WARN_LOG("Failed to create ", numFailed, " games");
+        return 1;
+    }
+
+    std::vector<LoadStats_t> stats(numClients);
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> clients;
+    for (size_t client = 0U; client < numClients; ++client)
+    {
+        clients.emplace_back(runClient, std::ref(host), std::cref(board), std::cref(config), client, std::ref(games[client]), std::ref(stats[client]));
+    }
+    for (std::thread& client : clients)
+    {
+        client.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    LoadStats_t total;
+    for (const LoadStats_t& clientStats : stats)
+    {
+        total.merge(clientStats);
+    }
+    out << std::fixed << std::setprecision(3) << "{\n" \
+        << "  \"config\": {\"games\": " << numGames << ", \"players\": " << NUM_PLAYERS << ", \"clients\": " << numClients \
+        << ", \"workers\": " << host.getNumWorkers() << ", \"turns\": " << config.numTurns << ", \"script\": \"" << script \
+        << "\", \"seed\": " << seed << "},\n" \
+        << "  \"seconds\": " << elapsed.count() << ",\n" \
+        << "  \"requests\": " << total.numRequests << ",\n" \
+        << "  \"errors\": " << total.numErrors << ",\n" \
+        << "  \"turns\": " << total.numTurns << ",\n" \
+        << "  \"timeouts\": " << host.getNumTimeouts() << ",\n" \
+        << "  \"hibernations\": " << host.getNumHibernations() << ",\n" \
+        << "  \"requests_per_second\": " << total.numRequests / elapsed.count() << ",\n" \
+        << "  \"turns_per_second\": " << total.numTurns / elapsed.count() << ",\n" \
+        << "  \"latency_ns\": ";
+    printLatency(out, total.latency);
+    out << ",\n  \"latency_ns_by_request\": {";
+    for (size_t kind = 0U; kind < REQUEST_KIND_SIZE; ++kind)
+    {
+        out << (kind == 0U ? "\n" : ",\n") << "    \"" << REQUEST_KIND_NAMES[kind] << "\": ";
+        printLatency(out, total.latencyByKind[kind]);
+    }
+    out << "\n  }\n}" << std::endl;
+    return (total.numErrors == 0U) ? 0 : 2;
+}
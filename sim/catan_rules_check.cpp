@@ -0,0 +1,278 @@
+/**
+ * Project: catan
+ * @file catan_rules_check.cpp
+ * @brief catan_rules_check.exe entry point, plays the same games on GameMap and on GameRules side by side
+ *        and fails on the first state where the two implementations of the rules drift apart
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <iostream>
+#include "cli_opt.hpp"
+#include "logger.hpp"
+#include "game_map.hpp"
+#include "map_file_io.hpp"
+#include "board_topology.hpp"
+#include "game_rules.hpp"
+#include "agent.hpp"
+#include "map_action.hpp"
+
+constexpr size_t NUM_PLAYERS = 4U;
+
+static void printUsage()
+{
+    std::cout << "Usage: catan_rules_check [--games=N] [--seed=N] [--map=FILE] [--debug=N]\n" \
+        << "  --games    num of games to play, default 1000\n" \
+        << "  --seed     game N is seeded with seed + N, default 0 (system clock)\n" \
+        << "  --map      map file, default map if not provided\n" \
+        << "exits with 1 and prints the first difference if GameMap and GameRules disagree" << std::endl;
+}
+
+/**
+ * the first difference of the board and the players between aMap (GameMap::exportGameState()) and aRules,
+ * the resources are left out if aCompareResources is false, empty if none
+ * the longest road and the largest army are left out, GameMap does not award them (yet), only GameRules does
+ */
+static std::string diffStates(const BoardTopology& aTopology, const GameState_t& aMap, const GameState_t& aRules,
+                              const bool aCompareResources)
+{
+    std::ostringstream diff;
+    for (size_t vertexId = 0U; vertexId < aTopology.getNumVertices(); ++vertexId)
+    {
+        if (aMap.vertexOwner[vertexId] != aRules.vertexOwner[vertexId] || aMap.colony[vertexId] != aRules.colony[vertexId])
+        {
+            diff << "Vertex#" << vertexId << " owner/colony: GameMap " << static_cast<int>(aMap.vertexOwner[vertexId]) \
+                << "/" << static_cast<int>(aMap.colony[vertexId]) << ", GameRules " << static_cast<int>(aRules.vertexOwner[vertexId]) \
+                << "/" << static_cast<int>(aRules.colony[vertexId]);
+            return diff.str();
+        }
+    }
+    for (size_t edgeId = 0U; edgeId < aTopology.getNumEdges(); ++edgeId)
+    {
+        if (aMap.edgeOwner[edgeId] != aRules.edgeOwner[edgeId])
+        {
+            diff << "Edge#" << edgeId << " owner: GameMap " << static_cast<int>(aMap.edgeOwner[edgeId]) \
+                << ", GameRules " << static_cast<int>(aRules.edgeOwner[edgeId]);
+            return diff.str();
+        }
+    }
+    if (aMap.robLandId != aRules.robLandId)
+    {
+        diff << "robber: GameMap Land#" << static_cast<int>(aMap.robLandId) << ", GameRules Land#" << static_cast<int>(aRules.robLandId);
+        return diff.str();
+    }
+    if (aMap.devCardDeck.size != aRules.devCardDeck.size || aMap.devCardDeck.remaining != aRules.devCardDeck.remaining)
+    {
+        diff << "development cards left: GameMap " << static_cast<int>(aMap.devCardDeck.size) \
+            << ", GameRules " << static_cast<int>(aRules.devCardDeck.size);
+        return diff.str();
+    }
+    for (size_t playerId = 0U; playerId < aRules.numPlayers; ++playerId)
+    {
+        const PlayerState_t& mapPlayer = aMap.players[playerId];
+        const PlayerState_t& rulesPlayer = aRules.players[playerId];
+        const char* field = nullptr;
+        if (aCompareResources && mapPlayer.resources != rulesPlayer.resources)
+        {
+            field = "resources";
+        }
+        else if (mapPlayer.devCards != rulesPlayer.devCards || mapPlayer.devCardsUsed != rulesPlayer.devCardsUsed)
+        {
+            field = "development cards";
+        }
+        else if (mapPlayer.numSettlements != rulesPlayer.numSettlements || mapPlayer.numCities != rulesPlayer.numCities || \
+                 mapPlayer.numRoads != rulesPlayer.numRoads)
+        {
+            field = "num of settlements, cities or roads";
+        }
+        if (field != nullptr)
+        {
+            diff << "Player#" << playerId << " " << field << " differ";
+            return diff.str();
+        }
+    }
+    return diff.str();
+}
+
+static std::string actionToStr(const GameAction_t& aAction)
+{
+    std::ostringstream str;
+    str << "action " << static_cast<int>(aAction.type) << " aux " << static_cast<int>(aAction.aux) << " id " << aAction.id;
+    return str.str();
+}
+
+/**
+ * play a game of aAgents on aMap and on a GameState_t of aRules from the same board, the actions are chosen
+ * on GameRules and applied to GameMap with MapActionExecutor, i.e., with the APIs of the command handlers
+ * the dice are the ones of GameMap, the rules are told of them, both draw the development cards from the deck of GameMap,
+ * the card robbed and the cards discarded on 7 are random on both sides, the resources are synced after them
+ * bank trades are left out, GameMap has no API for them
+ * @param aNumActions incremented by the num of actions played
+ * @return empty if the two agree till the end of the game, the first difference otherwise
+ */
+static std::string checkGame(GameMap& aMap, const GameRules& aRules, std::vector<std::unique_ptr<Agent> >& aAgents,
+                             RandomEngine& aEngine, size_t& aNumActions)
+{
+    MapActionExecutor executor;
+    GameState_t state;
+    GameState_t mapState;
+    if (aMap.exportGameState(state) != 0)
+    {
+        return "GameMap does not fit in GameState_t";
+    }
+    state.phase = GamePhase::SETUP_SETTLEMENT;
+    state.setupStep = 0U;
+    state.currentPlayer = 0U;
+
+    std::vector<GameAction_t> actions;
+    aRules.getLegalActions(state, actions);
+    while (!actions.empty())
+    {
+        actions.erase(std::remove_if(actions.begin(), actions.end(), [](const GameAction_t& aAction) {
+                return aAction.type == GameActionType::BANK_TRADE;
+            }), actions.end());
+        const GameAction_t action = actions[aAgents[state.currentPlayer]->chooseAction(aRules, state, actions, aEngine)];
+        const bool isSetup = (state.phase == GamePhase::SETUP_SETTLEMENT || state.phase == GamePhase::SETUP_ROAD);
+
+        MapAction_t mapAction = MapAction_t{MapActionOpcode::END_TURN, action.aux, action.id};
+        bool isResourceSynced = false;
+        switch (action.type)
+        {
+        case GameActionType::ROLL_DICE:
+            mapAction.opcode = MapActionOpcode::ROLL_DICE;
+            break;
+        case GameActionType::BUILD_ROAD:
+            mapAction.opcode = isSetup ? MapActionOpcode::PLACE_ROAD : MapActionOpcode::BUILD_ROAD;
+            break;
+        case GameActionType::BUILD_SETTLEMENT:
+            mapAction.opcode = isSetup ? MapActionOpcode::PLACE_SETTLEMENT : MapActionOpcode::BUILD_SETTLEMENT;
+            // the second settlement collects the resources next to it
+            mapAction.aux = static_cast<uint8_t>(isSetup && state.setupStep >= state.numPlayers);
+            break;
+        case GameActionType::BUILD_CITY:
+            mapAction.opcode = MapActionOpcode::BUILD_CITY;
+            break;
+        case GameActionType::BUY_DEV_CARD:
+            mapAction.opcode = MapActionOpcode::BUY_DEV_CARD;
+            break;
+        case GameActionType::MOVE_ROBBER:
+        case GameActionType::PLAY_KNIGHT:
+            mapAction.opcode = (action.type == GameActionType::MOVE_ROBBER) ? MapActionOpcode::MOVE_ROBBER : MapActionOpcode::PLAY_KNIGHT;
+            isResourceSynced = (action.aux != NO_PLAYER);
+            break;
+        case GameActionType::END_TURN:
+        case GameActionType::BANK_TRADE:
+        default:
+            break;
+        }
+
+        // the first two rounds of GameMap follow the order of its own, the player placing is picked by hand
+        if (isSetup)
+        {
+            while (aMap.currentPlayer() != state.currentPlayer)
+            {
+                aMap.nextPlayer();
+            }
+        }
+        const MapActionResult_t result = executor.execute(aMap, mapAction);
+        ++aNumActions;
+        if (result.rc != 0)
+        {
+            return "GameMap rejected " + actionToStr(action) + ", rc " + std::to_string(result.rc) + ", legal in GameRules";
+        }
+        if (action.type == GameActionType::ROLL_DICE)
+        {
+            aRules.applyDice(state, result.value, aEngine);
+            isResourceSynced = (result.value == 7U);
+        }
+        else
+        {
+            aRules.applyAction(state, action, aEngine);
+        }
+
+        aMap.exportGameState(mapState);
+        if (!isSetup && mapState.currentPlayer != state.currentPlayer)
+        {
+            return "current player after " + actionToStr(action) + ": GameMap " + std::to_string(mapState.currentPlayer) + \
+                ", GameRules " + std::to_string(state.currentPlayer);
+        }
+        const std::string diff = diffStates(aRules.getTopology(), mapState, state, !isResourceSynced);
+        if (!diff.empty())
+        {
+            return diff + " after " + actionToStr(action);
+        }
+        if (isResourceSynced)
+        {
+            for (size_t playerId = 0U; playerId < state.numPlayers; ++playerId)
+            {
+                state.players[playerId].resources = mapState.players[playerId].resources;
+            }
+        }
+        aRules.getLegalActions(state, actions);
+    }
+    return "";
+}
+
+int main(int argc, char** argv)
+{
+    Logger::initLogger();
+
+    CliOpt cliOpt;
+    cliOpt.processArg(argc, argv);
+    Logger::setDebugLevel(cliOpt.getOpt<CliOptIndex::DEBUG_LEVEL>());
+    if (cliOpt.getOpt<CliOptIndex::HELP_MANUAL>())
+    {
+        printUsage();
+        return 0;
+    }
+    // GameMap logs every action, INFO is left out of the way
+    Logger::setInfoEnabled(false);
+
+    const size_t numGames = std::max(cliOpt.getOpt<CliOptIndex::SIM_NUM_GAMES>(), 1);
+    const uint64_t seed = (cliOpt.getOpt<CliOptIndex::RANDOM_SEED>() != 0U) ? cliOpt.getOpt<CliOptIndex::RANDOM_SEED>() : \
+        static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    const std::shared_ptr<const BoardLayout> pLayout = MapIO(cliOpt.getOpt<CliOptIndex::MAP_FILE_PATH>()).readLayout();
+    if (pLayout == nullptr)
+    {
+        return 1;
+    }
+
+    // half of the seats greedy, half random, so that the rarer actions, e.g., knights, are played too
+    std::vector<std::unique_ptr<Agent> > agents;
+    for (size_t seat = 0U; seat < NUM_PLAYERS; ++seat)
+    {
+        agents.push_back(Agent::create(seat % 2U == 0U ? "greedy" : "random"));
+    }
+
+    size_t numActions = 0U;
+    for (size_t game = 0U; game < numGames; ++game)
+    {
+        GameMap map(pLayout, seed + game);
+        map.initMap();
+        map.addPlayer(NUM_PLAYERS);
+        std::shared_ptr<BoardTopology> pTopology = std::make_shared<BoardTopology>();
+        if (pTopology->init(map) != 0)
+        {
+            return 1;
+        }
+        const GameRules rules(pTopology);
+        RandomEngine engine(seed + game);
+        const std::string diff = checkGame(map, rules, agents, engine, numActions);
+        if (!diff.empty())
+        {
+            std::cout << "GameMap and GameRules differ in game " << game << ": " << diff << "\n" \
+                << "seed: " << seed << ", use --seed=" << seed << " to reproduce" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << numGames << " games, " << numActions << " actions, GameMap and GameRules agree, seed: " << seed << std::endl;
+    return 0;
+}
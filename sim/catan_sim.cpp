@@ -0,0 +1,283 @@
+/**
+ * Project: catan
+ * @file catan_sim.cpp
+ * @brief catan_sim.exe entry point, multithreaded self-play of headless games between agents
+ *        reports games/s, turns/s and the win rate of every agent
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <iostream>
+#include <iomanip>
+#include "cli_opt.hpp"
+#include "logger.hpp"
+#include "utility.hpp"
+#include "game_map.hpp"
+#include "map_file_io.hpp"
+#include "board_topology.hpp"
+#include "game_rules.hpp"
+#include "agent.hpp"
+
+struct SimStats_t
+{
+    size_t numGames;
+    size_t numTurns;
+    size_t numActions;
+    size_t numDraws;
+    std::array<size_t, constant::MAX_NUM_PLAYERS> winsByAgent;    // indexed by the position in --agents
+    std::array<size_t, constant::MAX_NUM_PLAYERS> winsBySeat;   // indexed by the order of play
+
+    void merge(const SimStats_t& aOther)
+    {
+        numGames += aOther.numGames;
+        numTurns += aOther.numTurns;
+        numActions += aOther.numActions;
+        numDraws += aOther.numDraws;
+        for (size_t index = 0U; index < constant::MAX_NUM_PLAYERS; ++index)
+        {
+            winsByAgent[index] += aOther.winsByAgent[index];
+            winsBySeat[index] += aOther.winsBySeat[index];
+        }
+    }
+};
+
+constexpr size_t NUM_LANES = 16U;  // games in flight per thread, decisions are batched across them
+
+// a game in flight
+struct SimLane_t
+{
+    size_t gameIndex;
+    bool isActive;
+    GameState_t state;
+    RandomEngine engine;
+    std::vector<GameAction_t> actions;
+};
+
+// the agent at the seat of the current player, agent K sits at seat (K + N) % numPlayers in game N
+static inline size_t currentAgent(const SimLane_t& aLane)
+{
+    const size_t numPlayers = aLane.state.numPlayers;
+    return (aLane.state.currentPlayer + numPlayers - aLane.gameIndex % numPlayers) % numPlayers;
+}
+
+/**
+ * play games until aNextGame reaches aNumGames, the thread owns its agents, states and engines,
+ * only aRules (immutable) is shared between threads
+ * NUM_LANES games are played side by side, every round each agent decides for all the lanes it is to act in
+ * with one Agent::chooseActions() call
+ * game N is seeded with aSeed + N and every decision draws from the engine of its game,
+ * i.e., the result depends neither on the num of threads nor on the batching
+ */
+static void playGames(const GameRules& aRules, const std::vector<std::string>& aAgentNames, const uint64_t aSeed,
+                      const size_t aNumGames, std::atomic<size_t>& aNextGame, SimStats_t& aStats)
+{
+    const size_t numPlayers = aAgentNames.size();
+    std::vector<std::unique_ptr<Agent> > agents;
+    for (const std::string& name : aAgentNames)
+    {
+        agents.push_back(Agent::create(name));
+    }
+
+    std::vector<SimLane_t> lanes(NUM_LANES);
+    std::vector<AgentQuery_t> queries;
+    std::vector<SimLane_t*> queryLanes;
+    std::vector<size_t> choices;
+    queries.reserve(NUM_LANES);
+    queryLanes.reserve(NUM_LANES);
+    aStats = SimStats_t();
+
+    size_t numActive = 0U;
+    bool hasMoreGames = true;
+    for (SimLane_t& lane : lanes)
+    {
+        lane.actions.reserve(GameRules::MAX_LEGAL_ACTIONS);
+        lane.isActive = false;
+    }
+    do
+    {
+        // start a new game in every idle lane
+        for (SimLane_t& lane : lanes)
+        {
+            if (lane.isActive || !hasMoreGames)
+            {
+                continue;
+            }
+            lane.gameIndex = aNextGame++;
+            if (lane.gameIndex >= aNumGames)
+            {
+                hasMoreGames = false;
+                continue;
+            }
+            lane.isActive = true;
+            ++numActive;
+            lane.engine.seed(aSeed + lane.gameIndex);
+            aRules.newGame(lane.state, numPlayers, lane.engine);
+            aRules.getLegalActions(lane.state, lane.actions);
+        }
+
+        for (size_t agentIndex = 0U; agentIndex < numPlayers; ++agentIndex)
+        {
+            queries.clear();
+            queryLanes.clear();
+            for (SimLane_t& lane : lanes)
+            {
+                if (lane.isActive && currentAgent(lane) == agentIndex)
+                {
+                    queries.push_back(AgentQuery_t{&lane.state, &lane.actions, &lane.engine});
+                    queryLanes.push_back(&lane);
+                }
+            }
+            if (queries.empty())
+            {
+                continue;
+            }
+            agents[agentIndex]->chooseActions(aRules, queries, choices);
+
+            for (size_t index = 0U; index < queryLanes.size(); ++index)
+            {
+                SimLane_t& lane = *queryLanes[index];
+                aRules.applyAction(lane.state, lane.actions[choices[index]], lane.engine);
+                aRules.getLegalActions(lane.state, lane.actions);
+                ++aStats.numActions;
+                if (!lane.actions.empty())
+                {
+                    continue;
+                }
+
+                // game over
+                lane.isActive = false;
+                --numActive;
+                ++aStats.numGames;
+                aStats.numTurns += lane.state.turn;
+                if (lane.state.winner == NO_PLAYER)
+                {
+                    ++aStats.numDraws;
+                }
+                else
+                {
+                    ++aStats.winsBySeat[lane.state.winner];
+                    ++aStats.winsByAgent[(lane.state.winner + numPlayers - lane.gameIndex % numPlayers) % numPlayers];
+                }
+            }
+        }
+    } while (numActive > 0U);
+}
+
+static void printUsage()
+{
+    std::cout << "Usage: catan_sim [--games=N] [--threads=N] [--agents=name,name,...] [--seed=N] [--map=FILE] [--debug=N]\n" \
+        << "  --games    num of games to play, default 1000\n" \
+        << "  --threads  num of threads, default 0 (one per core)\n" \
+        << "  --agents   2 to " << constant::MAX_NUM_PLAYERS << " of: random, greedy, mcts[:iterations[:trees[:threads per tree[:time ms]]]];\n" \
+        << "             default greedy,random,random,random\n" \
+        << "  --seed     seed of the games, the same seed replays the same games, default 0 (system clock)\n" \
+        << "  --map      map file, default map if not provided" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    Logger::initLogger();
+
+    CliOpt cliOpt;
+    cliOpt.processArg(argc, argv);
+    Logger::setDebugLevel(cliOpt.getOpt<CliOptIndex::DEBUG_LEVEL>());
+    if (cliOpt.getOpt<CliOptIndex::HELP_MANUAL>())
+    {
+        printUsage();
+        return 0;
+    }
+
+    const std::vector<std::string> agentNames = splitString(cliOpt.getOpt<CliOptIndex::SIM_AGENTS>(), ',');
+    if (agentNames.size() < 2U || agentNames.size() > constant::MAX_NUM_PLAYERS)
+    {
+        WARN_LOG("2 to ", constant::MAX_NUM_PLAYERS, " agents are required, got: ", agentNames.size());
+        return 1;
+    }
+    for (const std::string& name : agentNames)
+    {
+        if (!Agent::create(name))
+        {
+            WARN_LOG("Unknown agent: " + name);
+            return 1;
+        }
+    }
+    const size_t numGames = std::max(cliOpt.getOpt<CliOptIndex::SIM_NUM_GAMES>(), 0);
+    size_t numThreads = std::max(cliOpt.getOpt<CliOptIndex::SIM_NUM_THREADS>(), 0);
+    if (numThreads == 0U)
+    {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    // the map is only used to build the topology, games do not touch it
+    const std::shared_ptr<const BoardLayout> pLayout = MapIO(cliOpt.getOpt<CliOptIndex::MAP_FILE_PATH>()).readLayout();
+    if (pLayout == nullptr)
+    {
+        return 1;
+    }
+    GameMap gameMap(pLayout, cliOpt.getOpt<CliOptIndex::RANDOM_SEED>());
+    if (gameMap.initMap() != 0)
+    {
+        return 1;
+    }
+    std::shared_ptr<BoardTopology> topology = std::make_shared<BoardTopology>();
+    if (topology->init(gameMap) != 0)
+    {
+        return 1;
+    }
+    const GameRules rules(topology);
+    const uint64_t seed = gameMap.getSeed();
+
+    INFO_LOG("Playing ", numGames, " games on ", numThreads, " threads, agents: ", agentNames);
+    std::atomic<size_t> nextGame(0U);
+    std::vector<SimStats_t> threadStats(numThreads);
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t threadIndex = 0U; threadIndex < numThreads; ++threadIndex)
+    {
+        threads.emplace_back(playGames, std::cref(rules), std::cref(agentNames), seed, numGames, \
+                             std::ref(nextGame), std::ref(threadStats[threadIndex]));
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    SimStats_t stats = SimStats_t();
+    for (const SimStats_t& threadStat : threadStats)
+    {
+        stats.merge(threadStat);
+    }
+
+    const double seconds = std::max(elapsed.count(), 1e-9);
+    std::cout << std::fixed << std::setprecision(1) \
+        << stats.numGames << " games, " << stats.numTurns << " turns, " << stats.numActions << " actions in " \
+        << std::setprecision(3) << elapsed.count() << "s on " << numThreads << " threads\n" \
+        << std::setprecision(1) \
+        << std::setw(12) << stats.numGames / seconds << " games/s\n" \
+        << std::setw(12) << stats.numTurns / seconds << " turns/s\n" \
+        << std::setw(12) << stats.numActions / seconds << " actions/s\n" \
+        << "avg turns per game: " << (stats.numGames > 0U ? static_cast<double>(stats.numTurns) / stats.numGames : 0.0) \
+        << ", draws (no winner in " << constant::MAX_TURNS << " turns): " << stats.numDraws << "\n";
+
+    const double numGamesDivisor = std::max<double>(stats.numGames, 1.0) / 100.0;
+    std::cout << "win rate by agent:\n";
+    for (size_t agentIndex = 0U; agentIndex < agentNames.size(); ++agentIndex)
+    {
+        std::cout << "  #" << agentIndex << " " << std::left << std::setw(8) << agentNames[agentIndex] << std::right \
+            << std::setw(7) << stats.winsByAgent[agentIndex] / numGamesDivisor << "%\n";
+    }
+    std::cout << "win rate by seat:\n";
+    for (size_t seat = 0U; seat < agentNames.size(); ++seat)
+    {
+        std::cout << "  seat " << seat << std::setw(12) << stats.winsBySeat[seat] / numGamesDivisor << "%\n";
+    }
+    std::cout << "seed: " << seed << ", use --seed=" << seed << " to reproduce" << std::endl;
+    return 0;
+}
@@ -0,0 +1,148 @@
+/**
+ * Project: catan
+ * @file catan_tournament.cpp
+ * @brief catan_tournament.exe entry point, round-robin tournament of two-player games between agents
+ *        on a work-stealing thread pool, reports Elo and TrueSkill ratings
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <iostream>
+#include <iomanip>
+#include "cli_opt.hpp"
+#include "logger.hpp"
+#include "utility.hpp"
+#include "game_map.hpp"
+#include "map_file_io.hpp"
+#include "board_topology.hpp"
+#include "game_rules.hpp"
+#include "tournament.hpp"
+
+constexpr size_t MAX_NUM_AGENTS = 64U;
+
+static void printUsage()
+{
+    std::cout << "Usage: catan_tournament [--games=N] [--threads=N] [--agents=name,name,...] [--seed=N] [--map=FILE] [--debug=N]\n" \
+        << "  --games    num of games per pair of agents, the agents take turns to move first, default 1000\n" \
+        << "  --threads  num of threads, default 0 (one per core)\n" \
+        << "  --agents   2 to " << MAX_NUM_AGENTS << " of: random, greedy, mcts[:iterations[:trees[:threads per tree[:time ms]]]];\n" \
+        << "             the same name may appear more than once\n" \
+        << "  --seed     master seed, the same seed gives the same ratings for any num of threads, default 0 (system clock)\n" \
+        << "  --map      map file, default map if not provided" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    Logger::initLogger();
+
+    CliOpt cliOpt;
+    cliOpt.processArg(argc, argv);
+    Logger::setDebugLevel(cliOpt.getOpt<CliOptIndex::DEBUG_LEVEL>());
+    if (cliOpt.getOpt<CliOptIndex::HELP_MANUAL>())
+    {
+        printUsage();
+        return 0;
+    }
+
+    const std::vector<std::string> agentNames = splitString(cliOpt.getOpt<CliOptIndex::SIM_AGENTS>(), ',');
+    if (agentNames.size() < 2U || agentNames.size() > MAX_NUM_AGENTS)
+    {
+        WARN_LOG("2 to ", MAX_NUM_AGENTS, " agents are required, got: ", agentNames.size());
+        return 1;
+    }
+    const size_t gamesPerPair = std::max(cliOpt.getOpt<CliOptIndex::SIM_NUM_GAMES>(), 0);
+
+    // the map is only used to build the topology, games do not touch it
+    const std::shared_ptr<const BoardLayout> pLayout = MapIO(cliOpt.getOpt<CliOptIndex::MAP_FILE_PATH>()).readLayout();
+    if (pLayout == nullptr)
+    {
+        return 1;
+    }
+    GameMap gameMap(pLayout, cliOpt.getOpt<CliOptIndex::RANDOM_SEED>());
+    if (gameMap.initMap() != 0)
+    {
+        return 1;
+    }
+    std::shared_ptr<BoardTopology> topology = std::make_shared<BoardTopology>();
+    if (topology->init(gameMap) != 0)
+    {
+        return 1;
+    }
+    const GameRules rules(topology);
+    const uint64_t seed = gameMap.getSeed();
+
+    WorkStealingPool pool(std::max(cliOpt.getOpt<CliOptIndex::SIM_NUM_THREADS>(), 0));
+    Tournament tournament(rules, agentNames);
+    INFO_LOG("Playing ", gamesPerPair, " games per pair on ", pool.getNumWorkers(), " threads, agents: ", agentNames);
+    const auto start = std::chrono::steady_clock::now();
+    if (tournament.run(gamesPerPair, seed, pool) != 0)
+    {
+        return 1;
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const double seconds = std::max(elapsed.count(), 1e-9);
+
+    std::cout << std::fixed << std::setprecision(1) \
+        << tournament.getNumGames() << " games, " << tournament.getNumTurns() << " turns in " \
+        << std::setprecision(3) << elapsed.count() << "s on " << pool.getNumWorkers() << " threads, " \
+        << pool.getNumSteals() << " games stolen\n" \
+        << std::setprecision(1) \
+        << std::setw(12) << tournament.getNumGames() / seconds << " games/s\n" \
+        << std::setw(12) << tournament.getNumTurns() / seconds << " turns/s\n";
+
+    // best Elo first
+    const std::vector<TournamentRating_t>& ratings = tournament.getRatings();
+    std::vector<size_t> order(agentNames.size());
+    std::iota(order.begin(), order.end(), 0U);
+    std::stable_sort(order.begin(), order.end(), [&ratings](const size_t aLhs, const size_t aRhs) {
+            return ratings[aLhs].elo > ratings[aRhs].elo;
+        });
+    const size_t nameWidth = std::max_element(agentNames.begin(), agentNames.end(),
+        [](const std::string& aLhs, const std::string& aRhs) {
+            return aLhs.size() < aRhs.size();
+        })->size() + 2U;
+
+    std::cout << "  #  " << std::left << std::setw(nameWidth) << "agent" << std::right \
+        << std::setw(8) << "games" << std::setw(8) << "win%" << std::setw(8) << "draws" \
+        << std::setw(9) << "Elo" << std::setw(8) << "mu" << std::setw(8) << "sigma" << std::setw(8) << "mu-3s" << "\n";
+    for (const size_t agentIndex : order)
+    {
+        const TournamentRating_t& rating = ratings[agentIndex];
+        std::cout << std::setw(3) << agentIndex << "  " << std::left << std::setw(nameWidth) << agentNames[agentIndex] << std::right \
+            << std::setw(8) << rating.numGames \
+            << std::setw(8) << 100.0 * rating.numWins / std::max<double>(rating.numGames, 1.0) \
+            << std::setw(8) << rating.numDraws \
+            << std::setw(9) << rating.elo \
+            << std::setprecision(2) << std::setw(8) << rating.mu << std::setw(8) << rating.sigma \
+            << std::setw(8) << rating.mu - 3.0 * rating.sigma << std::setprecision(1) << "\n";
+    }
+
+    std::cout << "win% of row against column:\n     ";
+    for (size_t column = 0U; column < agentNames.size(); ++column)
+    {
+        std::cout << std::setw(7) << column;
+    }
+    std::cout << "\n";
+    for (size_t row = 0U; row < agentNames.size(); ++row)
+    {
+        std::cout << std::setw(3) << row << "  ";
+        for (size_t column = 0U; column < agentNames.size(); ++column)
+        {
+            if (row == column)
+            {
+                std::cout << std::setw(7) << "-";
+                continue;
+            }
+            std::cout << std::setw(7) << 100.0 * tournament.getNumWins(row, column) / std::max<double>(gamesPerPair, 1.0);
+        }
+        std::cout << "\n";
+    }
+    std::cout << "seed: " << seed << ", use --seed=" << seed << " to reproduce" << std::endl;
+    return 0;
+}
@@ -0,0 +1,376 @@
+/**
+ * Project: catan
+ * @file action_journal.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include "action_journal.hpp"
+#include "game_map.hpp"
+#include "logger.hpp"
+#include "little_endian.hpp"
+
+int ActionJournal::open(const std::string& aFilename, const GameMap& aMap)
+{
+    close();
+    mFile.open(aFilename, std::ios::binary | std::ios::trunc);
+    if (!mFile.is_open())
+    {
+        WARN_LOG("Cannot open journal file: " + aFilename);
+        return 1;
+    }
+    std::vector<uint8_t> board;
+    aMap.exportBoard(board);
+
+    writeUint(mFile, MAGIC);
+    writeUint(mFile, VERSION);
+    writeUint(mFile, static_cast<uint16_t>(aMap.getNumOfPlayers()));
+    writeUint(mFile, static_cast<uint32_t>(board.size()));
+    mFile.write(reinterpret_cast<const char*>(board.data()), board.size());
+    mFile.flush();
+
+    mMap = &aMap;
+    mBufferIndex = 0U;
+    mNumEvents = 0U;
+    mOffset = static_cast<uint64_t>(mFile.tellp());
+    mTurnIndex.clear();
+
+    // the state at the beginning, so that turn 0 can be seeked like any other turn
+    checkpoint();
+    mTurnIndex.push_back(JournalTurnIndex_t{mOffset, mLastCheckpoint});
+
+    INFO_LOG("Recording journal to " + aFilename + ", board size: ", board.size(), " bytes, checkpoint every ", \
+                mCheckpointInterval, " events");
+    return 0;
+}
+
+void ActionJournal::record(const JournalEventType aType, const uint8_t aAux, const uint16_t aId)
+{
+    if (!mFile.is_open())
+    {
+        return;
+    }
+    const JournalEvent_t event{aType, aAux, aId};
+    append(&event, 1U);
+    ++mNumEvents;
+
+    if (++mEventsSinceCheckpoint >= mCheckpointInterval)
+    {
+        checkpoint();
+    }
+    if (aType == JournalEventType::NEXT_PLAYER)
+    {
+        // a checkpoint written right above belongs to the new turn already
+        mTurnIndex.push_back(JournalTurnIndex_t{mOffset, mLastCheckpoint});
+    }
+}
+
+void ActionJournal::append(const void* const aData, const size_t aNumWords)
+{
+    const JournalEvent_t* const pWords = static_cast<const JournalEvent_t*>(aData);
+    for (size_t ii = 0U; ii < aNumWords; ++ii)
+    {
+        mBuffer[mBufferIndex++] = pWords[ii];
+        if (mBufferIndex == BUFFER_SIZE)
+        {
+            flush();
+        }
+    }
+    mOffset += aNumWords * sizeof(JournalEvent_t);
+}
+
+void ActionJournal::checkpoint()
+{
+    mMap->exportState(mState);
+    // pad to whole words so that the events after the checkpoint stay aligned
+    mState.resize((mState.size() + sizeof(JournalEvent_t) - 1U) / sizeof(JournalEvent_t) * sizeof(JournalEvent_t), 0U);
+    const size_t numWords = mState.size() / sizeof(JournalEvent_t);
+    if (numWords > UINT16_MAX)
+    {
+        ERROR_LOG("Game state is too large to be checkpointed: ", mState.size(), " bytes");
+    }
+
+    mLastCheckpoint = mOffset;
+    const JournalEvent_t event{JournalEventType::CHECKPOINT, 0U, static_cast<uint16_t>(numWords)};
+    append(&event, 1U);
+    append(mState.data(), numWords);
+    mEventsSinceCheckpoint = 0U;
+}
+
+void ActionJournal::flush()
+{
+    if (!mFile.is_open() || mBufferIndex == 0U)
+    {
+        return;
+    }
+    mFile.write(reinterpret_cast<const char*>(mBuffer.data()), mBufferIndex * sizeof(JournalEvent_t));
+    mFile.flush();
+    mBufferIndex = 0U;
+}
+
+void ActionJournal::close()
+{
+    if (mFile.is_open())
+    {
+        flush();
+        mFile.write(reinterpret_cast<const char*>(mTurnIndex.data()), mTurnIndex.size() * sizeof(JournalTurnIndex_t));
+        writeUint(mFile, mOffset);
+        writeUint(mFile, static_cast<uint64_t>(mNumEvents));
+        writeUint(mFile, static_cast<uint32_t>(mTurnIndex.size()));
+        writeUint(mFile, INDEX_MAGIC);
+        mFile.close();
+        INFO_LOG("Journal closed, recorded ", mNumEvents, " events, ", mTurnIndex.size(), " turns");
+    }
+}
+
+bool ActionJournal::isOpen() const
+{
+    return mFile.is_open();
+}
+
+size_t ActionJournal::getNumEvents() const
+{
+    return mNumEvents;
+}
+
+ActionJournal::ActionJournal(const size_t aCheckpointInterval) :
+    mBufferIndex(0U),
+    mNumEvents(0U),
+    mMap(nullptr),
+    mCheckpointInterval(std::max<size_t>(aCheckpointInterval, 1U)),
+    mEventsSinceCheckpoint(0U),
+    mOffset(0U),
+    mLastCheckpoint(0U)
+{
+    // empty
+}
+
+ActionJournal::~ActionJournal()
+{
+    close();
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+
+int ReplayEngine::load(const std::string& aFilename)
+{
+    std::ifstream file(aFilename, std::ios::binary);
+    if (!file.is_open())
+    {
+        WARN_LOG("Cannot open journal file: " + aFilename);
+        return 1;
+    }
+
+    uint32_t magic = 0U;
+    uint16_t version = 0U;
+    uint16_t numPlayers = 0U;
+    uint32_t boardSize = 0U;
+    if (!readUint(file, magic) || !readUint(file, version) || !readUint(file, numPlayers) || !readUint(file, boardSize) \
+        || magic != ActionJournal::MAGIC || version != ActionJournal::VERSION)
+    {
+        WARN_LOG("Incorrect journal header in " + aFilename, ", magic: ", magic, ", version: ", version);
+        return 2;
+    }
+    mNumPlayers = numPlayers;
+    mBoard.resize(boardSize);
+    if (!file.read(reinterpret_cast<char*>(mBoard.data()), boardSize))
+    {
+        WARN_LOG("Truncated board in journal " + aFilename);
+        return 2;
+    }
+
+    const std::streamoff bodyStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streamoff fileSize = file.tellg();
+    std::streamoff bodyEnd = fileSize;
+    const bool hasIndex = (loadIndex(file, bodyStart, fileSize, bodyEnd) == 0);
+
+    const std::streamoff bodySize = bodyEnd - bodyStart;
+    if (bodySize % sizeof(JournalEvent_t) != 0)
+    {
+        WARN_LOG("Journal " + aFilename + " has a truncated event at the end, discarded");
+    }
+    mRecords.resize(bodySize / sizeof(JournalEvent_t));
+    file.clear();
+    file.seekg(bodyStart);
+    file.read(reinterpret_cast<char*>(mRecords.data()), mRecords.size() * sizeof(JournalEvent_t));
+
+    if (!hasIndex)
+    {
+        WARN_LOG("Journal " + aFilename + " has no index, was the game closed properly? rebuilding the index");
+        rebuildIndex();
+    }
+
+    INFO_LOG("Loaded journal " + aFilename + ", players: ", mNumPlayers, ", events: ", mNumEvents, ", turns: ", mTurnIndex.size());
+    return 0;
+}
+
+int ReplayEngine::loadIndex(std::istream& aFile, const std::streamoff aBodyStart, const std::streamoff aFileSize, std::streamoff& aBodyEnd)
+{
+    constexpr std::streamoff FOOTER_SIZE = sizeof(uint64_t) + sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint32_t);
+    if (aFileSize - aBodyStart < FOOTER_SIZE)
+    {
+        return 1;
+    }
+
+    uint64_t bodyEnd = 0U;
+    uint64_t numEvents = 0U;
+    uint32_t numTurns = 0U;
+    uint32_t magic = 0U;
+    aFile.seekg(aFileSize - FOOTER_SIZE);
+    if (!readUint(aFile, bodyEnd) || !readUint(aFile, numEvents) || !readUint(aFile, numTurns) || !readUint(aFile, magic) \
+        || magic != ActionJournal::INDEX_MAGIC || bodyEnd < static_cast<uint64_t>(aBodyStart) \
+        || bodyEnd + numTurns * sizeof(JournalTurnIndex_t) + FOOTER_SIZE != static_cast<uint64_t>(aFileSize))
+    {
+        return 1;
+    }
+
+    std::vector<JournalTurnIndex_t> turnIndex(numTurns);
+    aFile.seekg(bodyEnd);
+    if (!aFile.read(reinterpret_cast<char*>(turnIndex.data()), numTurns * sizeof(JournalTurnIndex_t)))
+    {
+        return 1;
+    }
+
+    mTurnIndex.clear();
+    for (const JournalTurnIndex_t& entry : turnIndex)
+    {
+        if (entry.eventOffset < static_cast<uint64_t>(aBodyStart) || entry.eventOffset > bodyEnd \
+            || entry.checkpointOffset < static_cast<uint64_t>(aBodyStart) || entry.checkpointOffset > entry.eventOffset)
+        {
+            WARN_LOG("Incorrect turn index, eventOffset: ", entry.eventOffset, ", checkpointOffset: ", entry.checkpointOffset);
+            return 1;
+        }
+        mTurnIndex.emplace_back((entry.eventOffset - aBodyStart) / sizeof(JournalEvent_t), \
+                                (entry.checkpointOffset - aBodyStart) / sizeof(JournalEvent_t));
+    }
+    mNumEvents = numEvents;
+    aBodyEnd = bodyEnd;
+    return 0;
+}
+
+void ReplayEngine::rebuildIndex()
+{
+    mTurnIndex.clear();
+    mNumEvents = 0U;
+    size_t lastCheckpoint = 0U;
+    for (size_t index = 0U; index < mRecords.size(); ++index)
+    {
+        const JournalEvent_t& record = mRecords[index];
+        if (record.type == JournalEventType::CHECKPOINT)
+        {
+            lastCheckpoint = index;
+            index += record.id;
+            if (mTurnIndex.empty())
+            {
+                mTurnIndex.emplace_back(index + 1U, lastCheckpoint);
+            }
+            continue;
+        }
+        ++mNumEvents;
+        if (record.type == JournalEventType::NEXT_PLAYER)
+        {
+            // a checkpoint, if any, follows the event that triggers it
+            const size_t next = index + 1U;
+            const bool isCheckpointNext = (next < mRecords.size() && mRecords[next].type == JournalEventType::CHECKPOINT);
+            mTurnIndex.emplace_back(isCheckpointNext ? next + 1U + mRecords[next].id : next, \
+                                    isCheckpointNext ? next : lastCheckpoint);
+        }
+    }
+}
+
+int ReplayEngine::prepareMap(GameMap& aMap) const
+{
+    if (aMap.getNumOfPlayers() == 0U)
+    {
+        aMap.addPlayer(mNumPlayers);
+    }
+    if (aMap.getNumOfPlayers() != mNumPlayers)
+    {
+        WARN_LOG("Number of players mismatch, journal: ", mNumPlayers, ", map: ", aMap.getNumOfPlayers());
+        return 1;
+    }
+    return aMap.importBoard(mBoard);
+}
+
+int ReplayEngine::replayRange(GameMap& aMap, const size_t aBegin, const size_t aEnd, size_t& aNumEvents) const
+{
+    aNumEvents = 0U;
+    const size_t end = std::min(aEnd, mRecords.size());
+    for (size_t index = aBegin; index < end; ++index)
+    {
+        const JournalEvent_t& record = mRecords[index];
+        if (record.type == JournalEventType::CHECKPOINT)
+        {
+            index += record.id;
+            continue;
+        }
+        if (aMap.replayEvent(record) != 0)
+        {
+            WARN_LOG("Failed to replay record#", index, ", type: ", static_cast<int>(record.type), \
+                        ", aux: ", static_cast<int>(record.aux), ", id: ", record.id);
+            return 1;
+        }
+        ++aNumEvents;
+    }
+    return 0;
+}
+
+size_t ReplayEngine::replay(GameMap& aMap) const
+{
+    size_t numEvents = 0U;
+    replayRange(aMap, 0U, mRecords.size(), numEvents);
+    return numEvents;
+}
+
+int ReplayEngine::seek(GameMap& aMap, const size_t aTurn, size_t& aNumEvents) const
+{
+    aNumEvents = 0U;
+    if (aTurn >= mTurnIndex.size())
+    {
+        WARN_LOG("Turn ", aTurn, " is out of range, num of turns: ", mTurnIndex.size());
+        return 1;
+    }
+
+    const size_t checkpoint = mTurnIndex[aTurn].second;
+    const size_t stateBegin = checkpoint + 1U;
+    if (checkpoint >= mRecords.size() || mRecords[checkpoint].type != JournalEventType::CHECKPOINT \
+        || stateBegin + mRecords[checkpoint].id > mRecords.size())
+    {
+        WARN_LOG("Incorrect checkpoint at record#", checkpoint, " for turn ", aTurn);
+        return 2;
+    }
+    const size_t stateEnd = stateBegin + mRecords[checkpoint].id;
+    const std::vector<uint8_t> state(reinterpret_cast<const uint8_t*>(mRecords.data() + stateBegin), \
+                                     reinterpret_cast<const uint8_t*>(mRecords.data() + stateEnd));
+    if (aMap.importState(state) != 0)
+    {
+        return 2;
+    }
+    return (replayRange(aMap, stateEnd, mTurnIndex[aTurn].first, aNumEvents) == 0) ? 0 : 3;
+}
+
+size_t ReplayEngine::getNumPlayers() const
+{
+    return mNumPlayers;
+}
+
+size_t ReplayEngine::getNumEvents() const
+{
+    return mNumEvents;
+}
+
+size_t ReplayEngine::getNumTurns() const
+{
+    return mTurnIndex.size();
+}
+
+ReplayEngine::ReplayEngine() :
+    mNumPlayers(0U),
+    mNumEvents(0U)
+{
+    // empty
+}
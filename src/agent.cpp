@@ -0,0 +1,225 @@
+/**
+ * Project: catan
+ * @file agent.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include "agent.hpp"
+#include "mcts_agent.hpp"
+#include "utility.hpp"
+
+namespace
+{
+
+// priorities of GreedyAgent, END_TURN is 0, negative scores are never chosen over END_TURN
+constexpr int SCORE_CITY = 1000;
+constexpr int SCORE_SETTLEMENT = 800;
+constexpr int SCORE_KNIGHT_UNBLOCK = 600;  // the robber is on a land of the agent
+constexpr int SCORE_DEV_CARD = 400;
+constexpr int SCORE_ROAD = 300;
+constexpr int SCORE_ROLL_DICE = 300;
+constexpr int SCORE_TRADE = 150;
+constexpr int SCORE_KNIGHT = 100;
+
+} // namespace
+
+std::unique_ptr<Agent> Agent::create(const std::string& aName)
+{
+    if (aName == "random")
+    {
+        return std::make_unique<RandomAgent>();
+    }
+    else if (aName == "greedy")
+    {
+        return std::make_unique<GreedyAgent>();
+    }
+    else if (aName.compare(0U, 4U, "mcts") == 0)
+    {
+        // mcts[:iterations[:trees[:threads per tree[:time limit ms]]]]
+        const std::vector<std::string> params = splitString(aName, ':');
+        if (params[0] != "mcts" || params.size() > 5U)
+        {
+            return nullptr;
+        }
+        MctsConfig_t config = MctsAgent::defaultConfig();
+        std::array<size_t*, 4U> fields = {&config.iterations, &config.numTrees, &config.threadsPerTree, &config.timeLimitMs};
+        for (size_t index = 1U; index < params.size(); ++index)
+        {
+            int value = 0;
+            if (!stringToInteger(params[index], value) || value < 0)
+            {
+                return nullptr;
+            }
+            *fields[index - 1U] = value;
+        }
+        if (config.numTrees == 0U || config.threadsPerTree == 0U || (config.iterations == 0U && config.timeLimitMs == 0U))
+        {
+            return nullptr;
+        }
+        return std::make_unique<MctsAgent>(config);
+    }
+    return nullptr;
+}
+
+void Agent::chooseActions(const GameRules& aRules, const std::vector<AgentQuery_t>& aQueries, std::vector<size_t>& aChoices)
+{
+    aChoices.resize(aQueries.size());
+    for (size_t index = 0U; index < aQueries.size(); ++index)
+    {
+        const AgentQuery_t& query = aQueries[index];
+        aChoices[index] = chooseAction(aRules, *query.state, *query.actions, *query.engine);
+    }
+}
+
+Agent::~Agent()
+{
+}
+
+size_t RandomAgent::chooseAction(const GameRules& aRules, const GameState_t& aState,
+                               const std::vector<GameAction_t>& aActions, RandomEngine& aEngine)
+{
+    return uniformBelow(aEngine, aActions.size());
+}
+
+std::string RandomAgent::getName() const
+{
+    return "random";
+}
+
+size_t GreedyAgent::chooseAction(const GameRules& aRules, const GameState_t& aState,
+                               const std::vector<GameAction_t>& aActions, RandomEngine& aEngine)
+{
+    size_t best = 0U;
+    int bestScore = scoreAction(aRules, aState, aActions[0]);
+    for (size_t index = 1U; index < aActions.size(); ++index)
+    {
+        const int score = scoreAction(aRules, aState, aActions[index]);
+        if (score > bestScore)
+        {
+            best = index;
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+std::string GreedyAgent::getName() const
+{
+    return "greedy";
+}
+
+int GreedyAgent::scoreVertex(const GameRules& aRules, const GameState_t& aState, const size_t aVertexId) const
+{
+    const BoardTopology::VertexInfo_t& vertex = aRules.getTopology().getVertex(aVertexId);
+    int score = (vertex.harbour != static_cast<int8_t>(ResourceTypes::NONE)) ? 1 : 0;
+    uint32_t resources = 0U;
+    for (const uint8_t landId : vertex.lands)
+    {
+        if (landId != BoardTopology::NO_ID && landId != aState.robLandId)
+        {
+            score += constant::dicePips(aState.landDice[landId]);
+            resources |= 1U << aState.landResource[landId];
+        }
+    }
+    // prefer diversity
+    for (size_t resource = 0U; resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+    {
+        score += (resources >> resource) & 1U;
+    }
+    return score;
+}
+
+int GreedyAgent::scoreRobber(const GameRules& aRules, const GameState_t& aState, const GameAction_t& aAction) const
+{
+    int score = 0;
+    const int land = constant::dicePips(aState.landDice[aAction.id]);
+    for (const uint8_t vertex : aRules.getTopology().getLand(aAction.id).vertices)
+    {
+        const int owner = (vertex != BoardTopology::NO_ID) ? aState.vertexOwner[vertex] : -1;
+        if (owner == aState.currentPlayer)
+        {
+            score -= 100;
+        }
+        else if (owner != -1)
+        {
+            // block the leader
+            score += aState.colony[vertex] * land * (1 + static_cast<int>(aRules.getVictoryPoint(aState, owner)));
+        }
+    }
+    return score + ((aAction.aux != NO_PLAYER) ? 1 : 0);
+}
+
+int GreedyAgent::scoreAction(const GameRules& aRules, const GameState_t& aState, const GameAction_t& aAction) const
+{
+    const BoardTopology& topology = aRules.getTopology();
+    const PlayerState_t& player = aState.players[aState.currentPlayer];
+    switch (aAction.type)
+    {
+    case GameActionType::BUILD_CITY:
+        return SCORE_CITY + scoreVertex(aRules, aState, aAction.id);
+    case GameActionType::BUILD_SETTLEMENT:
+        return SCORE_SETTLEMENT + scoreVertex(aRules, aState, aAction.id);
+    case GameActionType::BUY_DEV_CARD:
+        return SCORE_DEV_CARD;
+    case GameActionType::BUILD_ROAD:
+    {
+        // only build towards a vertex where a settlement can be placed, one or two edges away
+        int best = -1;
+        for (const uint8_t end : topology.getEdge(aAction.id).vertices)
+        {
+            if (aState.vertexOwner[end] != -1)
+            {
+                continue;
+            }
+            bool isFree = true;
+            for (const uint8_t next : topology.getVertex(end).vertices)
+            {
+                if (next == BoardTopology::NO_ID || aState.vertexOwner[next] == -1)
+                {
+                    continue;
+                }
+                isFree = false;
+            }
+            if (isFree)
+            {
+                best = std::max(best, SCORE_ROAD + scoreVertex(aRules, aState, end));
+            }
+            for (const uint8_t next : topology.getVertex(end).vertices)
+            {
+                if (next != BoardTopology::NO_ID && aState.vertexOwner[next] == -1)
+                {
+                    best = std::max(best, SCORE_ROAD / 2 + scoreVertex(aRules, aState, next));
+                }
+            }
+        }
+        return best;
+    }
+    case GameActionType::PLAY_KNIGHT:
+    {
+        bool isBlocked = false;
+        for (const uint8_t vertex : topology.getLand(aState.robLandId).vertices)
+        {
+            isBlocked |= (vertex != BoardTopology::NO_ID && aState.vertexOwner[vertex] == aState.currentPlayer);
+        }
+        return (isBlocked ? SCORE_KNIGHT_UNBLOCK : SCORE_KNIGHT) + scoreRobber(aRules, aState, aAction);
+    }
+    case GameActionType::MOVE_ROBBER:
+        return scoreRobber(aRules, aState, aAction);
+    case GameActionType::ROLL_DICE:
+        return SCORE_ROLL_DICE;
+    case GameActionType::BANK_TRADE:
+    {
+        // trade the surplus for a resource not on hand, never trades back
+        const size_t give = aAction.aux >> 4;
+        const size_t take = aAction.aux & 0x0FU;
+        const size_t ratio = aRules.getTradeRatio(aState, aState.currentPlayer, static_cast<ResourceTypes>(give));
+        return (player.resources[take] == 0U && player.resources[give] > ratio) ? SCORE_TRADE : -1;
+    }
+    case GameActionType::END_TURN:
+    default:
+        return 0;
+    }
+}
@@ -21,7 +21,7 @@ Blank* Blank::getBlank()
     return mBlank;
 }
 
-char Blank::getCharRepresentation(const size_t aPointX, const size_t aPointY, const bool aUseId) const
+char Blank::getCharRepresentation(const size_t aPointX, const size_t aPointY, const BoardState_t& aState, const bool aUseId) const
 {
     return ' ';
 }
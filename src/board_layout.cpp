@@ -0,0 +1,535 @@
+/**
+ * Project: catan
+ * @file board_layout.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <unordered_map>
+#include <algorithm>
+#include "logger.hpp"
+#include "utility.hpp"
+#include "board_layout.hpp"
+#include "blank.hpp"
+#include "constant.hpp"
+
+void BoardLayout::fillInBlank()
+{
+    // traverse map, replace nullptr with Blank*
+    for (size_t jj = 0; jj < mSizeVertical; ++jj)
+    {
+        std::deque<Terrain*>& row = mGameMap.at(jj);
+        for (size_t ii = 0; ii < mSizeHorizontal; ++ii)
+        {
+            if (row.at(ii) == nullptr)
+            {
+                row.at(ii) = Blank::getBlank();
+            }
+        }
+    }
+}
+
+int BoardLayout::populateMap()
+{
+    /* populate terrains
+     * order matters!!
+     * Land::populateAdjacencies adds necessary edges and vertices and records adjacent vertices
+     * Vertex::populateAdjacencies records connected edges and adjcent vertices
+     * Edge::populateAdjacencies require Vertex to know connected edges first
+     */
+
+    // return codes
+    int rcLand = 0;
+    int rcEdge = 0;
+    int rcVertex = 0;
+
+    for (Land* const pLand : mLands)
+    {
+        rcLand |= pLand->populateAdjacencies(*this);
+    }
+    rcLand ?
+        ERROR_LOG("Failed to populate adjacencies for Lands")
+        :
+        INFO_LOG("Successfully populated adjacencies of Lands");
+
+    for (Vertex* const pVertex : mVertices)
+    {
+        rcVertex |= pVertex->populateAdjacencies(*this);
+    }
+    rcVertex ?
+        ERROR_LOG("Failed to populate adjacencies for Vertices")
+        :
+        INFO_LOG("Successfully populated adjacencies of Vertices");
+
+    for (Edge* const pEdge : mEdges)
+    {
+        rcEdge |= pEdge->populateAdjacencies(*this);
+    }
+    rcEdge ?
+        ERROR_LOG("Failed to populate adjacencies for Edges")
+        :
+        INFO_LOG("Successfully populated adjacencies of Edges");
+
+    return (rcLand | rcEdge | rcVertex);
+}
+
+int BoardLayout::populateHarbours(bool aUseDefaultPosition)
+{
+    int rc = 0;
+    if (mLands.size() != constant::NUM_LANDS_DEFAULT)
+    {
+        // override to use ramdon position when not using the default map
+        aUseDefaultPosition = false;
+    }
+    if (aUseDefaultPosition)
+    {
+        INFO_LOG("using default position for harbours");
+        rc = createHarboursDefault();
+    }
+    else
+    {
+        INFO_LOG("using random position for harbours");
+        RandomEngine engine;
+        engine.seed(HARBOUR_SEED);
+        rc = createHarboursRandom(engine);
+    }
+
+    rc ?
+        WARN_LOG("Failed to create all harbours, created: ", mHarbours.size(), ", expected: ", mNumHarbour)
+        :
+        INFO_LOG("Successfully created all harbours");
+
+    for (Harbour* const pHarbour : mHarbours)
+    {
+        rc |= pHarbour->calculatePoints(*this);
+        pHarbour->registerToMap(*this);
+    }
+
+    rc ?
+        WARN_LOG("Failed to populateHarbours")
+        :
+        INFO_LOG("Successfully populated all harbours");
+    return rc;
+}
+
+int BoardLayout::createHarboursDefault()
+{
+    std::vector<int> harbourCandidates;
+    const Vertex* pVertex = nullptr;
+    for (Vertex* pVertexTemp : mVertices)
+    {
+        // reset harbours
+        pVertexTemp->setHarbour(nullptr);
+        // find a coastal vertex as the starting point
+        if ((pVertex == nullptr) && (pVertexTemp->isCoastal()))
+        {
+            harbourCandidates.push_back(pVertexTemp->getId());
+            pVertex = pVertexTemp;
+        }
+    }
+    if (!pVertex)
+    {
+        ERROR_LOG("Unable to find a string point");
+        return 1;
+    }
+    const Vertex* pPreviousVertex = pVertex;
+    do
+    {
+        for (const Vertex* const pNextVertex : pVertex->getAdjacentVertices())
+        {
+            if (pNextVertex == pPreviousVertex)
+            {
+                continue;
+            }
+            if (pNextVertex->isCoastal())
+            {
+                harbourCandidates.push_back(pNextVertex->getId());
+                pPreviousVertex = pVertex;
+                pVertex = pNextVertex;
+                break;
+            }
+        }
+    } while (pVertex->getId() != harbourCandidates.at(0));
+
+    const size_t gap[] = {1U, 1U, 2U};
+    size_t index = 0U;
+    while (mHarbours.size() < mNumHarbour && index + 1 < harbourCandidates.size())
+    {
+        addHarbour(harbourCandidates[index], harbourCandidates[index + 1]);
+        index += 2U + gap[mHarbours.size() % 3];
+    }
+
+    return (mHarbours.size() != mNumHarbour);
+}
+
+int BoardLayout::createHarboursRandom(RandomEngine& aEngine)
+{
+    if (mHarbours.size() >= mNumHarbour)
+    {
+        mNumHarbour = mHarbours.size();
+        return 0;
+    }
+    std::vector<int> harbourCandidates;
+    for (Vertex* const pVertex : mVertices)
+    {
+        if (pVertex->isCoastal() && !pVertex->hasHarbour())
+        {
+            harbourCandidates.push_back(pVertex->getId());
+        }
+    }
+    while (mHarbours.size() < mNumHarbour)
+    {
+        if (harbourCandidates.size() == 0U)
+        {
+            WARN_LOG("Unable to create ", mNumHarbour, " of harbours, current number of harbour ", mHarbours.size());
+            break;
+        }
+        // get a vertex from candidates
+        size_t index = uniformBelow(aEngine, harbourCandidates.size());
+        int idVertex = harbourCandidates[index];
+        if (mVertices[idVertex]->hasHarbour())
+        {
+            continue;
+        }
+        int idOtherVertex = -1;
+        for (const Vertex* const pVertex : mVertices[idVertex]->getAdjacentVertices())
+        {
+            if (pVertex->isCoastal() && !pVertex->hasHarbour())
+            {
+                idOtherVertex = pVertex->getId();
+                break;
+            }
+        }
+        if (idOtherVertex != -1)
+        {
+            // found a valid pair for harbour
+            addHarbour(idVertex, idOtherVertex);
+            harbourCandidates.erase(std::remove(harbourCandidates.begin(), harbourCandidates.end(), idOtherVertex), \
+                                    harbourCandidates.end());
+        }
+        // if idOtherVertex != -1, add harbour, remove idVertex from harbourCandidates
+        // if idOtherVertex == -1, no available adjacent vertex, remove idVertex from harbourCandidates
+        harbourCandidates.erase(std::remove(harbourCandidates.begin(), harbourCandidates.end(), idVertex), \
+                                harbourCandidates.end());
+    }
+    return (mHarbours.size() != mNumHarbour);
+}
+
+int BoardLayout::checkOverlap() const
+{
+    std::unordered_map<Point_t, std::string, PointHash> points;
+    int overlapCount = 0;
+
+    auto lambda = [&points, &overlapCount](const std::vector<Point_t>& aPoints, const std::string& aId)
+        {
+            for (const Point_t& point : aPoints)
+            {
+                int count = points.count(point);
+                if (count) {
+                    overlapCount += count;
+                    WARN_LOG("Overlap detected at ", point, \
+                         " Collision IDs: ", aId, ", ", points.at(point));
+                }
+                else
+                {
+                    points.emplace(point, aId);
+                }
+            }
+        };
+
+    for (Vertex* const pVertex : mVertices)
+    {
+        lambda(pVertex->getAllPoints(), pVertex->getStringId());
+    }
+    for (Edge* const pEdge : mEdges)
+    {
+        lambda(pEdge->getAllPoints(), pEdge->getStringId());
+    }
+    for (Land* const pLand : mLands)
+    {
+        lambda(pLand->getAllPoints(), pLand->getStringId());
+    }
+    for (Harbour* const pHarbour : mHarbours)
+    {
+        lambda(pHarbour->getAllPoints(), pHarbour->getStringId());
+    }
+
+    if (overlapCount)
+    {
+        ERROR_LOG("Detected ", overlapCount, " Overlap");
+    }
+    else
+    {
+        INFO_LOG("No Overlap detected");
+    }
+
+    return overlapCount;
+}
+
+Terrain* BoardLayout::_getTerrain(const int x, const int y) const
+{
+    if (boundaryCheck(x,y))
+    {
+        return mGameMap.at(y).at(x);
+    }
+    else
+    {
+        WARN_LOG("Coord (", x, ", ", y, ") is out of bound");
+        return nullptr;
+    }
+}
+
+const Terrain* BoardLayout::getTerrain(const int x, const int y) const
+{
+    if (boundaryCheck(x,y))
+    {
+        return mGameMap.at(y).at(x);
+    }
+    else
+    {
+        WARN_LOG("Coord (", x, ", ", y, ") is out of bound");
+        return nullptr;
+    }
+}
+
+const Terrain* BoardLayout::getTerrain(const Point_t& aPoint) const
+{
+    return getTerrain(aPoint.x, aPoint.y);
+}
+
+const Vertex* BoardLayout::addVertex(const size_t aTopLeftX, const size_t aTopLeftY)
+{
+    if (mInitialized)
+    {
+        ERROR_LOG("Layout initialized, cannot add vertex");
+        return nullptr;
+    }
+    Vertex* const pVertex = new Vertex(mVertices.size(), Point_t{aTopLeftX, aTopLeftY});
+    pVertex->registerToMap(*this);
+    mVertices.push_back(pVertex);
+    return pVertex;
+}
+
+const Edge* BoardLayout::addEdge(const size_t aTopLeftX, const size_t aTopLeftY, const char aPattern)
+{
+    if (mInitialized)
+    {
+        ERROR_LOG("Layout initialized, cannot add edge");
+        return nullptr;
+    }
+    Edge* const pEdge = new Edge(mEdges.size(), Point_t{aTopLeftX, aTopLeftY}, aPattern);
+    pEdge->registerToMap(*this);
+    mEdges.push_back(pEdge);
+    return pEdge;
+
+}
+
+const Land* BoardLayout::addLand(const size_t aTopLeftX, const size_t aTopLeftY, const ResourceTypes aPresetResource)
+{
+    if (mInitialized)
+    {
+        ERROR_LOG("Layout initialized, cannot add land");
+        return nullptr;
+    }
+    Land* const pLand = new Land(mLands.size(), Point_t{aTopLeftX, aTopLeftY}, aPresetResource);
+    pLand->registerToMap(*this);
+    mLands.push_back(pLand);
+    return pLand;
+}
+
+Harbour* BoardLayout::addHarbour(const int aId1, const int aId2)
+{
+    Harbour* const pHarbour = new Harbour(mHarbours.size(), mVertices[aId1]->getTopLeft(), mVertices[aId2]->getTopLeft());
+    mVertices[aId1]->setHarbour(pHarbour);
+    mVertices[aId2]->setHarbour(pHarbour);
+
+    mHarbours.push_back(pHarbour);
+    DEBUG_LOG_L2("added harbour#", mHarbours.size(), " for ", aId1, " and ", aId2);
+    return pHarbour;
+}
+
+int BoardLayout::setTerrainColor(const int x, const int y, ColorPairIndex aColorIndex)
+{
+    if (!boundaryCheck(x, y))
+    {
+        WARN_LOG("SetColor called for an out-of-bound Point{", x, ", ", y, '}');
+        return 1;
+    }
+    DEBUG_LOG_L3("setting color#", (int)aColorIndex, " for Point{", x, ", ", y, '}');
+    _getTerrain(x, y)->setColor(aColorIndex);
+    return 0;
+
+}
+
+int BoardLayout::registerTerrain(const std::vector<Point_t>& aPoints, Terrain* const aTerrain)
+{
+    if (mInitialized)
+    {
+        ERROR_LOG("Layout initialized, cannot registerTerrain for " + aTerrain->getStringId());
+        return 1;
+    }
+    int rc = 0;
+    for (std::vector<Point_t>::const_iterator it = aPoints.begin() ; it != aPoints.end(); ++it)
+    {
+        rc |= registerTerrain(*it, aTerrain);
+    }
+    return rc;
+}
+
+int BoardLayout::registerTerrain(const Point_t& aPoint, Terrain* const aTerrain)
+{
+    if (mInitialized)
+    {
+        ERROR_LOG("Layout initialized, cannot registerTerrain for " + aTerrain->getStringId());
+        return 1;
+    }
+    return registerTerrain(aPoint.x, aPoint.y, aTerrain);
+}
+
+int BoardLayout::registerTerrain(const int x, const int y, Terrain* const aTerrain)
+{
+    if (mInitialized)
+    {
+        ERROR_LOG("Layout initialized, cannot registerTerrain for " + aTerrain->getStringId());
+        return 1;
+    }
+    if (boundaryCheck(x, y)) {
+        mGameMap.at(y).at(x) = aTerrain;
+        return 0;
+    }
+    else
+    {
+        ERROR_LOG("Failed to register point for " + aTerrain->getStringId(), " at (" , x, ", ", y, "), out of bound");
+        return 1;
+    }
+}
+
+void BoardLayout::setNumOfHarbour(const size_t aNum)
+{
+    if (mInitialized)
+    {
+        ERROR_LOG("Layout initialized, cannot setNumOfHarbour");
+    }
+    mNumHarbour = aNum;
+}
+
+int BoardLayout::initLayout()
+{
+    int rc = 0;
+    rc |= populateMap();
+    rc |= populateHarbours(true);   // (bool aUseDefaultPosition)
+    rc |= checkOverlap();
+
+    if (rc != 0)
+    {
+        ERROR_LOG("failed to initialize BoardLayout");
+    }
+    else
+    {
+        INFO_LOG("Successfully initialized BoardLayout, vertices: ", mVertices.size(), ", edges: ", mEdges.size(), \
+                 ", lands: ", mLands.size(), ", harbours: ", mHarbours.size());
+        mInitialized = true;
+    }
+    return rc;
+}
+
+bool BoardLayout::isInitialized() const
+{
+    return mInitialized;
+}
+
+bool BoardLayout::boundaryCheck(const int x, const int y) const
+{
+    return (x < static_cast<int>(mSizeHorizontal) && y < static_cast<int>(mSizeVertical));
+}
+
+const std::deque< std::deque<Terrain*> >& BoardLayout::getTerrainMap() const
+{
+    if (!mInitialized)
+    {
+        ERROR_LOG("Layout not initialized, cannot printMap");
+    }
+    return mGameMap;
+}
+
+const std::vector<Vertex*>& BoardLayout::getVertices() const
+{
+    return mVertices;
+}
+
+const std::vector<Edge*>& BoardLayout::getEdges() const
+{
+    return mEdges;
+}
+
+const std::vector<Land*>& BoardLayout::getLands() const
+{
+    return mLands;
+}
+
+const std::vector<Harbour*>& BoardLayout::getHarbours() const
+{
+    return mHarbours;
+}
+
+int BoardLayout::clearAndResize(const int aSizeHorizontal, const int aSizeVertical)
+{
+    clearTerrains();
+    mSizeHorizontal = aSizeHorizontal;
+    mSizeVertical = aSizeVertical;
+    mNumHarbour = constant::NUM_OF_HARBOUR;
+    mInitialized = false;
+    mGameMap.clear();
+    // init a 2D array with (Terrain*)nullptr
+    for (size_t jj = 0; jj < mSizeVertical; ++jj)
+    {
+        std::deque<Terrain*> row(mSizeHorizontal, Blank::getBlank());
+        mGameMap.push_back(row);
+    }
+    return 0;
+}
+
+int BoardLayout::getSizeHorizontal() const
+{
+    return mSizeHorizontal;
+}
+int BoardLayout::getSizeVertical() const
+{
+    return mSizeVertical;
+}
+
+void BoardLayout::clearTerrains()
+{
+    for (Vertex* pVertex : mVertices)
+    {
+        delete pVertex;
+    }
+    for (Edge* pEdge : mEdges)
+    {
+        delete pEdge;
+    }
+    for (Land* pLand : mLands)
+    {
+        delete pLand;
+    }
+    for (Harbour* pHarbour : mHarbours)
+    {
+        delete pHarbour;
+    }
+    mVertices.clear();
+    mEdges.clear();
+    mLands.clear();
+    mHarbours.clear();
+}
+
+BoardLayout::BoardLayout(const int aSizeHorizontal, const int aSizeVertical)
+{
+    clearAndResize(aSizeHorizontal, aSizeVertical);
+}
+
+BoardLayout::~BoardLayout()
+{
+    clearTerrains();
+}
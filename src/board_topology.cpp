@@ -0,0 +1,132 @@
+/**
+ * Project: catan
+ * @file board_topology.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include "board_topology.hpp"
+#include "game_map.hpp"
+#include "constant.hpp"
+#include "logger.hpp"
+
+constexpr uint8_t BoardTopology::NO_ID;
+
+int BoardTopology::init(const GameMap& aMap)
+{
+    const std::vector<Vertex*>& vertices = aMap.getVertices();
+    const std::vector<Edge*>& edges = aMap.getEdges();
+    const std::vector<Land*>& lands = aMap.getLands();
+    if (vertices.size() > constant::MAX_NUM_VERTICES || edges.size() > constant::MAX_NUM_EDGES || \
+        lands.size() > constant::MAX_NUM_LANDS)
+    {
+        WARN_LOG("Map too large for headless games, vertices: ", vertices.size(), ", edges: ", edges.size(), \
+                 ", lands: ", lands.size());
+        return 1;
+    }
+
+    const BoardState_t& board = aMap.getBoardState();
+    int rc = 0;
+    mVertices.assign(vertices.size(), VertexInfo_t());
+    for (const Vertex* const pVertex : vertices)
+    {
+        VertexInfo_t& info = mVertices[pVertex->getId()];
+        info.vertices.fill(NO_ID);
+        info.edges.fill(NO_ID);
+        info.lands.fill(NO_ID);
+        info.harbour = static_cast<int8_t>(pVertex->hasHarbour() ? \
+                            pVertex->getHarbour()->getResourceType(board) : ResourceTypes::NONE);
+        for (const Vertex* const pAdjVertex : pVertex->getAdjacentVertices())
+        {
+            rc |= appendId(info.vertices, pAdjVertex->getId());
+        }
+        for (const Edge* const pAdjEdge : pVertex->getAdjacentEdges())
+        {
+            rc |= appendId(info.edges, pAdjEdge->getId());
+        }
+    }
+
+    mEdges.assign(edges.size(), EdgeInfo_t());
+    for (const Edge* const pEdge : edges)
+    {
+        EdgeInfo_t& info = mEdges[pEdge->getId()];
+        info.vertices.fill(NO_ID);
+        for (const Vertex* const pAdjVertex : pEdge->getAdjacentVertices())
+        {
+            rc |= appendId(info.vertices, pAdjVertex->getId());
+        }
+    }
+
+    mLands.assign(lands.size(), LandInfo_t());
+    for (const Land* const pLand : lands)
+    {
+        LandInfo_t& info = mLands[pLand->getId()];
+        info.vertices.fill(NO_ID);
+        info.resource = static_cast<int8_t>(pLand->getResourceType(board));
+        info.dice = (pLand->getResourceType(board) == ResourceTypes::DESERT) ? 0U : static_cast<uint8_t>(pLand->getDiceNum(board));
+        for (const Vertex* const pAdjVertex : pLand->getAdjacentVertices())
+        {
+            rc |= appendId(info.vertices, pAdjVertex->getId());
+            rc |= appendId(mVertices[pAdjVertex->getId()].lands, pLand->getId());
+        }
+    }
+
+    (rc != 0) ?
+        WARN_LOG("Failed to build board topology, unexpected num of adjacencies")
+        :
+        DEBUG_LOG_L1("Board topology built, vertices: ", mVertices.size(), ", edges: ", mEdges.size(), \
+                     ", lands: ", mLands.size());
+    return rc;
+}
+
+size_t BoardTopology::getNumVertices() const
+{
+    return mVertices.size();
+}
+
+size_t BoardTopology::getNumEdges() const
+{
+    return mEdges.size();
+}
+
+size_t BoardTopology::getNumLands() const
+{
+    return mLands.size();
+}
+
+const BoardTopology::VertexInfo_t& BoardTopology::getVertex(const size_t aId) const
+{
+    return mVertices[aId];
+}
+
+const BoardTopology::EdgeInfo_t& BoardTopology::getEdge(const size_t aId) const
+{
+    return mEdges[aId];
+}
+
+const BoardTopology::LandInfo_t& BoardTopology::getLand(const size_t aId) const
+{
+    return mLands[aId];
+}
+
+uint8_t BoardTopology::getOtherVertex(const size_t aEdgeId, const size_t aVertexId) const
+{
+    const EdgeInfo_t& edge = mEdges[aEdgeId];
+    if (edge.vertices[0] == aVertexId)
+    {
+        return edge.vertices[1];
+    }
+    else if (edge.vertices[1] == aVertexId)
+    {
+        return edge.vertices[0];
+    }
+    return NO_ID;
+}
+
+BoardTopology::BoardTopology()
+{
+    // empty
+}
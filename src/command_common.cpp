@@ -85,3 +85,73 @@ ActionStatus StatefulCommandHandler::onStringParametersReceive(
     }
     return rc;
 }
+
+CoroutineCommandHandler::CoroutineCommandHandler() :
+    mResumePoint(COROUTINE_START),
+    mNumParameters(0U)
+{
+    // empty
+}
+
+void CoroutineCommandHandler::start(GameMap& aMap)
+{
+    resetParameters();
+    // nothing to say before the first await
+    std::vector<std::string> returnMsg;
+    resume(aMap, "", Point_t{0, 0}, returnMsg);
+}
+
+ActionStatus CoroutineCommandHandler::onParameterReceive(
+    GameMap& aMap, const std::string& aParam, Point_t aPoint, \
+    std::vector<std::string>& aReturnMsg)
+{
+    if (mResumePoint == COROUTINE_START)
+    {
+        start(aMap);
+    }
+    if (mResumePoint == COROUTINE_DONE)
+    {
+        aReturnMsg.emplace_back("discarded parameter: " + aParam);
+        return ActionStatus::SUCCESS;
+    }
+    if (resume(aMap, aParam, aPoint, aReturnMsg) == ActionStatus::FAILED)
+    {
+        return ActionStatus::FAILED;
+    }
+    ++mNumParameters;
+    return ActionStatus::SUCCESS;
+}
+
+ActionStatus CoroutineCommandHandler::onStringParametersReceive(
+    GameMap& aMap, const std::vector<std::string>& aArgs, \
+    std::vector<std::string>& aReturnMsg)
+{
+    // the command may be run without parameters, its first instruction is still needed
+    if (mResumePoint == COROUTINE_START)
+    {
+        start(aMap);
+    }
+    return StatefulCommandHandler::onStringParametersReceive(aMap, aArgs, aReturnMsg);
+}
+
+bool CoroutineCommandHandler::parameterComplete() const
+{
+    return mResumePoint == COROUTINE_DONE;
+}
+
+size_t CoroutineCommandHandler::currentParamIndex() const
+{
+    return mNumParameters;
+}
+
+void CoroutineCommandHandler::resetParameters()
+{
+    mResumePoint = COROUTINE_START;
+    mNumParameters = 0U;
+    mInstruction.clear();
+}
+
+void CoroutineCommandHandler::instruction(std::vector<std::string>& aReturnMsg) const
+{
+    aReturnMsg.insert(aReturnMsg.end(), mInstruction.begin(), mInstruction.end());
+}
@@ -16,6 +16,11 @@ CommandParameterReader::CommandParameterReader(CommandHandler* const aCmd):
     // empty
 }
 
+const CommandHandler* CommandParameterReader::getCommandHandler() const
+{
+    return mCmd;
+}
+
 ActionStatus CommandParameterReader::act(GameMap& aMap, UserInterface& aUi, std::string aInput, Point_t aPoint, std::vector<std::string>& aReturnMsg)
 {
     StatefulCommandHandler* const pStatefulCmd = dynamic_cast<StatefulCommandHandler*>(mCmd);
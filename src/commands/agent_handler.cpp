@@ -0,0 +1,92 @@
+/**
+ * Project: catan
+ * @file agent_handler.cpp
+ *
+ * @brief let an agent (see Agent) play the turn of the current player
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include "command_handlers.hpp"
+#include "board_topology.hpp"
+
+namespace
+{
+
+// expectimax plays the interactive game, a decision is to take about 1 second at most
+constexpr size_t EXPECTIMAX_MAX_DEPTH = 12U;
+constexpr size_t EXPECTIMAX_TIME_LIMIT_MS = 1000U;
+
+} // namespace
+
+const std::vector<std::string> AgentHandler::mAgentNames = {"greedy", "expectimax", "mcts", "random"};
+
+std::string AgentHandler::command() const
+{
+    return "agent";
+}
+
+std::string AgentHandler::description() const
+{
+    return "let an agent play the turn of the current player, e.g., 'agent greedy'";
+}
+
+const std::vector<std::string>& AgentHandler::paramAutoFillPool(size_t aParamIndex) const
+{
+    if (aParamIndex == 0)
+    {
+        return mAgentNames;
+    }
+    else
+    {
+        return EMPTY_STRING_VECTOR;
+    }
+}
+
+ActionStatus AgentHandler::statelessRun(GameMap& aMap, UserInterface& /* aUi */, const std::vector<std::string>& aArgs, std::vector<std::string>& aReturnMsg)
+{
+    const std::string name = (aArgs.size() == 0) ? mAgentNames.front() : aArgs.front();
+    std::unique_ptr<Agent> agent = Agent::create(name);
+    if (!agent && name != "expectimax")
+    {
+        aReturnMsg.emplace_back("Unknown agent: " + name);
+        aReturnMsg.emplace_back(stringVectorJoin(mAgentNames));
+        return ActionStatus::FAILED;
+    }
+
+    if (!mDriver)
+    {
+        std::shared_ptr<BoardTopology> topology = std::make_shared<BoardTopology>();
+        if (topology->init(aMap) != 0)
+        {
+            aReturnMsg.emplace_back("The map is not supported by agents");
+            return ActionStatus::FAILED;
+        }
+        mDriver = std::make_unique<MapAgentDriver>(topology, aMap.getSeed());
+    }
+
+    const size_t playerId = aMap.currentPlayer();
+    std::vector<std::string> actions;
+    int rc = 0;
+    if (agent)
+    {
+        rc = mDriver->playTurn(aMap, *agent, actions);
+    }
+    else
+    {
+        if (!mSearch)
+        {
+            mSearch = std::make_unique<ExpectimaxSearch>(EXPECTIMAX_MAX_DEPTH, EXPECTIMAX_TIME_LIMIT_MS);
+        }
+        rc = mDriver->playTurn(aMap, *mSearch, actions);
+        if (rc == 1)
+        {
+            actions.emplace_back("expectimax supports 2 players only");
+        }
+    }
+    aReturnMsg.emplace_back(Logger::formatString("Agent ", name, " played for player#", playerId, ":"));
+    aReturnMsg.insert(aReturnMsg.end(), actions.begin(), actions.end());
+    return (rc == 0) ? ActionStatus::SUCCESS : ActionStatus::FAILED;
+}
@@ -32,7 +32,7 @@ std::string BuildHandler::description() const
 
 const std::vector<std::string>& BuildHandler::paramAutoFillPool(size_t aParamIndex) const
 {
-    if (mBuildType == "" && aParamIndex == 0)
+    if (aParamIndex == 0)
     {
         return mBuildTypeMatchingPool;
     }
@@ -98,79 +98,32 @@ ActionStatus BuildHandler::statefulRun(GameMap& aMap, UserInterface& aUi, std::v
     return ActionStatus::SUCCESS;
 }
 
-ActionStatus BuildHandler::onParameterReceive(GameMap& aMap, const std::string& aParam, Point_t aPoint, std::vector<std::string>& aReturnMsg)
+ActionStatus BuildHandler::resume(GameMap& aMap, const std::string& aParam, const Point_t aPoint, std::vector<std::string>& aReturnMsg)
 {
+    COROUTINE_BEGIN();
+    mBuildType = "";
+    mPoint = Point_t{0, 0};
+
     // first prompt user for build type: road or settlement or city
+    AWAIT_PARAMETER("What do you want to build:", stringVectorJoin(mBuildTypeMatchingPool));
     INFO_LOG(command() + " reading parameter " + aParam);
-    if (mBuildType == "")
+    if (indexInVector(aParam, mBuildTypeMatchingPool) < 0)
     {
-        if (indexInVector(aParam, mBuildTypeMatchingPool) >= 0)
-        {
-            mBuildType = aParam;
-            return ActionStatus::SUCCESS;
-        }
-        else
-        {
-            return ActionStatus::FAILED;
-        }
+        return ActionStatus::FAILED;
     }
+    mBuildType = aParam;
 
-    if (mPoint == Point_t{0, 0})
-    {
-        if (mBuildType == "road")
-        {
-            if (aMap.isTerrain<Edge>(aPoint))
-            {
-                mPoint = aPoint;
-                return ActionStatus::SUCCESS;
-            }
-            else
-            {
-                aReturnMsg.emplace_back("Player clicked is not an edge");
-                return ActionStatus::FAILED;
-            }
-        }
-        else if (mBuildType == "settlement" || mBuildType == "city" )
-        {
-            if (aMap.isTerrain<Vertex>(aPoint))
-            {
-                mPoint = aPoint;
-                return ActionStatus::SUCCESS;
-            }
-            else
-            {
-                aReturnMsg.emplace_back("Player clicked is not a vertex");
-                return ActionStatus::FAILED;
-            }
-        }
-    }
-
-    return ActionStatus::SUCCESS;
-}
-
-bool BuildHandler::parameterComplete() const
-{
-    return (mPoint != Point_t{0, 0} && mBuildType != "");
-}
-
-void BuildHandler::resetParameters()
-{
-    mPoint = Point_t{0, 0};
-    mBuildType = "";
-}
-
-void BuildHandler::instruction(std::vector<std::string>& aReturnMsg) const
-{
-    if (mBuildType == "")
+    AWAIT_PARAMETER("You want to build a " + mBuildType, "Please click on the map where you want to build");
+    if (mBuildType == "road" && !aMap.isTerrain<Edge>(aPoint))
     {
-        aReturnMsg.emplace_back("What do you want to build:");
-        aReturnMsg.emplace_back(stringVectorJoin(mBuildTypeMatchingPool));
-        return;
+        aReturnMsg.emplace_back("Player clicked is not an edge");
+        return ActionStatus::FAILED;
     }
-    else if (mBuildType != "" && mPoint == Point_t{0, 0})
+    if (mBuildType != "road" && !aMap.isTerrain<Vertex>(aPoint))
     {
-        aReturnMsg.emplace_back("You want to build a " + mBuildType);
-        aReturnMsg.emplace_back("Please click on the map where you want to build");
-        return;
+        aReturnMsg.emplace_back("Player clicked is not a vertex");
+        return ActionStatus::FAILED;
     }
+    mPoint = aPoint;
+    COROUTINE_END();
 }
@@ -20,7 +20,7 @@ const std::vector<std::string> DevelopmentCardHandler::mPlayableDevCard = \
 DevelopmentCardHandler::DevelopmentCardHandler() :
     mAction(""),
     mDevCard(-1),
-    mRobberMoveHandler(RobberMoveHandler::getRobberHandler())
+    mRobberMoveHandler()
 {
     // empty
 }
@@ -73,7 +73,8 @@ ActionStatus DevelopmentCardHandler::statefulRun(GameMap& aMap, UserInterface& a
         rc == 0 ?
             aReturnMsg.emplace_back("Successfully buy a development card: " + developmentCardTypesToStr(devCard))
             :
-            aReturnMsg.emplace_back("Failed to buy a development card, insufficient resources");
+            aReturnMsg.emplace_back(aMap.getDevCardDeck().empty() ? "Failed to buy a development card, no card left" : \
+                                    "Failed to buy a development card, insufficient resources");
         return ActionStatus::SUCCESS;
     }
     // mAction == "play"
@@ -93,6 +94,7 @@ ActionStatus DevelopmentCardHandler::statefulRun(GameMap& aMap, UserInterface& a
     {
         case DevelopmentCardTypes::KNIGHT:
         {
+            mRobberMoveHandler.start(aMap);
             aUi.pushCommandHelper(std::make_unique<CommandParameterReader>(&mRobberMoveHandler));
             return ActionStatus::SUCCESS;
         }
@@ -103,11 +105,13 @@ ActionStatus DevelopmentCardHandler::statefulRun(GameMap& aMap, UserInterface& a
         }
         case DevelopmentCardTypes::YEAR_OF_PLENTY:
         {
+            mYearOfPlentyHandler.start(aMap);
             aUi.pushCommandHelper(std::make_unique<CommandParameterReader>(&mYearOfPlentyHandler));
             return ActionStatus::SUCCESS;
         }
         case DevelopmentCardTypes::MONOPOLY:
         {
+            mMonopolyHandler.start(aMap);
             aUi.pushCommandHelper(std::make_unique<CommandParameterReader>(&mMonopolyHandler));
             return ActionStatus::SUCCESS;
         }
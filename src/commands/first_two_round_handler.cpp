@@ -10,8 +10,20 @@
  * All right reserved.
  */
 
+#include <algorithm>
+#include <chrono>
 #include "command_handlers.hpp"
 #include "command_parameter_reader.hpp"
+#include "board_topology.hpp"
+
+namespace
+{
+
+constexpr size_t NUM_SUGGESTED_OPENINGS = 5U;
+
+} // namespace
+
+const std::vector<std::string> FirstTwoRoundHandler::mParamPool = {"suggest"};
 
 FirstTwoRoundHandler::FirstTwoRoundHandler(const std::vector<int>& aOrder, std::unique_ptr<CommandHelper> aCmdDispatcher) :
     mRound(1U),
@@ -29,19 +41,172 @@ std::string FirstTwoRoundHandler::command() const
     return "first_two_round_handler";
 }
 
+const std::vector<std::string>& FirstTwoRoundHandler::paramAutoFillPool(size_t aParamIndex) const
+{
+    if (aParamIndex == 0)
+    {
+        return mParamPool;
+    }
+    return EMPTY_STRING_VECTOR;
+}
+
 ActionStatus FirstTwoRoundHandler::statefulRun(GameMap& aMap, UserInterface& aUi, std::vector<std::string>& aReturnMsg)
 {
+    // the first player of the first round starts the game
+    while (!mOrder.empty() && static_cast<int>(aMap.currentPlayer()) != mOrder.front())
+    {
+        aMap.nextPlayer();
+    }
+    aReturnMsg.emplace_back(Logger::formatString("First two rounds completed, Player#", aMap.currentPlayer(), " starts"));
+    if (mTopLevelCmdDispatcher)
+    {
+        aUi.pushCommandHelper(std::move(mTopLevelCmdDispatcher));
+    }
     return ActionStatus::SUCCESS;
 }
 
 ActionStatus FirstTwoRoundHandler::onParameterReceive(GameMap& aMap, const std::string& aParam, Point_t aPoint, std::vector<std::string>& aReturnMsg)
 {
+    if (mIndex >= mOrder.size())
+    {
+        return ActionStatus::SUCCESS;
+    }
+    while (static_cast<int>(aMap.currentPlayer()) != mOrder[mIndex])
+    {
+        aMap.nextPlayer();
+    }
+
+    if (aParam == "suggest")
+    {
+        suggestOpenings(aMap, aReturnMsg);
+        return ActionStatus::SUCCESS;
+    }
+    if (aPoint == Point_t{0, 0})
+    {
+        aReturnMsg.emplace_back("unknown parameter: " + aParam);
+        return ActionStatus::FAILED;
+    }
+    return (mSettelment == Point_t{0, 0}) ? placeSettlement(aMap, aPoint, aReturnMsg) : placeRoad(aMap, aPoint, aReturnMsg);
+}
+
+ActionStatus FirstTwoRoundHandler::placeSettlement(GameMap& aMap, const Point_t aPoint, std::vector<std::string>& aReturnMsg)
+{
+    // free of charge, no road to connect to yet
+    const int rc = aMap.buildColony(aPoint, ColonyType::SETTLEMENT, false, false);
+    switch (rc)
+    {
+        case 0:
+            break;
+        case 1:
+            aReturnMsg.emplace_back("Please click on a vertex");
+            return ActionStatus::FAILED;
+        case 2:
+            aReturnMsg.emplace_back("It is already occupied by others");
+            return ActionStatus::FAILED;
+        case 3:
+            aReturnMsg.emplace_back("One or more adjacent vertex is occupied");
+            return ActionStatus::FAILED;
+        default:
+            aReturnMsg.emplace_back("Internal error");
+            return ActionStatus::FAILED;
+    }
+
+    mSettelment = aPoint;
+    aReturnMsg.emplace_back(Logger::formatString("Player#", aMap.currentPlayer(), " placed a settlement"));
+    if (mRound == 2U)
+    {
+        const size_t numOfResources = aMap.currentPlayerCollectResources(aPoint);
+        aReturnMsg.emplace_back(Logger::formatString("Player#", aMap.currentPlayer(), " collected ", numOfResources, " resources"));
+    }
+    return ActionStatus::SUCCESS;
+}
+
+ActionStatus FirstTwoRoundHandler::placeRoad(GameMap& aMap, const Point_t aPoint, std::vector<std::string>& aReturnMsg)
+{
+    const Edge* const pEdge = dynamic_cast<const Edge*>(aMap.getTerrain(aPoint));
+    if (!pEdge)
+    {
+        aReturnMsg.emplace_back("Please click on an edge");
+        return ActionStatus::FAILED;
+    }
+    // the road must lead away from the settlement just placed, not from the one of the first round
+    const std::set<const Vertex*>& adjVertices = pEdge->getAdjacentVertices();
+    if (adjVertices.find(dynamic_cast<const Vertex*>(aMap.getTerrain(mSettelment))) == adjVertices.end())
+    {
+        aReturnMsg.emplace_back("The road must be next to the settlement just placed");
+        return ActionStatus::FAILED;
+    }
+    const int rc = aMap.buildRoad(aPoint, false);
+    if (rc != 0)
+    {
+        INFO_LOG("Construction failed, GameMap::buildRoad() rc=", rc);
+        aReturnMsg.emplace_back((rc == 2) ? "It is already occupied by others" : "Internal error");
+        return ActionStatus::FAILED;
+    }
+
+    mRoad = aPoint;
+    aReturnMsg.emplace_back(Logger::formatString("Player#", aMap.currentPlayer(), " placed a road"));
+    resetParameters();
+    ++mIndex;
+    mRound = (2U * mIndex < mOrder.size()) ? 1U : 2U;
+    if (mIndex < mOrder.size())
+    {
+        while (static_cast<int>(aMap.currentPlayer()) != mOrder[mIndex])
+        {
+            aMap.nextPlayer();
+        }
+    }
     return ActionStatus::SUCCESS;
 }
 
+void FirstTwoRoundHandler::suggestOpenings(GameMap& aMap, std::vector<std::string>& aReturnMsg)
+{
+    if (mSettelment != Point_t{0, 0})
+    {
+        aReturnMsg.emplace_back("Please place the road first");
+        return;
+    }
+    GameState_t state;
+    if (!mOptimiser)
+    {
+        std::shared_ptr<BoardTopology> topology = std::make_shared<BoardTopology>();
+        if (topology->init(aMap) != 0)
+        {
+            aReturnMsg.emplace_back("The map is not supported by the optimiser");
+            return;
+        }
+        mOptimiser = std::make_unique<OpeningOptimiser>(topology);
+    }
+    if (aMap.exportGameState(state) != 0)
+    {
+        aReturnMsg.emplace_back("The map is not supported by the optimiser");
+        return;
+    }
+
+    const std::vector<uint8_t> order(mOrder.begin() + mIndex, mOrder.end());
+    std::vector<Opening_t> openings;
+    const auto start = std::chrono::steady_clock::now();
+    mOptimiser->search(state, order, NUM_SUGGESTED_OPENINGS, openings);
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    aReturnMsg.emplace_back(Logger::formatString("Best openings for Player#", aMap.currentPlayer(), " (", \
+        mOptimiser->getNumNodes(), " placements searched in ", elapsed.count(), " ms):"));
+    for (const Opening_t& opening : openings)
+    {
+        const Vertex* const pFirst = aMap.getVertices().at(opening.first);
+        std::string message = Logger::formatString("  ", pFirst->getStringId(), " ", pFirst->getTopLeft());
+        if (opening.second != BoardTopology::NO_ID)
+        {
+            const Vertex* const pSecond = aMap.getVertices().at(opening.second);
+            message += Logger::formatString(", then ", pSecond->getStringId(), " ", pSecond->getTopLeft());
+        }
+        aReturnMsg.emplace_back(Logger::formatString(message, ", score: ", opening.score));
+    }
+}
+
 bool FirstTwoRoundHandler::parameterComplete() const
 {
-    return (mRound == 2 && mIndex == 0);
+    return (mIndex >= mOrder.size());
 }
 
 void FirstTwoRoundHandler::resetParameters()
@@ -52,5 +217,19 @@ void FirstTwoRoundHandler::resetParameters()
 
 void FirstTwoRoundHandler::instruction(std::vector<std::string>& aReturnMsg) const
 {
-    //TODO:
+    if (mIndex >= mOrder.size())
+    {
+        return;
+    }
+    aReturnMsg.emplace_back(Logger::formatString("First two rounds, round ", mRound, ", Player#", mOrder[mIndex], ":"));
+    if (mSettelment == Point_t{0, 0})
+    {
+        aReturnMsg.emplace_back(std::string{"Please click on the map where you want to place your "} + \
+            (mRound == 1U ? "first" : "second") + " settlement");
+        aReturnMsg.emplace_back("suggest - list the best openings");
+    }
+    else
+    {
+        aReturnMsg.emplace_back("Please click on the map where you want to place the road next to the settlement");
+    }
 }
@@ -0,0 +1,44 @@
+/**
+ * Project: catan
+ * @file game_commands.cpp
+ *
+ * @brief the command set of a game, shared by catan.exe and catan-server
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include "command_handlers.hpp"
+#include "command_parameter_reader.hpp"
+#include "trading_system.hpp"
+
+std::unique_ptr<CommandHelper> createTopLevelCommands()
+{
+    return std::make_unique<CommandDispatcher>(
+        std::vector<CommandHandler*>({
+            new BuildHandler(),
+            new NextHandler(),
+            new PassHandler(),
+            new RollHandler(),
+            new StatusHandler(),
+            new DevelopmentCardHandler(),
+            new TradeHandler(),
+            new AgentHandler(),
+#ifndef RELEASE
+            // these commands are only for testing in development
+            new BuildingHandler(),
+            new SubCmdHandler(),
+            new ParameterExampleCommandHandler()
+#endif /* ifndef RELEASE*/
+        })
+    );
+}
+
+std::unique_ptr<CommandHelper> createGameCommands(GameMap& aMap)
+{
+    // the game starts with the first two rounds, the commands are available once they are over
+    const std::vector<int> playerOrder = aMap.getFirstTwoRoundOrder();
+    return std::make_unique<FosterCommandParameterReader>(
+        std::make_unique<FirstTwoRoundHandler>(playerOrder, createTopLevelCommands()));
+}
@@ -24,7 +24,7 @@ std::string MonopolyHandler::command() const
 
 const std::vector<std::string>& MonopolyHandler::paramAutoFillPool(size_t aParamIndex) const
 {
-    if (!parameterComplete())
+    if (aParamIndex == 0)
     {
         return consumableResourceStringValue;
     }
@@ -39,40 +39,20 @@ ActionStatus MonopolyHandler::statefulRun(GameMap& aMap, UserInterface& aUi, std
     return ActionStatus::SUCCESS;
 }
 
-ActionStatus MonopolyHandler::onParameterReceive(GameMap& aMap, const std::string& aParam, Point_t aPoint, std::vector<std::string>& aReturnMsg)
-{
-    if (parameterComplete())
-    {
-        aReturnMsg.emplace_back("discarded parameter: " + aParam);
-        return ActionStatus::SUCCESS;
-    }
-
-    int index = indexInVector(aParam, consumableResourceStringValue);
-    if (index == -1)
-    {
-        aReturnMsg.emplace_back("unknown parameter: " + aParam);
-        return ActionStatus::FAILED;
-    }
-    mResource = static_cast<ResourceTypes>(index);
-    return ActionStatus::SUCCESS;
-}
-
-bool MonopolyHandler::parameterComplete() const
-{
-    return (mResource != ResourceTypes::NONE);
-}
-
-void MonopolyHandler::resetParameters()
+ActionStatus MonopolyHandler::resume(GameMap& aMap, const std::string& aParam, const Point_t aPoint, std::vector<std::string>& aReturnMsg)
 {
+    COROUTINE_BEGIN();
     mResource = ResourceTypes::NONE;
-}
 
-void MonopolyHandler::instruction(std::vector<std::string>& aReturnMsg) const
-{
-    if (!parameterComplete())
+    AWAIT_PARAMETER("Which resource you want to steal from all other players?", stringVectorJoin(consumableResourceStringValue));
     {
-        aReturnMsg.emplace_back("Which resource you want to steal from all other players?");
-        aReturnMsg.emplace_back(stringVectorJoin(consumableResourceStringValue));
-        return;
+        const int index = indexInVector(aParam, consumableResourceStringValue);
+        if (index == -1)
+        {
+            aReturnMsg.emplace_back("unknown parameter: " + aParam);
+            return ActionStatus::FAILED;
+        }
+        mResource = static_cast<ResourceTypes>(index);
     }
+    COROUTINE_END();
 }
@@ -9,8 +9,28 @@
  * All right reserved.
  */
 
+#include <cstdlib>
+#include <numeric>
 #include "command_handlers.hpp"
 
+namespace
+{
+
+// a point of the terrain that is not claimed by a neighbour, nor {0, 0}, i.e., not taken for a missing click
+Point_t pointOf(const GameMap& aMap, const Terrain* const aTerrain)
+{
+    for (const Point_t& point : aTerrain->getAllPoints())
+    {
+        if (aMap.getTerrain(point) == aTerrain && point != Point_t{0, 0})
+        {
+            return point;
+        }
+    }
+    return aTerrain->getTopLeft();
+}
+
+} // namespace
+
 std::string RobberMoveHandler::command() const
 {
     return "robber_move";   // this should only be used for logging purpose
@@ -41,78 +61,102 @@ ActionStatus RobberMoveHandler::statefulRun(GameMap& aMap, UserInterface& aUi, s
     return ActionStatus::SUCCESS;
 }
 
-ActionStatus RobberMoveHandler::onParameterReceive(GameMap& aMap, const std::string& aParam, Point_t aPoint, std::vector<std::string>& aReturnMsg)
+ActionStatus RobberMoveHandler::resume(GameMap& aMap, const std::string& aParam, const Point_t aPoint, std::vector<std::string>& aReturnMsg)
 {
-    if (mRobberDestination == Point_t{0, 0})
+    COROUTINE_BEGIN();
+    mRobberDestination = Point_t{0, 0};
+    mRobbingVertex = Point_t{0, 0};
+
+    AWAIT_PARAMETER("Please click on the map to choose where you want the robber to go");
+    if (!aMap.isTerrain<Land>(aPoint))
     {
-        if (aMap.isTerrain<Land>(aPoint))
-        {
-            mRobberDestination = aPoint;
-            return ActionStatus::SUCCESS;
-        }
-        else
+        aReturnMsg.emplace_back("Player clicked is not land");
+        return ActionStatus::FAILED;
+    }
+    mRobberDestination = aPoint;
+
+    AWAIT_PARAMETER("Please click on the map to choose which settlement/city you want the rob");
+    if (const Vertex* const pVertex = dynamic_cast<const Vertex*>(aMap.getTerrain(aPoint)))
+    {
+        const std::vector<const Vertex*>& adjVertices = dynamic_cast<const Land*>(aMap.getTerrain(mRobberDestination))->getAdjacentVertices();
+        if (indexInVector(pVertex, adjVertices) < 0)
         {
-            aReturnMsg.emplace_back("Player clicked is not land");
+            aReturnMsg.emplace_back(Logger::formatString("Please click on a vertex directly connect to the land at ", mRobberDestination));
             return ActionStatus::FAILED;
         }
     }
-    if (mRobbingVertex == Point_t{0, 0})
+    else
     {
-        if (const Vertex* const pVertex = dynamic_cast<const Vertex*>(aMap.getTerrain(aPoint)))
+        aReturnMsg.emplace_back("Player clicked is not vertex");
+        return ActionStatus::FAILED;
+    }
+    mRobbingVertex = aPoint;
+    COROUTINE_END();
+}
+
+void RobberMoveHandler::defaultClicks(const GameMap& aMap, std::vector<Point_t>& aClicks) const
+{
+    const BoardState_t& state = aMap.getBoardState();
+    const int currentPlayer = static_cast<int>(aMap.currentPlayer());
+    const Land* pDestination = (mRobberDestination == Point_t{0, 0}) ? nullptr : \
+                               dynamic_cast<const Land*>(aMap.getTerrain(mRobberDestination));
+    if (pDestination == nullptr)
+    {
+        int bestScore = 0;
+        for (const Land* const pLand : aMap.getLands())
         {
-            const std::vector<const Vertex*>& adjVertices = dynamic_cast<const Land*>(aMap.getTerrain(mRobberDestination))->getAdjacentVertices();
-            if (indexInVector(pVertex, adjVertices) >= 0)
+            if (pLand->getId() == static_cast<int>(aMap.getRobLandId()))
+            {
+                continue;
+            }
+            const int dice = pLand->getDiceNum(state);
+            const int chance = (dice == 0) ? 0 : 6 - std::abs(7 - dice);    // in 36
+            int score = 0;
+            for (const Vertex* const pVertex : pLand->getAdjacentVertices())
             {
-                mRobbingVertex = aPoint;
-                return ActionStatus::SUCCESS;
+                const int owner = pVertex->getOwner(state);
+                if (owner >= 0)
+                {
+                    score += (owner == currentPlayer ? -2 : 1) * static_cast<int>(pVertex->getColonyType(state)) * chance;
+                }
             }
-            else
+            if (pDestination == nullptr || score > bestScore)
             {
-                aReturnMsg.emplace_back(Logger::formatString("Please click on a vertex directly connect to the land at ", mRobberDestination));
-                return ActionStatus::FAILED;
+                pDestination = pLand;
+                bestScore = score;
             }
         }
-        else
+        if (pDestination == nullptr)
         {
-            aReturnMsg.emplace_back("Player clicked is not vertex");
-            return ActionStatus::FAILED;
+            return;
         }
+        aClicks.push_back(pointOf(aMap, pDestination));
     }
-    return ActionStatus::FAILED;
-}
-
-bool RobberMoveHandler::parameterComplete() const
-{
-    return (mRobberDestination != Point_t{0, 0} &&
-            mRobbingVertex != Point_t{0, 0});
-}
-
-void RobberMoveHandler::resetParameters()
-{
-    mRobberDestination = {0, 0};
-    mRobbingVertex = {0, 0};
-}
 
-void RobberMoveHandler::instruction(std::vector<std::string>& aReturnMsg) const
-{
-    if (mRobberDestination == Point_t{0, 0})
+    // robbing a vertex without owner fails, as it does for a player clicking it
+    const Vertex* pVictim = pDestination->getAdjacentVertices().front();
+    size_t mostCards = 0U;
+    for (const Vertex* const pVertex : pDestination->getAdjacentVertices())
     {
-        aReturnMsg.emplace_back("Please click on the map to choose where you want the robber to go");
-        return;
+        const int owner = pVertex->getOwner(state);
+        if (owner < 0 || owner == currentPlayer)
+        {
+            continue;
+        }
+        const std::array<size_t, CONSUMABLE_RESOURCE_SIZE>& resources = aMap.getPlayers()[owner]->getResources();
+        const size_t numCards = std::accumulate(resources.begin(), resources.end(), size_t{0U});
+        if (numCards > mostCards)
+        {
+            pVictim = pVertex;
+            mostCards = numCards;
+        }
     }
-    aReturnMsg.emplace_back("Please click on the map to choose which settlement/city you want the rob");
+    aClicks.push_back(pointOf(aMap, pVictim));
 }
 
-
 RobberMoveHandler::RobberMoveHandler() :
     mRobberDestination(Point_t{0, 0}),
     mRobbingVertex(Point_t{0, 0})
 {
     // empty
 }
-
-RobberMoveHandler& RobberMoveHandler::getRobberHandler()
-{
-    static RobberMoveHandler robberHandler;
-    return robberHandler;
-}
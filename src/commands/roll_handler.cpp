@@ -28,13 +28,14 @@ ActionStatus RollHandler::statelessRun(GameMap& aMap, UserInterface& aUi, const
     aReturnMsg.emplace_back("You rolled: " + std::to_string(dice));
     if (dice == 7)
     {
+        mRobberMoveHandler.start(aMap);
         aUi.pushCommandHelper(std::make_unique<CommandParameterReader>(&mRobberMoveHandler));
     }
     return ActionStatus::SUCCESS;
 }
 
 RollHandler::RollHandler() :
-    mRobberMoveHandler(RobberMoveHandler::getRobberHandler())
+    mRobberMoveHandler()
 {
     // empty
 }
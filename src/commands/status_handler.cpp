@@ -9,6 +9,7 @@
  * All right reserved.
  */
 
+#include <algorithm>
 #include "command_handlers.hpp"
 
 
@@ -19,16 +20,22 @@ std::string StatusHandler::command() const
 
 std::string StatusHandler::description() const
 {
-    return "display player's status, optionally you may provide a 'player ID' to check on other's status";
+    return "display player's status, optionally you may provide a 'player ID' to check on other's status, " \
+           "and a 'num of rolls' for the chance to afford each build within that many rolls (default one round)";
 }
 
 ActionStatus StatusHandler::statelessRun(GameMap& aMap, UserInterface& aUi, const std::vector<std::string>& aArgs, std::vector<std::string>& aReturnMsg)
 {
     int playerId = -1;
+    int numRolls = 0;
     if (aArgs.size() > 0)
     {
         stringToInteger(aArgs.front(), playerId);
     }
-    aMap.summarizePlayerStatus(playerId, aReturnMsg);
+    if (aArgs.size() > 1)
+    {
+        stringToInteger(aArgs.at(1), numRolls);
+    }
+    aMap.summarizePlayerStatus(playerId, aReturnMsg, static_cast<size_t>(std::max(numRolls, 0)));
     return ActionStatus::SUCCESS;
 }
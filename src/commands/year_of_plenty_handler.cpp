@@ -35,19 +35,6 @@ const std::vector<std::string>& YearOfPlentyHandler::paramAutoFillPool(size_t aP
     return EMPTY_STRING_VECTOR;
 }
 
-size_t YearOfPlentyHandler::currentParamIndex() const
-{
-    if (mResource1 == ResourceTypes::NONE)
-    {
-        return 0;
-    }
-    else if (mResource2 == ResourceTypes::NONE)
-    {
-        return 1;
-    }
-    return 2;
-}
-
 ActionStatus YearOfPlentyHandler::statefulRun(GameMap& aMap, UserInterface& aUi, std::vector<std::string>& aReturnMsg)
 {
     aMap.currentPlayerAddResource(mResource1);
@@ -60,49 +47,33 @@ ActionStatus YearOfPlentyHandler::statefulRun(GameMap& aMap, UserInterface& aUi,
     return ActionStatus::SUCCESS;
 }
 
-ActionStatus YearOfPlentyHandler::onParameterReceive(GameMap& aMap, const std::string& aParam, Point_t aPoint, std::vector<std::string>& aReturnMsg)
-{
-    if (parameterComplete())
-    {
-        aReturnMsg.emplace_back("discarded parameter: " + aParam);
-        return ActionStatus::SUCCESS;
-    }
-
-    ResourceTypes& resource = (mResource1 == ResourceTypes::NONE ? mResource1 : mResource2);
-    int index = indexInVector(aParam, mResourceTypeMatchingPool);
-    if (index == -1)
-    {
-        aReturnMsg.emplace_back("unknown parameter: " + aParam);
-        return ActionStatus::FAILED;
-    }
-    resource = static_cast<ResourceTypes>(index);
-    return ActionStatus::SUCCESS;
-}
-
-bool YearOfPlentyHandler::parameterComplete() const
-{
-    return (mResource1 != ResourceTypes::NONE && mResource2 != ResourceTypes::NONE);
-}
-
-void YearOfPlentyHandler::resetParameters()
+ActionStatus YearOfPlentyHandler::resume(GameMap& aMap, const std::string& aParam, const Point_t aPoint, std::vector<std::string>& aReturnMsg)
 {
+    COROUTINE_BEGIN();
     mResource1 = ResourceTypes::NONE;
     mResource2 = ResourceTypes::NONE;
-}
 
-void YearOfPlentyHandler::instruction(std::vector<std::string>& aReturnMsg) const
-{
-    if (mResource1 == ResourceTypes::NONE)
+    AWAIT_PARAMETER("Which 2 resources you want to get?", stringVectorJoin(mResourceTypeMatchingPool));
     {
-        aReturnMsg.emplace_back("Which 2 resources you want to get?");
-        aReturnMsg.emplace_back(stringVectorJoin(mResourceTypeMatchingPool));
-        return;
+        const int index = indexInVector(aParam, mResourceTypeMatchingPool);
+        if (index == -1)
+        {
+            aReturnMsg.emplace_back("unknown parameter: " + aParam);
+            return ActionStatus::FAILED;
+        }
+        mResource1 = static_cast<ResourceTypes>(index);
     }
-    if (mResource2 == ResourceTypes::NONE)
+
+    AWAIT_PARAMETER("You chose " + mResourceTypeMatchingPool.at(static_cast<size_t>(mResource1)) + \
+                    ", what is the second resource you want?", stringVectorJoin(mResourceTypeMatchingPool));
     {
-        aReturnMsg.emplace_back("You chose " + mResourceTypeMatchingPool.at(static_cast<size_t>(mResource1)) + \
-        ", what is the second resource you want?");
-        aReturnMsg.emplace_back(stringVectorJoin(mResourceTypeMatchingPool));
-        return;
+        const int index = indexInVector(aParam, mResourceTypeMatchingPool);
+        if (index == -1)
+        {
+            aReturnMsg.emplace_back("unknown parameter: " + aParam);
+            return ActionStatus::FAILED;
+        }
+        mResource2 = static_cast<ResourceTypes>(index);
     }
+    COROUTINE_END();
 }
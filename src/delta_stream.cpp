@@ -0,0 +1,342 @@
+/**
+ * Project: catan
+ * @file delta_stream.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include "delta_stream.hpp"
+#include "game_map.hpp"
+#include "vertex.hpp"
+#include "edge.hpp"
+#include "logger.hpp"
+#include "little_endian.hpp"
+
+namespace
+{
+
+constexpr size_t STATE_HEADER_SIZE = 10U;
+constexpr size_t PLAYER_SIZE = 2U * (CONSUMABLE_RESOURCE_SIZE + 2U * DEVELOPMENT_CARD_TYPE_SIZE) + 1U;
+
+inline uint8_t ownerNibble(const int aOwner)
+{
+    return (aOwner < 0) ? DeltaStream::NO_OWNER : static_cast<uint8_t>(aOwner & 0x0F);
+}
+
+inline uint16_t change(const size_t aFrom, const size_t aTo)
+{
+    return static_cast<uint16_t>(static_cast<int16_t>(static_cast<int64_t>(aTo) - static_cast<int64_t>(aFrom)));
+}
+
+inline size_t readUint16(const std::vector<uint8_t>& aBuffer, const size_t aIndex)
+{
+    return loadUint(&aBuffer[aIndex], 2U);
+}
+
+inline void writeUint16(std::vector<uint8_t>& aBuffer, const size_t aIndex, const size_t aValue)
+{
+    storeUint(&aBuffer[aIndex], aValue, 2U);
+}
+
+// a count of the state, plus a signed change
+inline void addUint16(std::vector<uint8_t>& aBuffer, const size_t aIndex, const uint16_t aChange)
+{
+    writeUint16(aBuffer, aIndex, readUint16(aBuffer, aIndex) + static_cast<int16_t>(aChange));
+}
+
+} // namespace
+
+DeltaStream::DeltaStream(const size_t aKeyframeInterval) :
+    mKeyframeInterval(aKeyframeInterval),
+    mDeltasSinceKeyframe(0U),
+    mNumDeltas(0U),
+    mNumKeyframes(0U)
+{
+    // empty
+}
+
+void DeltaStream::push(const DeltaType aType, const uint8_t aAux, const uint16_t aValue)
+{
+    mBuffer.push_back(static_cast<uint8_t>(aType));
+    mBuffer.push_back(aAux);
+    pushUint(mBuffer, aValue, 2U);
+    if (aType != DeltaType::KEYFRAME)
+    {
+        ++mNumDeltas;
+        ++mDeltasSinceKeyframe;
+    }
+}
+
+void DeltaStream::keyframe(const GameMap& aMap)
+{
+    aMap.exportBoard(mBoard);
+    aMap.exportState(mState);
+    const size_t payload = mBoard.size() + mState.size();
+    const size_t numWords = (payload + DELTA_SIZE - 1U) / DELTA_SIZE;
+    if (numWords > UINT16_MAX)
+    {
+        ERROR_LOG("Game state is too large for a keyframe: ", payload, " bytes");
+    }
+    push(DeltaType::KEYFRAME, 0U, static_cast<uint16_t>(numWords));
+    mBuffer.insert(mBuffer.end(), mBoard.begin(), mBoard.end());
+    mBuffer.insert(mBuffer.end(), mState.begin(), mState.end());
+    mBuffer.resize(mBuffer.size() + numWords * DELTA_SIZE - payload, 0U);
+
+    mPlayers.resize(aMap.getNumOfPlayers());
+    for (size_t player = 0U; player < mPlayers.size(); ++player)
+    {
+        const Player& source = *aMap.getPlayers()[player];
+        mPlayers[player] = PlayerCards_t{source.getResources(), source.getDevCards(), source.getUsedDevCards(), \
+            static_cast<uint8_t>((source.hasLargestArmy() ? 0x01U : 0U) | (source.hasLongestRoad() ? 0x02U : 0U))};
+    }
+    mDeltasSinceKeyframe = 0U;
+    ++mNumKeyframes;
+}
+
+void DeltaStream::onEvent(const GameMap& aMap, const JournalEventType aType, const uint8_t aAux, const uint16_t aId)
+{
+    if (mNumKeyframes == 0U || mPlayers.size() != aMap.getNumOfPlayers())
+    {
+        // nothing to be relative to, the keyframe has the action already
+        keyframe(aMap);
+        return;
+    }
+    const BoardState_t& state = aMap.getBoardState();
+    switch (aType)
+    {
+        case JournalEventType::NEXT_PLAYER:
+            push(DeltaType::CURRENT_PLAYER, static_cast<uint8_t>(aMap.currentPlayer()), 0U);
+            break;
+        case JournalEventType::ROLL_DICE:
+            push(DeltaType::DICE, aAux, 0U);
+            break;
+        case JournalEventType::BUILD_ROAD:
+            push(DeltaType::EDGE, ownerNibble(aMap.getEdges()[aId]->getOwner(state)), aId);
+            break;
+        case JournalEventType::BUILD_SETTLEMENT:
+        case JournalEventType::BUILD_CITY:
+        {
+            const Vertex* const pVertex = aMap.getVertices()[aId];
+            push(DeltaType::VERTEX, static_cast<uint8_t>(ownerNibble(pVertex->getOwner(state)) | \
+                                                         (static_cast<uint8_t>(pVertex->getColonyType(state)) << 4U)), aId);
+            break;
+        }
+        case JournalEventType::MOVE_ROBBER:
+            push(DeltaType::ROBBER, 0U, aId);
+            break;
+        default:
+            // the cards only, see diffPlayers()
+            break;
+    }
+    diffPlayers(aMap);
+
+    if (mDeltasSinceKeyframe >= mKeyframeInterval)
+    {
+        keyframe(aMap);
+    }
+}
+
+void DeltaStream::sync(const GameMap& aMap)
+{
+    if (mNumKeyframes == 0U || mPlayers.size() != aMap.getNumOfPlayers())
+    {
+        keyframe(aMap);
+        return;
+    }
+    diffPlayers(aMap);
+}
+
+void DeltaStream::diffPlayers(const GameMap& aMap)
+{
+    for (size_t player = 0U; player < mPlayers.size(); ++player)
+    {
+        const Player& source = *aMap.getPlayers()[player];
+        PlayerCards_t& sent = mPlayers[player];
+        for (size_t resource = 0U; resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+        {
+            if (source.getResources()[resource] != sent.resources[resource])
+            {
+                push(DeltaType::RESOURCE, static_cast<uint8_t>(player | (resource << 4U)), \
+                     change(sent.resources[resource], source.getResources()[resource]));
+                sent.resources[resource] = source.getResources()[resource];
+            }
+        }
+        for (size_t card = 0U; card < DEVELOPMENT_CARD_TYPE_SIZE; ++card)
+        {
+            if (source.getDevCards()[card] != sent.devCards[card])
+            {
+                push(DeltaType::DEV_CARD, static_cast<uint8_t>(player | (card << 4U)), \
+                     change(sent.devCards[card], source.getDevCards()[card]));
+                sent.devCards[card] = source.getDevCards()[card];
+            }
+            if (source.getUsedDevCards()[card] != sent.usedDevCards[card])
+            {
+                push(DeltaType::USED_DEV_CARD, static_cast<uint8_t>(player | (card << 4U)), \
+                     change(sent.usedDevCards[card], source.getUsedDevCards()[card]));
+                sent.usedDevCards[card] = source.getUsedDevCards()[card];
+            }
+        }
+        const uint8_t awards = static_cast<uint8_t>((source.hasLargestArmy() ? 0x01U : 0U) | \
+                                                    (source.hasLongestRoad() ? 0x02U : 0U));
+        if (awards != sent.awards)
+        {
+            push(DeltaType::AWARDS, static_cast<uint8_t>(player), awards);
+            sent.awards = awards;
+        }
+    }
+}
+
+void DeltaStream::take(std::vector<uint8_t>& aBytes)
+{
+    aBytes.insert(aBytes.end(), mBuffer.begin(), mBuffer.end());
+    mBuffer.clear();
+}
+
+bool DeltaStream::empty() const
+{
+    return mBuffer.empty();
+}
+
+size_t DeltaStream::getNumDeltas() const
+{
+    return mNumDeltas;
+}
+
+size_t DeltaStream::getNumKeyframes() const
+{
+    return mNumKeyframes;
+}
+
+int DeltaStream::apply(const std::vector<uint8_t>& aDeltas, std::vector<uint8_t>& aBoard, std::vector<uint8_t>& aState)
+{
+    // the layout of GameMap::exportState()
+    size_t numOfVertices = 0U;
+    size_t numOfEdges = 0U;
+    size_t numOfPlayers = 0U;
+    size_t edgeStart = 0U;
+    size_t playerStart = 0U;
+    const auto readLayout = [&]()
+    {
+        numOfVertices = readUint16(aState, 0U);
+        numOfEdges = readUint16(aState, 2U);
+        numOfPlayers = readUint16(aState, 4U);
+        edgeStart = STATE_HEADER_SIZE + 2U * numOfVertices;
+        playerStart = edgeStart + numOfEdges;
+        return aState.size() == playerStart + numOfPlayers * PLAYER_SIZE;
+    };
+    if (!aState.empty() && !readLayout())
+    {
+        return 3;
+    }
+
+    size_t index = 0U;
+    while (index < aDeltas.size())
+    {
+        if (index + DELTA_SIZE > aDeltas.size())
+        {
+            return 1;
+        }
+        const DeltaType type = static_cast<DeltaType>(aDeltas[index]);
+        const uint8_t aux = aDeltas[index + 1U];
+        const size_t value = readUint16(aDeltas, index + 2U);
+        const size_t player = aux & 0x0FU;
+        const size_t item = aux >> 4U;
+        index += DELTA_SIZE;
+
+        if (type == DeltaType::KEYFRAME)
+        {
+            const size_t end = index + value * DELTA_SIZE;
+            if (end > aDeltas.size() || value * DELTA_SIZE < 2U)
+            {
+                return 1;
+            }
+            const size_t boardSize = 2U * readUint16(aDeltas, index) + 4U;
+            if (index + boardSize + STATE_HEADER_SIZE > end)
+            {
+                return 3;
+            }
+            aBoard.assign(aDeltas.begin() + index, aDeltas.begin() + index + boardSize);
+            aState.assign(aDeltas.begin() + index + boardSize, aDeltas.begin() + end);
+            // drop the padding
+            const size_t stateSize = STATE_HEADER_SIZE + 2U * readUint16(aState, 0U) + readUint16(aState, 2U) + \
+                                     readUint16(aState, 4U) * PLAYER_SIZE;
+            if (stateSize > aState.size())
+            {
+                return 3;
+            }
+            aState.resize(stateSize);
+            readLayout();
+            index = end;
+            continue;
+        }
+        if (aState.empty())
+        {
+            return 2;
+        }
+
+        switch (type)
+        {
+            case DeltaType::CURRENT_PLAYER:
+                if (aux >= numOfPlayers)
+                {
+                    return 3;
+                }
+                writeUint16(aState, 6U, aux);
+                break;
+            case DeltaType::DICE:
+                break;
+            case DeltaType::VERTEX:
+                if (value >= numOfVertices || (player != NO_OWNER && player >= numOfPlayers))
+                {
+                    return 3;
+                }
+                aState[STATE_HEADER_SIZE + 2U * value] = (player == NO_OWNER) ? 0xFFU : static_cast<uint8_t>(player);
+                aState[STATE_HEADER_SIZE + 2U * value + 1U] = static_cast<uint8_t>(item);
+                break;
+            case DeltaType::EDGE:
+                if (value >= numOfEdges || (player != NO_OWNER && player >= numOfPlayers))
+                {
+                    return 3;
+                }
+                aState[edgeStart + value] = (player == NO_OWNER) ? 0xFFU : static_cast<uint8_t>(player);
+                break;
+            case DeltaType::ROBBER:
+                if (value >= readUint16(aBoard, 0U))
+                {
+                    return 3;
+                }
+                writeUint16(aState, 8U, value);
+                writeUint16(aBoard, aBoard.size() - 2U, value);
+                break;
+            case DeltaType::RESOURCE:
+                if (player >= numOfPlayers || item >= CONSUMABLE_RESOURCE_SIZE)
+                {
+                    return 3;
+                }
+                addUint16(aState, playerStart + player * PLAYER_SIZE + 2U * item, static_cast<uint16_t>(value));
+                break;
+            case DeltaType::DEV_CARD:
+            case DeltaType::USED_DEV_CARD:
+                if (player >= numOfPlayers || item >= DEVELOPMENT_CARD_TYPE_SIZE)
+                {
+                    return 3;
+                }
+                addUint16(aState, playerStart + player * PLAYER_SIZE + 2U * CONSUMABLE_RESOURCE_SIZE + \
+                          (type == DeltaType::USED_DEV_CARD ? 2U * DEVELOPMENT_CARD_TYPE_SIZE : 0U) + 2U * item, \
+                          static_cast<uint16_t>(value));
+                break;
+            case DeltaType::AWARDS:
+                if (aux >= numOfPlayers)
+                {
+                    return 3;
+                }
+                aState[playerStart + aux * PLAYER_SIZE + PLAYER_SIZE - 1U] = static_cast<uint8_t>(value);
+                break;
+            default:
+                return 3;
+        }
+    }
+    return 0;
+}
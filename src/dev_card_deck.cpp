@@ -0,0 +1,80 @@
+/**
+ * Project: catan
+ * @file dev_card_deck.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include "dev_card_deck.hpp"
+
+namespace
+{
+
+constexpr std::array<size_t, DEVELOPMENT_CARD_TYPE_SIZE> DECK_COMPOSITION = {
+    constant::NUM_DEV_CARD_KNIGHT,
+    constant::NUM_DEV_CARD_ROAD_BUILDING,
+    constant::NUM_DEV_CARD_YEAR_OF_PLENTY,
+    constant::NUM_DEV_CARD_MONOPOLY,
+    constant::NUM_DEV_CARD_ONE_VICTORY_POINT,
+};
+
+} // namespace
+
+void DevCardDeck_t::reset()
+{
+    size = 0U;
+    for (size_t card = 0U; card < DEVELOPMENT_CARD_TYPE_SIZE; ++card)
+    {
+        remaining[card] = static_cast<uint8_t>(DECK_COMPOSITION[card]);
+        std::fill_n(cards.begin() + size, DECK_COMPOSITION[card], static_cast<uint8_t>(card));
+        size = static_cast<uint8_t>(size + DECK_COMPOSITION[card]);
+    }
+}
+
+bool DevCardDeck_t::empty() const
+{
+    return size == 0U;
+}
+
+int DevCardDeck_t::draw()
+{
+    if (size == 0U)
+    {
+        return -1;
+    }
+    const uint8_t card = cards[--size];
+    --remaining[card];
+    return card;
+}
+
+void DevCardDeck_t::putBack(const DevelopmentCardTypes aCard)
+{
+    if (size < cards.size())
+    {
+        cards[size++] = static_cast<uint8_t>(aCard);
+        ++remaining[static_cast<size_t>(aCard)];
+    }
+}
+
+int DevCardDeck_t::take(const DevelopmentCardTypes aCard)
+{
+    // the top is the likeliest, a journal replayed on the deck it was recorded on always finds it there
+    for (size_t index = size; index > 0U; --index)
+    {
+        if (cards[index - 1U] == static_cast<uint8_t>(aCard))
+        {
+            std::swap(cards[index - 1U], cards[size - 1U]);
+            draw();
+            return 0;
+        }
+    }
+    return 1;
+}
+
+double DevCardDeck_t::getDrawChance(const DevelopmentCardTypes aCard) const
+{
+    return (size == 0U) ? 0.0 : static_cast<double>(remaining[static_cast<size_t>(aCard)]) / size;
+}
@@ -10,7 +10,7 @@
 #include "logger.hpp"
 #include "edge.hpp"
 #include "vertex.hpp"
-#include "game_map.hpp"
+#include "board_layout.hpp"
 #include "utility.hpp"
 
 std::vector<Point_t> Edge::getAllPoints() const
@@ -38,17 +38,16 @@ std::vector<Point_t> Edge::getAllPoints() const
     return allPoints;
 }
 
-int Edge::populateAdjacencies(GameMap& aMap)
+int Edge::populateAdjacencies(BoardLayout& aLayout)
 {
     // reset edge
-    mOwner = -1;
     mAdjacentVertices.clear();
     mAdjacentEdges.clear();
 
     int rc = 0;
     std::pair<Point_t, Point_t> vertexPoints = getAdjacentVertexPoints();
-    rc |= addAdjacency(aMap, vertexPoints.first);
-    rc |= addAdjacency(aMap, vertexPoints.second);
+    rc |= addAdjacency(aLayout, vertexPoints.first);
+    rc |= addAdjacency(aLayout, vertexPoints.second);
 
     DEBUG_LOG_L0("Populated Adjacent Vertices for " + getStringId() + " ", mAdjacentVertices);
     DEBUG_LOG_L0("Populated Adjacent Edges for " + getStringId() + " ", mAdjacentEdges);
@@ -60,13 +59,14 @@ int Edge::populateAdjacencies(GameMap& aMap)
     return rc;
 }
 
-int Edge::addAdjacency(GameMap& aMap, const Point_t aPoint)
+int Edge::addAdjacency(BoardLayout& aLayout, const Point_t aPoint)
 {
-    const Vertex* const pVertex = dynamic_cast<const Vertex*>(aMap.getTerrain(aPoint));
+    const Terrain* const pTerrain = aLayout.getTerrain(aPoint);
+    const Vertex* const pVertex = dynamic_cast<const Vertex*>(pTerrain);
     if (!pVertex)
     {
         // not vertex
-        WARN_LOG("At ", aPoint, ", Expected Vertex - Actual ", pVertex->getStringId());
+        WARN_LOG("At ", aPoint, ", Expected Vertex - Actual ", (pTerrain ? pTerrain->getStringId() : "nullptr"));
         return 1;
     }
     mAdjacentVertices.emplace(pVertex);
@@ -75,16 +75,21 @@ int Edge::addAdjacency(GameMap& aMap, const Point_t aPoint)
     return 0;
 }
 
-const Vertex* Edge::getOtherVertex(const GameMap& aMap, const Vertex& aVertex) const
+const std::set<const Vertex*>& Edge::getAdjacentVertices() const
+{
+    return mAdjacentVertices;
+}
+
+const Vertex* Edge::getOtherVertex(const BoardLayout& aLayout, const Vertex& aVertex) const
 {
     std::pair<Point_t, Point_t> vertexPoints = getAdjacentVertexPoints();
     if (vertexPoints.first == aVertex.getTopLeft())
     {
-        return dynamic_cast<const Vertex*>(aMap.getTerrain(vertexPoints.second));
+        return dynamic_cast<const Vertex*>(aLayout.getTerrain(vertexPoints.second));
     }
     else if (vertexPoints.second == aVertex.getTopLeft())
     {
-        return dynamic_cast<const Vertex*>(aMap.getTerrain(vertexPoints.first));
+        return dynamic_cast<const Vertex*>(aLayout.getTerrain(vertexPoints.first));
     }
 
     WARN_LOG("Unknown adjacent vertex: " + aVertex.getStringId() + " at ", aVertex.getTopLeft());
@@ -116,31 +121,23 @@ std::pair<Point_t, Point_t> Edge::getAdjacentVertexPoints() const
     }
 }
 
-int Edge::setOwner(int aPlayerId)
-{
-    mOwner = aPlayerId;
-    mColorIndex = static_cast<ColorPairIndex>(mOwner + ColorPairIndex::PLAYER_START);
-    INFO_LOG("Successfully set owner Player#", mOwner, " for " + getStringId());
-    return 0;
-}
-
-int Edge::getOwner() const
+int Edge::getOwner(const BoardState_t& aState) const
 {
-    return mOwner;
+    return aState.edgeOwner[mId];
 }
 
-bool Edge::isAvailable(const int aPlayerId) const
+bool Edge::isAvailable(const BoardState_t& aState, const int aPlayerId) const
 {
     for (const Vertex* const pAdjVertex : mAdjacentVertices)
     {
-        if (pAdjVertex->getOwner() == aPlayerId)
+        if (pAdjVertex->getOwner(aState) == aPlayerId)
         {
             return true;
         }
     }
     for (const Edge* const pAdjEdge : mAdjacentEdges)
     {
-        if (pAdjEdge->getOwner() == aPlayerId)
+        if (pAdjEdge->getOwner(aState) == aPlayerId)
         {
             return true;
         }
@@ -149,8 +146,7 @@ bool Edge::isAvailable(const int aPlayerId) const
 }
 
 Edge::Edge(const int aId, const Point_t aTopLeft, const char aDirection) :
-    Terrain(aId, aTopLeft),
-    mOwner(-1)
+    Terrain(aId, aTopLeft)
 {
     if (aDirection == '-' || aDirection == '/' || aDirection == '\\' )
     {
@@ -177,7 +173,7 @@ Edge::Edge(const int aId, const Point_t aTopLeft, const char aDirection) :
     }
 }
 
-char Edge::getCharRepresentation(const size_t aPointX, const size_t aPointY, const bool aUseId) const
+char Edge::getCharRepresentation(const size_t aPointX, const size_t aPointY, const BoardState_t& aState, const bool aUseId) const
 {
     if (aUseId)
     {
@@ -189,6 +185,13 @@ char Edge::getCharRepresentation(const size_t aPointX, const size_t aPointY, con
     }
 }
 
+ColorPairIndex Edge::getColorIndex(const BoardState_t& aState) const
+{
+    // -1: no owner
+    const int owner = getOwner(aState);
+    return (owner < 0) ? mColorIndex : static_cast<ColorPairIndex>(owner + ColorPairIndex::PLAYER_START);
+}
+
 std::string Edge::getStringId() const
 {
     return Logger::formatString("Edge#", mId);
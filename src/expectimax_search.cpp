@@ -0,0 +1,576 @@
+/**
+ * Project: catan
+ * @file expectimax_search.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include "expectimax_search.hpp"
+#include "game_map.hpp"
+#include "random_engine.hpp"
+#include "logger.hpp"
+
+namespace
+{
+
+// the dice outcomes, the most likely first, so that chance nodes are cut off early
+constexpr std::array<int, 11> DICE_ORDER = {7, 6, 8, 5, 9, 4, 10, 3, 11, 2, 12};
+
+// the evaluation is within (-WIN_VALUE, WIN_VALUE), a won / lost game is +/- WIN_VALUE
+constexpr double WIN_VALUE = 10000.0;
+constexpr double VALUE_VICTORY_POINT = 100.0;
+constexpr double VALUE_PIP = 4.0;       // per 1/36 of production per turn
+constexpr double VALUE_ROAD = 4.0;
+constexpr double VALUE_CARD = 3.0;      // per resource on hand, up to MAX_HAND_ON_SEVEN
+
+constexpr size_t TIME_CHECK_INTERVAL = 1024U;  // num of nodes between two checks of the clock
+constexpr uint64_t KEY_SEED = 0x5EA4C4E5U;
+
+inline uint64_t nextKey(RandomEngine& aEngine)
+{
+    return (static_cast<uint64_t>(nextUint32(aEngine)) << 32) | nextUint32(aEngine);
+}
+
+inline bool isSameAction(const GameAction_t& aLhs, const GameAction_t& aRhs)
+{
+    return aLhs.type == aRhs.type && aLhs.id == aRhs.id;
+}
+
+} // namespace
+
+ExpectimaxSearch::ExpectimaxSearch(const size_t aMaxDepth, const size_t aTimeLimitMs, const size_t aTableSizeLog2) :
+    mMaxDepth(std::max<size_t>(aMaxDepth, 1U)),
+    mTimeLimitMs(aTimeLimitMs),
+    mTable(static_cast<size_t>(1U) << aTableSizeLog2),
+    mTableMask((static_cast<uint64_t>(1U) << aTableSizeLog2) - 1U),
+    mResourceKeys(),
+    mPlayerKey(0U),
+    mRobberPhaseKey(0U),
+    mRootKey(0U),
+    mBoardKey(0U),
+    mRootPlayer(0U),
+    mNumNodes(0U),
+    mDepthReached(0U),
+    mIsAborted(false),
+    mRootAction(GameAction_t{GameActionType::END_TURN, 0U, 0U}),
+    mActions(mMaxDepth + 2U)
+{
+    for (std::vector<GameAction_t>& actions : mActions)
+    {
+        actions.reserve(constant::MAX_NUM_VERTICES + constant::MAX_NUM_EDGES + 1U);
+    }
+}
+
+void ExpectimaxSearch::initKeys(const GameMap& aMap)
+{
+    if (mVertexKeys.size() == aMap.getVertices().size() * 4U && mEdgeKeys.size() == aMap.getEdges().size() * 2U && \
+        mRobberKeys.size() == aMap.getLands().size())
+    {
+        return;
+    }
+    // another map, the entries of the table are meaningless
+    std::fill(mTable.begin(), mTable.end(), TableEntry_t());
+    RandomEngine engine(KEY_SEED);
+    mVertexKeys.resize(aMap.getVertices().size() * 4U);
+    mEdgeKeys.resize(aMap.getEdges().size() * 2U);
+    mRobberKeys.resize(aMap.getLands().size());
+    for (uint64_t& key : mVertexKeys)
+    {
+        key = nextKey(engine);
+    }
+    for (uint64_t& key : mEdgeKeys)
+    {
+        key = nextKey(engine);
+    }
+    for (uint64_t& key : mRobberKeys)
+    {
+        key = nextKey(engine);
+    }
+    for (uint64_t& key : mResourceKeys)
+    {
+        key = nextKey(engine);
+    }
+    mPlayerKey = nextKey(engine);
+    mRobberPhaseKey = nextKey(engine);
+    mRootKey = nextKey(engine);
+}
+
+uint64_t ExpectimaxSearch::computeBoardKey(const GameMap& aMap) const
+{
+    const BoardState_t& board = aMap.getBoardState();
+    uint64_t key = mRobberKeys[aMap.getRobLandId()] ^ ((aMap.currentPlayer() == 1U) ? mPlayerKey : 0U);
+    for (const Vertex* const pVertex : aMap.getVertices())
+    {
+        const int owner = pVertex->getOwner(board);
+        if (owner >= 0)
+        {
+            const size_t base = (pVertex->getId() * 2U + owner) * 2U;
+            key ^= mVertexKeys[base] ^ ((pVertex->getColonyType(board) == ColonyType::CITY) ? mVertexKeys[base + 1U] : 0U);
+        }
+    }
+    for (const Edge* const pEdge : aMap.getEdges())
+    {
+        if (pEdge->getOwner(board) >= 0)
+        {
+            key ^= mEdgeKeys[pEdge->getId() * 2U + pEdge->getOwner(board)];
+        }
+    }
+    return key;
+}
+
+uint64_t ExpectimaxSearch::getKey(const GameMap& aMap, const bool aIsRobberPhase) const
+{
+    // resources are read rather than tracked, every event of a roll would change them
+    uint64_t key = mBoardKey ^ (aIsRobberPhase ? mRobberPhaseKey : 0U) ^ ((mRootPlayer == 1U) ? mRootKey : 0U);
+    for (size_t playerId = 0U; playerId < 2U; ++playerId)
+    {
+        const std::array<size_t, CONSUMABLE_RESOURCE_SIZE>& resources = aMap.getPlayers()[playerId]->getResources();
+        for (size_t resource = 0U; resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+        {
+            const size_t amount = std::min(resources[resource], MAX_KEYED_RESOURCES - 1U);
+            key ^= mResourceKeys[(playerId * CONSUMABLE_RESOURCE_SIZE + resource) * MAX_KEYED_RESOURCES + amount];
+        }
+    }
+    return key;
+}
+
+uint64_t ExpectimaxSearch::getEventKey(const JournalEvent_t& aEvent, const size_t aPlayer) const
+{
+    switch (aEvent.type)
+    {
+        case JournalEventType::NEXT_PLAYER:
+            return mPlayerKey;
+        case JournalEventType::MOVE_ROBBER:
+            return mRobberKeys[aEvent.aux] ^ mRobberKeys[aEvent.id];
+        case JournalEventType::BUILD_ROAD:
+            return mEdgeKeys[aEvent.id * 2U + aPlayer];
+        case JournalEventType::BUILD_SETTLEMENT:
+            return mVertexKeys[(aEvent.id * 2U + aPlayer) * 2U];
+        case JournalEventType::BUILD_CITY:
+            return mVertexKeys[(aEvent.id * 2U + aPlayer) * 2U + 1U];
+        default:
+            return 0U;
+    }
+}
+
+void ExpectimaxSearch::makeEvent(GameMap& aMap, const JournalEvent_t& aEvent)
+{
+    mBoardKey ^= getEventKey(aEvent, aMap.currentPlayer());
+    aMap.replayEvent(aEvent);
+}
+
+void ExpectimaxSearch::unmakeEvent(GameMap& aMap, const JournalEvent_t& aEvent)
+{
+    aMap.revertEvent(aEvent);
+    mBoardKey ^= getEventKey(aEvent, aMap.currentPlayer());
+}
+
+void ExpectimaxSearch::generateActions(const GameMap& aMap, const bool aIsRobberPhase, std::vector<GameAction_t>& aActions) const
+{
+    aActions.clear();
+    if (aIsRobberPhase)
+    {
+        for (const Land* const pLand : aMap.getLands())
+        {
+            if (static_cast<size_t>(pLand->getId()) != aMap.getRobLandId())
+            {
+                aActions.push_back(GameAction_t{GameActionType::MOVE_ROBBER, NO_PLAYER, static_cast<uint16_t>(pLand->getId())});
+            }
+        }
+        return;
+    }
+
+    // the order of the checks of GameMap::buildColony() and GameMap::buildRoad()
+    const BoardState_t& board = aMap.getBoardState();
+    const int playerId = aMap.currentPlayer();
+    if (aMap.currentPlayerHasResourceForCity())
+    {
+        for (const Vertex* const pVertex : aMap.getVertices())
+        {
+            if (pVertex->getOwner(board) == playerId && pVertex->getColonyType(board) == ColonyType::SETTLEMENT)
+            {
+                aActions.push_back(GameAction_t{GameActionType::BUILD_CITY, 0U, static_cast<uint16_t>(pVertex->getId())});
+            }
+        }
+    }
+    if (aMap.currentPlayerHasResourceForSettlement())
+    {
+        for (const Vertex* const pVertex : aMap.getVertices())
+        {
+            if (pVertex->getOwner(board) == -1 && pVertex->isAvailable(board) && pVertex->isConnected(board, playerId))
+            {
+                aActions.push_back(GameAction_t{GameActionType::BUILD_SETTLEMENT, 0U, static_cast<uint16_t>(pVertex->getId())});
+            }
+        }
+    }
+    if (aMap.currentPlayerHasResourceForRoad())
+    {
+        for (const Edge* const pEdge : aMap.getEdges())
+        {
+            if (pEdge->getOwner(board) == -1 && pEdge->isAvailable(board, playerId))
+            {
+                aActions.push_back(GameAction_t{GameActionType::BUILD_ROAD, 0U, static_cast<uint16_t>(pEdge->getId())});
+            }
+        }
+    }
+    aActions.push_back(GameAction_t{GameActionType::END_TURN, 0U, 0U});
+}
+
+double ExpectimaxSearch::evaluate(const GameMap& aMap) const
+{
+    const BoardState_t& board = aMap.getBoardState();
+    std::array<double, 2U> score = {0.0, 0.0};
+    for (size_t playerId = 0U; playerId < 2U; ++playerId)
+    {
+        const Player* const pPlayer = aMap.getPlayers()[playerId];
+        const std::array<size_t, CONSUMABLE_RESOURCE_SIZE>& resources = pPlayer->getResources();
+        const size_t numCards = std::accumulate(resources.begin(), resources.end(), static_cast<size_t>(0U));
+        score[playerId] = VALUE_VICTORY_POINT * pPlayer->getVictoryPoint(board, false) + \
+                          VALUE_CARD * std::min<size_t>(numCards, constant::MAX_HAND_ON_SEVEN);
+    }
+    for (const Land* const pLand : aMap.getLands())
+    {
+        if (pLand->getResourceType(board) == ResourceTypes::DESERT || pLand->isUnderRobber(board))
+        {
+            continue;
+        }
+        const double landValue = VALUE_PIP * constant::dicePips(pLand->getDiceNum(board));
+        for (const Vertex* const pVertex : pLand->getAdjacentVertices())
+        {
+            if (pVertex->getOwner(board) >= 0)
+            {
+                score[pVertex->getOwner(board)] += pVertex->getColonyType(board) * landValue;
+            }
+        }
+    }
+    for (const Edge* const pEdge : aMap.getEdges())
+    {
+        if (pEdge->getOwner(board) >= 0)
+        {
+            score[pEdge->getOwner(board)] += VALUE_ROAD;
+        }
+    }
+    const double value = score[mRootPlayer] - score[1U - mRootPlayer];
+    return std::max(std::min(value, WIN_VALUE - 1.0), 1.0 - WIN_VALUE);
+}
+
+bool ExpectimaxSearch::isGameOver(const GameMap& aMap, double& aValue) const
+{
+    for (size_t playerId = 0U; playerId < 2U; ++playerId)
+    {
+        if (aMap.getPlayers()[playerId]->getVictoryPoint(aMap.getBoardState(), false) >= constant::WINNING_VICTORY_POINT)
+        {
+            aValue = (playerId == mRootPlayer) ? WIN_VALUE : -WIN_VALUE;
+            return true;
+        }
+    }
+    return false;
+}
+
+double ExpectimaxSearch::searchDecision(GameMap& aMap, const size_t aDepth, double aAlpha, double aBeta,
+                                        const bool aIsRobberPhase, const size_t aPly)
+{
+    ++mNumNodes;
+    if (mDepthReached > 0U && mTimeLimitMs > 0U && mNumNodes % TIME_CHECK_INTERVAL == 0U && \
+        std::chrono::steady_clock::now() >= mDeadline)
+    {
+        mIsAborted = true;
+    }
+    double value = 0.0;
+    if (mIsAborted)
+    {
+        return value;
+    }
+    // the root always picks an action, even if the game is over already
+    if (aPly > 0U && isGameOver(aMap, value))
+    {
+        return value;
+    }
+    if (aDepth == 0U)
+    {
+        return evaluate(aMap);
+    }
+
+    const uint64_t key = getKey(aMap, aIsRobberPhase);
+    TableEntry_t& entry = mTable[key & mTableMask];
+    const bool isHit = (entry.key == key);
+    if (isHit && entry.depth >= aDepth && aPly > 0U)
+    {
+        value = entry.value;
+        if (entry.bound == Bound::EXACT || (entry.bound == Bound::LOWER && value >= aBeta) || \
+            (entry.bound == Bound::UPPER && value <= aAlpha))
+        {
+            return value;
+        }
+    }
+
+    std::vector<GameAction_t>& actions = mActions[aPly];
+    generateActions(aMap, aIsRobberPhase, actions);
+    if (isHit)
+    {
+        // the best action of a previous search first, it is only taken if it is still legal
+        const GameAction_t tableAction = entry.bestAction;
+        const auto iter = std::find_if(actions.begin(), actions.end(), [&tableAction](const GameAction_t& aAction) {
+                return isSameAction(aAction, tableAction);
+            });
+        if (iter != actions.end())
+        {
+            std::iter_swap(actions.begin(), iter);
+        }
+    }
+
+    const bool isMax = (aMap.currentPlayer() == mRootPlayer);
+    const double alpha = aAlpha;
+    const double beta = aBeta;
+    double best = isMax ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+    GameAction_t bestAction = actions.front();
+    for (size_t index = 0U; index < actions.size(); ++index)
+    {
+        // actions is not touched by the plies below
+        const GameAction_t action = actions[index];
+        value = searchAction(aMap, action, aDepth, aAlpha, aBeta, aPly);
+        if (mIsAborted)
+        {
+            return 0.0;
+        }
+        if (isMax ? (value > best) : (value < best))
+        {
+            best = value;
+            bestAction = action;
+        }
+        if (isMax)
+        {
+            aAlpha = std::max(aAlpha, value);
+        }
+        else
+        {
+            aBeta = std::min(aBeta, value);
+        }
+        if (aAlpha >= aBeta)
+        {
+            break;
+        }
+    }
+
+    // the entry may have been overwritten by the plies below
+    TableEntry_t& newEntry = mTable[key & mTableMask];
+    newEntry.key = key;
+    newEntry.value = static_cast<float>(best);
+    newEntry.depth = static_cast<uint8_t>(aDepth);
+    newEntry.bound = (best <= alpha) ? Bound::UPPER : ((best >= beta) ? Bound::LOWER : Bound::EXACT);
+    newEntry.bestAction = bestAction;
+    if (aPly == 0U)
+    {
+        mRootAction = bestAction;
+    }
+    return best;
+}
+
+double ExpectimaxSearch::searchAction(GameMap& aMap, const GameAction_t& aAction, const size_t aDepth,
+                                      const double aAlpha, const double aBeta, const size_t aPly)
+{
+    JournalEvent_t event = {JournalEventType::NEXT_PLAYER, 0U, aAction.id};
+    switch (aAction.type)
+    {
+        case GameActionType::END_TURN:
+        {
+            makeEvent(aMap, event);
+            const double value = searchChance(aMap, aDepth - 1U, aAlpha, aBeta, aPly + 1U);
+            unmakeEvent(aMap, event);
+            return value;
+        }
+        case GameActionType::MOVE_ROBBER:
+            event.type = JournalEventType::MOVE_ROBBER;
+            event.aux = static_cast<uint8_t>(aMap.getRobLandId());
+            break;
+        case GameActionType::BUILD_ROAD:
+            event.type = JournalEventType::BUILD_ROAD;
+            event.aux = JOURNAL_FLAG_CONSUME_RESOURCE;
+            break;
+        case GameActionType::BUILD_SETTLEMENT:
+            event.type = JournalEventType::BUILD_SETTLEMENT;
+            event.aux = JOURNAL_FLAG_CONSUME_RESOURCE;
+            break;
+        case GameActionType::BUILD_CITY:
+            event.type = JournalEventType::BUILD_CITY;
+            event.aux = JOURNAL_FLAG_CONSUME_RESOURCE;
+            break;
+        default:
+            ERROR_LOG("Action not searched: ", static_cast<int>(aAction.type));
+    }
+    makeEvent(aMap, event);
+    const double value = searchDecision(aMap, aDepth - 1U, aAlpha, aBeta, false, aPly + 1U);
+    unmakeEvent(aMap, event);
+    return value;
+}
+
+double ExpectimaxSearch::probe(GameMap& aMap, const size_t aDepth, const int aDice, const size_t aPly)
+{
+    const JournalEvent_t event = {JournalEventType::ROLL_DICE, static_cast<uint8_t>(aDice), 0U};
+    makeEvent(aMap, event);
+    std::vector<GameAction_t>& actions = mActions[aPly];
+    generateActions(aMap, aDice == 7, actions);
+    GameAction_t action = actions.front();
+    const uint64_t key = getKey(aMap, aDice == 7);
+    const TableEntry_t& entry = mTable[key & mTableMask];
+    if (entry.key == key)
+    {
+        const GameAction_t tableAction = entry.bestAction;
+        if (std::any_of(actions.begin(), actions.end(), [&tableAction](const GameAction_t& aAction) {
+                return isSameAction(aAction, tableAction);
+            }))
+        {
+            action = tableAction;
+        }
+    }
+    const double value = searchAction(aMap, action, aDepth, -WIN_VALUE, WIN_VALUE, aPly);
+    unmakeEvent(aMap, event);
+    return value;
+}
+
+double ExpectimaxSearch::searchChance(GameMap& aMap, const size_t aDepth, const double aAlpha, const double aBeta, const size_t aPly)
+{
+    double value = 0.0;
+    if (isGameOver(aMap, value))
+    {
+        return value;
+    }
+    if (aDepth == 0U)
+    {
+        return evaluate(aMap);
+    }
+
+    // the bounds of the value after each outcome, the sums are weighted by the probability of the outcomes
+    const bool isMax = (aMap.currentPlayer() == mRootPlayer);
+    std::array<double, DICE_ORDER.size()> lower;
+    std::array<double, DICE_ORDER.size()> upper;
+    lower.fill(-WIN_VALUE);
+    upper.fill(WIN_VALUE);
+    double lowerSum = -WIN_VALUE;
+    double upperSum = WIN_VALUE;
+
+    // probing, one move of a max node is a lower bound of the node, of a min node an upper bound
+    for (size_t index = 0U; index < DICE_ORDER.size(); ++index)
+    {
+        const double probability = constant::diceChance(DICE_ORDER[index]);
+        value = probe(aMap, aDepth, DICE_ORDER[index], aPly);
+        if (mIsAborted)
+        {
+            return 0.0;
+        }
+        if (isMax)
+        {
+            lowerSum += probability * (value - lower[index]);
+            lower[index] = value;
+            if (lowerSum >= aBeta)
+            {
+                return lowerSum;
+            }
+        }
+        else
+        {
+            upperSum += probability * (value - upper[index]);
+            upper[index] = value;
+            if (upperSum <= aAlpha)
+            {
+                return upperSum;
+            }
+        }
+    }
+
+    // Star1, the window of an outcome is where it may still move the node out of (aAlpha, aBeta)
+    for (size_t index = 0U; index < DICE_ORDER.size(); ++index)
+    {
+        const int dice = DICE_ORDER[index];
+        const double probability = constant::diceChance(dice);
+        lowerSum -= probability * lower[index];
+        upperSum -= probability * upper[index];
+        const double childAlpha = (aAlpha - upperSum) / probability;
+        const double childBeta = (aBeta - lowerSum) / probability;
+
+        const JournalEvent_t event = {JournalEventType::ROLL_DICE, static_cast<uint8_t>(dice), 0U};
+        makeEvent(aMap, event);
+        value = searchDecision(aMap, aDepth, std::max(childAlpha, -WIN_VALUE), std::min(childBeta, WIN_VALUE), dice == 7, aPly);
+        unmakeEvent(aMap, event);
+        if (mIsAborted)
+        {
+            return 0.0;
+        }
+        if (value <= childAlpha)
+        {
+            return upperSum + probability * value;
+        }
+        if (value >= childBeta)
+        {
+            return lowerSum + probability * value;
+        }
+        lowerSum += probability * value;
+        upperSum += probability * value;
+    }
+    return lowerSum;
+}
+
+int ExpectimaxSearch::search(GameMap& aMap, const bool aIsRobberPhase, GameAction_t& aAction)
+{
+    if (aMap.getNumOfPlayers() != 2U)
+    {
+        WARN_LOG("Expectimax search supports 2 players only, num of players: ", aMap.getNumOfPlayers());
+        return 1;
+    }
+    initKeys(aMap);
+    mRootPlayer = aMap.currentPlayer();
+    mBoardKey = computeBoardKey(aMap);
+    mNumNodes = 0U;
+    mDepthReached = 0U;
+    mIsAborted = false;
+    mDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(mTimeLimitMs);
+
+    for (size_t depth = 1U; depth <= mMaxDepth; ++depth)
+    {
+        const double value = searchDecision(aMap, depth, -WIN_VALUE, WIN_VALUE, aIsRobberPhase, 0U);
+        if (mIsAborted)
+        {
+            break;
+        }
+        aAction = mRootAction;
+        mDepthReached = depth;
+        if (value >= WIN_VALUE || value <= -WIN_VALUE)
+        {
+            // decided, deeper searches would not change it
+            break;
+        }
+    }
+
+    if (aAction.type == GameActionType::MOVE_ROBBER)
+    {
+        const BoardState_t& board = aMap.getBoardState();
+        const int opponent = 1 - static_cast<int>(mRootPlayer);
+        const std::array<size_t, CONSUMABLE_RESOURCE_SIZE>& resources = aMap.getPlayers()[opponent]->getResources();
+        const bool hasResources = std::any_of(resources.begin(), resources.end(), [](const size_t aAmount) {
+                return aAmount > 0U;
+            });
+        for (const Vertex* const pVertex : aMap.getLands()[aAction.id]->getAdjacentVertices())
+        {
+            if (pVertex->getOwner(board) == opponent && hasResources)
+            {
+                aAction.aux = static_cast<uint8_t>(opponent);
+            }
+        }
+    }
+    return 0;
+}
+
+size_t ExpectimaxSearch::getNumNodes() const
+{
+    return mNumNodes;
+}
+
+size_t ExpectimaxSearch::getDepthReached() const
+{
+    return mDepthReached;
+}
@@ -0,0 +1,926 @@
+/**
+ * Project: catan
+ * @file game_host.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include "game_host.hpp"
+#include "command_handlers.hpp"
+#include "command_dispatcher.hpp"
+#include "command_parameter_reader.hpp"
+#include "map_file_io.hpp"
+#include "logger.hpp"
+#include "little_endian.hpp"
+
+namespace
+{
+
+// [kind: u8] [num of players: u8] [seed: u64], followed by
+//   SNAPSHOT: GameMap::exportSnapshot()
+//   OPENING:  [num of clicks: u16] [x: u16, y: u16] * num of clicks
+enum class RecordKind : uint8_t
+{
+    SNAPSHOT = 0,
+    OPENING,
+};
+constexpr size_t RECORD_HEADER_SIZE = 10U;
+
+// the timeouts of a game nobody plays any more are not kept forever
+constexpr size_t MAX_TIMEOUT_MSGS = 64U;
+
+inline uint64_t elapsedUs(const std::chrono::steady_clock::time_point aStart)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - aStart).count();
+}
+
+void appendHex(std::string& aLine, const std::vector<uint8_t>& aBytes)
+{
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    for (const uint8_t byte : aBytes)
+    {
+        aLine += DIGITS[byte >> 4U];
+        aLine += DIGITS[byte & 0x0FU];
+    }
+}
+
+// pushed by RollHandler and DevelopmentCardHandler, waiting for its clicks
+const RobberMoveHandler* pendingRobber(const UserInterface& aUi)
+{
+    const CommandParameterReader* const pReader = dynamic_cast<const CommandParameterReader*>(aUi.currentCommandHelper());
+    return (pReader != nullptr) ? dynamic_cast<const RobberMoveHandler*>(pReader->getCommandHandler()) : nullptr;
+}
+
+} // namespace
+
+constexpr size_t GameHost::KEYFRAME_INTERVAL;
+
+void GameHost::appendLines(std::string& aBlock, const std::string& aMsg)
+{
+    size_t lineBegin = 0U;
+    while (lineBegin <= aMsg.size())
+    {
+        size_t lineEnd = aMsg.find('\n', lineBegin);
+        if (lineEnd == std::string::npos)
+        {
+            lineEnd = aMsg.size();
+        }
+        if (aMsg[lineBegin] == '.')
+        {
+            aBlock += '.';
+        }
+        aBlock.append(aMsg, lineBegin, lineEnd - lineBegin);
+        aBlock += '\n';
+        lineBegin = lineEnd + 1U;
+    }
+}
+
+std::shared_ptr<const BoardLayout> GameHost::loadLayout(const std::string& aMapFile)
+{
+    try
+    {
+        return MapIO(aMapFile).readLayout();
+    }
+    catch (const std::exception& e)
+    {
+        WARN_LOG("Cannot read the map: ", e.what());
+        return nullptr;
+    }
+}
+
+GameHost::GameHost(const size_t aNumWorkers, const std::string& aMapFile, const uint64_t aSeed,
+                   const HibernationConfig_t& aHibernation, const TurnTimerConfig_t& aTurnTimer) :
+    mLayout(loadLayout(aMapFile)),
+    mSeed(aSeed),
+    mHibernation(aHibernation),
+    mTurnTimer(aTurnTimer),
+    mStartTime(std::chrono::steady_clock::now()),
+    mNumHibernations(0U),
+    mNumRehydrations(0U),
+    mMaxRehydrationUs(0U),
+    mNumTimeouts(0U),
+    mNumGamesCreated(0U),
+    mIsStopping(false)
+{
+    if (!mHibernation.storePath.empty() && mHibernation.idleMs != 0U)
+    {
+        mStore = std::make_unique<HibernationStore>(mHibernation.storePath);
+        if (!mStore->isOpen())
+        {
+            WARN_LOG("Games are not hibernated");
+            mStore.reset();
+        }
+    }
+
+    const size_t numWorkers = (aNumWorkers == 0U) ? std::max(std::thread::hardware_concurrency(), 1U) : aNumWorkers;
+    for (size_t worker = 0U; worker < numWorkers; ++worker)
+    {
+        mWorkers.push_back(std::make_unique<Worker_t>());
+        mWorkers.back()->isSleeping = false;
+        mWorkers.back()->numRequests = 0U;
+        mWorkers.back()->lastScan = std::chrono::steady_clock::now();
+        mWorkers.back()->numRecords = 0U;
+    }
+    for (size_t worker = 0U; worker < numWorkers; ++worker)
+    {
+        mWorkers[worker]->thread = std::thread(&GameHost::workerLoop, this, worker);
+    }
+}
+
+GameHost::~GameHost()
+{
+    mIsStopping = true;
+    for (std::unique_ptr<Worker_t>& pWorker : mWorkers)
+    {
+        wake(*pWorker);
+    }
+    for (std::unique_ptr<Worker_t>& pWorker : mWorkers)
+    {
+        pWorker->thread.join();
+    }
+    // the records still queued are written, their acknowledgements go to the queues of the stopped workers
+    mStore.reset();
+}
+
+uint64_t GameHost::createGame(const size_t aNumOfPlayers, Callback_t aCallback)
+{
+    const uint64_t gameId = mNumGamesCreated.fetch_add(1U, std::memory_order_relaxed);
+    post(gameId, Request_t{RequestType::CREATE, gameId, aNumOfPlayers, {}, Point_t{0, 0}, std::move(aCallback), {}, 0U, nullptr});
+    return gameId;
+}
+
+void GameHost::act(const uint64_t aGameId, const std::string& aInput, const Point_t aPoint, Callback_t aCallback)
+{
+    post(aGameId, Request_t{RequestType::ACT, aGameId, 0U, aInput, aPoint, std::move(aCallback), {}, 0U, nullptr});
+}
+
+void GameHost::describe(const uint64_t aGameId, Callback_t aCallback)
+{
+    post(aGameId, Request_t{RequestType::DESCRIBE, aGameId, 0U, {}, Point_t{0, 0}, std::move(aCallback), {}, 0U, nullptr});
+}
+
+void GameHost::watch(const uint64_t aGameId, const uint64_t aWatcherId, FrameCallback_t aOnFrame, Callback_t aCallback)
+{
+    post(aGameId, Request_t{RequestType::WATCH, aGameId, 0U, {}, Point_t{0, 0}, std::move(aCallback), {}, \
+                            aWatcherId, std::move(aOnFrame)});
+}
+
+void GameHost::unwatch(const uint64_t aGameId, const uint64_t aWatcherId)
+{
+    post(aGameId, Request_t{RequestType::UNWATCH, aGameId, 0U, {}, Point_t{0, 0}, nullptr, {}, aWatcherId, nullptr});
+}
+
+size_t GameHost::getNumWorkers() const
+{
+    return mWorkers.size();
+}
+
+std::vector<size_t> GameHost::getNumRequests() const
+{
+    std::vector<size_t> numRequests;
+    for (const std::unique_ptr<Worker_t>& pWorker : mWorkers)
+    {
+        numRequests.push_back(pWorker->numRequests.load(std::memory_order_relaxed));
+    }
+    return numRequests;
+}
+
+size_t GameHost::getNumHibernations() const
+{
+    return mNumHibernations.load(std::memory_order_relaxed);
+}
+
+size_t GameHost::getNumRehydrations() const
+{
+    return mNumRehydrations.load(std::memory_order_relaxed);
+}
+
+uint64_t GameHost::getMaxRehydrationUs() const
+{
+    return mMaxRehydrationUs.load(std::memory_order_relaxed);
+}
+
+uint64_t GameHost::getStoreBytes() const
+{
+    return mStore ? mStore->getLiveBytes() : 0U;
+}
+
+size_t GameHost::getNumTimeouts() const
+{
+    return mNumTimeouts.load(std::memory_order_relaxed);
+}
+
+void GameHost::post(const uint64_t aGameId, Request_t&& aRequest)
+{
+    Worker_t& worker = *mWorkers[aGameId % mWorkers.size()];
+    worker.queue.push(std::move(aRequest));
+    // a busy worker is not sleeping, the load keeps the hot path free of writes to shared cache lines
+    if (worker.isSleeping.load())
+    {
+        wake(worker);
+    }
+}
+
+void GameHost::wake(Worker_t& aWorker)
+{
+    if (aWorker.isSleeping.exchange(false))
+    {
+        // the worker holds the mutex from announcing its sleep until it waits, the notification cannot get lost
+        std::lock_guard<std::mutex> lock(aWorker.sleepMutex);
+        aWorker.wakeCondition.notify_one();
+    }
+}
+
+void GameHost::workerLoop(const size_t aWorker)
+{
+    Worker_t& worker = *mWorkers[aWorker];
+    Request_t request;
+    while (true)
+    {
+        if (worker.queue.pop(request))
+        {
+            run(worker, request);
+            worker.numRequests.fetch_add(1U, std::memory_order_relaxed);
+            expireTimers(worker);
+            hibernateIdleGames(worker);
+            continue;
+        }
+        if (mIsStopping)
+        {
+            break;
+        }
+        expireTimers(worker);
+        hibernateIdleGames(worker);
+
+        std::unique_lock<std::mutex> lock(worker.sleepMutex);
+        worker.isSleeping = true;
+        // either this sees the request pushed meanwhile, or the producer sees isSleeping and wakes this up
+        if (!worker.queue.empty() || mIsStopping)
+        {
+            worker.isSleeping = false;
+            continue;
+        }
+        // wakes up on its own to look for idle games, and for the first deadline
+        uint64_t sleepMs = mStore ? std::max<uint64_t>(mHibernation.idleMs / 4U, 1U) : UINT64_MAX;
+        const uint64_t nextDeadline = worker.timers.getNextDeadline();
+        if (nextDeadline != UINT64_MAX)
+        {
+            const uint64_t now = nowMs();
+            sleepMs = std::min(sleepMs, (nextDeadline > now) ? nextDeadline - now : 0U);
+        }
+        if (sleepMs != UINT64_MAX)
+        {
+            worker.wakeCondition.wait_for(lock, std::chrono::milliseconds(sleepMs), [&worker]() { return !worker.isSleeping; });
+            worker.isSleeping = false;
+        }
+        else
+        {
+            worker.wakeCondition.wait(lock, [&worker]() { return !worker.isSleeping; });
+        }
+    }
+    INFO_LOG("GameHost worker ", aWorker, " exits with ", worker.games.size(), " games, ", \
+             worker.hibernatedGames.size(), " hibernated");
+}
+
+void GameHost::run(Worker_t& aWorker, Request_t& aRequest)
+{
+    if (aRequest.type == RequestType::HIBERNATED)
+    {
+        onHibernated(aWorker, aRequest);
+        return;
+    }
+    if (aRequest.type == RequestType::UNWATCH)
+    {
+        removeWatcher(aWorker, aRequest.gameId, aRequest.watcherId);
+        return;
+    }
+
+    std::vector<std::string> msgs;
+    Result result = Result::SUCCESS;
+    const auto gameIter = aWorker.games.find(aRequest.gameId);
+    const bool isHibernated = (gameIter == aWorker.games.end()) && (aWorker.hibernatedGames.count(aRequest.gameId) != 0U);
+    HostedGame_t* const pGame = (gameIter != aWorker.games.end()) ? &gameIter->second : \
+                                isHibernated ? rehydrate(aWorker, aRequest.gameId, msgs) : nullptr;
+
+    if (aRequest.type == RequestType::CREATE)
+    {
+        result = create(aWorker, aRequest.gameId, aRequest.numOfPlayers, msgs);
+    }
+    else if (pGame == nullptr && isHibernated)
+    {
+        msgs.emplace_back("game " + std::to_string(aRequest.gameId) + " aborted");
+        result = Result::FAILED;
+        dropTimer(aWorker, aRequest.gameId);
+        publish(aWorker, aRequest.gameId, nullptr, "", msgs, true);
+    }
+    else if (pGame == nullptr)
+    {
+        msgs.emplace_back("error: no game " + std::to_string(aRequest.gameId));
+        result = Result::NO_GAME;
+    }
+    else if (aRequest.type == RequestType::DESCRIBE)
+    {
+        takeTimeoutMsgs(aWorker, aRequest.gameId, msgs);
+        msgs.emplace_back("game " + std::to_string(aRequest.gameId));
+        pGame->map->summarizePlayerStatus(-1, msgs);
+        pGame->lastActive = std::chrono::steady_clock::now();
+    }
+    else if (aRequest.type == RequestType::WATCH)
+    {
+        msgs.emplace_back("watching game " + std::to_string(aRequest.gameId));
+    }
+    else
+    {
+        HostedGame_t& game = *pGame;
+        try
+        {
+            const auto start = std::chrono::steady_clock::now();
+            game.ui->act(*game.map, aRequest.input, aRequest.point, msgs);
+            game.lastActive = std::chrono::steady_clock::now();
+            if (game.isOpening && dynamic_cast<const CommandDispatcher*>(game.ui->currentCommandHelper()) != nullptr)
+            {
+                // the first two rounds are over, the game is a snapshot from now on
+                game.isOpening = false;
+                std::vector<Point_t>().swap(game.openingClicks);
+            }
+            else if (game.isOpening && !(aRequest.point == Point_t{0, 0}))
+            {
+                // help and suggest do not change the game, only the clicks are replayed
+                game.openingClicks.push_back(aRequest.point);
+                game.openingCostUs += elapsedUs(start);
+            }
+            if (game.ui->currentCommandHelper() == nullptr)
+            {
+                msgs.emplace_back("game " + std::to_string(aRequest.gameId) + " over");
+                result = Result::GAME_OVER;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            // the game may be left half way through an action, do not carry on with it
+            msgs.emplace_back(std::string("error: ") + e.what());
+            msgs.emplace_back("game " + std::to_string(aRequest.gameId) + " aborted");
+            result = Result::FAILED;
+        }
+        publish(aWorker, aRequest.gameId, pGame, (aRequest.point == Point_t{0, 0}) ? aRequest.input : \
+                Logger::formatString("click ", aRequest.point.x, " ", aRequest.point.y), msgs, result != Result::SUCCESS);
+        // already published when they happened
+        takeTimeoutMsgs(aWorker, aRequest.gameId, msgs);
+        if (result != Result::SUCCESS)
+        {
+            aWorker.games.erase(aRequest.gameId);
+            dropTimer(aWorker, aRequest.gameId);
+            INFO_LOG("Game ", aRequest.gameId, (result == Result::GAME_OVER ? " over" : " aborted"));
+        }
+        else
+        {
+            armTimer(aWorker, aRequest.gameId, game);
+        }
+    }
+
+    if (aRequest.callback)
+    {
+        aRequest.callback(aRequest.gameId, result, msgs);
+    }
+    // the keyframe follows the answer to the watch
+    if (aRequest.type == RequestType::WATCH && pGame != nullptr)
+    {
+        addWatcher(aWorker, aRequest, *pGame);
+    }
+}
+
+int GameHost::newGame(const uint64_t aSeed, const size_t aNumOfPlayers, HostedGame_t& aGame, std::vector<std::string>& aReturnMsg) const
+{
+    if (mLayout == nullptr)
+    {
+        aReturnMsg.emplace_back("error: cannot read the map");
+        return 1;
+    }
+    aGame.map = std::make_unique<GameMap>(mLayout, aSeed);
+    try
+    {
+        if (aGame.map->initMap() != 0)
+        {
+            aReturnMsg.emplace_back("error: cannot initialize the map");
+            return 1;
+        }
+        aGame.map->addPlayer(aNumOfPlayers);
+    }
+    catch (const std::exception& e)
+    {
+        aReturnMsg.emplace_back(std::string("error: ") + e.what());
+        return 1;
+    }
+    aGame.isOpening = true;
+    aGame.openingCostUs = 0U;
+    return 0;
+}
+
+GameHost::Result GameHost::create(Worker_t& aWorker, const uint64_t aGameId, const size_t aNumOfPlayers, std::vector<std::string>& aReturnMsg)
+{
+    HostedGame_t game;
+    if (newGame(mSeed != 0U ? mSeed + aGameId : 0U, aNumOfPlayers, game, aReturnMsg) != 0)
+    {
+        return Result::FAILED;
+    }
+
+    game.ui = std::make_unique<UserInterface>(createGameCommands(*game.map));
+    aReturnMsg.emplace_back("game " + std::to_string(aGameId));
+    // the instructions of the first two rounds
+    game.ui->act(*game.map, "", Point_t{0, 0}, aReturnMsg);
+    game.lastActive = std::chrono::steady_clock::now();
+    aWorker.games.emplace(aGameId, std::move(game));
+    INFO_LOG("Created game ", aGameId, " of ", aNumOfPlayers, " players");
+    return Result::SUCCESS;
+}
+
+void GameHost::hibernateIdleGames(Worker_t& aWorker)
+{
+    if (!mStore)
+    {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now - aWorker.lastScan < std::chrono::milliseconds(std::max<uint64_t>(mHibernation.idleMs / 4U, 1U)))
+    {
+        return;
+    }
+    aWorker.lastScan = now;
+
+    for (auto gameIter = aWorker.games.begin(); gameIter != aWorker.games.end();)
+    {
+        if (now - gameIter->second.lastActive >= std::chrono::milliseconds(mHibernation.idleMs) && \
+            hibernate(aWorker, gameIter->first, gameIter->second))
+        {
+            gameIter = aWorker.games.erase(gameIter);
+        }
+        else
+        {
+            ++gameIter;
+        }
+    }
+}
+
+bool GameHost::hibernate(Worker_t& aWorker, const uint64_t aGameId, HostedGame_t& aGame)
+{
+
+    std::vector<uint8_t> record;
+    if (aGame.isOpening)
+    {
+        if (aGame.openingCostUs > mHibernation.rehydrateBudgetUs)
+        {
+            return false;
+        }
+        pushUint(record, static_cast<uint8_t>(RecordKind::OPENING), 1U);
+        pushUint(record, aGame.map->getPlayers().size(), 1U);
+        pushUint(record, aGame.map->getSeed(), 8U);
+        pushUint(record, aGame.openingClicks.size(), 2U);
+        for (const Point_t& click : aGame.openingClicks)
+        {
+            if (click.x > UINT16_MAX || click.y > UINT16_MAX)
+            {
+                return false;
+            }
+            pushUint(record, click.x, 2U);
+            pushUint(record, click.y, 2U);
+        }
+    }
+    else
+    {
+        // in the middle of a command, e.g., a build waiting for its click, its state is in the command handlers
+        if (aGame.ui->getStackSize() != 1U)
+        {
+            return false;
+        }
+        std::vector<uint8_t> snapshot;
+        aGame.map->exportSnapshot(snapshot);
+        pushUint(record, static_cast<uint8_t>(RecordKind::SNAPSHOT), 1U);
+        pushUint(record, aGame.map->getPlayers().size(), 1U);
+        pushUint(record, aGame.map->getSeed(), 8U);
+        record.insert(record.end(), snapshot.begin(), snapshot.end());
+    }
+
+    const uint64_t recordId = aWorker.numRecords++;
+    const size_t size = record.size();
+    std::shared_ptr<const std::vector<uint8_t> > pRecord = std::make_shared<const std::vector<uint8_t> >(std::move(record));
+    aWorker.hibernatedGames[aGameId] = HibernatedGame_t{recordId, pRecord, HibernationStore::WRITE_FAILED, size};
+    mStore->write(std::move(pRecord), [this, aGameId, recordId, size](const uint64_t aOffset) {
+        post(aGameId, Request_t{RequestType::HIBERNATED, aGameId, 0U, {}, Point_t{0, 0}, nullptr, \
+                                HibernatedGame_t{recordId, nullptr, aOffset, size}, 0U, nullptr});
+    });
+    mNumHibernations.fetch_add(1U, std::memory_order_relaxed);
+    INFO_LOG("Hibernated game ", aGameId, ", ", size, " bytes");
+    return true;
+}
+
+void GameHost::onHibernated(Worker_t& aWorker, const Request_t& aRequest)
+{
+    auto hibernatedIter = aWorker.hibernatedGames.find(aRequest.gameId);
+    if (hibernatedIter == aWorker.hibernatedGames.end() || hibernatedIter->second.recordId != aRequest.written.recordId)
+    {
+        // rehydrated from the copy in memory before the record was written
+        if (aRequest.written.offset != HibernationStore::WRITE_FAILED)
+        {
+            mStore->release(aRequest.written.size);
+        }
+        return;
+    }
+    if (aRequest.written.offset != HibernationStore::WRITE_FAILED)
+    {
+        hibernatedIter->second.record.reset();
+        hibernatedIter->second.offset = aRequest.written.offset;
+    }
+}
+
+GameHost::HostedGame_t* GameHost::rehydrate(Worker_t& aWorker, const uint64_t aGameId, std::vector<std::string>& aReturnMsg)
+{
+    const auto start = std::chrono::steady_clock::now();
+    auto hibernatedIter = aWorker.hibernatedGames.find(aGameId);
+    const HibernatedGame_t hibernated = std::move(hibernatedIter->second);
+    aWorker.hibernatedGames.erase(hibernatedIter);
+
+    std::vector<uint8_t> buffer;
+    const std::vector<uint8_t>* pRecord = hibernated.record.get();
+    if (pRecord == nullptr)
+    {
+        const int rc = mStore->read(hibernated.offset, hibernated.size, buffer);
+        mStore->release(hibernated.size);
+        if (rc != 0)
+        {
+            aReturnMsg.emplace_back("error: cannot read the hibernated game");
+            return nullptr;
+        }
+        pRecord = &buffer;
+    }
+    const std::vector<uint8_t>& record = *pRecord;
+    if (record.size() < RECORD_HEADER_SIZE)
+    {
+        aReturnMsg.emplace_back("error: the hibernated game is corrupted");
+        return nullptr;
+    }
+    size_t index = 0U;
+    const RecordKind kind = static_cast<RecordKind>(readUint(record, index, 1U));
+    const size_t numOfPlayers = readUint(record, index, 1U);
+    const uint64_t seed = readUint(record, index, 8U);
+
+    HostedGame_t game;
+    if (newGame(seed, numOfPlayers, game, aReturnMsg) != 0)
+    {
+        return nullptr;
+    }
+    try
+    {
+        if (kind == RecordKind::SNAPSHOT)
+        {
+            if (game.map->importSnapshot(std::vector<uint8_t>(record.begin() + index, record.end())) != 0)
+            {
+                aReturnMsg.emplace_back("error: the hibernated game is corrupted");
+                return nullptr;
+            }
+            game.ui = std::make_unique<UserInterface>(createTopLevelCommands());
+            game.isOpening = false;
+        }
+        else
+        {
+            const size_t numOfClicks = (record.size() >= index + 2U) ? readUint(record, index, 2U) : 0U;
+            if (record.size() != index + 4U * numOfClicks)
+            {
+                aReturnMsg.emplace_back("error: the hibernated game is corrupted");
+                return nullptr;
+            }
+            // the same steps as create(), the msgs were already sent when the clicks were made
+            std::vector<std::string> replayMsgs;
+            game.ui = std::make_unique<UserInterface>(createGameCommands(*game.map));
+            game.ui->act(*game.map, "", Point_t{0, 0}, replayMsgs);
+            for (size_t click = 0U; click < numOfClicks; ++click)
+            {
+                const size_t x = readUint(record, index, 2U);
+                const size_t y = readUint(record, index, 2U);
+                game.ui->act(*game.map, "", Point_t{x, y}, replayMsgs);
+                game.openingClicks.push_back(Point_t{x, y});
+            }
+            game.openingCostUs = elapsedUs(start);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        aReturnMsg.emplace_back(std::string("error: ") + e.what());
+        return nullptr;
+    }
+    game.lastActive = std::chrono::steady_clock::now();
+
+    const uint64_t latencyUs = elapsedUs(start);
+    uint64_t maxLatencyUs = mMaxRehydrationUs.load(std::memory_order_relaxed);
+    while (latencyUs > maxLatencyUs && !mMaxRehydrationUs.compare_exchange_weak(maxLatencyUs, latencyUs))
+    {
+        // maxLatencyUs is reloaded
+    }
+    mNumRehydrations.fetch_add(1U, std::memory_order_relaxed);
+    INFO_LOG("Rehydrated game ", aGameId, " in ", latencyUs, " us");
+    // attached after the clicks are replayed, the watchers have seen them already
+    const auto watchIter = aWorker.watches.find(aGameId);
+    if (watchIter != aWorker.watches.end())
+    {
+        game.map->setDeltaStream(watchIter->second.deltas.get());
+    }
+    return &aWorker.games.emplace(aGameId, std::move(game)).first->second;
+}
+
+uint64_t GameHost::nowMs() const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - mStartTime).count();
+}
+
+void GameHost::armTimer(Worker_t& aWorker, const uint64_t aGameId, const HostedGame_t& aGame)
+{
+    // the first two rounds are not timed
+    if ((mTurnTimer.turnMs == 0U && mTurnTimer.robberMs == 0U) || aGame.isOpening)
+    {
+        return;
+    }
+    GameTimer_t& timer = aWorker.gameTimers.emplace(aGameId, \
+        GameTimer_t{TimerWheel::INVALID_HANDLE, 0U, SIZE_MAX, 0U, 0U, {}}).first->second;
+
+    const uint64_t now = nowMs();
+    const size_t player = aGame.map->currentPlayer();
+    if (player != timer.turnPlayer)
+    {
+        timer.turnPlayer = player;
+        timer.turnDeadline = (mTurnTimer.turnMs != 0U) ? now + mTurnTimer.turnMs : 0U;
+    }
+    if (pendingRobber(*aGame.ui) == nullptr)
+    {
+        timer.robberDeadline = 0U;
+    }
+    else if (timer.robberDeadline == 0U && mTurnTimer.robberMs != 0U)
+    {
+        timer.robberDeadline = now + mTurnTimer.robberMs;
+    }
+
+    const uint64_t deadline = (timer.turnDeadline == 0U) ? timer.robberDeadline : \
+                              (timer.robberDeadline == 0U) ? timer.turnDeadline : std::min(timer.turnDeadline, timer.robberDeadline);
+    if (deadline != timer.deadline)
+    {
+        aWorker.timers.cancel(timer.handle);
+        timer.handle = (deadline != 0U) ? aWorker.timers.schedule(deadline, aGameId) : TimerWheel::INVALID_HANDLE;
+        timer.deadline = deadline;
+    }
+}
+
+void GameHost::dropTimer(Worker_t& aWorker, const uint64_t aGameId)
+{
+    const auto timerIter = aWorker.gameTimers.find(aGameId);
+    if (timerIter != aWorker.gameTimers.end())
+    {
+        aWorker.timers.cancel(timerIter->second.handle);
+        aWorker.gameTimers.erase(timerIter);
+    }
+}
+
+void GameHost::takeTimeoutMsgs(Worker_t& aWorker, const uint64_t aGameId, std::vector<std::string>& aReturnMsg)
+{
+    const auto timerIter = aWorker.gameTimers.find(aGameId);
+    if (timerIter == aWorker.gameTimers.end() || timerIter->second.msgs.empty())
+    {
+        return;
+    }
+    std::vector<std::string>& timeoutMsgs = timerIter->second.msgs;
+    aReturnMsg.insert(aReturnMsg.begin(), std::make_move_iterator(timeoutMsgs.begin()), std::make_move_iterator(timeoutMsgs.end()));
+    timeoutMsgs.clear();
+}
+
+void GameHost::expireTimers(Worker_t& aWorker)
+{
+    if (aWorker.timers.size() == 0U)
+    {
+        return;
+    }
+    std::vector<uint64_t> expired;
+    aWorker.timers.advance(nowMs(), expired);
+    for (const uint64_t gameId : expired)
+    {
+        timeOut(aWorker, gameId);
+    }
+}
+
+void GameHost::timeOut(Worker_t& aWorker, const uint64_t aGameId)
+{
+    const auto timerIter = aWorker.gameTimers.find(aGameId);
+    if (timerIter == aWorker.gameTimers.end())
+    {
+        return;
+    }
+    GameTimer_t& timer = timerIter->second;
+    timer.handle = TimerWheel::INVALID_HANDLE;
+    timer.deadline = 0U;
+
+    std::vector<std::string> msgs;
+    const auto gameIter = aWorker.games.find(aGameId);
+    HostedGame_t* const pGame = (gameIter != aWorker.games.end()) ? &gameIter->second : \
+                                (aWorker.hibernatedGames.count(aGameId) != 0U) ? rehydrate(aWorker, aGameId, msgs) : nullptr;
+    if (pGame == nullptr)
+    {
+        WARN_LOG("Game ", aGameId, " cannot time out, dropped: ", (msgs.empty() ? "no game" : msgs.back()));
+        aWorker.gameTimers.erase(timerIter);
+        return;
+    }
+    HostedGame_t& game = *pGame;
+
+    const uint64_t now = nowMs();
+    const bool isTurnOver = (timer.turnDeadline != 0U && timer.turnDeadline <= now);
+    const size_t player = game.map->currentPlayer();
+    try
+    {
+        // the turn cannot be ended with the robber waiting, the robber is moved either way
+        if (const RobberMoveHandler* const pRobber = pendingRobber(*game.ui))
+        {
+            msgs.emplace_back("timeout: the robber is moved for Player#" + std::to_string(player));
+            std::vector<Point_t> clicks;
+            pRobber->defaultClicks(*game.map, clicks);
+            for (const Point_t& click : clicks)
+            {
+                game.ui->act(*game.map, "", click, msgs);
+            }
+            mNumTimeouts.fetch_add(1U, std::memory_order_relaxed);
+        }
+        if (isTurnOver)
+        {
+            msgs.emplace_back("timeout: the turn of Player#" + std::to_string(player) + " is over");
+            // a command half way through is dropped, as the player would with exit
+            for (size_t helper = game.ui->getStackSize(); helper > 1U && game.ui->getStackSize() > 1U; --helper)
+            {
+                game.ui->act(*game.map, "exit", Point_t{0, 0}, msgs);
+            }
+            game.ui->act(*game.map, "next", Point_t{0, 0}, msgs);
+            // a new turn, even if the current player is the same, e.g., a game of one player
+            timer.turnPlayer = SIZE_MAX;
+            mNumTimeouts.fetch_add(1U, std::memory_order_relaxed);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        msgs.emplace_back(std::string("error: ") + e.what());
+        WARN_LOG("Game ", aGameId, " aborted on timeout: ", e.what());
+        msgs.emplace_back("game " + std::to_string(aGameId) + " aborted");
+        publish(aWorker, aGameId, nullptr, "", msgs, true);
+        aWorker.games.erase(aGameId);
+        aWorker.gameTimers.erase(timerIter);
+        return;
+    }
+    if (game.ui->currentCommandHelper() == nullptr)
+    {
+        INFO_LOG("Game ", aGameId, " over on timeout");
+        msgs.emplace_back("game " + std::to_string(aGameId) + " over");
+        publish(aWorker, aGameId, nullptr, "", msgs, true);
+        aWorker.games.erase(aGameId);
+        aWorker.gameTimers.erase(timerIter);
+        return;
+    }
+    INFO_LOG("Game ", aGameId, " timed out for Player#", player);
+    publish(aWorker, aGameId, &game, "", msgs, false);
+
+    timer.msgs.insert(timer.msgs.end(), std::make_move_iterator(msgs.begin()), std::make_move_iterator(msgs.end()));
+    if (timer.msgs.size() > MAX_TIMEOUT_MSGS)
+    {
+        timer.msgs.erase(timer.msgs.begin(), timer.msgs.end() - MAX_TIMEOUT_MSGS);
+    }
+    armTimer(aWorker, aGameId, game);
+}
+
+void GameHost::addWatcher(Worker_t& aWorker, const Request_t& aRequest, const HostedGame_t& aGame)
+{
+    const auto emplaced = aWorker.watches.emplace(aRequest.gameId, GameWatch_t{0U, 0U, {}, nullptr});
+    GameWatch_t& watch = emplaced.first->second;
+    if (emplaced.second)
+    {
+        // the deltas are relative to the state now, sent with the keyframe below, not by the stream
+        std::vector<uint8_t> state;
+        watch.deltas = std::make_unique<DeltaStream>();
+        watch.deltas->keyframe(*aGame.map);
+        watch.deltas->take(state);
+        aGame.map->setDeltaStream(watch.deltas.get());
+    }
+    auto watcherIter = std::find_if(watch.watchers.begin(), watch.watchers.end(), \
+        [&aRequest](const std::pair<uint64_t, FrameCallback_t>& aWatcher) { return aWatcher.first == aRequest.watcherId; });
+    if (watcherIter == watch.watchers.end())
+    {
+        watch.watchers.emplace_back(aRequest.watcherId, aRequest.onFrame);
+        watcherIter = watch.watchers.end() - 1;
+    }
+    else
+    {
+        watcherIter->second = aRequest.onFrame;
+    }
+    watcherIter->second(encodeKeyframe(aRequest.gameId, watch.seq, aGame));
+}
+
+void GameHost::removeWatcher(Worker_t& aWorker, const uint64_t aGameId, const uint64_t aWatcherId)
+{
+    const auto watchIter = aWorker.watches.find(aGameId);
+    if (watchIter == aWorker.watches.end())
+    {
+        return;
+    }
+    std::vector<std::pair<uint64_t, FrameCallback_t> >& watchers = watchIter->second.watchers;
+    watchers.erase(std::remove_if(watchers.begin(), watchers.end(), \
+        [aWatcherId](const std::pair<uint64_t, FrameCallback_t>& aWatcher) { return aWatcher.first == aWatcherId; }), watchers.end());
+    if (watchers.empty())
+    {
+        eraseWatch(aWorker, aGameId);
+    }
+}
+
+void GameHost::eraseWatch(Worker_t& aWorker, const uint64_t aGameId)
+{
+    const auto gameIter = aWorker.games.find(aGameId);
+    if (gameIter != aWorker.games.end())
+    {
+        gameIter->second.map->setDeltaStream(nullptr);
+    }
+    aWorker.watches.erase(aGameId);
+}
+
+void GameHost::publish(Worker_t& aWorker, const uint64_t aGameId, const HostedGame_t* const aGame, const std::string& aInput,
+                       const std::vector<std::string>& aMsgs, const bool aIsLast)
+{
+    const auto watchIter = aWorker.watches.find(aGameId);
+    if (watchIter == aWorker.watches.end())
+    {
+        return;
+    }
+    GameWatch_t& watch = watchIter->second;
+
+    std::string data = "update " + std::to_string(aGameId) + " " + std::to_string(++watch.seq) + "\n";
+    if (!aInput.empty())
+    {
+        appendLines(data, "> " + aInput);
+    }
+    for (const std::string& msg : aMsgs)
+    {
+        appendLines(data, msg);
+    }
+    if (aGame != nullptr)
+    {
+        // e.g., a trade changes the cards without a journaled action
+        watch.deltas->sync(*aGame->map);
+    }
+    if (!watch.deltas->empty())
+    {
+        std::vector<uint8_t> deltas;
+        watch.deltas->take(deltas);
+        data += "delta ";
+        appendHex(data, deltas);
+        data += '\n';
+    }
+    data += ".\n";
+    const Frame_t update{aGameId, watch.seq, false, aIsLast, std::make_shared<const std::string>(std::move(data))};
+    for (const std::pair<uint64_t, FrameCallback_t>& watcher : watch.watchers)
+    {
+        watcher.second(update);
+    }
+
+    if (aIsLast)
+    {
+        eraseWatch(aWorker, aGameId);
+        return;
+    }
+    if (aGame != nullptr && ++watch.numUpdates >= KEYFRAME_INTERVAL)
+    {
+        watch.numUpdates = 0U;
+        const Frame_t keyframe = encodeKeyframe(aGameId, watch.seq, *aGame);
+        for (const std::pair<uint64_t, FrameCallback_t>& watcher : watch.watchers)
+        {
+            watcher.second(keyframe);
+        }
+    }
+}
+
+GameHost::Frame_t GameHost::encodeKeyframe(const uint64_t aGameId, const uint64_t aSeq, const HostedGame_t& aGame)
+{
+    const GameMap& map = *aGame.map;
+    std::string data = "keyframe " + std::to_string(aGameId) + " " + std::to_string(aSeq) + "\n";
+    appendLines(data, "Current Player is player#" + std::to_string(map.currentPlayer()));
+    // a stream of its own, whatever the stream of the game has sent so far
+    DeltaStream stream;
+    std::vector<uint8_t> state;
+    stream.keyframe(map);
+    stream.take(state);
+    data += "state ";
+    appendHex(data, state);
+    data += '\n';
+    std::string row;
+    for (int y = 0; y < map.getSizeVertical(); ++y)
+    {
+        row.clear();
+        for (int x = 0; x < map.getSizeHorizontal(); ++x)
+        {
+            row += map.getCharRepresentation(x, y);
+        }
+        appendLines(data, row);
+    }
+    data += ".\n";
+    return Frame_t{aGameId, aSeq, true, false, std::make_shared<const std::string>(std::move(data))};
+}
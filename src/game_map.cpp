@@ -13,321 +13,71 @@
 #include <set>
 #include <numeric>
 #include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <iomanip>
 #include "logger.hpp"
 #include "utility.hpp"
 #include "game_map.hpp"
 #include "blank.hpp"
 #include "constant.hpp"
+#include "little_endian.hpp"
 
-void GameMap::fillInBlank()
+int GameMap::assignHarbourResources(bool aUseDefaultResourceType)
 {
-    // traverse map, replace nullptr with Blank*
-    for (size_t jj = 0; jj < mSizeVertical; ++jj)
-    {
-        std::deque<Terrain*>& row = mGameMap.at(jj);
-        for (size_t ii = 0; ii < mSizeHorizontal; ++ii)
-        {
-            if (row.at(ii) == nullptr)
-            {
-                row.at(ii) = Blank::getBlank();
-            }
-        }
-    }
-}
-
-int GameMap::populateMap()
-{
-    /* populate terrains
-     * order matters!!
-     * Land::populateAdjacencies adds necessary edges and vertices and records adjacent vertices
-     * Vertex::populateAdjacencies records connected edges and adjcent vertices
-     * Edge::populateAdjacencies require Vertex to know connected edges first
-     */
-
-    // return codes
-    int rcLand = 0;
-    int rcEdge = 0;
-    int rcVertex = 0;
-
-    for (Land* const pLand : mLands)
-    {
-        rcLand |= pLand->populateAdjacencies(*this);
-    }
-    rcLand ?
-        ERROR_LOG("Failed to populate adjacencies for Lands")
-        :
-        INFO_LOG("Successfully populated adjacencies of Lands");
-
-    for (Vertex* const pVertex : mVertices)
-    {
-        rcVertex |= pVertex->populateAdjacencies(*this);
-    }
-    rcVertex ?
-        ERROR_LOG("Failed to populate adjacencies for Vertices")
-        :
-        INFO_LOG("Successfully populated adjacencies of Vertices");
-
-    for (Edge* const pEdge : mEdges)
-    {
-        rcEdge |= pEdge->populateAdjacencies(*this);
-    }
-    rcEdge ?
-        ERROR_LOG("Failed to populate adjacencies for Edges")
-        :
-        INFO_LOG("Successfully populated adjacencies of Edges");
-
-    return (rcLand | rcEdge | rcVertex);
-}
-
-int GameMap::populateHarbours(bool aUseDefaultPosition, bool aUseDefaultResourceType)
-{
-    int rc = 0;
-    if (mLands.size() != constant::NUM_LANDS_DEFAULT)
-    {
-        // override to use ramdon position when not using the default map
-        aUseDefaultPosition = false;
-    }
-    if (aUseDefaultPosition)
-    {
-        INFO_LOG("using default position for harbours");
-        rc = createHarboursDefault();
-    }
-    else
-    {
-        INFO_LOG("using random position for harbours");
-        rc = createHarboursRandom();
-    }
-
-    rc ?
-        WARN_LOG("Failed to create all harbours, created: ", mHarbours.size(), ", expected: ", mNumHarbour)
-        :
-        INFO_LOG("Successfully created all harbours");
-
+    const std::vector<Harbour*>& harbours = mLayout->getHarbours();
     SequenceConfig_t config(static_cast<size_t>(ResourceTypes::ANY) + 1);
     config[ResourceTypes::BRICK] = constant::NUM_HARBOUR_BRICK;
     config[ResourceTypes::SHEEP] = constant::NUM_HARBOUR_SHEEP;
     config[ResourceTypes::WHEAT] = constant::NUM_HARBOUR_WHEAT;
     config[ResourceTypes::WOOD]  = constant::NUM_HARBOUR_WOOD;
     config[ResourceTypes::ORE]   = constant::NUM_HARBOUR_ORE;
-    if (aUseDefaultResourceType && mHarbours.size() == constant::NUM_OF_HARBOUR)
+    if (aUseDefaultResourceType && harbours.size() == constant::NUM_OF_HARBOUR)
     {
         DEBUG_LOG_L3("Using 9 default harbour types");
         config[ResourceTypes::ANY] = 0; // ANY is determined by (index % 2 != 0)
-        std::vector<int> randomSeq = randomizeResource(config);
-        DEBUG_LOG_L2("Assigning randomSeq ", randomSeq, " to harbours");
-        for (size_t index = 0; index < mHarbours.size(); ++index)
+        for (size_t index = 0; index < harbours.size(); ++index)
         {
             if (index % 2 != 0)
             {
-                mHarbours[index]->setResourceType(ResourceTypes::ANY);
+                mState.harbourResource[index] = static_cast<int8_t>(ResourceTypes::ANY);
             }
             else
             {
-                mHarbours[index]->setResourceType(static_cast<ResourceTypes>(randomSeq.at(index / 2)));
+                mState.harbourResource[index] = static_cast<int8_t>(drawFromConfig(config, RandomStream::BOARD));
             }
         }
     }
     else
     {
-        if (mHarbours.size() > constant::NUM_HARBOUR_RESOURCE)
+        if (harbours.size() > constant::NUM_HARBOUR_RESOURCE)
         {
             // one harbour for each resource, ANY for the rest
-            config[ResourceTypes::ANY] = mHarbours.size() - constant::NUM_HARBOUR_RESOURCE;
+            config[ResourceTypes::ANY] = harbours.size() - constant::NUM_HARBOUR_RESOURCE;
         }
         else
         {
             // set num-of-ANY to default, shuffle the sequence and pick by luck
-            INFO_LOG("User defined map has ", mHarbours.size(), " harbours only, randomly picking from the 9 default harbours");
+            INFO_LOG("User defined map has ", harbours.size(), " harbours only, randomly picking from the 9 default harbours");
             config[ResourceTypes::ANY] = constant::NUM_HARBOUR_ANY;
         }
 
-        std::vector<int> randomSeq = randomizeResource(config);
-        for (size_t index = 0; index < mHarbours.size(); ++index)
-        {
-            mHarbours[index]->setResourceType(static_cast<ResourceTypes>(randomSeq[index]));
-        }
-    }
-    for (Harbour* const pHarbour : mHarbours)
-    {
-        rc |= pHarbour->calculatePoints(*this);
-        pHarbour->registerToMap(*this);
-    }
-
-    rc ?
-        WARN_LOG("Failed to populateHarbours")
-        :
-        INFO_LOG("Successfully populated all harbours");
-    return rc;
-}
-
-int GameMap::createHarboursDefault()
-{
-    std::vector<int> harbourCandidates;
-    const Vertex* pVertex = nullptr;
-    for (Vertex* pVertexTemp : mVertices)
-    {
-        // reset harbours
-        pVertexTemp->setHarbour(nullptr);
-        // find a coastal vertex as the starting point
-        if ((pVertex == nullptr) && (pVertexTemp->isCoastal()))
-        {
-            harbourCandidates.push_back(pVertexTemp->getId());
-            pVertex = pVertexTemp;
-        }
-    }
-    if (!pVertex)
-    {
-        ERROR_LOG("Unable to find a string point");
-        return 1;
-    }
-    const Vertex* pPreviousVertex = pVertex;
-    do
-    {
-        for (const Vertex* const pNextVertex : pVertex->getAdjacentVertices())
-        {
-            if (pNextVertex == pPreviousVertex)
-            {
-                continue;
-            }
-            if (pNextVertex->isCoastal())
-            {
-                harbourCandidates.push_back(pNextVertex->getId());
-                pPreviousVertex = pVertex;
-                pVertex = pNextVertex;
-                break;
-            }
-        }
-    } while (pVertex->getId() != harbourCandidates.at(0));
-
-    const size_t gap[] = {1U, 1U, 2U};
-    size_t index = 0U;
-    while (mHarbours.size() < mNumHarbour && index + 1 < harbourCandidates.size())
-    {
-        addHarbour(harbourCandidates[index], harbourCandidates[index + 1]);
-        index += 2U + gap[mHarbours.size() % 3];
-    }
-
-    return (mHarbours.size() != mNumHarbour);
-}
-
-int GameMap::createHarboursRandom()
-{
-    if (mHarbours.size() >= mNumHarbour)
-    {
-        mNumHarbour = mHarbours.size();
-        return 0;
-    }
-    std::vector<int> harbourCandidates;
-    for (Vertex* const pVertex : mVertices)
-    {
-        if (pVertex->isCoastal() && !pVertex->hasHarbour())
+        for (size_t index = 0; index < harbours.size(); ++index)
         {
-            harbourCandidates.push_back(pVertex->getId());
+            mState.harbourResource[index] = static_cast<int8_t>(drawFromConfig(config, RandomStream::BOARD));
         }
     }
-    while (mHarbours.size() < mNumHarbour)
-    {
-        if (harbourCandidates.size() == 0U)
-        {
-            WARN_LOG("Unable to create ", mNumHarbour, " of harbours, current number of harbour ", mHarbours.size());
-            break;
-        }
-        // get a vertex from candidates
-        std::uniform_int_distribution<size_t> distribution(0U, harbourCandidates.size() - 1U);
-        size_t index = distribution(mEngine);
-        int idVertex = harbourCandidates[index];
-        if (mVertices[idVertex]->hasHarbour())
-        {
-            continue;
-        }
-        int idOtherVertex = -1;
-        for (const Vertex* const pVertex : mVertices[idVertex]->getAdjacentVertices())
-        {
-            if (pVertex->isCoastal() && !pVertex->hasHarbour())
-            {
-                idOtherVertex = pVertex->getId();
-                break;
-            }
-        }
-        if (idOtherVertex != -1)
-        {
-            // found a valid pair for harbour
-            addHarbour(idVertex, idOtherVertex);
-            harbourCandidates.erase(std::remove(harbourCandidates.begin(), harbourCandidates.end(), idOtherVertex), \
-                                    harbourCandidates.end());
-        }
-        // if idOtherVertex != -1, add harbour, remove idVertex from harbourCandidates
-        // if idOtherVertex == -1, no available adjacent vertex, remove idVertex from harbourCandidates
-        harbourCandidates.erase(std::remove(harbourCandidates.begin(), harbourCandidates.end(), idVertex), \
-                                harbourCandidates.end());
-    }
-    return (mHarbours.size() != mNumHarbour);
+    return 0;
 }
 
-std::vector<int> GameMap::randomizeResource(SequenceConfig_t aConfig)
+RandomEngine& GameMap::getEngine(const RandomStream aStream)
 {
-
-    std::vector<int> resourceSequence;
-    for (int index = 0; index < (int)aConfig.size(); ++index)
-    {
-        for (size_t counter = 0U; counter < aConfig[index]; ++counter)
-        {
-            resourceSequence.emplace_back(index);
-        }
-    }
-    std::shuffle(resourceSequence.begin(), resourceSequence.end(), mEngine);
-    return resourceSequence;
+    return mEngines[static_cast<size_t>(aStream)];
 }
 
-int GameMap::checkOverlap() const
+int GameMap::drawFromConfig(SequenceConfig_t& aConfig, const RandomStream aStream)
 {
-    std::unordered_map<Point_t, std::string, PointHash> points;
-    int overlapCount = 0;
-
-    auto lambda = [&points, &overlapCount](const std::vector<Point_t>& aPoints, const std::string& aId)
-        {
-            for (const Point_t& point : aPoints)
-            {
-                int count = points.count(point);
-                if (count) {
-                    overlapCount += count;
-                    WARN_LOG("Overlap detected at ", point, \
-                         " Collision IDs: ", aId, ", ", points.at(point));
-                }
-                else
-                {
-                    points.emplace(point, aId);
-                }
-            }
-        };
-
-    for (Vertex* const pVertex : mVertices)
-    {
-        lambda(pVertex->getAllPoints(), pVertex->getStringId());
-    }
-    for (Edge* const pEdge : mEdges)
-    {
-        lambda(pEdge->getAllPoints(), pEdge->getStringId());
-    }
-    for (Land* const pLand : mLands)
-    {
-        lambda(pLand->getAllPoints(), pLand->getStringId());
-    }
-    for (Harbour* const pHarbour : mHarbours)
-    {
-        lambda(pHarbour->getAllPoints(), pHarbour->getStringId());
-    }
-
-    if (overlapCount)
-    {
-        ERROR_LOG("Detected ", overlapCount, " Overlap");
-    }
-    else
-    {
-        INFO_LOG("No Overlap detected");
-    }
-
-    return overlapCount;
+    return aConfig.draw(getEngine(aStream));
 }
 
 int GameMap::assignResourceAndDice()
@@ -340,9 +90,10 @@ int GameMap::assignResourceAndDice()
     resourceConfig[ResourceTypes::WOOD]   = constant::NUM_LAND_WOOD;
     resourceConfig[ResourceTypes::ORE]    = constant::NUM_LAND_ORE;
     resourceConfig[ResourceTypes::DESERT] = constant::NUM_LAND_DESERT;
-    for (Land* const pLand : mLands)
+    const std::vector<Land*>& lands = mLayout->getLands();
+    for (Land* const pLand : lands)
     {
-        const ResourceTypes resource = pLand->getResourceType();
+        const ResourceTypes resource = pLand->getPresetResourceType();
         if (resource != ResourceTypes::NONE)
         {
             size_t& amount = resourceConfig[resource];
@@ -356,13 +107,12 @@ int GameMap::assignResourceAndDice()
             }
         }
     }
-    if (resourceConfig.sum() < mLands.size())
+    if (resourceConfig.sum() < lands.size())
     {
         // TODO: prompt for user input?
-        WARN_LOG("Non-default map, extra Desert will be added, amount: ", mLands.size() - resourceConfig.sum());
-        resourceConfig[ResourceTypes::DESERT] += mLands.size() - resourceConfig.sum();
+        WARN_LOG("Non-default map, extra Desert will be added, amount: ", lands.size() - resourceConfig.sum());
+        resourceConfig[ResourceTypes::DESERT] += lands.size() - resourceConfig.sum();
     }
-    std::vector<int> resourceSeq = randomizeResource(resourceConfig);
 
     SequenceConfig_t diceConfig(13); // 0 to 12
     for (size_t index = 3; index <= 11; ++index)
@@ -373,203 +123,68 @@ int GameMap::assignResourceAndDice()
     diceConfig[7]  = constant::NUM_DICE_7;
     diceConfig[12] = constant::NUM_DICE_2_OR_12;
     const size_t numOfDesert = resourceConfig[ResourceTypes::DESERT];
-    if (diceConfig.sum() < mLands.size() - numOfDesert)
+    if (diceConfig.sum() < lands.size() - numOfDesert)
     {
         // TODO: prompt for user input?
-        WARN_LOG("Non-default map, extra 10 will be added, amount: ", mLands.size() - numOfDesert - diceConfig.sum());
-        diceConfig[10] += mLands.size() - numOfDesert - diceConfig.sum();
+        WARN_LOG("Non-default map, extra 10 will be added, amount: ", lands.size() - numOfDesert - diceConfig.sum());
+        diceConfig[10] += lands.size() - numOfDesert - diceConfig.sum();
     }
-    std::vector<int> diceSeq = randomizeResource(diceConfig);
-    size_t resourceIndex = 0;
-    size_t diceIndex = 0;
-    for (Land* const pLand : mLands)
+    // draw without replacement, one land at a time, no sequence is materialized
+    for (Land* const pLand : lands)
     {
-        if (pLand->getResourceType() == ResourceTypes::NONE)
+        const int landId = pLand->getId();
+        mState.landResource[landId] = static_cast<int8_t>(pLand->getPresetResourceType());
+        if (pLand->getPresetResourceType() == ResourceTypes::NONE)
         {
-            pLand->setResourceType(static_cast<ResourceTypes>(resourceSeq.at(resourceIndex++)));
+            mState.landResource[landId] = static_cast<int8_t>(drawFromConfig(resourceConfig, RandomStream::BOARD));
         }
-        if (pLand->getResourceType() != ResourceTypes::DESERT)
+        if (pLand->getResourceType(mState) != ResourceTypes::DESERT)
         {
-            pLand->setDiceNum(diceSeq.at(diceIndex++));
+            mState.landDice[landId] = static_cast<uint8_t>(drawFromConfig(diceConfig, RandomStream::BOARD));
         }
-        else if (mRobLandId == -1)
+        else if (mState.robLandId == -1)
         {
             // robber initially is at desert
-            mRobLandId = pLand->getId();
-            pLand->rob(true);
+            mState.robLandId = landId;
         }
     }
     return 0;
 }
 
-Terrain* GameMap::_getTerrain(const int x, const int y) const
-{
-    if (boundaryCheck(x,y))
-    {
-        return mGameMap.at(y).at(x);
-    }
-    else
-    {
-        WARN_LOG("Coord (", x, ", ", y, ") is out of bound");
-        return nullptr;
-    }
-}
-
-Terrain* GameMap::_getTerrain(const Point_t& aPoint) const
-{
-    return _getTerrain(aPoint.x, aPoint.y);
-}
-
 const Terrain* GameMap::getTerrain(const int x, const int y) const
 {
-    if (boundaryCheck(x,y))
-    {
-        return mGameMap.at(y).at(x);
-    }
-    else
-    {
-        WARN_LOG("Coord (", x, ", ", y, ") is out of bound");
-        return nullptr;
-    }
+    return mLayout->getTerrain(x, y);
 }
 
 const Terrain* GameMap::getTerrain(const Point_t& aPoint) const
 {
-    return getTerrain(aPoint.x, aPoint.y);
-}
-
-const Vertex* GameMap::addVertex(const size_t aTopLeftX, const size_t aTopLeftY)
-{
-    if (mInitialized)
-    {
-        ERROR_LOG("Map initialized, cannot add vertex");
-        return nullptr;
-    }
-    Vertex* const pVertex = new Vertex(mVertices.size(), Point_t{aTopLeftX, aTopLeftY});
-    pVertex->registerToMap(*this);
-    mVertices.push_back(pVertex);
-    return pVertex;
+    return mLayout->getTerrain(aPoint);
 }
 
-const Edge* GameMap::addEdge(const size_t aTopLeftX, const size_t aTopLeftY, const char aPattern)
+char GameMap::getCharRepresentation(const int x, const int y, const bool aUseId) const
 {
-    if (mInitialized)
-    {
-        ERROR_LOG("Map initialized, cannot add edge");
-        return nullptr;
-    }
-    Edge* const pEdge = new Edge(mEdges.size(), Point_t{aTopLeftX, aTopLeftY}, aPattern);
-    pEdge->registerToMap(*this);
-    mEdges.push_back(pEdge);
-    return pEdge;
-
+    const Terrain* const pTerrain = getTerrain(x, y);
+    return pTerrain ? pTerrain->getCharRepresentation(x, y, mState, aUseId) : ' ';
 }
 
-const Land* GameMap::addLand(const size_t aTopLeftX, const size_t aTopLeftY, const ResourceTypes aResource)
+ColorPairIndex GameMap::getColorIndex(const int x, const int y) const
 {
-    if (mInitialized)
-    {
-        ERROR_LOG("Map initialized, cannot add land");
-        return nullptr;
-    }
-    Land* const pLand = new Land(mLands.size(), Point_t{aTopLeftX, aTopLeftY}, aResource);
-    pLand->registerToMap(*this);
-    mLands.push_back(pLand);
-    return pLand;
+    const Terrain* const pTerrain = getTerrain(x, y);
+    return pTerrain ? pTerrain->getColorIndex(mState) : ColorPairIndex::COLOR_PAIR_INDEX_RESERVED;
 }
 
-Harbour* GameMap::addHarbour(const int aId1, const int aId2)
-{
-    Harbour* const pHarbour = new Harbour(mHarbours.size(), ResourceTypes::NONE, \
-                                        mVertices[aId1]->getTopLeft(), mVertices[aId2]->getTopLeft());
-    mVertices[aId1]->setHarbour(pHarbour);
-    mVertices[aId2]->setHarbour(pHarbour);
-
-    mHarbours.push_back(pHarbour);
-    DEBUG_LOG_L2("added harbour#", mHarbours.size(), " for ", aId1, " and ", aId2);
-    return pHarbour;
-}
-
-// int GameMap::addHarbourCandidate(Vertex* const aVertex)
-// {
-//     if (aVertex)
-//     {
-//         mHarbourCandidates.emplace(aVertex->getId());
-//     }
-//     return 0;
-// }
-
-int GameMap::setTerrainColor(const int x, const int y, ColorPairIndex aColorIndex)
-{
-    if (!boundaryCheck(x, y))
-    {
-        WARN_LOG("SetColor called for an out-of-bound Point{", x, ", ", y, '}');
-        return 1;
-    }
-    DEBUG_LOG_L3("setting color#", (int)aColorIndex, " for Point{", x, ", ", y, '}');
-    _getTerrain(x, y)->setColor(aColorIndex);
-    return 0;
-
-}
-
-int GameMap::registerTerrain(const std::vector<Point_t>& aPoints, Terrain* const aTerrain)
-{
-    if (mInitialized)
-    {
-        ERROR_LOG("Map initialized, cannot registerTerrain for " + aTerrain->getStringId());
-        return 1;
-    }
-    int rc = 0;
-    for (std::vector<Point_t>::const_iterator it = aPoints.begin() ; it != aPoints.end(); ++it)
-    {
-        rc |= registerTerrain(*it, aTerrain);
-    }
-    return rc;
-}
-
-int GameMap::registerTerrain(const Point_t& aPoint, Terrain* const aTerrain)
-{
-    if (mInitialized)
-    {
-        ERROR_LOG("Map initialized, cannot registerTerrain for " + aTerrain->getStringId());
-        return 1;
-    }
-    return registerTerrain(aPoint.x, aPoint.y, aTerrain);
-}
-
-int GameMap::registerTerrain(const int x, const int y, Terrain* const aTerrain)
+int GameMap::initMap()
 {
-    if (mInitialized)
-    {
-        ERROR_LOG("Map initialized, cannot registerTerrain for " + aTerrain->getStringId());
-        return 1;
-    }
-    if (boundaryCheck(x, y)) {
-        mGameMap.at(y).at(x) = aTerrain;
-        return 0;
-    }
-    else
+    if (!mLayout || !mLayout->isInitialized())
     {
-        ERROR_LOG("Failed to register point for " + aTerrain->getStringId(), " at (" , x, ", ", y, "), out of bound");
+        ERROR_LOG("BoardLayout not initialized, cannot initialize GameMap");
         return 1;
     }
-}
-
-void GameMap::setNumOfHarbour(const size_t aNum)
-{
-    if (mInitialized)
-    {
-        ERROR_LOG("Map initialized, cannot setNumOfHarbour");
-    }
-    mNumHarbour = aNum;
-}
-
-int GameMap::initMap()
-{
+    mCurrentPlayer = 0;
+    mState.reset(mLayout->getVertices().size(), mLayout->getEdges().size(), mLayout->getLands().size(), \
+                 mLayout->getHarbours().size());
     int rc = 0;
-    rc |= populateMap();
-    rc |= populateHarbours(true, true); // (bool aUseDefaultPosition, bool aUseDefaultResourceType)
-    rc |= checkOverlap();
+    rc |= assignHarbourResources(true); // (bool aUseDefaultResourceType)
     rc |= assignResourceAndDice();
 
     if (rc != 0)
@@ -580,13 +195,16 @@ int GameMap::initMap()
     {
         INFO_LOG("Successfully initialized GameMap");
         mInitialized = true;
+        mIncomeModel.reset();   // built again from the new board when queried
+        mDevCardDeck.reset();
+        mDevCardDeck.shuffle(getEngine(RandomStream::DEV_CARD));
     }
     return rc;
 }
 
-bool GameMap::boundaryCheck(const int x, const int y) const
+uint64_t GameMap::getSeed() const
 {
-    return (x < static_cast<int>(mSizeHorizontal) && y < static_cast<int>(mSizeVertical));
+    return mSeed;
 }
 
 void GameMap::logMap(bool aUseId)
@@ -596,13 +214,14 @@ void GameMap::logMap(bool aUseId)
         WARN_LOG("Map not initialized, printMap may not function as expected");
     }
     std::string map = "\n========================\n|";
-    for (size_t jj = 0; jj < mSizeVertical; ++jj)
+    const std::deque< std::deque<Terrain*> >& terrainMap = mLayout->getTerrainMap();
+    for (size_t jj = 0; jj < terrainMap.size(); ++jj)
     {
-        const std::deque<Terrain*>& row = mGameMap.at(jj);
-        for (size_t ii = 0; ii < mSizeHorizontal; ++ii)
+        const std::deque<Terrain*>& row = terrainMap.at(jj);
+        for (size_t ii = 0; ii < row.size(); ++ii)
         {
             // easier to debug using an extra char c
-            char character = row.at(ii)->getCharRepresentation(ii, jj, aUseId); //print ID
+            char character = row.at(ii)->getCharRepresentation(ii, jj, mState, aUseId); //print ID
             map += character;
         }
         map += "|\n|";
@@ -611,76 +230,84 @@ void GameMap::logMap(bool aUseId)
     INFO_LOG("The map is", map);
 }
 
-const std::deque< std::deque<Terrain*> >& GameMap::getTerrainMap() const
+const std::shared_ptr<const BoardLayout>& GameMap::getLayout() const
 {
-    if (!mInitialized)
-    {
-        ERROR_LOG("Map not initialized, cannot printMap");
-    }
-    return mGameMap;
+    return mLayout;
 }
 
-std::vector<int> GameMap::getFirstTwoRoundOrder()
+const BoardState_t& GameMap::getBoardState() const
 {
-    SequenceConfig_t playerOrderConfig( std::vector<size_t>(mPlayers.size(), 1U) );
-    std::vector<int> playerOrder = randomizeResource(playerOrderConfig);
-    INFO_LOG("First two round player order: ", playerOrder);
-    return playerOrder;
+    return mState;
 }
 
-int GameMap::clearAndResize(const int aSizeHorizontal, const int aSizeVertical)
+const std::vector<Vertex*>& GameMap::getVertices() const
 {
-    mSizeHorizontal = aSizeHorizontal;
-    mSizeVertical = aSizeVertical;
-    mNumHarbour = constant::NUM_OF_HARBOUR;
-    mRobLandId = -1;
-    mInitialized = false;
-    mCurrentPlayer = 0;
-    mVertices.clear();
-    mEdges.clear();
-    mLands.clear();
-    mHarbours.clear();
-    mGameMap.clear();
-    // init a 2D array with (Terrain*)nullptr
-    for (size_t jj = 0; jj < mSizeVertical; ++jj)
+    return mLayout->getVertices();
+}
+
+const std::vector<Edge*>& GameMap::getEdges() const
+{
+    return mLayout->getEdges();
+}
+
+const std::vector<Land*>& GameMap::getLands() const
+{
+    return mLayout->getLands();
+}
+
+const std::vector<Player*>& GameMap::getPlayers() const
+{
+    return mPlayers;
+}
+
+std::vector<int> GameMap::getFirstTwoRoundOrder()
+{
+    SequenceConfig_t playerOrderConfig(mPlayers.size());
+    std::array<int, SequenceConfig_t::MAX_SIZE> order;
+    for (size_t playerId = 0U; playerId < mPlayers.size(); ++playerId)
     {
-        std::deque<Terrain*> row(mSizeHorizontal, Blank::getBlank());
-        mGameMap.push_back(row);
+        playerOrderConfig[playerId] = 1U;
     }
-    return 0;
+    const size_t numOfPlayers = playerOrderConfig.shuffle(getEngine(RandomStream::PLAYER_ORDER), order.data(), order.size());
+    std::vector<int> playerOrder(order.begin(), order.begin() + numOfPlayers);
+    INFO_LOG("First two round player order: ", playerOrder);
+    // the second round goes back the other way, read from order, a vector may not insert a range of itself
+    playerOrder.insert(playerOrder.end(), order.rend() - numOfPlayers, order.rend());
+    return playerOrder;
 }
 
 int GameMap::getSizeHorizontal() const
 {
-    return mSizeHorizontal;
+    return mLayout->getSizeHorizontal();
 }
 int GameMap::getSizeVertical() const
 {
-    return mSizeVertical;
+    return mLayout->getSizeVertical();
 }
 
-GameMap::GameMap(const int aSizeHorizontal, const int aSizeVertical) :
-    mSeed(std::chrono::system_clock::now().time_since_epoch().count()),
-    mEngine(mSeed)
+bool GameMap::boundaryCheck(const int x, const int y) const
 {
-    INFO_LOG("random engine seed: ", mSeed);
-    clearAndResize(aSizeHorizontal, aSizeVertical);
+    return (x < getSizeHorizontal() && y < getSizeVertical());
 }
 
-GameMap::~GameMap()
+GameMap::GameMap(std::shared_ptr<const BoardLayout> aLayout, const uint64_t aSeed) :
+    mCurrentPlayer(0),
+    mInitialized(false),
+    mSeed(aSeed != 0U ? aSeed : std::chrono::system_clock::now().time_since_epoch().count()),
+    mLayout(std::move(aLayout)),
+    mJournal(nullptr),
+    mDeltaStream(nullptr)
 {
-    for (Vertex* pVertex : mVertices)
+    for (size_t stream = 0U; stream < RANDOM_STREAM_SIZE; ++stream)
     {
-        delete pVertex;
-    }
-    for (Edge* pEdge : mEdges)
-    {
-        delete pEdge;
-    }
-    for (Land* pLand : mLands)
-    {
-        delete pLand;
+        mEngines[stream].seed(mSeed, stream);
     }
+    INFO_LOG("random engine seed: ", mSeed, ", use --seed=", mSeed, " to reproduce");
+    mState.reset(0U, 0U, 0U, 0U);
+}
+
+GameMap::~GameMap()
+{
     for (Player* pPlayer : mPlayers)
     {
         delete pPlayer;
@@ -696,6 +323,11 @@ int GameMap::addPlayer(size_t aNumOfPlayer)
     return mPlayers.size();
 }
 
+size_t GameMap::getNumOfPlayers() const
+{
+    return mPlayers.size();
+}
+
 size_t GameMap::nextPlayer()
 {
     if (mPlayers.size() == 0)
@@ -703,6 +335,7 @@ size_t GameMap::nextPlayer()
         ERROR_LOG("No player");
     }
     mCurrentPlayer = (mCurrentPlayer + 1) % mPlayers.size();
+    recordEvent(JournalEventType::NEXT_PLAYER);
     return mCurrentPlayer;
 }
 
@@ -752,25 +385,33 @@ bool GameMap::currentPlayerHasResourceForDevCard() const
 
 int GameMap::currentPlayerBuyDevCard(DevelopmentCardTypes& aDevCard)
 {
-    if (!currentPlayerHasResourceForDevCard())
+    if (!currentPlayerHasResourceForDevCard() || mDevCardDeck.empty())
     {
         return 1;
     }
-    // TODO: draw dev card from devCardPile
-    static std::uniform_int_distribution<int> distribution(
-        static_cast<int>(DevelopmentCardTypes::KNIGHT), static_cast<int>(DevelopmentCardTypes::ONE_VICTORY_POINT));
-    aDevCard = static_cast<DevelopmentCardTypes>(distribution(mEngine));
+    aDevCard = static_cast<DevelopmentCardTypes>(mDevCardDeck.draw());
     Player* & currPlayer = mPlayers[mCurrentPlayer];
     currPlayer->drawDevelopmentCard(aDevCard, 1);
     currPlayer->consumeResources(ResourceTypes::SHEEP, 1);
     currPlayer->consumeResources(ResourceTypes::WHEAT, 1);
     currPlayer->consumeResources(ResourceTypes::ORE, 1);
+    recordEvent(JournalEventType::BUY_DEV_CARD, static_cast<uint8_t>(aDevCard));
     return 0;
 }
 
 int GameMap::currentPlayerConsumeDevCard(const DevelopmentCardTypes aDevCard)
 {
-    return mPlayers[mCurrentPlayer]->consumeDevelopmentCard(aDevCard);
+    const int rc = mPlayers[mCurrentPlayer]->consumeDevelopmentCard(aDevCard);
+    if (rc == 0)
+    {
+        recordEvent(JournalEventType::CONSUME_DEV_CARD, static_cast<uint8_t>(aDevCard));
+    }
+    return rc;
+}
+
+const DevCardDeck_t& GameMap::getDevCardDeck() const
+{
+    return mDevCardDeck;
 }
 
 size_t GameMap::currentPlayerPlayMonopoly(const ResourceTypes aResource)
@@ -780,6 +421,14 @@ size_t GameMap::currentPlayerPlayMonopoly(const ResourceTypes aResource)
         ERROR_LOG("Incorrect ResourceType, int_val: ", static_cast<int>(aResource));
     }
 
+    const size_t sumOfResource = monopolize(aResource);
+    DEBUG_LOG_L3("Monopoly_card: sum of resource is ", sumOfResource);
+    recordEvent(JournalEventType::MONOPOLY, static_cast<uint8_t>(aResource));
+    return sumOfResource;
+}
+
+size_t GameMap::monopolize(const ResourceTypes aResource)
+{
     size_t sumOfResource = 0;
     for (Player* player : mPlayers)
     {
@@ -791,12 +440,11 @@ size_t GameMap::currentPlayerPlayMonopoly(const ResourceTypes aResource)
         sumOfResource += numOfResource;
         player->consumeResources(aResource, numOfResource);
     }
-    DEBUG_LOG_L3("Monopoly_card: sum of resource is ", sumOfResource);
     mPlayers.at(mCurrentPlayer)->addResources(aResource, sumOfResource);
     return sumOfResource;
 }
 
-void GameMap::summarizePlayerStatus(int aPlayerId, std::vector<std::string>& aReturnMsg) const
+void GameMap::summarizePlayerStatus(int aPlayerId, std::vector<std::string>& aReturnMsg, const size_t aNumRolls) const
 {
     if (aPlayerId == -1)
     {
@@ -812,7 +460,7 @@ void GameMap::summarizePlayerStatus(int aPlayerId, std::vector<std::string>& aRe
     auto playerResources = player->getResources();
     auto playerDevCard = player->getDevCards();
     auto playerDevCardUsed = player->getUsedDevCards();
-    const size_t victoryPoint = player->getVictoryPoint(aPlayerId != static_cast<int>(mCurrentPlayer));
+    const size_t victoryPoint = player->getVictoryPoint(mState, aPlayerId != static_cast<int>(mCurrentPlayer));
 
     aReturnMsg.emplace_back("Status of Player#" + std::to_string(aPlayerId));
     aReturnMsg.emplace_back("");
@@ -831,6 +479,18 @@ void GameMap::summarizePlayerStatus(int aPlayerId, std::vector<std::string>& aRe
         aReturnMsg.emplace_back("  " + summarizeEnumArray(playerDevCardUsed, developmentCardTypesToStr));
         aReturnMsg.emplace_back("");
 
+        // the hand is private, so are the chances
+        const size_t numRolls = (aNumRolls != 0U) ? aNumRolls : mPlayers.size();
+        std::ostringstream chances;
+        chances << std::fixed << std::setprecision(1);
+        for (size_t target = 0U; target < INCOME_TARGET_SIZE; ++target)
+        {
+            chances << (target == 0U ? "  " : ", ") << incomeTargetToStr(static_cast<IncomeTarget>(target)) << ": " \
+                << 100.0 * getIncomeModel().getAffordChance(aPlayerId, playerResources, static_cast<IncomeTarget>(target), numRolls) << "%";
+        }
+        aReturnMsg.emplace_back(Logger::formatString("Chance to afford within ", numRolls, " rolls: "));
+        aReturnMsg.emplace_back(chances.str());
+        aReturnMsg.emplace_back("");
     }
     else
     {
@@ -842,12 +502,42 @@ void GameMap::summarizePlayerStatus(int aPlayerId, std::vector<std::string>& aRe
         aReturnMsg.emplace_back("Number of Used development card: " + \
                 std::to_string(std::accumulate(playerDevCardUsed.begin(), playerDevCardUsed.end(), 0U)));
     }
+
+    // colonies and robber are public, so is the income
+    const IncomeModel::Income_t& income = getIncomeModel().getIncome(aPlayerId);
+    std::ostringstream expected;
+    expected << std::fixed << std::setprecision(2);
+    for (size_t resource = 0U; resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+    {
+        expected << (resource == 0U ? "  " : ", ") << resourceTypesToStr(static_cast<ResourceTypes>(resource)) << ": " \
+            << income.expected[resource];
+    }
+    aReturnMsg.emplace_back("Expected income per roll: ");
+    aReturnMsg.emplace_back(expected.str());
     aReturnMsg.emplace_back(Logger::formatString("Victory point: ", victoryPoint));
 }
 
 void GameMap::currentPlayerAddResource(const ResourceTypes aResource)
 {
     mPlayers.at(mCurrentPlayer)->addResources(aResource, 1);
+    recordEvent(JournalEventType::ADD_RESOURCE, static_cast<uint8_t>(aResource));
+}
+
+size_t GameMap::currentPlayerCollectResources(const Point_t aVertex)
+{
+    const Terrain* const pVertex = getTerrain(aVertex);
+    size_t numOfResources = 0U;
+    for (const Land* const pLand : getLands())
+    {
+        const std::vector<const Vertex*>& adjVertices = pLand->getAdjacentVertices();
+        if (pLand->getResourceType(mState) != ResourceTypes::DESERT && \
+            std::find(adjVertices.begin(), adjVertices.end(), pVertex) != adjVertices.end())
+        {
+            currentPlayerAddResource(pLand->getResourceType(mState));
+            ++numOfResources;
+        }
+    }
+    return numOfResources;
 }
 
 int GameMap::buildColony(const Point_t aPoint, const ColonyType aColony, const bool aEdgeCheck, const bool aConsumeResource)
@@ -862,14 +552,14 @@ int GameMap::buildColony(const Point_t aPoint, const ColonyType aColony, const b
         WARN_LOG("buildColony called with ColonyType::NONE");
         return 1;
     }
-    Vertex* const pVertex = dynamic_cast<Vertex*>(_getTerrain(aPoint));
+    const Vertex* const pVertex = dynamic_cast<const Vertex*>(getTerrain(aPoint));
     if (!pVertex)
     {
-        WARN_LOG("Expected vertex at ", aPoint, ", actual: " + _getTerrain(aPoint)->getStringId());
+        WARN_LOG("Expected vertex at ", aPoint, ", actual: " + getTerrain(aPoint)->getStringId());
         return 1;
     }
 
-    int vertexOwner = pVertex->getOwner();
+    int vertexOwner = pVertex->getOwner(mState);
     if ((aColony == ColonyType::SETTLEMENT && vertexOwner != -1) || \
         (aColony == ColonyType::CITY && vertexOwner != static_cast<int>(mCurrentPlayer)))
     {
@@ -879,7 +569,7 @@ int GameMap::buildColony(const Point_t aPoint, const ColonyType aColony, const b
 
     if (aColony == ColonyType::SETTLEMENT)
     {
-        if (!pVertex->isAvailable())
+        if (!pVertex->isAvailable(mState))
         {
             WARN_LOG("cannot build settlement at " + pVertex->getStringId() + "adjacent vertex occupied");
             return 3;
@@ -887,7 +577,7 @@ int GameMap::buildColony(const Point_t aPoint, const ColonyType aColony, const b
 
         if (aEdgeCheck)
         {
-            if (!pVertex->isConnected(mCurrentPlayer))
+            if (!pVertex->isConnected(mState, mCurrentPlayer))
             {
                 WARN_LOG("cannot build settlement at " + pVertex->getStringId() + ", no edge connected to this vertex");
                 return 5;
@@ -898,16 +588,6 @@ int GameMap::buildColony(const Point_t aPoint, const ColonyType aColony, const b
         {
             return 4;
         }
-
-        if (aConsumeResource)
-        {
-            mPlayers[mCurrentPlayer]->consumeResources(ResourceTypes::BRICK, 1);
-            mPlayers[mCurrentPlayer]->consumeResources(ResourceTypes::WOOD, 1);
-            mPlayers[mCurrentPlayer]->consumeResources(ResourceTypes::WHEAT, 1);
-            mPlayers[mCurrentPlayer]->consumeResources(ResourceTypes::SHEEP, 1);
-        }
-
-        mPlayers[mCurrentPlayer]->addColony(*pVertex);
     }
     else
     {
@@ -915,14 +595,40 @@ int GameMap::buildColony(const Point_t aPoint, const ColonyType aColony, const b
         {
             return 4;
         }
+    }
+
+    placeColony(pVertex, aColony, aConsumeResource);
+    INFO_LOG("Successfully set " + colonyTypesToStr(aColony) + " for Player#", mCurrentPlayer, " for " + pVertex->getStringId());
+    recordEvent(aColony == ColonyType::SETTLEMENT ? JournalEventType::BUILD_SETTLEMENT : JournalEventType::BUILD_CITY, \
+                aConsumeResource ? JOURNAL_FLAG_CONSUME_RESOURCE : 0U, pVertex->getId());
+    return 0;
+}
+
+void GameMap::placeColony(const Vertex* const aVertex, const ColonyType aColony, const bool aConsumeResource)
+{
+    Player* const pPlayer = mPlayers[mCurrentPlayer];
+    if (aColony == ColonyType::SETTLEMENT)
+    {
         if (aConsumeResource)
         {
-            mPlayers[mCurrentPlayer]->consumeResources(ResourceTypes::WHEAT, 2);
-            mPlayers[mCurrentPlayer]->consumeResources(ResourceTypes::ORE, 3);
+            pPlayer->consumeResources(ResourceTypes::BRICK, 1);
+            pPlayer->consumeResources(ResourceTypes::WOOD, 1);
+            pPlayer->consumeResources(ResourceTypes::WHEAT, 1);
+            pPlayer->consumeResources(ResourceTypes::SHEEP, 1);
         }
+        pPlayer->addColony(*aVertex);
+    }
+    else if (aConsumeResource)
+    {
+        pPlayer->consumeResources(ResourceTypes::WHEAT, 2);
+        pPlayer->consumeResources(ResourceTypes::ORE, 3);
+    }
+    mState.vertexOwner[aVertex->getId()] = static_cast<int8_t>(mCurrentPlayer);
+    mState.colony[aVertex->getId()] = static_cast<uint8_t>(aColony);
+    if (mIncomeModel)
+    {
+        mIncomeModel->setColony(aVertex->getId(), mCurrentPlayer, aColony);
     }
-
-    return pVertex->setOwner(mCurrentPlayer, aColony);
 }
 
 int GameMap::buildRoad(const Point_t aPoint, const bool aConsumeResource)
@@ -932,19 +638,19 @@ int GameMap::buildRoad(const Point_t aPoint, const bool aConsumeResource)
         WARN_LOG("buildRoad called for an out-of-bound ", aPoint);
         return 1;
     }
-    Edge* const pEdge = dynamic_cast<Edge*>(_getTerrain(aPoint));
+    const Edge* const pEdge = dynamic_cast<const Edge*>(getTerrain(aPoint));
     if (!pEdge)
     {
-        WARN_LOG("Expected edge at ", aPoint, ", actual: " + _getTerrain(aPoint)->getStringId());
+        WARN_LOG("Expected edge at ", aPoint, ", actual: " + getTerrain(aPoint)->getStringId());
         return 1;
     }
-    if (pEdge->getOwner() != -1)
+    if (pEdge->getOwner(mState) != -1)
     {
-        WARN_LOG(pEdge->getStringId() + " is owned by Player#", pEdge->getOwner(), " already, cannot reset for Player#", mCurrentPlayer);
+        WARN_LOG(pEdge->getStringId() + " is owned by Player#", pEdge->getOwner(mState), " already, cannot reset for Player#", mCurrentPlayer);
         return 2;
     }
 
-    if (!pEdge->isAvailable(mCurrentPlayer))
+    if (!pEdge->isAvailable(mState, mCurrentPlayer))
     {
         WARN_LOG("None of the adjacent vertices of " + pEdge->getStringId() + " is owned by current player, cannot build road here");
         return 3;
@@ -955,15 +661,22 @@ int GameMap::buildRoad(const Point_t aPoint, const bool aConsumeResource)
         return 4;
     }
 
+    placeRoad(pEdge, aConsumeResource);
+    INFO_LOG("Successfully set owner Player#", mCurrentPlayer, " for " + pEdge->getStringId());
+    recordEvent(JournalEventType::BUILD_ROAD, aConsumeResource ? JOURNAL_FLAG_CONSUME_RESOURCE : 0U, pEdge->getId());
+    return 0;
+}
+
+void GameMap::placeRoad(const Edge* const aEdge, const bool aConsumeResource)
+{
+    Player* const pPlayer = mPlayers[mCurrentPlayer];
     if (aConsumeResource)
     {
-        mPlayers[mCurrentPlayer]->consumeResources(ResourceTypes::BRICK, 1);
-        mPlayers[mCurrentPlayer]->consumeResources(ResourceTypes::WOOD, 1);
+        pPlayer->consumeResources(ResourceTypes::BRICK, 1);
+        pPlayer->consumeResources(ResourceTypes::WOOD, 1);
     }
-
-    mPlayers[mCurrentPlayer]->addRoad(*pEdge);
-
-    return pEdge->setOwner(mCurrentPlayer);
+    pPlayer->addRoad(*aEdge);
+    mState.edgeOwner[aEdge->getId()] = static_cast<int8_t>(mCurrentPlayer);
 }
 
 int GameMap::moveRobber(const Point_t aDestination)
@@ -972,61 +685,633 @@ int GameMap::moveRobber(const Point_t aDestination)
     {
         return 1;
     }
-    int landId = _getTerrain(aDestination)->getId();
-    mLands.at(mRobLandId)->rob(false);
-    mLands.at(landId)->rob(true);
-    mRobLandId = landId;
+    const int landId = getTerrain(aDestination)->getId();
+    const uint8_t fromLandId = (mState.robLandId < 0) ? JOURNAL_NO_LAND : static_cast<uint8_t>(mState.robLandId);
+    placeRobber(landId);
+    recordEvent(JournalEventType::MOVE_ROBBER, fromLandId, landId);
     return 0;
 }
 
+void GameMap::placeRobber(const int aLandId)
+{
+    mState.robLandId = aLandId;
+    if (mIncomeModel)
+    {
+        mIncomeModel->setRobber(aLandId);
+    }
+}
+
 int GameMap::robVertex(const Point_t aVertex, ResourceTypes& aRobResource)
 {
-    Vertex* const pVertex = dynamic_cast<Vertex*>(_getTerrain(aVertex));
+    const Vertex* const pVertex = dynamic_cast<const Vertex*>(getTerrain(aVertex));
     if (!pVertex)
     {
         return 1;
     }
-    int owner = pVertex->getOwner();
+    int owner = pVertex->getOwner(mState);
     if (owner == -1)
     {
         return 2;
     }
-    auto resource = mPlayers.at(owner)->getResources();
-    SequenceConfig_t seqConfig(resource);
-    std::vector<int> randomResource = randomizeResource(seqConfig);
-    if (randomResource.size() == 0)
+    // every card in the hand is equally likely to be robbed
+    SequenceConfig_t hand(mPlayers.at(owner)->getResources());
+    const int robbed = drawFromConfig(hand, RandomStream::ROB);
+    if (robbed == -1)
     {
         return 3;
     }
-    aRobResource = static_cast<ResourceTypes>(randomResource.front());
+    aRobResource = static_cast<ResourceTypes>(robbed);
     mPlayers.at(owner)->consumeResources(aRobResource, 1U);
     mPlayers.at(mCurrentPlayer)->addResources(aRobResource, 1U);
+    recordEvent(JournalEventType::ROB_VERTEX, static_cast<uint8_t>(aRobResource), pVertex->getId());
     return 0;
 }
 
 int GameMap::rollDice()
 {
-    static std::uniform_int_distribution<int> distribution(1,6);
-    int dice = distribution(mEngine) + distribution(mEngine);
+    // one draw for both dice, 6 * 6 outcomes, each (first, second) pair equally likely
+    const uint32_t outcome = uniformBelow(getEngine(RandomStream::DICE), 36U);
+    int dice = static_cast<int>(outcome / 6U + outcome % 6U) + 2;
     INFO_LOG("Player#", mCurrentPlayer, " rolled: ", dice);
-    for (Land* const pLand : mLands)
+    produceResources(dice);
+    recordEvent(JournalEventType::ROLL_DICE, static_cast<uint8_t>(dice));
+    return dice;
+}
+
+void GameMap::produceResources(const int aDice, const bool aRevert)
+{
+    for (Land* const pLand : getLands())
     {
-        if (pLand->getDiceNum() == dice && !pLand->isUnderRobber())
+        if (pLand->getDiceNum(mState) == aDice && !pLand->isUnderRobber(mState))
         {
             for (const Vertex* const pConstVertex : pLand->getAdjacentVertices())
             {
-                const int playerId = pConstVertex->getOwner();
+                const int playerId = pConstVertex->getOwner(mState);
                 if (playerId != -1)
                 {
                     // vertex is owned by Player
-                    const ResourceTypes resource = pLand->getResourceType();
-                    const size_t numOfResource = static_cast<size_t>(pConstVertex->getColonyType());
-
-                    DEBUG_LOG_L3("Adding ", numOfResource, " " + resourceTypesToStr(resource) + " to Player#", playerId);
-                    mPlayers.at(playerId)->addResources(resource, numOfResource);
+                    const ResourceTypes resource = pLand->getResourceType(mState);
+                    const size_t numOfResource = static_cast<size_t>(pConstVertex->getColonyType(mState));
+                    if (aRevert)
+                    {
+                        mPlayers[playerId]->consumeResources(resource, numOfResource);
+                    }
+                    else
+                    {
+                        mPlayers[playerId]->addResources(resource, numOfResource);
+                    }
                 }
             }
         }
     }
-    return dice;
+}
+
+void GameMap::recordEvent(const JournalEventType aType, const uint8_t aAux, const uint16_t aId)
+{
+    if (mJournal)
+    {
+        mJournal->record(aType, aAux, aId);
+    }
+    if (mDeltaStream)
+    {
+        mDeltaStream->onEvent(*this, aType, aAux, aId);
+    }
+}
+
+void GameMap::setJournal(ActionJournal* const aJournal)
+{
+    mJournal = aJournal;
+}
+
+void GameMap::setDeltaStream(DeltaStream* const aDeltaStream)
+{
+    mDeltaStream = aDeltaStream;
+}
+
+void GameMap::exportBoard(std::vector<uint8_t>& aBoard) const
+{
+    // [num of lands: u16] [resource: u8, dice: u8] * num of lands [robber land ID: u16]
+    aBoard.clear();
+    pushUint(aBoard, getLands().size(), 2U);
+    for (Land* const pLand : getLands())
+    {
+        aBoard.push_back(static_cast<uint8_t>(pLand->getResourceType(mState)));
+        aBoard.push_back(static_cast<uint8_t>(pLand->getDiceNum(mState)));
+    }
+    pushUint(aBoard, mState.robLandId, 2U);
+}
+
+int GameMap::importBoard(const std::vector<uint8_t>& aBoard)
+{
+    size_t index = 0U;
+    const size_t numOfLands = (aBoard.size() >= 2U) ? readUint(aBoard, index, 2U) : 0U;
+    if (numOfLands != getLands().size() || aBoard.size() != 2U * numOfLands + 4U)
+    {
+        WARN_LOG("Board does not match the map, num of lands: ", numOfLands, ", expected: ", getLands().size());
+        return 1;
+    }
+    for (Land* const pLand : getLands())
+    {
+        mState.landResource[pLand->getId()] = static_cast<int8_t>(aBoard[index]);
+        mState.landDice[pLand->getId()] = aBoard[index + 1];
+        if (mIncomeModel)
+        {
+            mIncomeModel->setLand(pLand->getId(), pLand->getResourceType(mState), pLand->getDiceNum(mState));
+        }
+        index += 2U;
+    }
+    const int robLandId = static_cast<int>(readUint(aBoard, index, 2U));
+    if (robLandId >= static_cast<int>(getLands().size()))
+    {
+        WARN_LOG("Incorrect robber position in board: Land#", robLandId);
+        return 1;
+    }
+    placeRobber(robLandId);
+    return 0;
+}
+
+void GameMap::exportState(std::vector<uint8_t>& aState) const
+{
+    // [num of vertices: u16] [num of edges: u16] [num of players: u16] [current player: u16] [robber land ID: u16]
+    // [owner: i8, colony: u8] * num of vertices
+    // [owner: i8] * num of edges
+    // [resources: u16 * 5, dev cards: u16 * 5, used dev cards: u16 * 5, largest army | longest road << 1: u8] * num of players
+    aState.clear();
+    pushUint(aState, getVertices().size(), 2U);
+    pushUint(aState, getEdges().size(), 2U);
+    pushUint(aState, mPlayers.size(), 2U);
+    pushUint(aState, mCurrentPlayer, 2U);
+    pushUint(aState, mState.robLandId, 2U);
+    for (Vertex* const pVertex : getVertices())
+    {
+        aState.push_back(static_cast<uint8_t>(pVertex->getOwner(mState)));
+        aState.push_back(static_cast<uint8_t>(pVertex->getColonyType(mState)));
+    }
+    for (Edge* const pEdge : getEdges())
+    {
+        aState.push_back(static_cast<uint8_t>(pEdge->getOwner(mState)));
+    }
+    for (Player* const pPlayer : mPlayers)
+    {
+        for (const size_t amount : pPlayer->getResources())
+        {
+            pushUint(aState, amount, 2U);
+        }
+        for (const size_t amount : pPlayer->getDevCards())
+        {
+            pushUint(aState, amount, 2U);
+        }
+        for (const size_t amount : pPlayer->getUsedDevCards())
+        {
+            pushUint(aState, amount, 2U);
+        }
+        aState.push_back(static_cast<uint8_t>((pPlayer->hasLargestArmy() ? 0x01U : 0U) | (pPlayer->hasLongestRoad() ? 0x02U : 0U)));
+    }
+}
+
+int GameMap::importState(const std::vector<uint8_t>& aState)
+{
+    constexpr size_t PLAYER_SIZE = 2U * (CONSUMABLE_RESOURCE_SIZE + 2U * DEVELOPMENT_CARD_TYPE_SIZE) + 1U;
+    size_t index = 0U;
+    if (aState.size() < 10U)
+    {
+        WARN_LOG("State is too short: ", aState.size(), " bytes");
+        return 1;
+    }
+    const size_t numOfVertices = readUint(aState, index, 2U);
+    const size_t numOfEdges = readUint(aState, index, 2U);
+    const size_t numOfPlayers = readUint(aState, index, 2U);
+    const size_t currentPlayer = readUint(aState, index, 2U);
+    const size_t robLandId = readUint(aState, index, 2U);
+    // the state may be padded
+    if (numOfVertices != getVertices().size() || numOfEdges != getEdges().size() || numOfPlayers != mPlayers.size() || \
+        currentPlayer >= mPlayers.size() || robLandId >= getLands().size() || \
+        aState.size() < index + 2U * numOfVertices + numOfEdges + numOfPlayers * PLAYER_SIZE)
+    {
+        WARN_LOG("State does not match the map, vertices: ", numOfVertices, ", edges: ", numOfEdges, ", players: ", numOfPlayers, \
+                    ", current player: ", currentPlayer, ", robber: ", robLandId, ", size: ", aState.size());
+        return 1;
+    }
+
+    // validate the owners and colonies first, a state rejected leaves the map untouched
+    for (size_t vertexId = 0U; vertexId < numOfVertices; ++vertexId)
+    {
+        const int owner = static_cast<int8_t>(aState[index + 2U * vertexId]);
+        const ColonyType colony = static_cast<ColonyType>(aState[index + 2U * vertexId + 1U]);
+        if (owner < -1 || owner >= static_cast<int>(mPlayers.size()) || colony > ColonyType::CITY)
+        {
+            WARN_LOG("Incorrect owner of Vertex#", vertexId, ", owner: ", owner, ", colony: ", colony);
+            return 1;
+        }
+    }
+    const size_t edgeStart = index + 2U * numOfVertices;
+    for (size_t edgeId = 0U; edgeId < numOfEdges; ++edgeId)
+    {
+        const int owner = static_cast<int8_t>(aState[edgeStart + edgeId]);
+        if (owner < -1 || owner >= static_cast<int>(mPlayers.size()))
+        {
+            WARN_LOG("Incorrect owner of Edge#", edgeId, ", owner: ", owner);
+            return 1;
+        }
+    }
+
+    std::array<size_t, CONSUMABLE_RESOURCE_SIZE> resources;
+    std::array<size_t, DEVELOPMENT_CARD_TYPE_SIZE> devCard;
+    std::array<size_t, DEVELOPMENT_CARD_TYPE_SIZE> devCardUsed;
+    std::array<size_t, DEVELOPMENT_CARD_TYPE_SIZE> devCardDrawn = {};
+    size_t playerIndex = edgeStart + numOfEdges;
+    for (Player* const pPlayer : mPlayers)
+    {
+        for (size_t& amount : resources)
+        {
+            amount = readUint(aState, playerIndex, 2U);
+        }
+        for (size_t& amount : devCard)
+        {
+            amount = readUint(aState, playerIndex, 2U);
+        }
+        for (size_t& amount : devCardUsed)
+        {
+            amount = readUint(aState, playerIndex, 2U);
+        }
+        for (size_t card = 0U; card < DEVELOPMENT_CARD_TYPE_SIZE; ++card)
+        {
+            devCardDrawn[card] += devCard[card] + devCardUsed[card];
+        }
+        const uint8_t flags = aState[playerIndex++];
+        pPlayer->restore(resources, devCard, devCardUsed, flags & 0x01U, flags & 0x02U);
+    }
+
+    for (Vertex* const pVertex : getVertices())
+    {
+        const int owner = static_cast<int8_t>(aState[index]);
+        const ColonyType colony = static_cast<ColonyType>(aState[index + 1]);
+        index += 2U;
+        mState.vertexOwner[pVertex->getId()] = static_cast<int8_t>(owner);
+        mState.colony[pVertex->getId()] = static_cast<uint8_t>(colony);
+        if (mIncomeModel)
+        {
+            mIncomeModel->setColony(pVertex->getId(), owner, colony);
+        }
+        if (owner >= 0)
+        {
+            mPlayers[owner]->addColony(*pVertex);
+        }
+    }
+    for (Edge* const pEdge : getEdges())
+    {
+        const int owner = static_cast<int8_t>(aState[index++]);
+        mState.edgeOwner[pEdge->getId()] = static_cast<int8_t>(owner);
+        if (owner >= 0)
+        {
+            mPlayers[owner]->addRoad(*pEdge);
+        }
+    }
+
+    // the order of the deck is not part of the state, the cards left are reshuffled
+    mDevCardDeck.reset(devCardDrawn);
+    mDevCardDeck.shuffle(getEngine(RandomStream::DEV_CARD));
+    mCurrentPlayer = currentPlayer;
+    placeRobber(robLandId);
+    return 0;
+}
+
+void GameMap::exportSnapshot(std::vector<uint8_t>& aSnapshot) const
+{
+    // [board size: u16] [board] [state size: u16] [state] [random engines] [development card deck]
+    std::vector<uint8_t> board;
+    std::vector<uint8_t> state;
+    exportBoard(board);
+    exportState(state);
+    aSnapshot.clear();
+    aSnapshot.reserve(4U + board.size() + state.size() + sizeof(mEngines) + sizeof(mDevCardDeck));
+    pushUint(aSnapshot, board.size(), 2U);
+    aSnapshot.insert(aSnapshot.end(), board.begin(), board.end());
+    pushUint(aSnapshot, state.size(), 2U);
+    aSnapshot.insert(aSnapshot.end(), state.begin(), state.end());
+    const uint8_t* const pEngines = reinterpret_cast<const uint8_t*>(mEngines.data());
+    aSnapshot.insert(aSnapshot.end(), pEngines, pEngines + sizeof(mEngines));
+    const uint8_t* const pDeck = reinterpret_cast<const uint8_t*>(&mDevCardDeck);
+    aSnapshot.insert(aSnapshot.end(), pDeck, pDeck + sizeof(mDevCardDeck));
+}
+
+int GameMap::importSnapshot(const std::vector<uint8_t>& aSnapshot)
+{
+    static_assert(std::is_trivially_copyable<RandomEngine>::value, "RandomEngine is copied as it is in memory");
+    size_t index = 0U;
+    const size_t boardSize = (aSnapshot.size() >= 2U) ? readUint(aSnapshot, index, 2U) : 0U;
+    if (aSnapshot.size() < index + boardSize + 2U)
+    {
+        WARN_LOG("Snapshot is too short: ", aSnapshot.size(), " bytes");
+        return 1;
+    }
+    const std::vector<uint8_t> board(aSnapshot.begin() + index, aSnapshot.begin() + index + boardSize);
+    index += boardSize;
+    const size_t stateSize = readUint(aSnapshot, index, 2U);
+    if (aSnapshot.size() != index + stateSize + sizeof(mEngines) + sizeof(mDevCardDeck))
+    {
+        WARN_LOG("Snapshot does not match the map, size: ", aSnapshot.size(), " bytes");
+        return 1;
+    }
+    const std::vector<uint8_t> state(aSnapshot.begin() + index, aSnapshot.begin() + index + stateSize);
+    index += stateSize;
+    if (importBoard(board) != 0 || importState(state) != 0)
+    {
+        return 1;
+    }
+    // importState() reshuffled the deck, the snapshot has its order
+    std::memcpy(mEngines.data(), aSnapshot.data() + index, sizeof(mEngines));
+    index += sizeof(mEngines);
+    std::memcpy(&mDevCardDeck, aSnapshot.data() + index, sizeof(mDevCardDeck));
+    return 0;
+}
+
+size_t GameMap::getRobLandId() const
+{
+    return mState.robLandId;
+}
+
+const IncomeModel& GameMap::getIncomeModel() const
+{
+    if (!mIncomeModel)
+    {
+        mIncomeModel = std::make_unique<IncomeModel>();
+        mIncomeModel->init(*this);
+    }
+    return *mIncomeModel;
+}
+
+int GameMap::exportGameState(GameState_t& aState) const
+{
+    if (getVertices().size() > constant::MAX_NUM_VERTICES || getEdges().size() > constant::MAX_NUM_EDGES || \
+        getLands().size() > constant::MAX_NUM_LANDS || mPlayers.size() > constant::MAX_NUM_PLAYERS)
+    {
+        WARN_LOG("Map too large for GameState_t, vertices: ", getVertices().size(), ", edges: ", getEdges().size(), \
+                 ", lands: ", getLands().size(), ", players: ", mPlayers.size());
+        return 1;
+    }
+
+    aState = GameState_t();
+    aState.vertexOwner.fill(-1);
+    aState.edgeOwner.fill(-1);
+    aState.numPlayers = static_cast<uint8_t>(mPlayers.size());
+    aState.currentPlayer = static_cast<uint8_t>(mCurrentPlayer);
+    aState.robLandId = static_cast<uint8_t>(mState.robLandId);
+    aState.phase = GamePhase::ROLL;
+    aState.largestArmyOwner = NO_PLAYER;
+    aState.longestRoadOwner = NO_PLAYER;
+    aState.winner = NO_PLAYER;
+    aState.devCardDeck = mDevCardDeck;
+
+    for (const Land* const pLand : getLands())
+    {
+        aState.landResource[pLand->getId()] = static_cast<int8_t>(pLand->getResourceType(mState));
+        aState.landDice[pLand->getId()] = (pLand->getResourceType(mState) == ResourceTypes::DESERT) ? \
+                                            0U : static_cast<uint8_t>(pLand->getDiceNum(mState));
+    }
+    for (const Vertex* const pVertex : getVertices())
+    {
+        const int owner = pVertex->getOwner(mState);
+        aState.vertexOwner[pVertex->getId()] = static_cast<int8_t>(owner);
+        aState.colony[pVertex->getId()] = static_cast<uint8_t>(pVertex->getColonyType(mState));
+        if (owner >= 0)
+        {
+            PlayerState_t& player = aState.players[owner];
+            if (pVertex->getColonyType(mState) == ColonyType::CITY)
+            {
+                ++player.numCities;
+            }
+            else
+            {
+                ++player.numSettlements;
+            }
+        }
+    }
+    for (const Edge* const pEdge : getEdges())
+    {
+        aState.edgeOwner[pEdge->getId()] = static_cast<int8_t>(pEdge->getOwner(mState));
+        if (pEdge->getOwner(mState) >= 0)
+        {
+            ++aState.players[pEdge->getOwner(mState)].numRoads;
+        }
+    }
+    for (size_t playerId = 0U; playerId < mPlayers.size(); ++playerId)
+    {
+        const Player* const pPlayer = mPlayers[playerId];
+        PlayerState_t& player = aState.players[playerId];
+        std::copy(pPlayer->getResources().begin(), pPlayer->getResources().end(), player.resources.begin());
+        std::copy(pPlayer->getDevCards().begin(), pPlayer->getDevCards().end(), player.devCards.begin());
+        std::copy(pPlayer->getUsedDevCards().begin(), pPlayer->getUsedDevCards().end(), player.devCardsUsed.begin());
+        player.longestRoad = static_cast<uint8_t>(pPlayer->getPlayerLongestRoadSize());
+        if (pPlayer->hasLargestArmy())
+        {
+            aState.largestArmyOwner = static_cast<uint8_t>(playerId);
+        }
+        if (pPlayer->hasLongestRoad())
+        {
+            aState.longestRoadOwner = static_cast<uint8_t>(playerId);
+        }
+    }
+    return 0;
+}
+
+int GameMap::replayEvent(const JournalEvent_t& aEvent)
+{
+    const bool isResourceValid = (aEvent.aux < CONSUMABLE_RESOURCE_SIZE);
+    const bool isDevCardValid = (aEvent.aux < DEVELOPMENT_CARD_TYPE_SIZE);
+    switch (aEvent.type)
+    {
+        case JournalEventType::NEXT_PLAYER:
+            mCurrentPlayer = (mCurrentPlayer + 1) % mPlayers.size();
+            return 0;
+        case JournalEventType::ROLL_DICE:
+            produceResources(aEvent.aux);
+            return 0;
+        case JournalEventType::BUILD_ROAD:
+            if (aEvent.id >= getEdges().size())
+            {
+                return 1;
+            }
+            placeRoad(getEdges()[aEvent.id], aEvent.aux & JOURNAL_FLAG_CONSUME_RESOURCE);
+            return 0;
+        case JournalEventType::BUILD_SETTLEMENT:
+        case JournalEventType::BUILD_CITY:
+            if (aEvent.id >= getVertices().size())
+            {
+                return 1;
+            }
+            placeColony(getVertices()[aEvent.id], \
+                (aEvent.type == JournalEventType::BUILD_SETTLEMENT ? ColonyType::SETTLEMENT : ColonyType::CITY), \
+                aEvent.aux & JOURNAL_FLAG_CONSUME_RESOURCE);
+            return 0;
+        case JournalEventType::MOVE_ROBBER:
+            if (aEvent.id >= getLands().size())
+            {
+                return 1;
+            }
+            placeRobber(aEvent.id);
+            return 0;
+        case JournalEventType::ROB_VERTEX:
+        {
+            if (!isResourceValid || aEvent.id >= getVertices().size() || getVertices()[aEvent.id]->getOwner(mState) == -1)
+            {
+                return 1;
+            }
+            const ResourceTypes resource = static_cast<ResourceTypes>(aEvent.aux);
+            mPlayers[getVertices()[aEvent.id]->getOwner(mState)]->consumeResources(resource, 1U);
+            mPlayers[mCurrentPlayer]->addResources(resource, 1U);
+            return 0;
+        }
+        case JournalEventType::BUY_DEV_CARD:
+        {
+            if (!isDevCardValid || mDevCardDeck.take(static_cast<DevelopmentCardTypes>(aEvent.aux)) != 0)
+            {
+                return 1;
+            }
+            Player* const pPlayer = mPlayers[mCurrentPlayer];
+            pPlayer->drawDevelopmentCard(static_cast<DevelopmentCardTypes>(aEvent.aux), 1);
+            pPlayer->consumeResources(ResourceTypes::SHEEP, 1);
+            pPlayer->consumeResources(ResourceTypes::WHEAT, 1);
+            pPlayer->consumeResources(ResourceTypes::ORE, 1);
+            return 0;
+        }
+        case JournalEventType::CONSUME_DEV_CARD:
+            if (!isDevCardValid)
+            {
+                return 1;
+            }
+            return mPlayers[mCurrentPlayer]->consumeDevelopmentCard(static_cast<DevelopmentCardTypes>(aEvent.aux));
+        case JournalEventType::MONOPOLY:
+            if (!isResourceValid)
+            {
+                return 1;
+            }
+            monopolize(static_cast<ResourceTypes>(aEvent.aux));
+            return 0;
+        case JournalEventType::ADD_RESOURCE:
+            if (!isResourceValid)
+            {
+                return 1;
+            }
+            mPlayers[mCurrentPlayer]->addResources(static_cast<ResourceTypes>(aEvent.aux), 1);
+            return 0;
+        default:
+            return 1;
+    }
+}
+
+int GameMap::revertEvent(const JournalEvent_t& aEvent)
+{
+    Player* const pPlayer = mPlayers[mCurrentPlayer];
+    switch (aEvent.type)
+    {
+        case JournalEventType::NEXT_PLAYER:
+            mCurrentPlayer = (mCurrentPlayer + mPlayers.size() - 1) % mPlayers.size();
+            return 0;
+        case JournalEventType::ROLL_DICE:
+            produceResources(aEvent.aux, true);
+            return 0;
+        case JournalEventType::BUILD_ROAD:
+        {
+            if (aEvent.id >= getEdges().size() || getEdges()[aEvent.id]->getOwner(mState) != static_cast<int>(mCurrentPlayer))
+            {
+                return 1;
+            }
+            const Edge* const pEdge = getEdges()[aEvent.id];
+            mState.edgeOwner[aEvent.id] = -1;
+            pPlayer->removeRoad(*pEdge);
+            if (aEvent.aux & JOURNAL_FLAG_CONSUME_RESOURCE)
+            {
+                pPlayer->addResources(ResourceTypes::BRICK, 1);
+                pPlayer->addResources(ResourceTypes::WOOD, 1);
+            }
+            return 0;
+        }
+        case JournalEventType::BUILD_SETTLEMENT:
+        case JournalEventType::BUILD_CITY:
+        {
+            const bool isSettlement = (aEvent.type == JournalEventType::BUILD_SETTLEMENT);
+            if (aEvent.id >= getVertices().size() || getVertices()[aEvent.id]->getOwner(mState) != static_cast<int>(mCurrentPlayer) || \
+                getVertices()[aEvent.id]->getColonyType(mState) != (isSettlement ? ColonyType::SETTLEMENT : ColonyType::CITY))
+            {
+                return 1;
+            }
+            const Vertex* const pVertex = getVertices()[aEvent.id];
+            if (isSettlement)
+            {
+                mState.vertexOwner[aEvent.id] = -1;
+                mState.colony[aEvent.id] = static_cast<uint8_t>(ColonyType::NONE);
+                pPlayer->removeColony(*pVertex);
+            }
+            else
+            {
+                mState.colony[aEvent.id] = static_cast<uint8_t>(ColonyType::SETTLEMENT);
+            }
+            if (mIncomeModel)
+            {
+                mIncomeModel->setColony(pVertex->getId(), pVertex->getOwner(mState), pVertex->getColonyType(mState));
+            }
+            if ((aEvent.aux & JOURNAL_FLAG_CONSUME_RESOURCE) && isSettlement)
+            {
+                pPlayer->addResources(ResourceTypes::BRICK, 1);
+                pPlayer->addResources(ResourceTypes::WOOD, 1);
+                pPlayer->addResources(ResourceTypes::WHEAT, 1);
+                pPlayer->addResources(ResourceTypes::SHEEP, 1);
+            }
+            else if (aEvent.aux & JOURNAL_FLAG_CONSUME_RESOURCE)
+            {
+                pPlayer->addResources(ResourceTypes::WHEAT, 2);
+                pPlayer->addResources(ResourceTypes::ORE, 3);
+            }
+            return 0;
+        }
+        case JournalEventType::MOVE_ROBBER:
+            if ((aEvent.aux >= getLands().size() && aEvent.aux != JOURNAL_NO_LAND) || static_cast<int>(aEvent.id) != mState.robLandId)
+            {
+                return 1;
+            }
+            placeRobber((aEvent.aux == JOURNAL_NO_LAND) ? -1 : aEvent.aux);
+            return 0;
+        case JournalEventType::ROB_VERTEX:
+        {
+            if (aEvent.aux >= CONSUMABLE_RESOURCE_SIZE || aEvent.id >= getVertices().size() || getVertices()[aEvent.id]->getOwner(mState) == -1)
+            {
+                return 1;
+            }
+            const ResourceTypes resource = static_cast<ResourceTypes>(aEvent.aux);
+            if (!pPlayer->consumeResources(resource, 1U))
+            {
+                return 1;
+            }
+            mPlayers[getVertices()[aEvent.id]->getOwner(mState)]->addResources(resource, 1U);
+            return 0;
+        }
+        case JournalEventType::BUY_DEV_CARD:
+            if (aEvent.aux >= DEVELOPMENT_CARD_TYPE_SIZE || \
+                pPlayer->returnDevelopmentCard(static_cast<DevelopmentCardTypes>(aEvent.aux)) != 0)
+            {
+                return 1;
+            }
+            mDevCardDeck.putBack(static_cast<DevelopmentCardTypes>(aEvent.aux));
+            pPlayer->addResources(ResourceTypes::SHEEP, 1);
+            pPlayer->addResources(ResourceTypes::WHEAT, 1);
+            pPlayer->addResources(ResourceTypes::ORE, 1);
+            return 0;
+        case JournalEventType::CONSUME_DEV_CARD:
+            if (aEvent.aux >= DEVELOPMENT_CARD_TYPE_SIZE)
+            {
+                return 1;
+            }
+            return pPlayer->unconsumeDevelopmentCard(static_cast<DevelopmentCardTypes>(aEvent.aux));
+        case JournalEventType::ADD_RESOURCE:
+            if (aEvent.aux >= CONSUMABLE_RESOURCE_SIZE || !pPlayer->consumeResources(static_cast<ResourceTypes>(aEvent.aux), 1))
+            {
+                return 1;
+            }
+            return 0;
+        case JournalEventType::MONOPOLY:
+            // the amount taken from each player is not recorded
+        default:
+            return 1;
+    }
 }
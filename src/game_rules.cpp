@@ -0,0 +1,650 @@
+/**
+ * Project: catan
+ * @file game_rules.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include "game_rules.hpp"
+#include "constant.hpp"
+#include "logger.hpp"
+
+namespace
+{
+
+using ResourceCost_t = std::array<uint16_t, CONSUMABLE_RESOURCE_SIZE>;
+// BRICK, SHEEP, WHEAT, WOOD, ORE
+constexpr ResourceCost_t ROAD_COST       = {1, 0, 0, 1, 0};
+constexpr ResourceCost_t SETTLEMENT_COST = {1, 1, 1, 1, 0};
+constexpr ResourceCost_t CITY_COST       = {0, 0, 2, 0, 3};
+constexpr ResourceCost_t DEV_CARD_COST   = {0, 1, 1, 0, 1};
+
+constexpr size_t KNIGHT = static_cast<size_t>(DevelopmentCardTypes::KNIGHT);
+
+inline bool canAfford(const PlayerState_t& aPlayer, const ResourceCost_t& aCost)
+{
+    for (size_t resource = 0U; resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+    {
+        if (aPlayer.resources[resource] < aCost[resource])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline void pay(PlayerState_t& aPlayer, const ResourceCost_t& aCost)
+{
+    for (size_t resource = 0U; resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+    {
+        aPlayer.resources[resource] -= aCost[resource];
+    }
+}
+
+inline size_t handSize(const PlayerState_t& aPlayer)
+{
+    size_t total = 0U;
+    for (const uint16_t amount : aPlayer.resources)
+    {
+        total += amount;
+    }
+    return total;
+}
+
+// take a card uniformly at random from aPlayer's hand, the hand must not be empty
+inline size_t takeRandomCard(PlayerState_t& aPlayer, RandomEngine& aEngine)
+{
+    size_t pick = uniformBelow(aEngine, handSize(aPlayer));
+    for (size_t resource = 0U; resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+    {
+        if (pick < aPlayer.resources[resource])
+        {
+            --aPlayer.resources[resource];
+            return resource;
+        }
+        pick -= aPlayer.resources[resource];
+    }
+    return 0U;
+}
+
+} // namespace
+
+GameRules::GameRules(std::shared_ptr<const BoardTopology> aTopology) :
+    mTopology(aTopology),
+    mResourceConfig(static_cast<size_t>(ResourceTypes::ANY)),
+    mDiceConfig(13) // 0 to 12
+{
+    for (size_t landId = 0U; landId < mTopology->getNumLands(); ++landId)
+    {
+        const BoardTopology::LandInfo_t& land = mTopology->getLand(landId);
+        ++mResourceConfig[static_cast<size_t>(land.resource)];
+        if (land.resource != static_cast<int8_t>(ResourceTypes::DESERT))
+        {
+            ++mDiceConfig[land.dice];
+        }
+    }
+}
+
+const BoardTopology& GameRules::getTopology() const
+{
+    return *mTopology;
+}
+
+size_t GameRules::getSetupPlayer(const size_t aNumPlayers, const size_t aStep)
+{
+    return (aStep < aNumPlayers) ? aStep : (aNumPlayers + aNumPlayers - 1U - aStep);
+}
+
+bool GameRules::isChanceAction(const GameAction_t& aAction)
+{
+    switch (aAction.type)
+    {
+    case GameActionType::ROLL_DICE:
+    case GameActionType::BUY_DEV_CARD:
+        return true;
+    case GameActionType::MOVE_ROBBER:
+    case GameActionType::PLAY_KNIGHT:
+        return aAction.aux != NO_PLAYER;
+    default:
+        return false;
+    }
+}
+
+void GameRules::newGame(GameState_t& aState, const size_t aNumPlayers, RandomEngine& aEngine) const
+{
+    aState = GameState_t();
+    aState.vertexOwner.fill(-1);
+    aState.edgeOwner.fill(-1);
+    aState.numPlayers = static_cast<uint8_t>(std::min(aNumPlayers, constant::MAX_NUM_PLAYERS));
+    aState.currentPlayer = 0U;
+    aState.phase = GamePhase::SETUP_SETTLEMENT;
+    aState.largestArmyOwner = NO_PLAYER;
+    aState.longestRoadOwner = NO_PLAYER;
+    aState.winner = NO_PLAYER;
+    aState.robLandId = BoardTopology::NO_ID;
+    aState.devCardDeck.reset();
+
+    // same as GameMap::assignResourceAndDice(), draw without replacement, one land at a time
+    SequenceConfig_t resourceConfig = mResourceConfig;
+    SequenceConfig_t diceConfig = mDiceConfig;
+    for (size_t landId = 0U; landId < mTopology->getNumLands(); ++landId)
+    {
+        aState.landResource[landId] = static_cast<int8_t>(resourceConfig.draw(aEngine));
+        if (aState.landResource[landId] != static_cast<int8_t>(ResourceTypes::DESERT))
+        {
+            aState.landDice[landId] = static_cast<uint8_t>(diceConfig.draw(aEngine));
+        }
+        else if (aState.robLandId == BoardTopology::NO_ID)
+        {
+            aState.robLandId = static_cast<uint8_t>(landId);
+        }
+    }
+    aState.devCardDeck.shuffle(aEngine);
+}
+
+bool GameRules::isVertexFree(const GameState_t& aState, const size_t aVertexId) const
+{
+    if (aState.vertexOwner[aVertexId] != -1)
+    {
+        return false;
+    }
+    for (const uint8_t adjVertex : mTopology->getVertex(aVertexId).vertices)
+    {
+        if (adjVertex != BoardTopology::NO_ID && aState.vertexOwner[adjVertex] != -1)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GameRules::isRoadConnected(const GameState_t& aState, const size_t aEdgeId, const int aPlayerId) const
+{
+    for (const uint8_t vertex : mTopology->getEdge(aEdgeId).vertices)
+    {
+        if (aState.vertexOwner[vertex] == aPlayerId)
+        {
+            return true;
+        }
+        if (aState.vertexOwner[vertex] != -1)
+        {
+            // a colony of another player breaks the road
+            continue;
+        }
+        for (const uint8_t adjEdge : mTopology->getVertex(vertex).edges)
+        {
+            if (adjEdge != BoardTopology::NO_ID && adjEdge != aEdgeId && aState.edgeOwner[adjEdge] == aPlayerId)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool GameRules::canPlayKnight(const GameState_t& aState) const
+{
+    const PlayerState_t& player = aState.players[aState.currentPlayer];
+    return !aState.devCardPlayed && player.devCards[KNIGHT] > aState.newKnights;
+}
+
+void GameRules::appendRobberActions(const GameState_t& aState, const GameActionType aType, std::vector<GameAction_t>& aActions) const
+{
+    for (size_t landId = 0U; landId < mTopology->getNumLands(); ++landId)
+    {
+        if (landId == aState.robLandId)
+        {
+            continue;
+        }
+        // one action per player that can be robbed
+        uint32_t victims = 0U;
+        for (const uint8_t vertex : mTopology->getLand(landId).vertices)
+        {
+            const int owner = (vertex != BoardTopology::NO_ID) ? aState.vertexOwner[vertex] : -1;
+            if (owner != -1 && owner != aState.currentPlayer && handSize(aState.players[owner]) > 0U && \
+                !(victims & (1U << owner)))
+            {
+                victims |= 1U << owner;
+                aActions.push_back(GameAction_t{aType, static_cast<uint8_t>(owner), static_cast<uint16_t>(landId)});
+            }
+        }
+        if (victims == 0U)
+        {
+            aActions.push_back(GameAction_t{aType, NO_PLAYER, static_cast<uint16_t>(landId)});
+        }
+    }
+}
+
+void GameRules::getLegalActions(const GameState_t& aState, std::vector<GameAction_t>& aActions) const
+{
+    aActions.clear();
+    const int playerId = aState.currentPlayer;
+    const PlayerState_t& player = aState.players[playerId];
+    switch (aState.phase)
+    {
+    case GamePhase::SETUP_SETTLEMENT:
+        for (size_t vertexId = 0U; vertexId < mTopology->getNumVertices(); ++vertexId)
+        {
+            if (isVertexFree(aState, vertexId))
+            {
+                aActions.push_back(GameAction_t{GameActionType::BUILD_SETTLEMENT, 0U, static_cast<uint16_t>(vertexId)});
+            }
+        }
+        break;
+    case GamePhase::SETUP_ROAD:
+        for (const uint8_t edgeId : mTopology->getVertex(aState.setupVertex).edges)
+        {
+            if (edgeId != BoardTopology::NO_ID && aState.edgeOwner[edgeId] == -1)
+            {
+                aActions.push_back(GameAction_t{GameActionType::BUILD_ROAD, 0U, edgeId});
+            }
+        }
+        break;
+    case GamePhase::ROLL:
+        aActions.push_back(GameAction_t{GameActionType::ROLL_DICE, 0U, 0U});
+        if (canPlayKnight(aState))
+        {
+            appendRobberActions(aState, GameActionType::PLAY_KNIGHT, aActions);
+        }
+        break;
+    case GamePhase::MOVE_ROBBER:
+        appendRobberActions(aState, GameActionType::MOVE_ROBBER, aActions);
+        break;
+    case GamePhase::MAIN:
+        if (aState.actionsThisTurn < constant::MAX_ACTIONS_PER_TURN)
+        {
+            if (player.numCities < constant::MAX_CITIES && canAfford(player, CITY_COST))
+            {
+                for (size_t vertexId = 0U; vertexId < mTopology->getNumVertices(); ++vertexId)
+                {
+                    if (aState.vertexOwner[vertexId] == playerId && aState.colony[vertexId] == ColonyType::SETTLEMENT)
+                    {
+                        aActions.push_back(GameAction_t{GameActionType::BUILD_CITY, 0U, static_cast<uint16_t>(vertexId)});
+                    }
+                }
+            }
+            if (player.numSettlements < constant::MAX_SETTLEMENTS && canAfford(player, SETTLEMENT_COST))
+            {
+                for (size_t vertexId = 0U; vertexId < mTopology->getNumVertices(); ++vertexId)
+                {
+                    if (!isVertexFree(aState, vertexId))
+                    {
+                        continue;
+                    }
+                    for (const uint8_t edgeId : mTopology->getVertex(vertexId).edges)
+                    {
+                        if (edgeId != BoardTopology::NO_ID && aState.edgeOwner[edgeId] == playerId)
+                        {
+                            aActions.push_back(GameAction_t{GameActionType::BUILD_SETTLEMENT, 0U, static_cast<uint16_t>(vertexId)});
+                            break;
+                        }
+                    }
+                }
+            }
+            if (player.numRoads < constant::MAX_ROADS && canAfford(player, ROAD_COST))
+            {
+                for (size_t edgeId = 0U; edgeId < mTopology->getNumEdges(); ++edgeId)
+                {
+                    if (aState.edgeOwner[edgeId] == -1 && isRoadConnected(aState, edgeId, playerId))
+                    {
+                        aActions.push_back(GameAction_t{GameActionType::BUILD_ROAD, 0U, static_cast<uint16_t>(edgeId)});
+                    }
+                }
+            }
+            if (canAfford(player, DEV_CARD_COST) && !aState.devCardDeck.empty())
+            {
+                aActions.push_back(GameAction_t{GameActionType::BUY_DEV_CARD, 0U, 0U});
+            }
+            if (canPlayKnight(aState))
+            {
+                appendRobberActions(aState, GameActionType::PLAY_KNIGHT, aActions);
+            }
+            for (size_t give = 0U; give < CONSUMABLE_RESOURCE_SIZE; ++give)
+            {
+                if (player.resources[give] < getTradeRatio(aState, playerId, static_cast<ResourceTypes>(give)))
+                {
+                    continue;
+                }
+                for (size_t take = 0U; take < CONSUMABLE_RESOURCE_SIZE; ++take)
+                {
+                    if (take != give)
+                    {
+                        aActions.push_back(GameAction_t{GameActionType::BANK_TRADE, static_cast<uint8_t>(give << 4 | take), 0U});
+                    }
+                }
+            }
+        }
+        aActions.push_back(GameAction_t{GameActionType::END_TURN, 0U, 0U});
+        break;
+    case GamePhase::GAME_OVER:
+    default:
+        break;
+    }
+}
+
+void GameRules::applyAction(GameState_t& aState, const GameAction_t& aAction, RandomEngine& aEngine) const
+{
+    const int playerId = aState.currentPlayer;
+    PlayerState_t& player = aState.players[playerId];
+    const bool isSetup = (aState.phase == GamePhase::SETUP_SETTLEMENT || aState.phase == GamePhase::SETUP_ROAD);
+    if (aState.phase == GamePhase::MAIN)
+    {
+        ++aState.actionsThisTurn;
+    }
+
+    switch (aAction.type)
+    {
+    case GameActionType::ROLL_DICE:
+    {
+        const size_t roll = uniformBelow(aEngine, 36U);
+        applyDice(aState, roll / 6U + roll % 6U + 2U, aEngine);
+        break;
+    }
+    case GameActionType::MOVE_ROBBER:
+        moveRobber(aState, aAction, aEngine);
+        aState.phase = GamePhase::MAIN;
+        break;
+    case GameActionType::PLAY_KNIGHT:
+        --player.devCards[KNIGHT];
+        ++player.devCardsUsed[KNIGHT];
+        aState.devCardPlayed = true;
+        moveRobber(aState, aAction, aEngine);
+        updateLargestArmy(aState);
+        break;
+    case GameActionType::BUILD_ROAD:
+        if (!isSetup)
+        {
+            pay(player, ROAD_COST);
+        }
+        aState.edgeOwner[aAction.id] = static_cast<int8_t>(playerId);
+        ++player.numRoads;
+        updateLongestRoad(aState);
+        if (isSetup)
+        {
+            ++aState.setupStep;
+            if (aState.setupStep >= aState.numPlayers * 2U)
+            {
+                aState.currentPlayer = 0U;
+                aState.phase = GamePhase::ROLL;
+            }
+            else
+            {
+                aState.currentPlayer = static_cast<uint8_t>(getSetupPlayer(aState.numPlayers, aState.setupStep));
+                aState.phase = GamePhase::SETUP_SETTLEMENT;
+            }
+        }
+        break;
+    case GameActionType::BUILD_SETTLEMENT:
+        aState.vertexOwner[aAction.id] = static_cast<int8_t>(playerId);
+        aState.colony[aAction.id] = ColonyType::SETTLEMENT;
+        ++player.numSettlements;
+        if (isSetup)
+        {
+            aState.setupVertex = static_cast<uint8_t>(aAction.id);
+            aState.phase = GamePhase::SETUP_ROAD;
+            if (aState.setupStep >= aState.numPlayers)
+            {
+                // second settlement, collect the resources next to it
+                for (const uint8_t landId : mTopology->getVertex(aAction.id).lands)
+                {
+                    if (landId != BoardTopology::NO_ID && \
+                        aState.landResource[landId] != static_cast<int8_t>(ResourceTypes::DESERT))
+                    {
+                        ++player.resources[aState.landResource[landId]];
+                    }
+                }
+            }
+        }
+        else
+        {
+            pay(player, SETTLEMENT_COST);
+            // the settlement may break the road of another player
+            updateLongestRoad(aState);
+        }
+        break;
+    case GameActionType::BUILD_CITY:
+        pay(player, CITY_COST);
+        aState.colony[aAction.id] = ColonyType::CITY;
+        --player.numSettlements;
+        ++player.numCities;
+        break;
+    case GameActionType::BUY_DEV_CARD:
+    {
+        pay(player, DEV_CARD_COST);
+        // legal only if the deck is not empty
+        const size_t devCard = static_cast<size_t>(aState.devCardDeck.draw());
+        ++player.devCards[devCard];
+        if (devCard == KNIGHT)
+        {
+            ++aState.newKnights;
+        }
+        break;
+    }
+    case GameActionType::BANK_TRADE:
+    {
+        const size_t give = aAction.aux >> 4;
+        const size_t take = aAction.aux & 0x0FU;
+        player.resources[give] -= getTradeRatio(aState, playerId, static_cast<ResourceTypes>(give));
+        ++player.resources[take];
+        break;
+    }
+    case GameActionType::END_TURN:
+        endTurn(aState);
+        return;
+    default:
+        break;
+    }
+    checkWinner(aState);
+}
+
+void GameRules::applyDice(GameState_t& aState, const size_t aDice, RandomEngine& aEngine) const
+{
+    if (aDice == 7U)
+    {
+        discardHalf(aState, aEngine);
+        aState.phase = GamePhase::MOVE_ROBBER;
+    }
+    else
+    {
+        produceResources(aState, aDice);
+        aState.phase = GamePhase::MAIN;
+    }
+}
+
+void GameRules::produceResources(GameState_t& aState, const size_t aDice) const
+{
+    for (size_t landId = 0U; landId < mTopology->getNumLands(); ++landId)
+    {
+        if (aState.landDice[landId] != aDice || landId == aState.robLandId)
+        {
+            continue;
+        }
+        const size_t resource = aState.landResource[landId];
+        for (const uint8_t vertex : mTopology->getLand(landId).vertices)
+        {
+            if (vertex != BoardTopology::NO_ID && aState.vertexOwner[vertex] != -1)
+            {
+                aState.players[aState.vertexOwner[vertex]].resources[resource] += aState.colony[vertex];
+            }
+        }
+    }
+}
+
+void GameRules::discardHalf(GameState_t& aState, RandomEngine& aEngine) const
+{
+    for (size_t playerId = 0U; playerId < aState.numPlayers; ++playerId)
+    {
+        PlayerState_t& player = aState.players[playerId];
+        const size_t total = handSize(player);
+        if (total <= constant::MAX_HAND_ON_SEVEN)
+        {
+            continue;
+        }
+        for (size_t discarded = 0U; discarded < total / 2U; ++discarded)
+        {
+            takeRandomCard(player, aEngine);
+        }
+    }
+}
+
+void GameRules::moveRobber(GameState_t& aState, const GameAction_t& aAction, RandomEngine& aEngine) const
+{
+    aState.robLandId = static_cast<uint8_t>(aAction.id);
+    if (aAction.aux != NO_PLAYER)
+    {
+        const size_t resource = takeRandomCard(aState.players[aAction.aux], aEngine);
+        ++aState.players[aState.currentPlayer].resources[resource];
+    }
+}
+
+void GameRules::endTurn(GameState_t& aState) const
+{
+    aState.currentPlayer = static_cast<uint8_t>((aState.currentPlayer + 1U) % aState.numPlayers);
+    aState.phase = GamePhase::ROLL;
+    aState.actionsThisTurn = 0U;
+    aState.newKnights = 0U;
+    aState.devCardPlayed = false;
+    if (++aState.turn >= constant::MAX_TURNS)
+    {
+        // draw
+        aState.phase = GamePhase::GAME_OVER;
+    }
+}
+
+void GameRules::updateLargestArmy(GameState_t& aState) const
+{
+    // only the current player can play a knight, hence the only possible new owner
+    const uint8_t playerId = aState.currentPlayer;
+    const size_t knights = aState.players[playerId].devCardsUsed[KNIGHT];
+    if (knights < constant::LARGEST_ARMY_MIN_KNIGHTS || aState.largestArmyOwner == playerId)
+    {
+        return;
+    }
+    if (aState.largestArmyOwner == NO_PLAYER || \
+        knights > aState.players[aState.largestArmyOwner].devCardsUsed[KNIGHT])
+    {
+        aState.largestArmyOwner = playerId;
+    }
+}
+
+size_t GameRules::longestRoadFrom(const GameState_t& aState, const size_t aVertexId, const int aPlayerId,
+                                  std::array<bool, constant::MAX_NUM_EDGES>& aVisited) const
+{
+    size_t longest = 0U;
+    for (const uint8_t edgeId : mTopology->getVertex(aVertexId).edges)
+    {
+        if (edgeId == BoardTopology::NO_ID || aVisited[edgeId] || aState.edgeOwner[edgeId] != aPlayerId)
+        {
+            continue;
+        }
+        const uint8_t nextVertex = mTopology->getOtherVertex(edgeId, aVertexId);
+        aVisited[edgeId] = true;
+        size_t length = 1U;
+        // the road cannot continue through a colony of another player
+        if (aState.vertexOwner[nextVertex] == -1 || aState.vertexOwner[nextVertex] == aPlayerId)
+        {
+            length += longestRoadFrom(aState, nextVertex, aPlayerId, aVisited);
+        }
+        aVisited[edgeId] = false;
+        longest = std::max(longest, length);
+    }
+    return longest;
+}
+
+void GameRules::updateLongestRoad(GameState_t& aState) const
+{
+    std::array<bool, constant::MAX_NUM_EDGES> visited;
+    visited.fill(false);
+    for (size_t playerId = 0U; playerId < aState.numPlayers; ++playerId)
+    {
+        PlayerState_t& player = aState.players[playerId];
+        size_t longest = 0U;
+        for (size_t edgeId = 0U; edgeId < mTopology->getNumEdges() && player.numRoads > longest; ++edgeId)
+        {
+            if (aState.edgeOwner[edgeId] != static_cast<int8_t>(playerId))
+            {
+                continue;
+            }
+            for (const uint8_t vertex : mTopology->getEdge(edgeId).vertices)
+            {
+                longest = std::max(longest, longestRoadFrom(aState, vertex, playerId, visited));
+            }
+        }
+        player.longestRoad = static_cast<uint8_t>(longest);
+    }
+
+    // the owner keeps the title until someone has a strictly longer road
+    // if the owner's road is broken, the title goes to the unique longest road, or to nobody on a tie
+    const uint8_t owner = aState.longestRoadOwner;
+    size_t best = (owner != NO_PLAYER) ? aState.players[owner].longestRoad : 0U;
+    uint8_t bestPlayer = owner;
+    bool isTie = false;
+    for (size_t playerId = 0U; playerId < aState.numPlayers; ++playerId)
+    {
+        const size_t length = aState.players[playerId].longestRoad;
+        if (playerId == owner)
+        {
+            continue;
+        }
+        if (length > best)
+        {
+            best = length;
+            bestPlayer = static_cast<uint8_t>(playerId);
+            isTie = false;
+        }
+        else if (length == best && bestPlayer != owner)
+        {
+            isTie = true;
+        }
+    }
+    aState.longestRoadOwner = (best < constant::LONGEST_ROAD_MIN_LENGTH || isTie) ? NO_PLAYER : bestPlayer;
+}
+
+void GameRules::checkWinner(GameState_t& aState) const
+{
+    // only the player of the turn can win
+    if (getVictoryPoint(aState, aState.currentPlayer) >= constant::WINNING_VICTORY_POINT)
+    {
+        aState.winner = aState.currentPlayer;
+        aState.phase = GamePhase::GAME_OVER;
+    }
+}
+
+size_t GameRules::getVictoryPoint(const GameState_t& aState, const size_t aPlayerId) const
+{
+    const PlayerState_t& player = aState.players[aPlayerId];
+    return player.numSettlements + 2U * player.numCities + \
+        (aState.largestArmyOwner == aPlayerId ? 2U : 0U) + \
+        (aState.longestRoadOwner == aPlayerId ? 2U : 0U) + \
+        player.devCards[static_cast<size_t>(DevelopmentCardTypes::ONE_VICTORY_POINT)];
+}
+
+size_t GameRules::getTradeRatio(const GameState_t& aState, const size_t aPlayerId, const ResourceTypes aResource) const
+{
+    size_t ratio = constant::BANK_TRADE_RATIO;
+    for (size_t vertexId = 0U; vertexId < mTopology->getNumVertices(); ++vertexId)
+    {
+        const int8_t harbour = mTopology->getVertex(vertexId).harbour;
+        if (harbour == static_cast<int8_t>(ResourceTypes::NONE) || aState.vertexOwner[vertexId] != static_cast<int8_t>(aPlayerId))
+        {
+            continue;
+        }
+        if (harbour == static_cast<int8_t>(aResource))
+        {
+            return constant::HARBOUR_RESOURCE_TRADE_RATIO;
+        }
+        if (harbour == static_cast<int8_t>(ResourceTypes::ANY))
+        {
+            ratio = constant::HARBOUR_ANY_TRADE_RATIO;
+        }
+    }
+    return ratio;
+}
+
+size_t GameRules::getNumResources(const GameState_t& aState, const size_t aPlayerId) const
+{
+    return handSize(aState.players[aPlayerId]);
+}
@@ -9,12 +9,12 @@
 
 #include <algorithm>
 #include "logger.hpp"
-#include "game_map.hpp"
+#include "board_layout.hpp"
 #include "harbour.hpp"
 #include "blank.hpp"
 #include "utility.hpp"
 
-int Harbour::calculatePoints(GameMap& aMap)
+int Harbour::calculatePoints(BoardLayout& aLayout)
 {
     if (mVertex1.y == mVertex2.y)
     {
@@ -23,7 +23,7 @@ int Harbour::calculatePoints(GameMap& aMap)
         //    xx  xx     |   xx      xx
         //     SHEEP     |  +----------+
         int dy = 1;
-        if (aMap.getTerrain(mVertex1.x, mVertex1.y - 1) == Blank::getBlank())
+        if (aLayout.getTerrain(mVertex1.x, mVertex1.y - 1) == Blank::getBlank())
         {
             // harbour is above the vertices
             dy = -1;
@@ -51,7 +51,7 @@ int Harbour::calculatePoints(GameMap& aMap)
         Point_t pointB = mVertex2;  // the other point
         int dx = -1;
         int dy = -1;
-        const Terrain* pTest = aMap.getTerrain(mVertex2.x + 1, mVertex2.y);
+        const Terrain* pTest = aLayout.getTerrain(mVertex2.x + 1, mVertex2.y);
         if (pTest == Blank::getBlank() || pTest == nullptr)
         {
             // harbour is right to the vertices
@@ -64,7 +64,8 @@ int Harbour::calculatePoints(GameMap& aMap)
         }
         else
         {
-            mTopLeft.x = pointB.x - 1 - resourceTypesToStr(mResourceType).length();
+            mTopLeft.x = pointB.x - 1 - LABEL_WIDTH;
+            mIsRightAligned = true;
         }
         mLinks.push_back(Point_t{pointA.x + dx * 1, pointA.y});
         mLinks.push_back(Point_t{pointA.x + dx * 2, pointA.y});
@@ -85,7 +86,7 @@ int Harbour::calculatePoints(GameMap& aMap)
         Point_t pointB = mVertex1;  // the other point
         int dx = -1;
         int dy = 1;
-        const Terrain* pTest = aMap.getTerrain(mVertex1.x + 1, mVertex1.y);
+        const Terrain* pTest = aLayout.getTerrain(mVertex1.x + 1, mVertex1.y);
         if (pTest == Blank::getBlank() || pTest == nullptr)
         {
             // harbour is right to the vertices
@@ -98,7 +99,8 @@ int Harbour::calculatePoints(GameMap& aMap)
         }
         else
         {
-            mTopLeft.x = pointB.x - 1 - resourceTypesToStr(mResourceType).length();
+            mTopLeft.x = pointB.x - 1 - LABEL_WIDTH;
+            mIsRightAligned = true;
         }
         mLinks.push_back(Point_t{pointA.x + dx * 1, pointA.y});
         mLinks.push_back(Point_t{pointA.x + dx * 2, pointA.y});
@@ -115,26 +117,21 @@ int Harbour::calculatePoints(GameMap& aMap)
 std::vector<Point_t> Harbour::getAllPoints() const
 {
     std::vector<Point_t> allPoints(mLinks);
-    for (size_t ii = 0; ii < std::min(resourceTypesToStr(mResourceType).length(), size_t{5U}); ++ii)
+    for (size_t ii = 0; ii < LABEL_WIDTH; ++ii)
     {
         allPoints.push_back(Point_t{mTopLeft.x + ii, mTopLeft.y});
     }
     return allPoints;
 }
 
-ResourceTypes Harbour::getResourceType()
+ResourceTypes Harbour::getResourceType(const BoardState_t& aState) const
 {
-    return mResourceType;
+    return static_cast<ResourceTypes>(aState.harbourResource[mId]);
 }
 
-void Harbour::setResourceType(ResourceTypes aResource)
-{
-    mResourceType = aResource;
-}
-
-Harbour::Harbour(const int aId, const ResourceTypes aResource, const Point_t aVertex1, const Point_t aVertex2) :
+Harbour::Harbour(const int aId, const Point_t aVertex1, const Point_t aVertex2) :
     Terrain(aId, Point_t{0, 0}),
-    mResourceType(aResource)
+    mIsRightAligned(false)
 {
     if (aVertex1.y < aVertex2.y)
     {
@@ -153,7 +150,7 @@ Harbour::Harbour(const int aId, const ResourceTypes aResource, const Point_t aVe
     }
 }
 
-char Harbour::getCharRepresentation(const size_t aPointX, const size_t aPointY, const bool aUseId) const
+char Harbour::getCharRepresentation(const size_t aPointX, const size_t aPointY, const BoardState_t& aState, const bool aUseId) const
 {
     if (aUseId)
     {
@@ -167,15 +164,13 @@ char Harbour::getCharRepresentation(const size_t aPointX, const size_t aPointY,
         }
         else
         {
-            if (mResourceType != ResourceTypes::ANY)
-            {
-                return resourceTypesToStr(mResourceType).at(aPointX - mTopLeft.x);
-            }
-            else
-            {
-                static const std::vector<char> harbourAny = {'3', ':', '1'};
-                return harbourAny[aPointX - mTopLeft.x];
-            }
+            const ResourceTypes resource = getResourceType(aState);
+            const std::string label = (resource != ResourceTypes::ANY) ? \
+                                        resourceTypesToStr(resource).substr(0U, LABEL_WIDTH) : std::string("3:1");
+            // the label is shorter than LABEL_WIDTH, pad it on the side away from the vertices
+            const size_t padding = mIsRightAligned ? LABEL_WIDTH - label.length() : 0U;
+            const size_t index = aPointX - mTopLeft.x;
+            return (index >= padding && index - padding < label.length()) ? label.at(index - padding) : ' ';
         }
     }
 }
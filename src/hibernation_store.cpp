@@ -0,0 +1,193 @@
+/**
+ * Project: catan
+ * @file hibernation_store.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include "hibernation_store.hpp"
+#include "logger.hpp"
+
+HibernationStore::HibernationStore(const std::string& aPath) :
+    mPath(aPath),
+    mWriteFile(std::fopen(aPath.c_str(), "wb")),
+    mReadFile(nullptr),
+    mEnd(0U),
+    mLiveBytes(0U),
+    mNumBatches(0U),
+    mIsSleeping(false),
+    mIsStopping(false)
+{
+    if (mWriteFile == nullptr)
+    {
+        WARN_LOG("Cannot create the hibernation store: ", aPath);
+        return;
+    }
+    mReadFile = std::fopen(aPath.c_str(), "rb");
+    if (mReadFile == nullptr)
+    {
+        WARN_LOG("Cannot read the hibernation store: ", aPath);
+        std::fclose(mWriteFile);
+        mWriteFile = nullptr;
+        std::remove(aPath.c_str());
+        return;
+    }
+    // the file is rewritten once truncated, a read buffer would serve the old records
+    std::setvbuf(mReadFile, nullptr, _IONBF, 0U);
+    mThread = std::thread(&HibernationStore::ioLoop, this);
+}
+
+HibernationStore::~HibernationStore()
+{
+    if (!isOpen())
+    {
+        return;
+    }
+    mIsStopping = true;
+    if (mIsSleeping.exchange(false))
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mWakeCondition.notify_one();
+    }
+    mThread.join();
+    std::fclose(mReadFile);
+    if (mWriteFile != nullptr)
+    {
+        std::fclose(mWriteFile);
+    }
+    std::remove(mPath.c_str());
+}
+
+bool HibernationStore::isOpen() const
+{
+    return mReadFile != nullptr;
+}
+
+void HibernationStore::write(std::shared_ptr<const std::vector<uint8_t> > aRecord, OnWritten_t aOnWritten)
+{
+    mWrites.push(Write_t{std::move(aRecord), std::move(aOnWritten)});
+    // same handshake as the workers of GameHost, the I/O thread cannot miss the record
+    if (mIsSleeping.load() && mIsSleeping.exchange(false))
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mWakeCondition.notify_one();
+    }
+}
+
+int HibernationStore::read(const uint64_t aOffset, const size_t aSize, std::vector<uint8_t>& aRecord)
+{
+    aRecord.resize(aSize);
+    std::lock_guard<std::mutex> lock(mReadMutex);
+    // the I/O thread has flushed the record before handing out its offset
+    if (std::fseek(mReadFile, static_cast<long>(aOffset), SEEK_SET) != 0 || \
+        std::fread(aRecord.data(), 1U, aSize, mReadFile) != aSize)
+    {
+        WARN_LOG("Cannot read ", aSize, " bytes at ", aOffset, " of the hibernation store");
+        std::clearerr(mReadFile);
+        return 1;
+    }
+    return 0;
+}
+
+void HibernationStore::release(const size_t aSize)
+{
+    mLiveBytes.fetch_sub(aSize, std::memory_order_acq_rel);
+}
+
+uint64_t HibernationStore::getLiveBytes() const
+{
+    return mLiveBytes.load(std::memory_order_relaxed);
+}
+
+size_t HibernationStore::getNumBatches() const
+{
+    return mNumBatches.load(std::memory_order_relaxed);
+}
+
+void HibernationStore::ioLoop()
+{
+    std::vector<Write_t> batch;
+    Write_t write;
+    while (true)
+    {
+        while (mWrites.pop(write))
+        {
+            batch.push_back(std::move(write));
+        }
+        if (!batch.empty())
+        {
+            writeBatch(batch);
+            batch.clear();
+            continue;
+        }
+        if (!mWrites.empty())
+        {
+            // a push in progress, see MpscQueue
+            std::this_thread::yield();
+            continue;
+        }
+        if (mIsStopping)
+        {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(mSleepMutex);
+        mIsSleeping = true;
+        if (!mWrites.empty() || mIsStopping)
+        {
+            mIsSleeping = false;
+            continue;
+        }
+        mWakeCondition.wait(lock, [this]() { return !mIsSleeping; });
+    }
+}
+
+void HibernationStore::writeBatch(std::vector<Write_t>& aBatch)
+{
+    // nobody holds a record of the store, start it over instead of growing it
+    if (mEnd != 0U && mLiveBytes.load(std::memory_order_acquire) == 0U)
+    {
+        mWriteFile = std::freopen(mPath.c_str(), "wb", mWriteFile);
+        mEnd = 0U;
+        if (mWriteFile == nullptr)
+        {
+            // every write fails from now on, the records stay with their writers
+            WARN_LOG("Cannot truncate the hibernation store: ", mPath);
+        }
+    }
+
+    std::vector<uint8_t> buffer;
+    std::vector<uint64_t> offsets;
+    for (const Write_t& write : aBatch)
+    {
+        offsets.push_back(mEnd + buffer.size());
+        buffer.insert(buffer.end(), write.record->begin(), write.record->end());
+    }
+    const bool isWritten = (mWriteFile != nullptr) && \
+                           (std::fwrite(buffer.data(), 1U, buffer.size(), mWriteFile) == buffer.size()) && \
+                           (std::fflush(mWriteFile) == 0);
+    if (isWritten)
+    {
+        mEnd += buffer.size();
+        mLiveBytes.fetch_add(buffer.size(), std::memory_order_acq_rel);
+    }
+    else if (mWriteFile != nullptr)
+    {
+        WARN_LOG("Cannot write ", aBatch.size(), " records, ", buffer.size(), " bytes to the hibernation store");
+        // what was partially written is never read, append after it
+        std::clearerr(mWriteFile);
+        std::fseek(mWriteFile, 0L, SEEK_END);
+        const long end = std::ftell(mWriteFile);
+        mEnd = (end > 0L) ? static_cast<uint64_t>(end) : mEnd;
+    }
+    mNumBatches.fetch_add(1U, std::memory_order_relaxed);
+
+    for (size_t ii = 0U; ii < aBatch.size(); ++ii)
+    {
+        // the writer may free its copy of the record from now on
+        aBatch[ii].record.reset();
+        aBatch[ii].onWritten(isWritten ? offsets[ii] : WRITE_FAILED);
+    }
+}
@@ -0,0 +1,343 @@
+/**
+ * Project: catan
+ * @file income_model.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include "income_model.hpp"
+#include "game_map.hpp"
+#include "logger.hpp"
+
+namespace
+{
+
+using ResourceCount_t = IncomeModel::ResourceCount_t;
+
+// indexed by IncomeTarget
+const std::array<ResourceCount_t, INCOME_TARGET_SIZE> TARGET_COST = {{
+    {1, 0, 0, 1, 0},    // ROAD
+    {1, 1, 1, 1, 0},    // SETTLEMENT
+    {0, 0, 2, 0, 3},    // CITY
+    {0, 1, 1, 0, 1},    // DEV_CARD
+}};
+
+constexpr size_t MAX_CHANCE_STATES = 16U;   // (1 + 1) ^ 4, settlement, the most of any target
+constexpr size_t BITS_PER_MISSING = 2U;     // no target costs more than 3 of a resource
+constexpr double CERTAIN = 1.0 - 1e-12;     // stop convolving once the chance is this close to 1
+
+} // namespace
+
+constexpr size_t IncomeModel::NUM_DICE_OUTCOMES;
+
+IncomeModel::IncomeModel() :
+    mNumVertices(0U),
+    mNumLands(0U),
+    mRobLandId(constant::MAX_NUM_LANDS),
+    mDirtyPlayers(0U)
+{
+    clearBoard();
+}
+
+void IncomeModel::clearBoard()
+{
+    for (std::array<uint8_t, 6>& vertices : mLandVertices)
+    {
+        vertices.fill(BoardTopology::NO_ID);
+    }
+    mLandResource.fill(static_cast<int8_t>(ResourceTypes::NONE));
+    mLandDice.fill(0U);
+    mVertexOwner.fill(-1);
+    mColony.fill(ColonyType::NONE);
+    mNumVertices = 0U;
+    mNumLands = 0U;
+    mRobLandId = constant::MAX_NUM_LANDS;
+    // everything is recomputed on the next query
+    mDirtyPlayers = (1U << constant::MAX_NUM_PLAYERS) - 1U;
+}
+
+int IncomeModel::init(const GameMap& aMap)
+{
+    clearBoard();
+    const std::vector<Vertex*>& vertices = aMap.getVertices();
+    const std::vector<Land*>& lands = aMap.getLands();
+    if (vertices.size() > constant::MAX_NUM_VERTICES || lands.size() > constant::MAX_NUM_LANDS)
+    {
+        WARN_LOG("Map too large for the income model, vertices: ", vertices.size(), ", lands: ", lands.size());
+        return 1;
+    }
+
+    const BoardState_t& board = aMap.getBoardState();
+    int rc = 0;
+    mNumVertices = vertices.size();
+    mNumLands = lands.size();
+    for (const Land* const pLand : lands)
+    {
+        const int landId = pLand->getId();
+        mLandResource[landId] = static_cast<int8_t>(pLand->getResourceType(board));
+        mLandDice[landId] = static_cast<uint8_t>(pLand->getDiceNum(board));
+        if (pLand->isUnderRobber(board))
+        {
+            mRobLandId = landId;
+        }
+        for (const Vertex* const pVertex : pLand->getAdjacentVertices())
+        {
+            rc |= BoardTopology::appendId(mLandVertices[landId], pVertex->getId());
+        }
+    }
+    for (const Vertex* const pVertex : vertices)
+    {
+        mVertexOwner[pVertex->getId()] = static_cast<int8_t>(pVertex->getOwner(board));
+        mColony[pVertex->getId()] = static_cast<uint8_t>(pVertex->getColonyType(board));
+    }
+    if (rc != 0)
+    {
+        WARN_LOG("Incorrect adjacency between lands and vertices");
+    }
+    return rc;
+}
+
+int IncomeModel::init(const BoardTopology& aTopology)
+{
+    clearBoard();
+    if (aTopology.getNumLands() == 0U)
+    {
+        WARN_LOG("BoardTopology is not initialized");
+        return 1;
+    }
+
+    mNumVertices = aTopology.getNumVertices();
+    mNumLands = aTopology.getNumLands();
+    for (size_t landId = 0U; landId < mNumLands; ++landId)
+    {
+        const BoardTopology::LandInfo_t& land = aTopology.getLand(landId);
+        mLandVertices[landId] = land.vertices;
+        mLandResource[landId] = land.resource;
+        mLandDice[landId] = land.dice;
+    }
+    return 0;
+}
+
+void IncomeModel::invalidatePlayer(const int aPlayerId)
+{
+    if (aPlayerId >= 0 && aPlayerId < static_cast<int>(constant::MAX_NUM_PLAYERS))
+    {
+        mDirtyPlayers |= (1U << aPlayerId);
+    }
+}
+
+void IncomeModel::invalidateLand(const size_t aLandId)
+{
+    if (aLandId >= mNumLands)
+    {
+        return;
+    }
+    for (const uint8_t vertexId : mLandVertices[aLandId])
+    {
+        if (vertexId != BoardTopology::NO_ID)
+        {
+            invalidatePlayer(mVertexOwner[vertexId]);
+        }
+    }
+}
+
+void IncomeModel::setLand(const size_t aLandId, const ResourceTypes aResource, const int aDice)
+{
+    if (aLandId >= mNumLands || \
+        (mLandResource[aLandId] == static_cast<int8_t>(aResource) && mLandDice[aLandId] == aDice))
+    {
+        return;
+    }
+    mLandResource[aLandId] = static_cast<int8_t>(aResource);
+    mLandDice[aLandId] = static_cast<uint8_t>(aDice);
+    invalidateLand(aLandId);
+}
+
+void IncomeModel::setColony(const size_t aVertexId, const int aOwner, const ColonyType aColony)
+{
+    if (aVertexId >= mNumVertices || (mVertexOwner[aVertexId] == aOwner && mColony[aVertexId] == aColony))
+    {
+        return;
+    }
+    invalidatePlayer(mVertexOwner[aVertexId]);
+    mVertexOwner[aVertexId] = static_cast<int8_t>(aOwner);
+    mColony[aVertexId] = static_cast<uint8_t>(aColony);
+    invalidatePlayer(aOwner);
+}
+
+void IncomeModel::setRobber(const size_t aLandId)
+{
+    const size_t landId = (aLandId < mNumLands) ? aLandId : constant::MAX_NUM_LANDS; // no robber, e.g., a reverted move
+    if (landId == mRobLandId)
+    {
+        return;
+    }
+    invalidateLand(mRobLandId);
+    mRobLandId = landId;
+    invalidateLand(mRobLandId);
+}
+
+void IncomeModel::sync(const GameState_t& aState)
+{
+    for (size_t landId = 0U; landId < mNumLands; ++landId)
+    {
+        setLand(landId, static_cast<ResourceTypes>(aState.landResource[landId]), aState.landDice[landId]);
+    }
+    setRobber(aState.robLandId);
+    for (size_t vertexId = 0U; vertexId < mNumVertices; ++vertexId)
+    {
+        setColony(vertexId, aState.vertexOwner[vertexId], static_cast<ColonyType>(aState.colony[vertexId]));
+    }
+}
+
+void IncomeModel::updateIncome(const size_t aPlayerId) const
+{
+    Income_t& income = mIncome[aPlayerId];
+    for (std::array<uint8_t, CONSUMABLE_RESOURCE_SIZE>& produced : income.perDice)
+    {
+        produced.fill(0U);
+    }
+    income.expected.fill(0.0);
+    for (size_t landId = 0U; landId < mNumLands; ++landId)
+    {
+        const int dice = mLandDice[landId];
+        const int resource = mLandResource[landId];
+        if (landId == mRobLandId || getDiceChance(dice) == 0.0 || \
+            resource < 0 || resource >= static_cast<int>(CONSUMABLE_RESOURCE_SIZE))
+        {
+            continue;
+        }
+        for (const uint8_t vertexId : mLandVertices[landId])
+        {
+            if (vertexId != BoardTopology::NO_ID && mVertexOwner[vertexId] == static_cast<int>(aPlayerId))
+            {
+                // a settlement produces 1, a city 2
+                income.perDice[dice - 2][resource] = static_cast<uint8_t>(income.perDice[dice - 2][resource] + mColony[vertexId]);
+                income.expected[resource] += mColony[vertexId] * getDiceChance(dice);
+            }
+        }
+    }
+    mChances[aPlayerId].clear();
+    mDirtyPlayers &= ~(1U << aPlayerId);
+}
+
+const IncomeModel::Income_t& IncomeModel::getIncome(const size_t aPlayerId) const
+{
+    if (mDirtyPlayers & (1U << aPlayerId))
+    {
+        updateIncome(aPlayerId);
+    }
+    return mIncome.at(aPlayerId);
+}
+
+double IncomeModel::getAffordChance(const size_t aPlayerId, const ResourceCount_t& aHand, const IncomeTarget aTarget,
+                                    const size_t aNumRolls) const
+{
+    const Income_t& income = getIncome(aPlayerId);
+    const ResourceCount_t& cost = getCost(aTarget);
+
+    // the state of the convolution is what is still missing of each resource, mixed radix, missing + 1 per digit
+    std::array<size_t, CONSUMABLE_RESOURCE_SIZE> missing;
+    std::array<size_t, CONSUMABLE_RESOURCE_SIZE> stride;
+    size_t numStates = 1U;
+    uint64_t key = 0U;
+    for (size_t resource = 0U; resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+    {
+        missing[resource] = (aHand[resource] < cost[resource]) ? cost[resource] - aHand[resource] : 0U;
+        if (missing[resource] > 0U && income.expected[resource] == 0.0)
+        {
+            return 0.0;     // never produced
+        }
+        stride[resource] = numStates;
+        numStates *= missing[resource] + 1U;
+        key |= static_cast<uint64_t>(missing[resource]) << (resource * BITS_PER_MISSING);
+    }
+    if (numStates == 1U)
+    {
+        return 1.0;
+    }
+    if (aNumRolls == 0U)
+    {
+        return 0.0;
+    }
+
+    // the cost, i.e., the target, is implied by what is missing
+    key |= static_cast<uint64_t>(aNumRolls) << (CONSUMABLE_RESOURCE_SIZE * BITS_PER_MISSING);
+    std::unordered_map<uint64_t, double>& chances = mChances[aPlayerId];
+    const auto found = chances.find(key);
+    if (found != chances.end())
+    {
+        return found->second;
+    }
+
+    // state 0 is nothing collected yet, numStates - 1 is everything collected
+    std::array<std::array<uint8_t, MAX_CHANCE_STATES>, NUM_DICE_OUTCOMES> next;
+    std::array<double, NUM_DICE_OUTCOMES> diceChance;
+    for (size_t outcome = 0U; outcome < NUM_DICE_OUTCOMES; ++outcome)
+    {
+        diceChance[outcome] = getDiceChance(static_cast<int>(outcome) + 2);
+        for (size_t state = 0U; state < numStates; ++state)
+        {
+            size_t nextState = 0U;
+            for (size_t resource = 0U; resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+            {
+                const size_t collected = (state / stride[resource]) % (missing[resource] + 1U);
+                nextState += stride[resource] * std::min<size_t>(collected + income.perDice[outcome][resource], missing[resource]);
+            }
+            next[outcome][state] = static_cast<uint8_t>(nextState);
+        }
+    }
+
+    std::array<double, MAX_CHANCE_STATES> distribution = {};
+    std::array<double, MAX_CHANCE_STATES> convolved;
+    distribution[0] = 1.0;
+    for (size_t roll = 0U; roll < aNumRolls && distribution[numStates - 1U] < CERTAIN; ++roll)
+    {
+        convolved.fill(0.0);
+        for (size_t state = 0U; state < numStates; ++state)
+        {
+            if (distribution[state] == 0.0)
+            {
+                continue;
+            }
+            for (size_t outcome = 0U; outcome < NUM_DICE_OUTCOMES; ++outcome)
+            {
+                convolved[next[outcome][state]] += diceChance[outcome] * distribution[state];
+            }
+        }
+        distribution = convolved;
+    }
+    chances.emplace(key, distribution[numStates - 1U]);
+    return distribution[numStates - 1U];
+}
+
+double IncomeModel::getDiceChance(const int aDice)
+{
+    return (aDice < 0) ? 0.0 : constant::diceChance(static_cast<size_t>(aDice));
+}
+
+const IncomeModel::ResourceCount_t& IncomeModel::getCost(const IncomeTarget aTarget)
+{
+    return TARGET_COST.at(static_cast<size_t>(aTarget));
+}
+
+std::string incomeTargetToStr(const IncomeTarget aTarget)
+{
+#define CASE_PRINT(target) \
+    case IncomeTarget::target: \
+        return #target
+
+    switch (aTarget)
+    {
+        CASE_PRINT(ROAD);
+        CASE_PRINT(SETTLEMENT);
+        CASE_PRINT(CITY);
+        CASE_PRINT(DEV_CARD);
+    }
+    return "";
+
+#undef CASE_PRINT
+}
@@ -8,7 +8,7 @@
  */
 
 #include "logger.hpp"
-#include "game_map.hpp"
+#include "board_layout.hpp"
 #include "land.hpp"
 #include "blank.hpp"
 #include "utility.hpp"
@@ -34,37 +34,37 @@ std::vector<Point_t> Land::getAllPoints() const
     return allPoints;
 }
 
-int Land::populateAdjacencies(GameMap& aMap)
+int Land::populateAdjacencies(BoardLayout& aLayout)
 {
     // check vertices and edges clockwise from top-left corner
     // add vertex or edge if needed
     int rc = 0;
     constexpr int horizontalLength = Edge::HORIZONTAL_LENGTH + 3;
     // top-left vertex
-    rc |= addAdjacency(aMap, true, mTopLeft.x, mTopLeft.y - 1);
+    rc |= addAdjacency(aLayout, true, mTopLeft.x, mTopLeft.y - 1);
     // top left vertex
-    rc |= addAdjacency(aMap, true, mTopLeft.x + horizontalLength - 1, mTopLeft.y - 1);
+    rc |= addAdjacency(aLayout, true, mTopLeft.x + horizontalLength - 1, mTopLeft.y - 1);
     // left vertex
-    rc |= addAdjacency(aMap, true, mTopLeft.x + horizontalLength + 2, mTopLeft.y + 2);
+    rc |= addAdjacency(aLayout, true, mTopLeft.x + horizontalLength + 2, mTopLeft.y + 2);
     // bottom left vertex
-    rc |= addAdjacency(aMap, true, mTopLeft.x + horizontalLength - 1, mTopLeft.y + 5);
+    rc |= addAdjacency(aLayout, true, mTopLeft.x + horizontalLength - 1, mTopLeft.y + 5);
     // bottom right vertex
-    rc |= addAdjacency(aMap, true, mTopLeft.x, mTopLeft.y + 5);
+    rc |= addAdjacency(aLayout, true, mTopLeft.x, mTopLeft.y + 5);
     // right vertex
-    rc |= addAdjacency(aMap, true, mTopLeft.x - 3, mTopLeft.y + 2);
+    rc |= addAdjacency(aLayout, true, mTopLeft.x - 3, mTopLeft.y + 2);
 
     // top edge
-    rc |= addAdjacency(aMap, false, mTopLeft.x + 1, mTopLeft.y - 1, '-');
+    rc |= addAdjacency(aLayout, false, mTopLeft.x + 1, mTopLeft.y - 1, '-');
     // left top edge
-    rc |= addAdjacency(aMap, false, mTopLeft.x + horizontalLength, mTopLeft.y, '\\');
+    rc |= addAdjacency(aLayout, false, mTopLeft.x + horizontalLength, mTopLeft.y, '\\');
     // left bottom edge
-    rc |= addAdjacency(aMap, false, mTopLeft.x + horizontalLength + 1, mTopLeft.y + 3, '/');
+    rc |= addAdjacency(aLayout, false, mTopLeft.x + horizontalLength + 1, mTopLeft.y + 3, '/');
     // bottom edge
-    rc |= addAdjacency(aMap, false, mTopLeft.x + 1, mTopLeft.y + 5, '-');
+    rc |= addAdjacency(aLayout, false, mTopLeft.x + 1, mTopLeft.y + 5, '-');
     // right bottom edge
-    rc |= addAdjacency(aMap, false, mTopLeft.x - 2, mTopLeft.y + 3, '\\');
+    rc |= addAdjacency(aLayout, false, mTopLeft.x - 2, mTopLeft.y + 3, '\\');
     // right top edge
-    rc |= addAdjacency(aMap, false, mTopLeft.x - 1, mTopLeft.y, '/');
+    rc |= addAdjacency(aLayout, false, mTopLeft.x - 1, mTopLeft.y, '/');
 
     (rc != 0) ?
         WARN_LOG("Failed to populate adjacencies of ", getStringId(), " at ", mTopLeft)
@@ -73,36 +73,36 @@ int Land::populateAdjacencies(GameMap& aMap)
     return rc;
 }
 
-int Land::addAdjacency(GameMap& aMap, bool aIsVertex, const int aPointX, const int aPointY, const char aPattern)
+int Land::addAdjacency(BoardLayout& aLayout, bool aIsVertex, const int aPointX, const int aPointY, const char aPattern)
 {
-    const Terrain* pTerrain = aMap.getTerrain(aPointX, aPointY);
+    const Terrain* pTerrain = aLayout.getTerrain(aPointX, aPointY);
     bool isCorrectTerrain;
     std::string expectedTerrain;
 
     // sanity check
     if (aIsVertex)
     {
-        isCorrectTerrain = GameMap::isTerrain<Vertex>(pTerrain);
+        isCorrectTerrain = BoardLayout::isTerrain<Vertex>(pTerrain);
         expectedTerrain = "Vertex";
     }
     else
     {
-        isCorrectTerrain = GameMap::isTerrain<Edge>(pTerrain);
+        isCorrectTerrain = BoardLayout::isTerrain<Edge>(pTerrain);
         expectedTerrain = "Edge";
     }
     if (!isCorrectTerrain)
     {
         // incorrect terrain
-        if (GameMap::isTerrain<Blank>(pTerrain))
+        if (BoardLayout::isTerrain<Blank>(pTerrain))
         {
             // is blank, add correct terrain
             if (aIsVertex)
             {
-                pTerrain = aMap.addVertex(aPointX, aPointY);
+                pTerrain = aLayout.addVertex(aPointX, aPointY);
             }
             else
             {
-                pTerrain = aMap.addEdge(aPointX, aPointY, aPattern);
+                pTerrain = aLayout.addEdge(aPointX, aPointY, aPattern);
             }
             DEBUG_LOG_L3("Added new ", pTerrain->getStringId(), " for ", getStringId());
         }
@@ -122,38 +122,31 @@ int Land::addAdjacency(GameMap& aMap, bool aIsVertex, const int aPointX, const i
     return 0;
 }
 
-void Land::setResourceType(ResourceTypes aResourceType)
+ResourceTypes Land::getPresetResourceType() const
 {
-    mResourceType = aResourceType;
+    return mPresetResourceType;
 }
 
-ResourceTypes Land::getResourceType()
+ResourceTypes Land::getResourceType(const BoardState_t& aState) const
 {
-    return mResourceType;
+    return static_cast<ResourceTypes>(aState.landResource[mId]);
 }
 
-Land::Land(const int aId, const Point_t aTopLeft, const ResourceTypes aResourceType) :
+Land::Land(const int aId, const Point_t aTopLeft, const ResourceTypes aPresetResourceType) :
     Terrain(aId, aTopLeft),
-    mResourceType(aResourceType),
-    mDiceNum(0),
-    mIsUnderRobber(false)
+    mPresetResourceType(aPresetResourceType)
 {
     // empty
 }
 
-void Land::setDiceNum(int aDice)
+int Land::getDiceNum(const BoardState_t& aState) const
 {
-    mDiceNum = aDice;
+    return aState.landDice[mId];
 }
 
-void Land::rob(bool aIsRob)
+bool Land::isUnderRobber(const BoardState_t& aState) const
 {
-    mIsUnderRobber = aIsRob;
-}
-
-bool Land::isUnderRobber() const
-{
-    return mIsUnderRobber;
+    return (aState.robLandId == mId);
 }
 
 const std::vector<const Vertex*>& Land::getAdjacentVertices() const
@@ -161,13 +154,15 @@ const std::vector<const Vertex*>& Land::getAdjacentVertices() const
     return mAdjacentVertices;
 }
 
-char Land::getCharRepresentation(const size_t aPointX, const size_t aPointY, const bool aUseId) const
+char Land::getCharRepresentation(const size_t aPointX, const size_t aPointY, const BoardState_t& aState, const bool aUseId) const
 {
     if (aUseId)
     {
         return static_cast<char>(mId % 10) + '0';
     }
-    if (mResourceType == ResourceTypes::NONE)
+    const ResourceTypes resourceType = getResourceType(aState);
+    const bool isUnderRobber = this->isUnderRobber(aState);
+    if (resourceType == ResourceTypes::NONE)
     {
         return '.';
     }
@@ -188,21 +183,21 @@ char Land::getCharRepresentation(const size_t aPointX, const size_t aPointY, con
     {
         // print label
         const size_t WIDTH = 16;
-        const std::string label = resourceTypesToStr(mResourceType);
+        const std::string label = resourceTypesToStr(resourceType);
         return printAtMiddle(WIDTH, 2, label);
     }
     else if (aPointY == mTopLeft.y + 3)
     {
         const size_t WIDTH = 14;
         const size_t offset = 1;
-        if (mResourceType != ResourceTypes::DESERT)
+        if (resourceType != ResourceTypes::DESERT)
         {
             // print dice num
-            const std::string robber = (mIsUnderRobber ? "#" : "");
-            const std::string label = robber + std::to_string(mDiceNum) + robber;
+            const std::string robber = (isUnderRobber ? "#" : "");
+            const std::string label = robber + std::to_string(getDiceNum(aState)) + robber;
             return printAtMiddle(WIDTH, offset, label);
         }
-        else if (mIsUnderRobber)
+        else if (isUnderRobber)
         {
             // desert under rob
             return printAtMiddle(WIDTH, offset, "##");
@@ -216,11 +211,6 @@ std::string Land::getStringId() const
     return Logger::formatString("Land#", mId);
 }
 
-int Land::getDiceNum()
-{
-    return mDiceNum;
-}
-
 Land::~Land()
 {
 }
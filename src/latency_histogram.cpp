@@ -0,0 +1,134 @@
+/**
+ * Project: catan
+ * @file latency_histogram.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include "latency_histogram.hpp"
+
+namespace
+{
+
+inline size_t highestBit(const uint64_t aValue)
+{
+    return 63U - __builtin_clzll(aValue);
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram(const uint64_t aHighestTrackable, const size_t aSignificantDigits) :
+    mSubBucketBits(0U),
+    mSubBucketHalf(0U),
+    mHighestTrackable(std::max<uint64_t>(aHighestTrackable, 2U)),
+    mTotalCount(0U),
+    mMin(UINT64_MAX),
+    mMax(0U),
+    mSum(0.0)
+{
+    // the smallest power of 2 telling apart 2 * 10^digits values, e.g., 2048 for 3 digits
+    uint64_t resolution = 2U;
+    for (size_t digit = 0U; digit < std::min<size_t>(std::max<size_t>(aSignificantDigits, 1U), 5U); ++digit)
+    {
+        resolution *= 10U;
+    }
+    mSubBucketBits = highestBit(resolution - 1U) + 1U;
+    mSubBucketHalf = 1ULL << (mSubBucketBits - 1U);
+    mCounts.resize(indexOf(mHighestTrackable) + 1U, 0U);
+}
+
+size_t LatencyHistogram::indexOf(const uint64_t aValue) const
+{
+    if (aValue < 2U * mSubBucketHalf)
+    {
+        return static_cast<size_t>(aValue);
+    }
+    // bucket N holds [2^(N + bits - 1), 2^(N + bits)) in steps of 2^N
+    const size_t bucket = highestBit(aValue) + 1U - mSubBucketBits;
+    return static_cast<size_t>((bucket + 1U) * mSubBucketHalf + ((aValue >> bucket) - mSubBucketHalf));
+}
+
+uint64_t LatencyHistogram::highestEquivalent(const size_t aIndex) const
+{
+    if (aIndex < 2U * mSubBucketHalf)
+    {
+        return aIndex;
+    }
+    const size_t bucket = aIndex / mSubBucketHalf - 1U;
+    const uint64_t subBucket = aIndex % mSubBucketHalf + mSubBucketHalf;
+    return ((subBucket + 1U) << bucket) - 1U;
+}
+
+void LatencyHistogram::record(const uint64_t aValue)
+{
+    ++mCounts[std::min(indexOf(std::min(aValue, mHighestTrackable)), mCounts.size() - 1U)];
+    ++mTotalCount;
+    mMin = std::min(mMin, aValue);
+    mMax = std::max(mMax, aValue);
+    mSum += static_cast<double>(aValue);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& aOther)
+{
+    for (size_t index = 0U; index < std::min(mCounts.size(), aOther.mCounts.size()); ++index)
+    {
+        mCounts[index] += aOther.mCounts[index];
+    }
+    mTotalCount += aOther.mTotalCount;
+    mMin = std::min(mMin, aOther.mMin);
+    mMax = std::max(mMax, aOther.mMax);
+    mSum += aOther.mSum;
+}
+
+void LatencyHistogram::reset()
+{
+    std::fill(mCounts.begin(), mCounts.end(), 0U);
+    mTotalCount = 0U;
+    mMin = UINT64_MAX;
+    mMax = 0U;
+    mSum = 0.0;
+}
+
+uint64_t LatencyHistogram::getTotalCount() const
+{
+    return mTotalCount;
+}
+
+uint64_t LatencyHistogram::getMin() const
+{
+    return (mTotalCount == 0U) ? 0U : mMin;
+}
+
+uint64_t LatencyHistogram::getMax() const
+{
+    return mMax;
+}
+
+double LatencyHistogram::getMean() const
+{
+    return (mTotalCount == 0U) ? 0.0 : mSum / mTotalCount;
+}
+
+uint64_t LatencyHistogram::getValueAtPercentile(const double aPercentile) const
+{
+    if (mTotalCount == 0U)
+    {
+        return 0U;
+    }
+    // the rank of the value, at least the first one
+    const double percentile = std::min(std::max(aPercentile, 0.0), 100.0);
+    const uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(percentile / 100.0 * mTotalCount + 0.5), 1U);
+    uint64_t count = 0U;
+    for (size_t index = 0U; index < mCounts.size(); ++index)
+    {
+        count += mCounts[index];
+        if (count >= rank)
+        {
+            return std::min(highestEquivalent(index), mMax);
+        }
+    }
+    return mMax;
+}
@@ -0,0 +1,785 @@
+/**
+ * Project: catan
+ * @file lockstep_engine.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include <climits>
+#include <numeric>
+#include "lockstep_engine.hpp"
+
+namespace
+{
+
+constexpr uint16_t LANE_ON = 0xFFFFU;   // a lane of a mask, vector comparisons give all ones or all zeros
+constexpr size_t MAX_TRADES_PER_TURN = 4U;
+
+inline uint64_t splitMix64(uint64_t& aState)
+{
+    uint64_t value = (aState += 0x9E3779B97F4A7C15ULL);
+    value = (value ^ (value >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27U)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31U);
+}
+
+template<typename Vector>
+inline bool isAnyLane(const Vector& aMask, const size_t aNumLanes)
+{
+    for (size_t lane = 0U; lane < aNumLanes; ++lane)
+    {
+        if (aMask[lane] != 0U)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+template<size_t LANES>
+constexpr size_t LockstepEngine<LANES>::NUM_LANES;
+
+template<size_t LANES>
+LockstepEngine<LANES>::LockstepEngine(std::shared_ptr<const BoardTopology> aTopology) :
+    mVertices(),
+    mEdges(),
+    mNumVertices(aTopology->getNumVertices()),
+    mNumEdges(aTopology->getNumEdges()),
+    mNumLands(aTopology->getNumLands()),
+    mInitialState(),
+    mInitialProduction(),
+    mVertexPips(),
+    mVertexOrder(),
+    mNumPlayers(0U),
+    mCurrentPlayer(0U),
+    mTurn(0U),
+    mTurnLimit(0U),
+    mSeed(0U),
+    mResources(),
+    mProduction(),
+    mSettlements(),
+    mCities(),
+    mRoads(),
+    mRobLandId(),
+    mWinner(Vector_t() + NO_PLAYER),
+    mNumTurns(),
+    mParked(Vector_t() + LANE_ON),     // no game until reset()
+    mDice(),
+    mRandomState(),
+    mBoards(),
+    mNumGames(0U),
+    mNumDraws(0U),
+    mNumWins()
+{
+    for (size_t vertexId = 0U; vertexId < mNumVertices; ++vertexId)
+    {
+        mVertices[vertexId] = aTopology->getVertex(vertexId);
+    }
+    for (size_t edgeId = 0U; edgeId < mNumEdges; ++edgeId)
+    {
+        mEdges[edgeId] = aTopology->getEdge(edgeId);
+    }
+}
+
+template<size_t LANES>
+int LockstepEngine<LANES>::reset(const GameState_t& aState, const uint64_t aSeed)
+{
+    if (aState.phase != GamePhase::ROLL || aState.turn >= constant::MAX_TURNS)
+    {
+        return 1;
+    }
+    if (aState.numPlayers == 0U || aState.numPlayers > constant::MAX_NUM_PLAYERS || aState.currentPlayer >= aState.numPlayers)
+    {
+        return 1;
+    }
+
+    mInitialState = aState;
+    mNumPlayers = aState.numPlayers;
+    mCurrentPlayer = aState.currentPlayer;
+    mTurn = 0U;
+    mTurnLimit = static_cast<uint16_t>(constant::MAX_TURNS - aState.turn);
+    mSeed = aSeed;
+    mVertexPips.fill(0U);
+    for (size_t vertexId = 0U; vertexId < mNumVertices; ++vertexId)
+    {
+        for (const uint8_t landId : mVertices[vertexId].lands)
+        {
+            if (landId != BoardTopology::NO_ID)
+            {
+                mVertexPips[vertexId] = static_cast<uint8_t>(mVertexPips[vertexId] + constant::dicePips(aState.landDice[landId]));
+            }
+        }
+    }
+    // the placement takes the first vertex that fits in this order, the lowest ID first on ties
+    std::iota(mVertexOrder.begin(), mVertexOrder.begin() + mNumVertices, 0U);
+    std::stable_sort(mVertexOrder.begin(), mVertexOrder.begin() + mNumVertices, [this](const uint8_t aLhs, const uint8_t aRhs) {
+            return mVertexPips[aLhs] > mVertexPips[aRhs];
+        });
+    for (std::array<uint16_t, constant::MAX_NUM_LANDS>& production : mInitialProduction)
+    {
+        production.fill(0U);
+    }
+    for (size_t vertexId = 0U; vertexId < mNumVertices; ++vertexId)
+    {
+        const int owner = aState.vertexOwner[vertexId];
+        if (owner < 0 || static_cast<size_t>(owner) >= mNumPlayers)
+        {
+            continue;
+        }
+        const uint16_t weight = (aState.colony[vertexId] == static_cast<uint8_t>(ColonyType::CITY)) ? 2U : 1U;
+        for (const uint8_t landId : mVertices[vertexId].lands)
+        {
+            if (landId != BoardTopology::NO_ID)
+            {
+                mInitialProduction[owner][landId] = static_cast<uint16_t>(mInitialProduction[owner][landId] + weight);
+            }
+        }
+    }
+
+    // the seats beyond aState.numPlayers stay empty in every lane
+    for (size_t playerId = 0U; playerId < constant::MAX_NUM_PLAYERS; ++playerId)
+    {
+        mResources[playerId].fill(Vector_t());
+        mProduction[playerId].fill(Vector_t());
+        mSettlements[playerId] = Vector_t();
+        mCities[playerId] = Vector_t();
+        mRoads[playerId] = Vector_t();
+    }
+    mDice = Vector_t();
+    for (size_t lane = 0U; lane < LANES; ++lane)
+    {
+        startGame(lane, lane);
+    }
+    mNumGames = 0U;
+    mNumDraws = 0U;
+    mNumWins.fill(0U);
+    return 0;
+}
+
+template<size_t LANES>
+void LockstepEngine<LANES>::startGame(const size_t aLane, const size_t aGameIndex)
+{
+    // lane by lane, only at the start of a game
+    mBoards[aLane] = LaneBoard_t{mInitialState.vertexOwner, mInitialState.colony, mInitialState.edgeOwner};
+    for (size_t playerId = 0U; playerId < mNumPlayers; ++playerId)
+    {
+        const PlayerState_t& player = mInitialState.players[playerId];
+        for (size_t resource = 0U; resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+        {
+            mResources[playerId][resource][aLane] = player.resources[resource];
+        }
+        for (size_t landId = 0U; landId < mNumLands; ++landId)
+        {
+            mProduction[playerId][landId][aLane] = mInitialProduction[playerId][landId];
+        }
+        mSettlements[playerId][aLane] = player.numSettlements;
+        mCities[playerId][aLane] = player.numCities;
+        mRoads[playerId][aLane] = player.numRoads;
+    }
+    mRobLandId[aLane] = mInitialState.robLandId;
+    mWinner[aLane] = NO_PLAYER;
+    mNumTurns[aLane] = 0U;
+    mParked[aLane] = 0U;
+    // xorshift32 must not start from 0
+    uint64_t seed = mSeed + aGameIndex;
+    mRandomState[aLane] = static_cast<uint32_t>(splitMix64(seed)) | 1U;
+}
+
+template<size_t LANES>
+void LockstepEngine<LANES>::getActiveLanes(Vector_t& aActive) const
+{
+    // casts of a comparison turn its signed mask into Vector_t
+    aActive = ~mParked & (Vector_t)(mWinner == NO_PLAYER) & (Vector_t)(mNumTurns < mTurnLimit);
+}
+
+template<size_t LANES>
+void LockstepEngine<LANES>::rollDice()
+{
+    // xorshift32 then a multiplicative scramble, each half of the 32 bits gives a die by multiply-shift,
+    // the bias of the multiply-shift (6 / 65536) is far below what a game can notice
+    mRandomState ^= mRandomState << 13U;
+    mRandomState ^= mRandomState >> 17U;
+    mRandomState ^= mRandomState << 5U;
+    const WideVector_t scrambled = mRandomState * 0x9E3779BBU;
+    const WideVector_t dice = (((scrambled & 0xFFFFU) * 6U) >> 16U) + (((scrambled >> 16U) * 6U) >> 16U) + 2U;
+    mDice = __builtin_convertvector(dice, Vector_t);
+}
+
+template<size_t LANES>
+void LockstepEngine<LANES>::produceResources(const Vector_t& aActive)
+{
+    for (size_t landId = 0U; landId < mNumLands; ++landId)
+    {
+        if (mInitialState.landDice[landId] == 0U)
+        {
+            continue;
+        }
+        const Vector_t hit = aActive & (Vector_t)(mDice == static_cast<uint16_t>(mInitialState.landDice[landId])) & \
+            (Vector_t)(mRobLandId != static_cast<uint16_t>(landId));
+        const size_t resource = static_cast<size_t>(mInitialState.landResource[landId]);
+        for (size_t playerId = 0U; playerId < mNumPlayers; ++playerId)
+        {
+            mResources[playerId][resource] += hit & mProduction[playerId][landId];
+        }
+    }
+}
+
+template<size_t LANES>
+void LockstepEngine<LANES>::discardHalf(const Vector_t& aSevens)
+{
+    for (size_t playerId = 0U; playerId < mNumPlayers; ++playerId)
+    {
+        std::array<Vector_t, CONSUMABLE_RESOURCE_SIZE>& resources = mResources[playerId];
+        Vector_t total = Vector_t();
+        for (const Vector_t& amount : resources)
+        {
+            total += amount;
+        }
+        Vector_t toDiscard = aSevens & (Vector_t)(total > static_cast<uint16_t>(constant::MAX_HAND_ON_SEVEN)) & (total >> 1U);
+
+        // one card per pass from the most plentiful resource, the lowest resource first on ties
+        while (isAnyLane(toDiscard, LANES))
+        {
+            const Vector_t discarding = (Vector_t)(toDiscard != 0U);
+            Vector_t most = resources[0];
+            Vector_t mostResource = Vector_t();
+            for (size_t resource = 1U; resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+            {
+                const Vector_t isMore = (Vector_t)(resources[resource] > most);
+                most = (isMore & resources[resource]) | (~isMore & most);
+                mostResource = (isMore & static_cast<uint16_t>(resource)) | (~isMore & mostResource);
+            }
+            for (size_t resource = 0U; resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+            {
+                resources[resource] -= discarding & (Vector_t)(mostResource == static_cast<uint16_t>(resource)) & 1U;
+            }
+            toDiscard -= discarding & 1U;
+        }
+    }
+}
+
+template<size_t LANES>
+void LockstepEngine<LANES>::moveRobber(const size_t aLane)
+{
+    // the land hurting the opponents most and the current player least
+    const size_t robLandId = mRobLandId[aLane];
+    size_t bestLandId = robLandId;
+    int bestScore = INT_MIN;
+    for (size_t landId = 0U; landId < mNumLands; ++landId)
+    {
+        if (landId == robLandId)
+        {
+            continue;
+        }
+        int score = 0;
+        for (size_t playerId = 0U; playerId < mNumPlayers; ++playerId)
+        {
+            const int weight = mProduction[playerId][landId][aLane];
+            score += (playerId == mCurrentPlayer) ? -2 * weight : weight;
+        }
+        score *= constant::dicePips(mInitialState.landDice[landId]);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestLandId = landId;
+        }
+    }
+    mRobLandId[aLane] = static_cast<uint16_t>(bestLandId);
+
+    // the richest opponent on the land loses its most plentiful resource
+    size_t victim = NO_PLAYER;
+    size_t victimCards = 0U;
+    for (size_t playerId = 0U; playerId < mNumPlayers; ++playerId)
+    {
+        if (playerId == mCurrentPlayer || mProduction[playerId][bestLandId][aLane] == 0U)
+        {
+            continue;
+        }
+        size_t cards = 0U;
+        for (const Vector_t& amount : mResources[playerId])
+        {
+            cards += amount[aLane];
+        }
+        if (cards > victimCards)
+        {
+            victim = playerId;
+            victimCards = cards;
+        }
+    }
+    if (victim == NO_PLAYER)
+    {
+        return;
+    }
+    size_t robResource = 0U;
+    for (size_t resource = 1U; resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+    {
+        if (mResources[victim][resource][aLane] > mResources[victim][robResource][aLane])
+        {
+            robResource = resource;
+        }
+    }
+    mResources[victim][robResource][aLane] -= 1U;
+    mResources[mCurrentPlayer][robResource][aLane] += 1U;
+}
+
+template<size_t LANES>
+void LockstepEngine<LANES>::tradeWithBank(const Vector_t& aActive)
+{
+    // the most plentiful resource for the scarcest one, one trade per pass, as long as the current player
+    // holds more than BANK_TRADE_RATIO of a resource, the lowest resource first on ties
+    std::array<Vector_t, CONSUMABLE_RESOURCE_SIZE>& resources = mResources[mCurrentPlayer];
+    for (size_t pass = 0U; pass < MAX_TRADES_PER_TURN; ++pass)
+    {
+        Vector_t most = resources[0];
+        Vector_t mostResource = Vector_t();
+        Vector_t fewest = resources[0];
+        Vector_t fewestResource = Vector_t();
+        for (size_t resource = 1U; resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+        {
+            const uint16_t resourceIndex = static_cast<uint16_t>(resource);
+            const Vector_t isMore = (Vector_t)(resources[resource] > most);
+            most = (isMore & resources[resource]) | (~isMore & most);
+            mostResource = (isMore & resourceIndex) | (~isMore & mostResource);
+            const Vector_t isFewer = (Vector_t)(resources[resource] < fewest);
+            fewest = (isFewer & resources[resource]) | (~isFewer & fewest);
+            fewestResource = (isFewer & resourceIndex) | (~isFewer & fewestResource);
+        }
+
+        const Vector_t trading = aActive & (Vector_t)(most > static_cast<uint16_t>(constant::BANK_TRADE_RATIO)) & \
+            (Vector_t)(mostResource != fewestResource);
+        if (!isAnyLane(trading, LANES))
+        {
+            return;
+        }
+        for (size_t resource = 0U; resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+        {
+            const uint16_t resourceIndex = static_cast<uint16_t>(resource);
+            resources[resource] -= trading & (Vector_t)(mostResource == resourceIndex) & static_cast<uint16_t>(constant::BANK_TRADE_RATIO);
+            resources[resource] += trading & (Vector_t)(fewestResource == resourceIndex) & 1U;
+        }
+    }
+}
+
+template<size_t LANES>
+bool LockstepEngine<LANES>::isVertexFree(const LaneBoard_t& aBoard, const size_t aVertexId) const
+{
+    if (aBoard.vertexOwner[aVertexId] != -1)
+    {
+        return false;
+    }
+    for (const uint8_t adjVertex : mVertices[aVertexId].vertices)
+    {
+        if (adjVertex != BoardTopology::NO_ID && aBoard.vertexOwner[adjVertex] != -1)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<size_t LANES>
+bool LockstepEngine<LANES>::isRoadConnected(const LaneBoard_t& aBoard, const size_t aEdgeId, const int aPlayerId) const
+{
+    for (const uint8_t vertex : mEdges[aEdgeId].vertices)
+    {
+        if (aBoard.vertexOwner[vertex] == aPlayerId)
+        {
+            return true;
+        }
+        if (aBoard.vertexOwner[vertex] != -1)
+        {
+            // a colony of another player breaks the road
+            continue;
+        }
+        for (const uint8_t adjEdge : mVertices[vertex].edges)
+        {
+            if (adjEdge != BoardTopology::NO_ID && adjEdge != aEdgeId && aBoard.edgeOwner[adjEdge] == aPlayerId)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template<size_t LANES>
+size_t LockstepEngine<LANES>::findCity(const size_t aLane) const
+{
+    const LaneBoard_t& board = mBoards[aLane];
+    for (size_t order = 0U; order < mNumVertices; ++order)
+    {
+        const size_t vertexId = mVertexOrder[order];
+        if (board.vertexOwner[vertexId] == static_cast<int>(mCurrentPlayer) && \
+            board.colony[vertexId] == static_cast<uint8_t>(ColonyType::SETTLEMENT))
+        {
+            return vertexId;
+        }
+    }
+    return BoardTopology::NO_ID;
+}
+
+template<size_t LANES>
+size_t LockstepEngine<LANES>::findSettlement(const size_t aLane) const
+{
+    const LaneBoard_t& board = mBoards[aLane];
+    for (size_t order = 0U; order < mNumVertices; ++order)
+    {
+        const size_t vertexId = mVertexOrder[order];
+        if (!isVertexFree(board, vertexId))
+        {
+            continue;
+        }
+        for (const uint8_t edgeId : mVertices[vertexId].edges)
+        {
+            if (edgeId != BoardTopology::NO_ID && board.edgeOwner[edgeId] == static_cast<int>(mCurrentPlayer))
+            {
+                return vertexId;
+            }
+        }
+    }
+    return BoardTopology::NO_ID;
+}
+
+template<size_t LANES>
+size_t LockstepEngine<LANES>::findRoad(const size_t aLane) const
+{
+    // towards the best free vertex, either at the end of the road or one edge further
+    const LaneBoard_t& board = mBoards[aLane];
+    size_t best = BoardTopology::NO_ID;
+    int bestScore = -1;
+    for (size_t edgeId = 0U; edgeId < mNumEdges; ++edgeId)
+    {
+        if (board.edgeOwner[edgeId] != -1 || !isRoadConnected(board, edgeId, static_cast<int>(mCurrentPlayer)))
+        {
+            continue;
+        }
+        int score = 0;
+        for (const uint8_t vertex : mEdges[edgeId].vertices)
+        {
+            if (isVertexFree(board, vertex))
+            {
+                score = std::max(score, 100 + mVertexPips[vertex]);
+                continue;
+            }
+            for (const uint8_t adjVertex : mVertices[vertex].vertices)
+            {
+                if (adjVertex != BoardTopology::NO_ID && isVertexFree(board, adjVertex))
+                {
+                    score = std::max(score, static_cast<int>(mVertexPips[adjVertex]));
+                }
+            }
+        }
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = edgeId;
+        }
+    }
+    return best;
+}
+
+template<size_t LANES>
+void LockstepEngine<LANES>::addColony(const size_t aLane, const size_t aVertexId, const ColonyType aColony)
+{
+    LaneBoard_t& board = mBoards[aLane];
+    board.vertexOwner[aVertexId] = static_cast<int8_t>(mCurrentPlayer);
+    board.colony[aVertexId] = static_cast<uint8_t>(aColony);
+    // a city adds one more to the production of the settlement it replaces
+    for (const uint8_t landId : mVertices[aVertexId].lands)
+    {
+        if (landId != BoardTopology::NO_ID)
+        {
+            mProduction[mCurrentPlayer][landId][aLane] += 1U;
+        }
+    }
+}
+
+template<size_t LANES>
+bool LockstepEngine<LANES>::buildOnce(const Vector_t& aActive)
+{
+    // the affordability is a mask over the lanes, the placement runs on the lanes of the mask only
+    // and clears the lanes it cannot place on, the resources are paid by the lanes left
+    const size_t playerId = mCurrentPlayer;
+    std::array<Vector_t, CONSUMABLE_RESOURCE_SIZE>& resources = mResources[playerId];
+    const size_t brick = static_cast<size_t>(ResourceTypes::BRICK);
+    const size_t sheep = static_cast<size_t>(ResourceTypes::SHEEP);
+    const size_t wheat = static_cast<size_t>(ResourceTypes::WHEAT);
+    const size_t wood = static_cast<size_t>(ResourceTypes::WOOD);
+    const size_t ore = static_cast<size_t>(ResourceTypes::ORE);
+    bool isBuilt = false;
+
+    Vector_t city = aActive & (Vector_t)(resources[wheat] >= 2U) & (Vector_t)(resources[ore] >= 3U) & \
+        (Vector_t)(mSettlements[playerId] > 0U) & (Vector_t)(mCities[playerId] < static_cast<uint16_t>(constant::MAX_CITIES));
+    for (size_t lane = 0U; lane < LANES; ++lane)
+    {
+        if (city[lane] == 0U)
+        {
+            continue;
+        }
+        const size_t vertexId = findCity(lane);
+        if (vertexId == BoardTopology::NO_ID)
+        {
+            city[lane] = 0U;
+            continue;
+        }
+        addColony(lane, vertexId, ColonyType::CITY);
+        isBuilt = true;
+    }
+    resources[wheat] -= city & 2U;
+    resources[ore] -= city & 3U;
+    mSettlements[playerId] -= city & 1U;
+    mCities[playerId] += city & 1U;
+
+    Vector_t settlement = aActive & (Vector_t)(resources[brick] >= 1U) & (Vector_t)(resources[wood] >= 1U) & \
+        (Vector_t)(resources[sheep] >= 1U) & (Vector_t)(resources[wheat] >= 1U) & \
+        (Vector_t)(mSettlements[playerId] < static_cast<uint16_t>(constant::MAX_SETTLEMENTS));
+    for (size_t lane = 0U; lane < LANES; ++lane)
+    {
+        if (settlement[lane] == 0U)
+        {
+            continue;
+        }
+        const size_t vertexId = findSettlement(lane);
+        if (vertexId == BoardTopology::NO_ID)
+        {
+            settlement[lane] = 0U;
+            continue;
+        }
+        addColony(lane, vertexId, ColonyType::SETTLEMENT);
+        isBuilt = true;
+    }
+    resources[brick] -= settlement & 1U;
+    resources[wood] -= settlement & 1U;
+    resources[sheep] -= settlement & 1U;
+    resources[wheat] -= settlement & 1U;
+    mSettlements[playerId] += settlement & 1U;
+
+    // a road only when there is nowhere to settle, the brick and the wood are kept for the settlement otherwise
+    Vector_t road = aActive & (Vector_t)(resources[brick] >= 1U) & (Vector_t)(resources[wood] >= 1U) & \
+        (Vector_t)(mRoads[playerId] < static_cast<uint16_t>(constant::MAX_ROADS));
+    for (size_t lane = 0U; lane < LANES; ++lane)
+    {
+        if (road[lane] == 0U)
+        {
+            continue;
+        }
+        const size_t edgeId = (findSettlement(lane) == BoardTopology::NO_ID) ? findRoad(lane) : BoardTopology::NO_ID;
+        if (edgeId == BoardTopology::NO_ID)
+        {
+            road[lane] = 0U;
+            continue;
+        }
+        mBoards[lane].edgeOwner[edgeId] = static_cast<int8_t>(playerId);
+        isBuilt = true;
+    }
+    resources[brick] -= road & 1U;
+    resources[wood] -= road & 1U;
+    mRoads[playerId] += road & 1U;
+    return isBuilt;
+}
+
+template<size_t LANES>
+typename LockstepEngine<LANES>::LaneMask_t LockstepEngine<LANES>::step()
+{
+    Vector_t active;
+    getActiveLanes(active);
+    if (isAnyLane(active, LANES))
+    {
+        rollDice();
+        produceResources(active);
+        const Vector_t sevens = active & (Vector_t)(mDice == 7U);
+        if (isAnyLane(sevens, LANES))
+        {
+            discardHalf(sevens);
+            for (size_t lane = 0U; lane < LANES; ++lane)
+            {
+                if (sevens[lane] != 0U)
+                {
+                    moveRobber(lane);
+                }
+            }
+        }
+
+        tradeWithBank(active);
+        for (size_t build = 0U; build < constant::MAX_ACTIONS_PER_TURN && buildOnce(active); ++build)
+        {
+            // build until no lane can build any more
+        }
+
+        const Vector_t victoryPoint = mSettlements[mCurrentPlayer] + (mCities[mCurrentPlayer] << 1U);
+        const Vector_t isWon = active & (Vector_t)(victoryPoint >= static_cast<uint16_t>(constant::WINNING_VICTORY_POINT));
+        mWinner = (~isWon & mWinner) | (isWon & static_cast<uint16_t>(mCurrentPlayer));
+        mNumTurns += active & 1U;
+    }
+
+    // the turn passes in the idle lanes too, so that every lane agrees on the current player
+    mCurrentPlayer = (mCurrentPlayer + 1U) % mNumPlayers;
+    ++mTurn;
+    return getPlayingLanes();
+}
+
+template<size_t LANES>
+size_t LockstepEngine<LANES>::run(const size_t aNumGames)
+{
+    size_t numStarted = 0U;
+    for (size_t lane = 0U; lane < LANES; ++lane)
+    {
+        if (mParked[lane] != 0U)
+        {
+            continue;
+        }
+        if (numStarted < aNumGames)
+        {
+            ++numStarted;
+        }
+        else
+        {
+            mParked[lane] = LANE_ON;
+        }
+    }
+
+    size_t numTurns = 0U;
+    while (true)
+    {
+        // count the games just over and park their lanes
+        Vector_t active;
+        getActiveLanes(active);
+        bool isAnyPlaying = false;
+        for (size_t lane = 0U; lane < LANES; ++lane)
+        {
+            if (active[lane] != 0U || mParked[lane] != 0U)
+            {
+                isAnyPlaying = isAnyPlaying || (active[lane] != 0U);
+                continue;
+            }
+            numTurns += mNumTurns[lane];
+            ++mNumGames;
+            if (mWinner[lane] == NO_PLAYER)
+            {
+                ++mNumDraws;
+            }
+            else
+            {
+                ++mNumWins[mWinner[lane]];
+            }
+            mParked[lane] = LANE_ON;
+        }
+
+        // a new game starts with the first player of the state of reset()
+        if (numStarted < aNumGames && mCurrentPlayer == mInitialState.currentPlayer)
+        {
+            for (size_t lane = 0U; lane < LANES && numStarted < aNumGames; ++lane)
+            {
+                if (mParked[lane] != 0U)
+                {
+                    startGame(lane, numStarted++);
+                    isAnyPlaying = true;
+                }
+            }
+        }
+        if (!isAnyPlaying && numStarted >= aNumGames)
+        {
+            return numTurns;
+        }
+        step();
+    }
+}
+
+template<size_t LANES>
+typename LockstepEngine<LANES>::LaneMask_t LockstepEngine<LANES>::getPlayingLanes() const
+{
+    Vector_t active;
+    getActiveLanes(active);
+    LaneMask_t playing = 0U;
+    for (size_t lane = 0U; lane < LANES; ++lane)
+    {
+        if (active[lane] != 0U)
+        {
+            playing |= (1U << lane);
+        }
+    }
+    return playing;
+}
+
+template<size_t LANES>
+size_t LockstepEngine<LANES>::getTurn() const
+{
+    return mTurn;
+}
+
+template<size_t LANES>
+uint8_t LockstepEngine<LANES>::getWinner(const size_t aLane) const
+{
+    return static_cast<uint8_t>(mWinner[aLane]);
+}
+
+template<size_t LANES>
+size_t LockstepEngine<LANES>::getNumTurns(const size_t aLane) const
+{
+    return mNumTurns[aLane];
+}
+
+template<size_t LANES>
+size_t LockstepEngine<LANES>::getVictoryPoint(const size_t aLane, const size_t aPlayerId) const
+{
+    return mSettlements[aPlayerId][aLane] + 2U * mCities[aPlayerId][aLane];
+}
+
+template<size_t LANES>
+size_t LockstepEngine<LANES>::getResource(const size_t aLane, const size_t aPlayerId, const ResourceTypes aResource) const
+{
+    return mResources[aPlayerId][static_cast<size_t>(aResource)][aLane];
+}
+
+template<size_t LANES>
+size_t LockstepEngine<LANES>::getNumGames() const
+{
+    return mNumGames;
+}
+
+template<size_t LANES>
+size_t LockstepEngine<LANES>::getNumDraws() const
+{
+    return mNumDraws;
+}
+
+template<size_t LANES>
+size_t LockstepEngine<LANES>::getNumWins(const size_t aPlayerId) const
+{
+    return mNumWins.at(aPlayerId);
+}
+
+template<size_t LANES>
+void LockstepEngine<LANES>::exportLane(const size_t aLane, GameState_t& aState) const
+{
+    aState = mInitialState;
+    const LaneBoard_t& board = mBoards[aLane];
+    aState.vertexOwner = board.vertexOwner;
+    aState.colony = board.colony;
+    aState.edgeOwner = board.edgeOwner;
+    for (size_t playerId = 0U; playerId < mNumPlayers; ++playerId)
+    {
+        PlayerState_t& player = aState.players[playerId];
+        for (size_t resource = 0U; resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+        {
+            player.resources[resource] = mResources[playerId][resource][aLane];
+        }
+        player.numSettlements = static_cast<uint8_t>(mSettlements[playerId][aLane]);
+        player.numCities = static_cast<uint8_t>(mCities[playerId][aLane]);
+        player.numRoads = static_cast<uint8_t>(mRoads[playerId][aLane]);
+    }
+    aState.robLandId = static_cast<uint8_t>(mRobLandId[aLane]);
+    aState.winner = getWinner(aLane);
+    aState.turn = static_cast<uint16_t>(mInitialState.turn + mNumTurns[aLane]);
+    // a game over stopped at the turn of its winner
+    aState.currentPlayer = (aState.winner == NO_PLAYER) ? static_cast<uint8_t>(mCurrentPlayer) : aState.winner;
+    aState.phase = ((getPlayingLanes() & (1U << aLane)) != 0U) ? GamePhase::ROLL : GamePhase::GAME_OVER;
+}
+
+template class LockstepEngine<8U>;
+template class LockstepEngine<16U>;
@@ -11,13 +11,20 @@
 #include "constant.hpp"
 
 int Logger::mDebugLevel = constant::DEFAULT_DEBUG_LEVEL;
+std::atomic<bool> Logger::mInfoEnabled(true);
 Logger* Logger::mLogger = nullptr;
+std::mutex Logger::mMutex;
 
 void Logger::setDebugLevel(int aDebugLevel)
 {
     mDebugLevel = aDebugLevel;
 }
 
+void Logger::setInfoEnabled(bool aEnabled)
+{
+    mInfoEnabled.store(aEnabled, std::memory_order_relaxed);
+}
+
 void Logger::initLogger(std::string aLogFilename)
 {
     static Logger logger;
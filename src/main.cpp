@@ -8,17 +8,69 @@
  * All right reserved.
  */
 
+#include <chrono>
 #include "common.hpp"
-#include "user_interface.hpp"
+#include "curses_user_interface.hpp"
 #include "panel.h"
 #include "game_map.hpp"
 #include "map_file_io.hpp"
 #include "cli_opt.hpp"
-#include "command_dispatcher.hpp"
 #include "command_handlers.hpp"
-#include "trading_system.hpp"
 #include "utility.hpp"
 #include "logger.hpp"
+#include "action_journal.hpp"
+
+/**
+ * headless replay, re-applies the journal to a freshly initialized map and logs the final status
+ * @param aSeekTurn stop at the beginning of this turn, replay the whole journal if negative
+ */
+static int replayJournal(GameMap& aMap, const std::string& aJournalFile, const int aSeekTurn)
+{
+    ReplayEngine replayEngine;
+    if (replayEngine.load(aJournalFile) != 0)
+    {
+        return 1;
+    }
+    aMap.initMap();
+    if (replayEngine.prepareMap(aMap) != 0)
+    {
+        WARN_LOG("Journal " + aJournalFile + " does not match the map, was it recorded using a different --map?");
+        return 1;
+    }
+
+    int rc = 0;
+    size_t numEvents = 0U;
+    const auto start = std::chrono::steady_clock::now();
+    if (aSeekTurn < 0)
+    {
+        numEvents = replayEngine.replay(aMap);
+        rc = (numEvents == replayEngine.getNumEvents() ? 0 : 1);
+    }
+    else
+    {
+        rc = replayEngine.seek(aMap, aSeekTurn, numEvents);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    INFO_LOG("Replayed ", numEvents, " of ", replayEngine.getNumEvents(), " events in ", elapsed.count(), "s, ", \
+        (elapsed.count() > 0 ? numEvents / elapsed.count() : 0), " events/s");
+    if (aSeekTurn >= 0)
+    {
+        INFO_LOG("Seek to turn ", aSeekTurn, " of ", replayEngine.getNumTurns(), (rc == 0 ? " succeeded" : " failed"));
+    }
+    aMap.logMap();
+    std::vector<std::string> status;
+    aMap.summarizePlayerStatus(-1, status);
+    for (size_t playerId = 0; playerId < aMap.getNumOfPlayers(); ++playerId)
+    {
+        if (playerId != aMap.currentPlayer())
+        {
+            aMap.summarizePlayerStatus(playerId, status);
+        }
+    }
+    INFO_LOG("Status after replay: ", status);
+    return rc;
+}
 
 int main(int argc, char** argv)
 {
@@ -29,39 +81,32 @@ int main(int argc, char** argv)
     cliOpt.processArg(argc, argv);
     Logger::setDebugLevel(cliOpt.getOpt<CliOptIndex::DEBUG_LEVEL>());
 
-    GameMap gameMap;
-
+    const std::shared_ptr<const BoardLayout> pLayout = MapIO(cliOpt.getOpt<CliOptIndex::MAP_FILE_PATH>()).readLayout();
+    if (pLayout == nullptr)
     {
-        // auto release mapFile
-        MapIO mapFile(cliOpt.getOpt<CliOptIndex::MAP_FILE_PATH>());
-        mapFile.readMap(gameMap);
+        return 1;
     }
+    GameMap gameMap(pLayout, cliOpt.getOpt<CliOptIndex::RANDOM_SEED>());
 
-    UserInterface ui(gameMap, std::make_unique<CommandDispatcher>(
-        std::vector<CommandHandler*>({
-            new BuildHandler(),
-            new NextHandler(),
-            new PassHandler(),
-            new RollHandler(),
-            new StatusHandler(),
-            new DevelopmentCardHandler(),
-            new TradeHandler(),
-#ifndef RELEASE
-            // these commands are only for testing in development
-            new BuildingHandler(),
-            new SubCmdHandler(),
-            new ParameterExampleCommandHandler()
-#endif /* ifndef RELEASE*/
-        })
-    ));
+    if (cliOpt.getOpt<CliOptIndex::REPLAY_FILE_PATH>() != "")
+    {
+        return replayJournal(gameMap, cliOpt.getOpt<CliOptIndex::REPLAY_FILE_PATH>(), \
+                             cliOpt.getOpt<CliOptIndex::REPLAY_SEEK_TURN>());
+    }
 
     gameMap.initMap();
     gameMap.logMap();
     gameMap.addPlayer(6U);
 
-    ui.printMapToWindow(gameMap);
+    ActionJournal journal;
+    if (cliOpt.getOpt<CliOptIndex::JOURNAL_FILE_PATH>() != "" && \
+        journal.open(cliOpt.getOpt<CliOptIndex::JOURNAL_FILE_PATH>(), gameMap) == 0)
+    {
+        gameMap.setJournal(&journal);
+    }
 
-    const std::vector<int> playerOrder = gameMap.getFirstTwoRoundOrder();
+    CursesUserInterface ui(gameMap, createGameCommands(gameMap));
+    ui.printMapToWindow(gameMap);
 
     ui.loop(gameMap);
 
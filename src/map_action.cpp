@@ -0,0 +1,247 @@
+/**
+ * Project: catan
+ * @file map_action.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include "map_action.hpp"
+#include "game_map.hpp"
+#include "vertex.hpp"
+#include "edge.hpp"
+#include "land.hpp"
+#include "logger.hpp"
+#include "little_endian.hpp"
+
+namespace
+{
+
+constexpr MapActionResult_t INCORRECT = MapActionResult_t{MapActionExecutor::INCORRECT_ACTION, 0U, 0U};
+
+inline MapActionResult_t result(const int aRc, const size_t aValue = 0U, const size_t aAmount = 0U)
+{
+    return MapActionResult_t{static_cast<uint8_t>(aRc), static_cast<uint8_t>(aValue), static_cast<uint16_t>(aAmount)};
+}
+
+inline bool isResource(const size_t aResource)
+{
+    return aResource < CONSUMABLE_RESOURCE_SIZE;
+}
+
+} // namespace
+
+constexpr size_t MapActionExecutor::ACTION_SIZE;
+constexpr size_t MapActionExecutor::RESULT_SIZE;
+constexpr uint8_t MapActionExecutor::INCORRECT_ACTION;
+constexpr uint8_t MapActionExecutor::NO_RESOURCE;
+
+MapActionExecutor::MapActionExecutor()
+{
+    resetStats();
+}
+
+MapActionResult_t MapActionExecutor::execute(GameMap& aMap, const MapAction_t& aAction)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const MapActionResult_t actionResult = dispatch(aMap, aAction);
+    const uint64_t elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    if (actionResult.rc == INCORRECT_ACTION)
+    {
+        WARN_LOG("Incorrect map action ", static_cast<int>(aAction.opcode), " id: ", aAction.id, " aux: ", static_cast<int>(aAction.aux));
+    }
+    const size_t opcode = static_cast<size_t>(aAction.opcode);
+    if (opcode < MAP_ACTION_OPCODE_SIZE)
+    {
+        MapActionStats_t& stats = mStats[opcode];
+        ++stats.count;
+        stats.totalNs += elapsedNs;
+        stats.minNs = std::min(stats.minNs, elapsedNs);
+        stats.maxNs = std::max(stats.maxNs, elapsedNs);
+    }
+    return actionResult;
+}
+
+size_t MapActionExecutor::executeWire(GameMap& aMap, const std::vector<uint8_t>& aActions, std::vector<uint8_t>& aResults)
+{
+    size_t numExecuted = 0U;
+    for (size_t offset = 0U; offset + ACTION_SIZE <= aActions.size(); offset += ACTION_SIZE)
+    {
+        const MapActionResult_t actionResult = execute(aMap, decodeAction(aActions.data() + offset));
+        encode(actionResult, aResults);
+        ++numExecuted;
+        if (actionResult.rc != 0U)
+        {
+            break;
+        }
+    }
+    return numExecuted;
+}
+
+MapActionResult_t MapActionExecutor::dispatch(GameMap& aMap, const MapAction_t& aAction) const
+{
+    switch (aAction.opcode)
+    {
+    case MapActionOpcode::ROLL_DICE:
+        return result(0, aMap.rollDice());
+    case MapActionOpcode::PLACE_SETTLEMENT:
+    {
+        if (aAction.id >= aMap.getVertices().size() || aAction.aux > 1U)
+        {
+            return INCORRECT;
+        }
+        const Point_t point = aMap.getVertices()[aAction.id]->getTopLeft();
+        const int rc = aMap.buildColony(point, ColonyType::SETTLEMENT, false, false);
+        return (rc == 0 && aAction.aux == 1U) ? result(0, 0U, aMap.currentPlayerCollectResources(point)) : result(rc);
+    }
+    case MapActionOpcode::PLACE_ROAD:
+    case MapActionOpcode::BUILD_ROAD:
+    {
+        if (aAction.id >= aMap.getEdges().size())
+        {
+            return INCORRECT;
+        }
+        return result(aMap.buildRoad(aMap.getEdges()[aAction.id]->getTopLeft(), aAction.opcode == MapActionOpcode::BUILD_ROAD));
+    }
+    case MapActionOpcode::BUILD_SETTLEMENT:
+    case MapActionOpcode::BUILD_CITY:
+    {
+        if (aAction.id >= aMap.getVertices().size())
+        {
+            return INCORRECT;
+        }
+        const ColonyType colony = (aAction.opcode == MapActionOpcode::BUILD_CITY) ? ColonyType::CITY : ColonyType::SETTLEMENT;
+        return result(aMap.buildColony(aMap.getVertices()[aAction.id]->getTopLeft(), colony));
+    }
+    case MapActionOpcode::BUY_DEV_CARD:
+    {
+        DevelopmentCardTypes devCard = DevelopmentCardTypes::KNIGHT;
+        const int rc = aMap.currentPlayerBuyDevCard(devCard);
+        return (rc == 0) ? result(0, static_cast<size_t>(devCard)) : result(rc);
+    }
+    case MapActionOpcode::MOVE_ROBBER:
+    case MapActionOpcode::PLAY_KNIGHT:
+        return robLand(aMap, aAction.id, aAction.aux, aAction.opcode == MapActionOpcode::PLAY_KNIGHT);
+    case MapActionOpcode::PLAY_ROAD_BUILDING:
+        return result(aMap.currentPlayerConsumeDevCard(DevelopmentCardTypes::ROAD_BUILDING));
+    case MapActionOpcode::PLAY_YEAR_OF_PLENTY:
+    {
+        const size_t first = aAction.aux & 0x0FU;
+        const size_t second = aAction.aux >> 4U;
+        if (!isResource(first) || !isResource(second))
+        {
+            return INCORRECT;
+        }
+        const int rc = aMap.currentPlayerConsumeDevCard(DevelopmentCardTypes::YEAR_OF_PLENTY);
+        if (rc == 0)
+        {
+            aMap.currentPlayerAddResource(static_cast<ResourceTypes>(first));
+            aMap.currentPlayerAddResource(static_cast<ResourceTypes>(second));
+        }
+        return result(rc);
+    }
+    case MapActionOpcode::PLAY_MONOPOLY:
+    {
+        if (!isResource(aAction.aux))
+        {
+            return INCORRECT;
+        }
+        const int rc = aMap.currentPlayerConsumeDevCard(DevelopmentCardTypes::MONOPOLY);
+        return (rc == 0) ? result(0, 0U, aMap.currentPlayerPlayMonopoly(static_cast<ResourceTypes>(aAction.aux))) : result(rc);
+    }
+    case MapActionOpcode::END_TURN:
+        return result(0, aMap.nextPlayer());
+    case MapActionOpcode::OPCODE_END:
+    default:
+        return INCORRECT;
+    }
+}
+
+MapActionResult_t MapActionExecutor::robLand(GameMap& aMap, const uint16_t aId, const uint8_t aVictim, const bool aPlayKnight) const
+{
+    if (aId >= aMap.getLands().size())
+    {
+        return INCORRECT;
+    }
+    const Land* const pLand = aMap.getLands()[aId];
+    const Vertex* pVictim = nullptr;
+    if (aVictim != NO_PLAYER)
+    {
+        for (const Vertex* const pVertex : pLand->getAdjacentVertices())
+        {
+            if (pVertex->getOwner(aMap.getBoardState()) == aVictim)
+            {
+                pVictim = pVertex;
+                break;
+            }
+        }
+        if (!pVictim)
+        {
+            // nothing of aVictim next to the land
+            return INCORRECT;
+        }
+    }
+
+    if (aPlayKnight)
+    {
+        const int rc = aMap.currentPlayerConsumeDevCard(DevelopmentCardTypes::KNIGHT);
+        if (rc != 0)
+        {
+            return result(rc);
+        }
+    }
+    const int rc = aMap.moveRobber(pLand->getTopLeft());
+    if (rc != 0 || !pVictim)
+    {
+        return result(rc, NO_RESOURCE);
+    }
+    ResourceTypes robbed = ResourceTypes::NONE;
+    switch (aMap.robVertex(pVictim->getTopLeft(), robbed))
+    {
+    case 0:
+        return result(0, static_cast<size_t>(robbed));
+    case 3:
+        // aVictim has no resources, nothing to rob
+        return result(0, NO_RESOURCE);
+    default:
+        return result(1, NO_RESOURCE);
+    }
+}
+
+void MapActionExecutor::encode(const MapAction_t& aAction, std::vector<uint8_t>& aBytes)
+{
+    aBytes.push_back(static_cast<uint8_t>(aAction.opcode));
+    aBytes.push_back(aAction.aux);
+    pushUint(aBytes, aAction.id, 2U);
+}
+
+void MapActionExecutor::encode(const MapActionResult_t& aResult, std::vector<uint8_t>& aBytes)
+{
+    aBytes.push_back(aResult.rc);
+    aBytes.push_back(aResult.value);
+    pushUint(aBytes, aResult.amount, 2U);
+}
+
+MapAction_t MapActionExecutor::decodeAction(const uint8_t* const aBytes)
+{
+    return MapAction_t{static_cast<MapActionOpcode>(aBytes[0]), aBytes[1], static_cast<uint16_t>(loadUint(aBytes + 2, 2U))};
+}
+
+MapActionResult_t MapActionExecutor::decodeResult(const uint8_t* const aBytes)
+{
+    return MapActionResult_t{aBytes[0], aBytes[1], static_cast<uint16_t>(loadUint(aBytes + 2, 2U))};
+}
+
+const MapActionStats_t& MapActionExecutor::getStats(const MapActionOpcode aOpcode) const
+{
+    return mStats.at(static_cast<size_t>(aOpcode));
+}
+
+void MapActionExecutor::resetStats()
+{
+    mStats.fill(MapActionStats_t{0U, 0U, UINT64_MAX, 0U});
+}
@@ -0,0 +1,178 @@
+/**
+ * Project: catan
+ * @file map_agent_driver.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include "map_agent_driver.hpp"
+#include "game_map.hpp"
+#include "utility.hpp"
+#include "logger.hpp"
+
+MapAgentDriver::MapAgentDriver(std::shared_ptr<const BoardTopology> aTopology, const uint64_t aSeed) :
+    mRules(aTopology),
+    mEngine(aSeed)
+{
+    // empty
+}
+
+int MapAgentDriver::playTurn(GameMap& aMap, Agent& aAgent, std::vector<std::string>& aReturnMsg)
+{
+    GameState_t state;
+    if (aMap.exportGameState(state) != 0)
+    {
+        return 1;
+    }
+
+    // GameMap does not track the turn, the per-turn fields are kept here
+    GameState_t turn = state;
+    turn.phase = GamePhase::ROLL;
+    while (true)
+    {
+        state.phase = turn.phase;
+        state.actionsThisTurn = turn.actionsThisTurn;
+        state.newKnights = turn.newKnights;
+        state.devCardPlayed = turn.devCardPlayed;
+
+        mRules.getLegalActions(state, mActions);
+        mActions.erase(std::remove_if(mActions.begin(), mActions.end(), [](const GameAction_t& aAction) {
+                return aAction.type == GameActionType::BANK_TRADE;
+            }), mActions.end());
+        if (mActions.empty())
+        {
+            // e.g., the state says game over, nothing more to do in this turn
+            aMap.nextPlayer();
+            return 0;
+        }
+        const GameAction_t action = mActions[aAgent.chooseAction(mRules, state, mActions, mEngine)];
+        if (applyToMap(aMap, action, turn, aReturnMsg) != 0)
+        {
+            WARN_LOG("Agent " + aAgent.getName() + " failed to apply action ", static_cast<int>(action.type), \
+                     " id: ", action.id, " aux: ", static_cast<int>(action.aux));
+            return 2;
+        }
+        if (action.type == GameActionType::END_TURN)
+        {
+            return 0;
+        }
+        aMap.exportGameState(state);
+    }
+}
+
+int MapAgentDriver::playTurn(GameMap& aMap, ExpectimaxSearch& aSearch, std::vector<std::string>& aReturnMsg)
+{
+    GameState_t turn = GameState_t();
+    GameAction_t action = GameAction_t{GameActionType::ROLL_DICE, 0U, 0U};
+    while (true)
+    {
+        if (applyToMap(aMap, action, turn, aReturnMsg) != 0)
+        {
+            WARN_LOG("Search failed to apply action ", static_cast<int>(action.type), \
+                     " id: ", action.id, " aux: ", static_cast<int>(action.aux));
+            return 2;
+        }
+        if (action.type == GameActionType::END_TURN)
+        {
+            return 0;
+        }
+        if (aSearch.search(aMap, turn.phase == GamePhase::MOVE_ROBBER, action) != 0)
+        {
+            return 1;
+        }
+        aReturnMsg.push_back(Logger::formatString("searched ", aSearch.getNumNodes(), " nodes, depth ", aSearch.getDepthReached()));
+    }
+}
+
+int MapAgentDriver::applyToMap(GameMap& aMap, const GameAction_t& aAction, GameState_t& aState, std::vector<std::string>& aReturnMsg)
+{
+    if (aState.phase == GamePhase::MAIN)
+    {
+        ++aState.actionsThisTurn;
+    }
+
+    int rc = 0;
+    switch (aAction.type)
+    {
+    case GameActionType::ROLL_DICE:
+    {
+        const int dice = aMap.rollDice();
+        aReturnMsg.push_back(Logger::formatString("rolled ", dice));
+        aState.phase = (dice == 7) ? GamePhase::MOVE_ROBBER : GamePhase::MAIN;
+        break;
+    }
+    case GameActionType::MOVE_ROBBER:
+        rc = robLand(aMap, aAction, aReturnMsg);
+        aState.phase = GamePhase::MAIN;
+        break;
+    case GameActionType::PLAY_KNIGHT:
+        rc = aMap.currentPlayerConsumeDevCard(DevelopmentCardTypes::KNIGHT);
+        if (rc == 0)
+        {
+            aReturnMsg.push_back("played " + developmentCardTypesToStr(DevelopmentCardTypes::KNIGHT));
+            rc = robLand(aMap, aAction, aReturnMsg);
+        }
+        aState.devCardPlayed = true;
+        break;
+    case GameActionType::BUILD_ROAD:
+    {
+        const Edge* const pEdge = aMap.getEdges().at(aAction.id);
+        rc = aMap.buildRoad(pEdge->getTopLeft());
+        aReturnMsg.push_back("built road on " + pEdge->getStringId());
+        break;
+    }
+    case GameActionType::BUILD_SETTLEMENT:
+    case GameActionType::BUILD_CITY:
+    {
+        const ColonyType colony = (aAction.type == GameActionType::BUILD_CITY) ? ColonyType::CITY : ColonyType::SETTLEMENT;
+        const Vertex* const pVertex = aMap.getVertices().at(aAction.id);
+        rc = aMap.buildColony(pVertex->getTopLeft(), colony);
+        aReturnMsg.push_back("built " + colonyTypesToStr(colony) + " on " + pVertex->getStringId());
+        break;
+    }
+    case GameActionType::BUY_DEV_CARD:
+    {
+        DevelopmentCardTypes devCard;
+        rc = aMap.currentPlayerBuyDevCard(devCard);
+        if (rc == 0 && devCard == DevelopmentCardTypes::KNIGHT)
+        {
+            ++aState.newKnights;
+        }
+        aReturnMsg.push_back("bought a development card");
+        break;
+    }
+    case GameActionType::END_TURN:
+        aReturnMsg.push_back(Logger::formatString("passed to player#", aMap.nextPlayer()));
+        break;
+    case GameActionType::BANK_TRADE:
+    default:
+        rc = 1;
+        break;
+    }
+    return rc;
+}
+
+int MapAgentDriver::robLand(GameMap& aMap, const GameAction_t& aAction, std::vector<std::string>& aReturnMsg)
+{
+    const Land* const pLand = aMap.getLands().at(aAction.id);
+    int rc = aMap.moveRobber(pLand->getTopLeft());
+    aReturnMsg.push_back("moved robber to " + pLand->getStringId());
+    if (rc != 0 || aAction.aux == NO_PLAYER)
+    {
+        return rc;
+    }
+    for (const Vertex* const pVertex : pLand->getAdjacentVertices())
+    {
+        if (pVertex->getOwner(aMap.getBoardState()) == aAction.aux)
+        {
+            ResourceTypes robbed;
+            rc = aMap.robVertex(pVertex->getTopLeft(), robbed);
+            aReturnMsg.push_back(Logger::formatString("robbed player#", static_cast<int>(aAction.aux)));
+            return rc;
+        }
+    }
+    return 1;
+}
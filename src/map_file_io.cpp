@@ -12,7 +12,7 @@
 #include "logger.hpp"
 #include "utility.hpp"
 
-int MapIO::readMap(GameMap& aGameMap)
+int MapIO::readMap(BoardLayout& aLayout)
 {
     std::deque<std::string> stringQueue;
     if (mFilename == "" || mFilename == "default")
@@ -42,7 +42,7 @@ int MapIO::readMap(GameMap& aGameMap)
     }
 
     Point_t mapSize = preprocessStringVector(stringQueue);
-    aGameMap.clearAndResize(mapSize.x, mapSize.y);
+    aLayout.clearAndResize(mapSize.x, mapSize.y);
 
     size_t jj = 0;
 
@@ -55,7 +55,7 @@ int MapIO::readMap(GameMap& aGameMap)
             {
                 continue;
             }
-            const Terrain* const pTerrain = aGameMap.getTerrain(ii, jj);
+            const Terrain* const pTerrain = aLayout.getTerrain(ii, jj);
             if (pTerrain != Blank::getBlank())
             {
                 // occupied
@@ -67,7 +67,7 @@ int MapIO::readMap(GameMap& aGameMap)
                 {
                     // vertex
                     DEBUG_LOG_L0("Read in char '", pattern, "', adding vertex at ", Point_t{ii, jj});
-                    aGameMap.addVertex(ii, jj);
+                    aLayout.addVertex(ii, jj);
                     break;
                 }
                 case '-':
@@ -76,7 +76,7 @@ int MapIO::readMap(GameMap& aGameMap)
                 {
                     // edge
                     DEBUG_LOG_L0("Read in char '", pattern, "', adding edge at ", Point_t{ii, jj});
-                    aGameMap.addEdge(ii, jj, pattern);
+                    aLayout.addEdge(ii, jj, pattern);
                     break;
                 }
                 case '.':
@@ -94,7 +94,7 @@ int MapIO::readMap(GameMap& aGameMap)
                         :
                         ResourceTypes::NONE;
                     DEBUG_LOG_L0("Read in char '", pattern, "', adding land at ", Point_t{ii, jj}, " resource = " + resourceTypesToStr(resource));
-                    aGameMap.addLand(ii, jj, resource);
+                    aLayout.addLand(ii, jj, resource);
                     break;
                 }
                 default:
@@ -112,7 +112,18 @@ int MapIO::readMap(GameMap& aGameMap)
     return 0;
 }
 
-int MapIO::saveMap(GameMap* const aGameMap)
+std::shared_ptr<const BoardLayout> MapIO::readLayout()
+{
+    std::shared_ptr<BoardLayout> pLayout = std::make_shared<BoardLayout>();
+    if (readMap(*pLayout) != 0 || pLayout->initLayout() != 0)
+    {
+        WARN_LOG("Failed to build the board layout of " + (mFilename == "" ? std::string("the default map") : mFilename));
+        return nullptr;
+    }
+    return pLayout;
+}
+
+int MapIO::saveMap(const BoardLayout& aLayout)
 {
     // TODO: implement
     return 0;
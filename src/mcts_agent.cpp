@@ -0,0 +1,469 @@
+/**
+ * Project: catan
+ * @file mcts_agent.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "mcts_agent.hpp"
+
+namespace
+{
+
+constexpr uint32_t NO_NODE = 0xFFFFFFFFU;
+constexpr uint64_t REWARD_SCALE = 1U << 16;    // rewards are fixed point, so that they can be summed atomically
+constexpr size_t MAX_PATH = 1024U;              // max depth of a descent
+constexpr uint32_t ROLLOUT_RANDOM_ONE_IN = 8U;  // the rollout policy is greedy, except for 1 random action in 8
+
+enum NodeStatus : uint8_t
+{
+    NODE_LEAF = 0,
+    NODE_EXPANDING,
+    NODE_EXPANDED,
+};
+
+/**
+ * decision node: the state after the path is known, one child per legal action, contiguous in the arena
+ * chance node:   the child of a chance action, its children are the outcomes met so far, linked by nextSibling
+ * outcome node:  a decision node under a chance node, keyed by the hash of its state
+ */
+struct MctsNode_t
+{
+    GameAction_t action;        // the action leading to this node, outcome nodes: the action of the chance node
+    uint8_t player;             // the player who chose the action, NO_PLAYER for the root and outcome nodes
+    bool isChance;
+    uint16_t numChildren;       // decision nodes only
+    std::atomic<uint8_t> status;        // NodeStatus, decision nodes only
+    std::atomic<uint32_t> firstChild;   // chance nodes: head of the outcome list
+    uint32_t nextSibling;       // outcome nodes only, immutable once the node is published
+    uint64_t hash;              // outcome nodes only
+    std::atomic<uint32_t> visits;
+    std::atomic<uint32_t> virtualLoss;
+    std::atomic<uint64_t> reward;       // sum of the rewards of player, REWARD_SCALE is 1
+};
+
+// 8 bytes at a time, the mixing of splitmix64, GameState_t has no padding
+// the order of the deck is reshuffled on every iteration, only the cards left per type are hashed
+uint64_t hashState(const GameState_t& aState)
+{
+    constexpr size_t HASHED_SIZE = offsetof(GameState_t, devCardDeck);
+    const unsigned char* const pBytes = reinterpret_cast<const unsigned char*>(&aState);
+    uint64_t hash = 0x9E3779B97F4A7C15ULL;
+    size_t offset = 0U;
+    for (; offset + sizeof(uint64_t) <= HASHED_SIZE; offset += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, pBytes + offset, sizeof(uint64_t));
+        hash = (hash ^ word) * 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 31;
+    }
+    for (; offset < HASHED_SIZE; ++offset)
+    {
+        hash = (hash ^ pBytes[offset]) * 0x94D049BB133111EBULL;
+    }
+    for (const uint8_t remaining : aState.devCardDeck.remaining)
+    {
+        hash = (hash ^ remaining) * 0x94D049BB133111EBULL;
+    }
+    return hash ^ (hash >> 29);
+}
+
+} // namespace
+
+/**
+ * the nodes of one tree, shared by the threads of the tree
+ * nodes are never freed individually, reset() discards the whole tree
+ */
+class MctsTree
+{
+private:
+    std::unique_ptr<MctsNode_t[]> mNodes;
+    const uint32_t mCapacity;
+    std::atomic<uint32_t> mNumNodes;
+    std::atomic<size_t> mIterations;
+
+public:
+    void reset()
+    {
+        mNumNodes.store(0U, std::memory_order_relaxed);
+        mIterations.store(0U, std::memory_order_relaxed);
+    }
+
+    /** @return index of the first of aCount contiguous nodes, NO_NODE if the arena is full */
+    uint32_t allocate(const uint32_t aCount)
+    {
+        if (mNumNodes.load(std::memory_order_relaxed) + aCount > mCapacity)
+        {
+            return NO_NODE;
+        }
+        const uint32_t first = mNumNodes.fetch_add(aCount, std::memory_order_relaxed);
+        return (first + aCount <= mCapacity) ? first : NO_NODE;
+    }
+
+    void initNode(const uint32_t aIndex, const GameAction_t& aAction, const uint8_t aPlayer, const bool aIsChance)
+    {
+        MctsNode_t& node = mNodes[aIndex];
+        node.action = aAction;
+        node.player = aPlayer;
+        node.isChance = aIsChance;
+        node.numChildren = 0U;
+        node.status.store(NODE_LEAF, std::memory_order_relaxed);
+        node.firstChild.store(NO_NODE, std::memory_order_relaxed);
+        node.nextSibling = NO_NODE;
+        node.hash = 0U;
+        node.visits.store(0U, std::memory_order_relaxed);
+        node.virtualLoss.store(0U, std::memory_order_relaxed);
+        node.reward.store(0U, std::memory_order_relaxed);
+    }
+
+    /** @return false if the iteration budget of the tree is used up, aIterations == 0 means unlimited */
+    bool claimIteration(const size_t aIterations)
+    {
+        return aIterations == 0U || mIterations.fetch_add(1U, std::memory_order_relaxed) < aIterations;
+    }
+
+    MctsNode_t& operator[](const uint32_t aIndex)
+    {
+        return mNodes[aIndex];
+    }
+
+    MctsTree(const size_t aCapacity) :
+        mNodes(new MctsNode_t[aCapacity]),
+        mCapacity(static_cast<uint32_t>(aCapacity)),
+        mNumNodes(0U),
+        mIterations(0U)
+    {
+        // empty
+    }
+};
+
+namespace
+{
+
+/**
+ * one search thread, everything it touches during the search (except the tree) is its own
+ */
+class MctsWorker
+{
+private:
+    const GameRules& mRules;
+    const MctsConfig_t& mConfig;
+    const GameState_t& mRootState;
+    MctsTree& mTree;
+    RandomEngine mEngine;
+    GreedyAgent mRolloutPolicy;
+    std::vector<GameAction_t> mActions;     // reserved up front, the rollouts do not allocate
+    std::array<uint32_t, MAX_PATH> mPath;
+
+    bool expand(MctsNode_t& aNode, const GameState_t& aState)
+    {
+        mRules.getLegalActions(aState, mActions);
+        const uint32_t first = mActions.empty() ? NO_NODE : mTree.allocate(mActions.size());
+        if (first == NO_NODE)
+        {
+            return false;
+        }
+        for (size_t index = 0U; index < mActions.size(); ++index)
+        {
+            mTree.initNode(first + index, mActions[index], aState.currentPlayer, GameRules::isChanceAction(mActions[index]));
+        }
+        aNode.numChildren = static_cast<uint16_t>(mActions.size());
+        aNode.firstChild.store(first, std::memory_order_relaxed);
+        return true;
+    }
+
+    // UCT, a virtual loss counts as a visit without reward
+    uint32_t select(const MctsNode_t& aNode)
+    {
+        const uint32_t first = aNode.firstChild.load(std::memory_order_relaxed);
+        const double logVisits = std::log(static_cast<double>(aNode.visits.load(std::memory_order_relaxed) + \
+                                          aNode.virtualLoss.load(std::memory_order_relaxed) + 1U));
+        uint32_t best = first;
+        double bestValue = -std::numeric_limits<double>::infinity();
+        for (uint32_t index = first; index < first + aNode.numChildren; ++index)
+        {
+            const MctsNode_t& child = mTree[index];
+            const uint32_t visits = child.visits.load(std::memory_order_relaxed) + \
+                                    child.virtualLoss.load(std::memory_order_relaxed);
+            if (visits == 0U)
+            {
+                return index;
+            }
+            const double value = static_cast<double>(child.reward.load(std::memory_order_relaxed)) / REWARD_SCALE / visits + \
+                                 mConfig.exploration * std::sqrt(logVisits / visits);
+            if (value > bestValue)
+            {
+                best = index;
+                bestValue = value;
+            }
+        }
+        return best;
+    }
+
+    /** @return the outcome node of aChance for a state of aHash, added if not met yet, NO_NODE if the arena is full */
+    uint32_t findOutcome(MctsNode_t& aChance, const uint64_t aHash)
+    {
+        uint32_t head = aChance.firstChild.load(std::memory_order_acquire);
+        uint32_t scannedHead = NO_NODE;     // the list from scannedHead on is known not to contain aHash
+        uint32_t outcome = NO_NODE;
+        while (true)
+        {
+            for (uint32_t index = head; index != scannedHead; index = mTree[index].nextSibling)
+            {
+                if (mTree[index].hash == aHash)
+                {
+                    return index;
+                }
+            }
+            if (outcome == NO_NODE)
+            {
+                outcome = mTree.allocate(1U);
+                if (outcome == NO_NODE)
+                {
+                    return NO_NODE;
+                }
+                mTree.initNode(outcome, aChance.action, NO_PLAYER, false);
+                mTree[outcome].hash = aHash;
+            }
+            mTree[outcome].nextSibling = head;
+            const uint32_t expected = head;
+            if (aChance.firstChild.compare_exchange_weak(head, outcome, std::memory_order_release, std::memory_order_acquire))
+            {
+                return outcome;
+            }
+            scannedHead = expected;
+        }
+    }
+
+    void rollout(GameState_t& aState, std::array<uint64_t, constant::MAX_NUM_PLAYERS>& aRewards)
+    {
+        for (size_t step = 0U; step < mConfig.rolloutDepth && aState.phase != GamePhase::GAME_OVER; ++step)
+        {
+            mRules.getLegalActions(aState, mActions);
+            const size_t choice = (uniformBelow(mEngine, ROLLOUT_RANDOM_ONE_IN) == 0U) ? \
+                uniformBelow(mEngine, mActions.size()) : mRolloutPolicy.chooseAction(mRules, aState, mActions, mEngine);
+            mRules.applyAction(aState, mActions[choice], mEngine);
+        }
+
+        aRewards.fill(0U);
+        if (aState.winner != NO_PLAYER)
+        {
+            aRewards[aState.winner] = REWARD_SCALE;
+            return;
+        }
+        // unfinished (or a draw), share of the victory points
+        size_t totalPoints = 0U;
+        for (size_t playerId = 0U; playerId < aState.numPlayers; ++playerId)
+        {
+            aRewards[playerId] = mRules.getVictoryPoint(aState, playerId);
+            totalPoints += aRewards[playerId];
+        }
+        for (size_t playerId = 0U; playerId < aState.numPlayers; ++playerId)
+        {
+            aRewards[playerId] = (totalPoints > 0U) ? aRewards[playerId] * REWARD_SCALE / totalPoints : 0U;
+        }
+    }
+
+    void iterate()
+    {
+        GameState_t state = mRootState;
+        state.devCardDeck.shuffle(mEngine);
+        uint32_t nodeIndex = 0U;    // the root
+        size_t depth = 0U;
+        mPath[depth++] = nodeIndex;
+        while (state.phase != GamePhase::GAME_OVER && depth + 2U <= MAX_PATH)
+        {
+            MctsNode_t& node = mTree[nodeIndex];
+            bool isNewLeaf = false;
+            uint8_t status = node.status.load(std::memory_order_acquire);
+            if (status == NODE_LEAF)
+            {
+                if (!node.status.compare_exchange_strong(status, NODE_EXPANDING, std::memory_order_acq_rel))
+                {
+                    // another thread got here first and is expanding it
+                    break;
+                }
+                if (!expand(node, state))
+                {
+                    node.status.store(NODE_LEAF, std::memory_order_release);
+                    break;
+                }
+                node.status.store(NODE_EXPANDED, std::memory_order_release);
+                isNewLeaf = true;
+            }
+            else if (status == NODE_EXPANDING)
+            {
+                break;
+            }
+
+            const uint32_t childIndex = select(node);
+            MctsNode_t& child = mTree[childIndex];
+            child.virtualLoss.fetch_add(1U, std::memory_order_relaxed);
+            mPath[depth++] = childIndex;
+            mRules.applyAction(state, child.action, mEngine);
+            nodeIndex = childIndex;
+            if (child.isChance)
+            {
+                const uint32_t outcomeIndex = findOutcome(child, hashState(state));
+                if (outcomeIndex == NO_NODE)
+                {
+                    break;
+                }
+                mTree[outcomeIndex].virtualLoss.fetch_add(1U, std::memory_order_relaxed);
+                mPath[depth++] = outcomeIndex;
+                nodeIndex = outcomeIndex;
+            }
+            if (isNewLeaf)
+            {
+                break;
+            }
+        }
+
+        std::array<uint64_t, constant::MAX_NUM_PLAYERS> rewards;
+        rollout(state, rewards);
+
+        mTree[mPath[0]].visits.fetch_add(1U, std::memory_order_relaxed);
+        for (size_t index = 1U; index < depth; ++index)
+        {
+            MctsNode_t& node = mTree[mPath[index]];
+            node.visits.fetch_add(1U, std::memory_order_relaxed);
+            node.virtualLoss.fetch_sub(1U, std::memory_order_relaxed);
+            if (node.player != NO_PLAYER)
+            {
+                node.reward.fetch_add(rewards[node.player], std::memory_order_relaxed);
+            }
+        }
+    }
+
+public:
+    void run(const std::chrono::steady_clock::time_point aDeadline)
+    {
+        while (mTree.claimIteration(mConfig.iterations))
+        {
+            if (mConfig.timeLimitMs > 0U && std::chrono::steady_clock::now() >= aDeadline)
+            {
+                break;
+            }
+            iterate();
+        }
+    }
+
+    MctsWorker(const GameRules& aRules, const MctsConfig_t& aConfig, const GameState_t& aRootState,
+               MctsTree& aTree, const uint64_t aSeed) :
+        mRules(aRules),
+        mConfig(aConfig),
+        mRootState(aRootState),
+        mTree(aTree),
+        mEngine(aSeed)
+    {
+        mActions.reserve(GameRules::MAX_LEGAL_ACTIONS);
+    }
+};
+
+} // namespace
+
+MctsConfig_t MctsAgent::defaultConfig()
+{
+    MctsConfig_t config;
+    config.iterations = 1000U;
+    config.timeLimitMs = 0U;
+    config.numTrees = 1U;
+    config.threadsPerTree = 1U;
+    config.exploration = 0.7;
+    config.rolloutDepth = 200U;
+    config.arenaSize = 1U << 18;
+    return config;
+}
+
+size_t MctsAgent::chooseAction(const GameRules& aRules, const GameState_t& aState,
+                               const std::vector<GameAction_t>& aActions, RandomEngine& aEngine)
+{
+    if (aActions.size() == 1U)
+    {
+        return 0U;
+    }
+
+    // the root and its children, in the order of aActions
+    for (std::unique_ptr<MctsTree>& pTree : mTrees)
+    {
+        MctsTree& tree = *pTree;
+        tree.reset();
+        tree.initNode(tree.allocate(1U), GameAction_t{GameActionType::END_TURN, 0U, 0U}, NO_PLAYER, false);
+        const uint32_t first = tree.allocate(aActions.size());
+        for (size_t index = 0U; index < aActions.size(); ++index)
+        {
+            tree.initNode(first + index, aActions[index], aState.currentPlayer, GameRules::isChanceAction(aActions[index]));
+        }
+        tree[0].numChildren = static_cast<uint16_t>(aActions.size());
+        tree[0].firstChild.store(first, std::memory_order_relaxed);
+        tree[0].status.store(NODE_EXPANDED, std::memory_order_relaxed);
+    }
+
+    // seeds are drawn before the threads start, the draws from aEngine do not depend on the timing
+    const size_t numThreads = mConfig.numTrees * mConfig.threadsPerTree;
+    std::vector<std::unique_ptr<MctsWorker> > workers;
+    for (size_t threadIndex = 0U; threadIndex < numThreads; ++threadIndex)
+    {
+        const uint64_t seed = (static_cast<uint64_t>(nextUint32(aEngine)) << 32) | nextUint32(aEngine);
+        workers.push_back(std::make_unique<MctsWorker>(aRules, mConfig, aState, *mTrees[threadIndex / mConfig.threadsPerTree], seed));
+    }
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + \
+                                                           std::chrono::milliseconds(mConfig.timeLimitMs);
+    std::vector<std::thread> threads;
+    for (size_t threadIndex = 1U; threadIndex < numThreads; ++threadIndex)
+    {
+        threads.emplace_back(&MctsWorker::run, workers[threadIndex].get(), deadline);
+    }
+    workers[0]->run(deadline);
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    // the most visited action summed over the trees
+    size_t best = 0U;
+    uint64_t bestVisits = 0U;
+    for (size_t index = 0U; index < aActions.size(); ++index)
+    {
+        uint64_t visits = 0U;
+        for (std::unique_ptr<MctsTree>& pTree : mTrees)
+        {
+            MctsTree& tree = *pTree;
+            visits += tree[tree[0].firstChild.load(std::memory_order_relaxed) + index].visits.load(std::memory_order_relaxed);
+        }
+        if (visits > bestVisits)
+        {
+            best = index;
+            bestVisits = visits;
+        }
+    }
+    return best;
+}
+
+std::string MctsAgent::getName() const
+{
+    return "mcts";
+}
+
+MctsAgent::MctsAgent(const MctsConfig_t& aConfig) :
+    mConfig(aConfig)
+{
+    for (size_t treeIndex = 0U; treeIndex < std::max<size_t>(mConfig.numTrees, 1U); ++treeIndex)
+    {
+        mTrees.push_back(std::make_unique<MctsTree>(mConfig.arenaSize));
+    }
+}
+
+MctsAgent::~MctsAgent()
+{
+    // out of line, MctsTree is incomplete in the header
+}
@@ -0,0 +1,341 @@
+/**
+ * Project: catan
+ * @file opening_optimiser.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include <limits>
+#include "opening_optimiser.hpp"
+#include "game_rules.hpp"
+
+namespace
+{
+
+constexpr double VALUE_DIVERSITY = 2.0;         // per distinct resource produced
+constexpr double VALUE_HARBOUR_ANY = 1.0;       // 3:1 harbour
+constexpr double VALUE_HARBOUR_PER_PIP = 0.25;  // 2:1 harbour, per pip of its resource produced
+constexpr double INF = std::numeric_limits<double>::infinity();
+constexpr size_t MAX_BRANCHING_STEPS = 5U;      // opponent placements searched on all their responses, greedy beyond
+
+// keep aBest sorted, best first, at most aNumBest
+void insertBest(std::vector<Opening_t>& aBest, const Opening_t& aOpening, const size_t aNumBest)
+{
+    const auto position = std::find_if(aBest.begin(), aBest.end(), [&aOpening](const Opening_t& aOther) {
+            return aOpening.score > aOther.score;
+        });
+    aBest.insert(position, aOpening);
+    if (aBest.size() > aNumBest)
+    {
+        aBest.pop_back();
+    }
+}
+
+} // namespace
+
+constexpr size_t OpeningOptimiser::DEFAULT_NUM_RESPONSES;
+
+OpeningOptimiser::OpeningOptimiser(std::shared_ptr<const BoardTopology> aTopology, const size_t aNumResponses) :
+    mTopology(aTopology),
+    mNumResponses(std::max<size_t>(aNumResponses, 1U)),
+    mState(),
+    mPlayer(NO_PLAYER),
+    mNumNodes(0U)
+{
+    // empty
+}
+
+bool OpeningOptimiser::isVertexFree(const size_t aVertexId) const
+{
+    if (mState.vertexOwner[aVertexId] != -1)
+    {
+        return false;
+    }
+    for (const uint8_t adjVertex : mTopology->getVertex(aVertexId).vertices)
+    {
+        if (adjVertex != BoardTopology::NO_ID && mState.vertexOwner[adjVertex] != -1)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+double OpeningOptimiser::scorePair(const size_t aFirst, const size_t aSecond) const
+{
+    const std::array<size_t, 2U> vertices = {aFirst, aSecond};
+    std::array<int, CONSUMABLE_RESOURCE_SIZE> production = {};
+    for (const size_t vertexId : vertices)
+    {
+        for (size_t resource = 0U; vertexId != BoardTopology::NO_ID && resource < CONSUMABLE_RESOURCE_SIZE; ++resource)
+        {
+            production[resource] += mProduction[vertexId][resource];
+        }
+    }
+
+    double score = 0.0;
+    for (const int pip : production)
+    {
+        score += pip + (pip > 0 ? VALUE_DIVERSITY : 0.0);
+    }
+    for (const size_t vertexId : vertices)
+    {
+        const int harbour = (vertexId != BoardTopology::NO_ID) ? mTopology->getVertex(vertexId).harbour : -1;
+        if (harbour == static_cast<int>(ResourceTypes::ANY))
+        {
+            score += VALUE_HARBOUR_ANY;
+        }
+        else if (harbour >= 0 && harbour < static_cast<int>(CONSUMABLE_RESOURCE_SIZE))
+        {
+            score += VALUE_HARBOUR_PER_PIP * production[harbour];
+        }
+    }
+    return score;
+}
+
+uint8_t OpeningOptimiser::findSettlement(const size_t aPlayerId) const
+{
+    for (size_t vertexId = 0U; vertexId < mTopology->getNumVertices(); ++vertexId)
+    {
+        if (mState.vertexOwner[vertexId] == static_cast<int>(aPlayerId))
+        {
+            return static_cast<uint8_t>(vertexId);
+        }
+    }
+    return BoardTopology::NO_ID;
+}
+
+void OpeningOptimiser::rankSeconds(const size_t aFirst)
+{
+    mSeconds.clear();
+    for (size_t vertexId = 0U; vertexId < mTopology->getNumVertices(); ++vertexId)
+    {
+        if (isVertexFree(vertexId))
+        {
+            ++mNumNodes;
+            mSeconds.emplace_back(scorePair(aFirst, vertexId), static_cast<uint8_t>(vertexId));
+        }
+    }
+    std::stable_sort(mSeconds.begin(), mSeconds.end(),
+        [](const std::pair<double, uint8_t>& aLhs, const std::pair<double, uint8_t>& aRhs) {
+            return aLhs.first > aRhs.first;
+        });
+}
+
+double OpeningOptimiser::boundSecond(const size_t aFirst, const size_t aNumPlacements, double& aLower, uint8_t& aSecond) const
+{
+    // mSeconds only loses vertices as the opponents place, the first free one is the best pair
+    const size_t numVerticesTaken = aNumPlacements * 4U;
+    double upper = scorePair(aFirst, BoardTopology::NO_ID);
+    aLower = upper;
+    aSecond = BoardTopology::NO_ID;
+    size_t numFree = 0U;
+    for (const std::pair<double, uint8_t>& second : mSeconds)
+    {
+        if (!isVertexFree(second.second))
+        {
+            continue;
+        }
+        if (numFree == 0U)
+        {
+            upper = second.first;
+            aSecond = second.second;
+        }
+        if (numFree == numVerticesTaken)
+        {
+            aLower = second.first;
+            break;
+        }
+        ++numFree;
+    }
+    return upper;
+}
+
+double OpeningOptimiser::searchResponses(const size_t aStep, const size_t aFirst, const double aAlpha, uint8_t& aSecond)
+{
+    size_t numPlacements = 0U;
+    while (aStep + numPlacements < mOrder.size() && mOrder[aStep + numPlacements] != mPlayer)
+    {
+        ++numPlacements;
+    }
+    double lower = 0.0;
+    const double upper = boundSecond(aFirst, numPlacements, lower, aSecond);
+    if (numPlacements == 0U || upper <= aAlpha || lower >= upper)
+    {
+        // the second settlement is placed now, or nothing the opponents do can matter
+        return upper;
+    }
+
+    // the best vertices of the opponent by its own value, best first
+    const uint8_t opponent = mOrder[aStep];
+    const uint8_t settlement = findSettlement(opponent);
+    const size_t numResponses = (aStep <= MAX_BRANCHING_STEPS) ? mNumResponses : 1U;
+    std::vector<uint8_t>& responses = mResponses[aStep];
+    std::array<double, constant::MAX_NUM_VERTICES> scores;
+    responses.clear();
+    for (size_t vertexId = 0U; vertexId < mTopology->getNumVertices(); ++vertexId)
+    {
+        if (!isVertexFree(vertexId))
+        {
+            continue;
+        }
+        ++mNumNodes;
+        scores[vertexId] = scorePair(settlement, vertexId);
+        const auto position = std::find_if(responses.begin(), responses.end(), [&scores, vertexId](const uint8_t aOther) {
+                return scores[vertexId] > scores[aOther];
+            });
+        if (static_cast<size_t>(position - responses.begin()) < numResponses)
+        {
+            responses.insert(position, static_cast<uint8_t>(vertexId));
+            if (responses.size() > numResponses)
+            {
+                responses.pop_back();
+            }
+        }
+    }
+    if (responses.empty())
+    {
+        // nowhere left to place, the opponent passes
+        return searchResponses(aStep + 1U, aFirst, aAlpha, aSecond);
+    }
+
+    double value = INF;
+    for (size_t index = 0U; index < responses.size() && value > std::max(aAlpha, lower); ++index)
+    {
+        const uint8_t response = responses[index];
+        mState.vertexOwner[response] = static_cast<int8_t>(opponent);
+        uint8_t second = BoardTopology::NO_ID;
+        const double child = searchResponses(aStep + 1U, aFirst, aAlpha, second);
+        mState.vertexOwner[response] = -1;
+        if (child < value)
+        {
+            value = child;
+            aSecond = second;
+        }
+    }
+    return value;
+}
+
+int OpeningOptimiser::search(const GameState_t& aState, const std::vector<uint8_t>& aOrder, const size_t aNumBest,
+                             std::vector<Opening_t>& aBest)
+{
+    aBest.clear();
+    mNumNodes = 0U;
+    if (aOrder.empty() || aNumBest == 0U)
+    {
+        return 1;
+    }
+    mState = aState;
+    mOrder = aOrder;
+    mPlayer = aOrder.front();
+    if (mResponses.size() < mOrder.size())
+    {
+        mResponses.resize(mOrder.size());
+    }
+
+    size_t numSettlements = 0U;
+    for (size_t vertexId = 0U; vertexId < mTopology->getNumVertices(); ++vertexId)
+    {
+        numSettlements += (mState.vertexOwner[vertexId] == static_cast<int>(mPlayer)) ? 1U : 0U;
+        // the robber does not move during the setup
+        mProduction[vertexId].fill(0U);
+        for (const uint8_t landId : mTopology->getVertex(vertexId).lands)
+        {
+            const int resource = (landId != BoardTopology::NO_ID) ? mState.landResource[landId] : -1;
+            if (landId != mState.robLandId && resource >= 0 && resource < static_cast<int>(CONSUMABLE_RESOURCE_SIZE))
+            {
+                mProduction[vertexId][resource] = static_cast<uint8_t>(mProduction[vertexId][resource] + constant::dicePips(mState.landDice[landId]));
+            }
+        }
+    }
+    if (numSettlements >= 2U)
+    {
+        return 1;
+    }
+
+    const uint8_t settlement = findSettlement(mPlayer);
+    const bool isLastPlacement = (settlement != BoardTopology::NO_ID) || \
+        (std::find(mOrder.begin() + 1, mOrder.end(), mPlayer) == mOrder.end());
+    if (isLastPlacement)
+    {
+        // nothing to respond to, every free vertex completes the pair
+        for (size_t vertexId = 0U; vertexId < mTopology->getNumVertices(); ++vertexId)
+        {
+            if (isVertexFree(vertexId))
+            {
+                ++mNumNodes;
+                insertBest(aBest, Opening_t{static_cast<uint8_t>(vertexId), BoardTopology::NO_ID,
+                                            scorePair(settlement, vertexId)}, aNumBest);
+            }
+        }
+        return 0;
+    }
+
+    // bound every first settlement by its best pair on the current board, search the best bounds first
+    mCandidates.clear();
+    for (size_t first = 0U; first < mTopology->getNumVertices(); ++first)
+    {
+        if (!isVertexFree(first))
+        {
+            continue;
+        }
+        double best = scorePair(first, BoardTopology::NO_ID);
+        mState.vertexOwner[first] = static_cast<int8_t>(mPlayer);
+        for (size_t second = 0U; second < mTopology->getNumVertices(); ++second)
+        {
+            if (isVertexFree(second))
+            {
+                ++mNumNodes;
+                best = std::max(best, scorePair(first, second));
+            }
+        }
+        mState.vertexOwner[first] = -1;
+        mCandidates.emplace_back(best, static_cast<uint8_t>(first));
+    }
+    std::stable_sort(mCandidates.begin(), mCandidates.end(),
+        [](const std::pair<double, uint8_t>& aLhs, const std::pair<double, uint8_t>& aRhs) {
+            return aLhs.first > aRhs.first;
+        });
+
+    for (const std::pair<double, uint8_t>& candidate : mCandidates)
+    {
+        const double alpha = (aBest.size() < aNumBest) ? -INF : aBest.back().score;
+        if (candidate.first <= alpha)
+        {
+            break;
+        }
+        uint8_t second = BoardTopology::NO_ID;
+        mState.vertexOwner[candidate.second] = static_cast<int8_t>(mPlayer);
+        rankSeconds(candidate.second);
+        const double value = searchResponses(1U, candidate.second, alpha, second);
+        mState.vertexOwner[candidate.second] = -1;
+        if (value > alpha)
+        {
+            insertBest(aBest, Opening_t{candidate.second, second, value}, aNumBest);
+        }
+    }
+    return 0;
+}
+
+size_t OpeningOptimiser::getNumNodes() const
+{
+    return mNumNodes;
+}
+
+void OpeningOptimiser::getSetupOrder(const GameState_t& aState, std::vector<uint8_t>& aOrder)
+{
+    aOrder.clear();
+    if (aState.phase != GamePhase::SETUP_SETTLEMENT && aState.phase != GamePhase::SETUP_ROAD)
+    {
+        return;
+    }
+    // the settlement of the current step is on the board once its road is to be placed
+    const size_t numSteps = aState.numPlayers * 2U;
+    for (size_t step = aState.setupStep + (aState.phase == GamePhase::SETUP_ROAD ? 1U : 0U); step < numSteps; ++step)
+    {
+        aOrder.push_back(static_cast<uint8_t>(GameRules::getSetupPlayer(aState.numPlayers, step)));
+    }
+}
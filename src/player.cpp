@@ -30,6 +30,27 @@ int Player::consumeDevelopmentCard(DevelopmentCardTypes aCard)
     return 0;
 }
 
+int Player::returnDevelopmentCard(DevelopmentCardTypes aCard)
+{
+    if (mDevCard.at(static_cast<size_t>(aCard)) == 0)
+    {
+        return 1;
+    }
+    --mDevCard.at(static_cast<size_t>(aCard));
+    return 0;
+}
+
+int Player::unconsumeDevelopmentCard(DevelopmentCardTypes aCard)
+{
+    if (mDevCardUsed.at(static_cast<size_t>(aCard)) == 0)
+    {
+        return 1;
+    }
+    --mDevCardUsed.at(static_cast<size_t>(aCard));
+    ++mDevCard.at(static_cast<size_t>(aCard));
+    return 0;
+}
+
 void Player::addResources(ResourceTypes aResource, size_t aAmount)
 {
     mResourcesOnHand.at(static_cast<size_t>(aResource)) += aAmount;
@@ -55,6 +76,16 @@ void Player::addRoad(const Edge& aEdge)
     mRoad.emplace(&aEdge);
 }
 
+void Player::removeColony(const Vertex& aVertex)
+{
+    mColony.erase(&aVertex);
+}
+
+void Player::removeRoad(const Edge& aEdge)
+{
+    mRoad.erase(&aEdge);
+}
+
 void Player::setLargestArmy(const bool aLargestArmy)
 {
     mLargestArmy = aLargestArmy;
@@ -71,14 +102,38 @@ size_t Player::getPlayerLongestRoadSize() const
     return 0;
 }
 
-size_t Player::getVictoryPoint(bool aPublic) const
+bool Player::hasLargestArmy() const
+{
+    return mLargestArmy;
+}
+
+bool Player::hasLongestRoad() const
+{
+    return mLongestRoad;
+}
+
+void Player::restore(const std::array<size_t, CONSUMABLE_RESOURCE_SIZE>& aResources, \
+                     const std::array<size_t, DEVELOPMENT_CARD_TYPE_SIZE>& aDevCard, \
+                     const std::array<size_t, DEVELOPMENT_CARD_TYPE_SIZE>& aDevCardUsed, \
+                     const bool aLargestArmy, const bool aLongestRoad)
+{
+    mResourcesOnHand = aResources;
+    mDevCard = aDevCard;
+    mDevCardUsed = aDevCardUsed;
+    mLargestArmy = aLargestArmy;
+    mLongestRoad = aLongestRoad;
+    mColony.clear();
+    mRoad.clear();
+}
+
+size_t Player::getVictoryPoint(const BoardState_t& aState, bool aPublic) const
 {
     size_t vicPoint = (mLargestArmy ? 2 : 0) + \
         (mLongestRoad ? 2 : 0) + \
         (aPublic ? 0 : mDevCard.at(static_cast<size_t>(DevelopmentCardTypes::ONE_VICTORY_POINT)));
     for (const Vertex* const pVertex : mColony)
     {
-        vicPoint += pVertex->getColonyType();
+        vicPoint += pVertex->getColonyType(aState);
     }
     return vicPoint;
 }
@@ -1,37 +1,41 @@
 #include "sequence_config.hpp"
+#include "logger.hpp"
 
-SequenceConfig_t::SequenceConfig_t(const size_t aSize) : mConfig(aSize, 0)
+SequenceConfig_t::SequenceConfig_t(const size_t aSize) :
+    mConfig({0}),
+    mSize(aSize)
 {
-    //empty
-}
-
-SequenceConfig_t::SequenceConfig_t(const std::vector<size_t>& aVec) :
-    mConfig(aVec)
-{
-    //empty
+    if (aSize > MAX_SIZE)
+    {
+        ERROR_LOG("SequenceConfig_t supports up to ", MAX_SIZE, " values, requested: ", aSize);
+    }
 }
 
 size_t SequenceConfig_t::size() const
 {
-    return mConfig.size();
+    return mSize;
 }
 
 size_t SequenceConfig_t::sum() const
 {
     size_t sum = 0;
-    for (size_t num : mConfig)
+    for (size_t index = 0U; index < mSize; ++index)
     {
-        sum += num;
+        sum += mConfig[index];
     }
     return sum;
 }
 
 size_t& SequenceConfig_t::operator[](const size_t aIndex)
 {
-    return mConfig.at(aIndex);
+    if (aIndex >= mSize)
+    {
+        ERROR_LOG("SequenceConfig_t index out of range: ", aIndex, ", size: ", mSize);
+    }
+    return mConfig[aIndex];
 }
 
 size_t& SequenceConfig_t::operator[](const ResourceTypes aIndex)
 {
-    return mConfig.at(static_cast<size_t>(aIndex));
+    return operator[](static_cast<size_t>(aIndex));
 }
@@ -8,7 +8,7 @@
  */
 
 #include "terrain.hpp"
-#include "game_map.hpp"
+#include "board_layout.hpp"
 
 Point_t Terrain::getTopLeft() const
 {
@@ -25,12 +25,12 @@ void Terrain::setColor(ColorPairIndex aColorIndex)
     mColorIndex = aColorIndex;
 }
 
-void Terrain::registerToMap(GameMap& aMap)
+void Terrain::registerToMap(BoardLayout& aLayout)
 {
-    aMap.registerTerrain(getAllPoints(), this);
+    aLayout.registerTerrain(getAllPoints(), this);
 }
 
-int Terrain::populateAdjacencies(GameMap& aMap)
+int Terrain::populateAdjacencies(BoardLayout& aLayout)
 {
     // empty
     // override by derive classes
@@ -45,11 +45,9 @@ Terrain::Terrain(const int aId, const Point_t aTopLeft) :
     // empty
 }
 
-chtype Terrain::getColorCharRepresentation(const size_t aPointX, const size_t aPointY, \
-                                            const bool aUseId) const
+ColorPairIndex Terrain::getColorIndex(const BoardState_t& aState) const
 {
-    return UserInterface::getColorText( \
-                mColorIndex, getCharRepresentation(aPointX, aPointY, aUseId));
+    return mColorIndex;
 }
 
 std::vector<Point_t> Terrain::getAllPoints() const
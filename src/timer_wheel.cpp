@@ -0,0 +1,210 @@
+/**
+ * Project: catan
+ * @file timer_wheel.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include "timer_wheel.hpp"
+
+namespace
+{
+
+inline uint64_t levelShift(const size_t aLevel)
+{
+    return aLevel * 6U;
+}
+
+} // namespace
+
+constexpr TimerWheel::Handle_t TimerWheel::INVALID_HANDLE;
+constexpr size_t TimerWheel::SLOT_BITS;
+constexpr size_t TimerWheel::NUM_SLOTS;
+constexpr size_t TimerWheel::NUM_LEVELS;
+constexpr uint32_t TimerWheel::NIL;
+
+TimerWheel::TimerWheel(const uint64_t aNow) :
+    mFreeList(NIL),
+    mNow(aNow),
+    mSize(0U)
+{
+    static_assert(SLOT_BITS == 6U, "levelShift() and the 64-bit occupancy masks assume 64 slots per level");
+    mSlots.fill(NIL);
+    mOccupied.fill(0U);
+}
+
+TimerWheel::Handle_t TimerWheel::schedule(const uint64_t aDeadline, const uint64_t aPayload)
+{
+    uint32_t index = mFreeList;
+    if (index != NIL)
+    {
+        mFreeList = mTimers[index].next;
+    }
+    else
+    {
+        index = static_cast<uint32_t>(mTimers.size());
+        mTimers.push_back(Timer_t{0U, 0U, NIL, NIL, 0U, NIL});
+    }
+    Timer_t& timer = mTimers[index];
+    timer.deadline = (aDeadline > mNow) ? aDeadline : mNow + 1U;
+    timer.payload = aPayload;
+    link(index);
+    ++mSize;
+    return (static_cast<uint64_t>(timer.generation) << 32U) | index;
+}
+
+bool TimerWheel::cancel(const Handle_t aHandle)
+{
+    const uint32_t index = static_cast<uint32_t>(aHandle);
+    if (aHandle == INVALID_HANDLE || index >= mTimers.size() || \
+        mTimers[index].generation != static_cast<uint32_t>(aHandle >> 32U) || mTimers[index].slot == NIL)
+    {
+        return false;
+    }
+    unlink(index);
+    Timer_t& timer = mTimers[index];
+    ++timer.generation;
+    timer.next = mFreeList;
+    mFreeList = index;
+    --mSize;
+    return true;
+}
+
+void TimerWheel::link(const uint32_t aIndex)
+{
+    Timer_t& timer = mTimers[aIndex];
+    // the lowest level whose current revolution holds the deadline, i.e., the slot is reached before the deadline
+    size_t level = 0U;
+    while (level < NUM_LEVELS - 1U && (timer.deadline >> levelShift(level + 1U)) != (mNow >> levelShift(level + 1U)))
+    {
+        ++level;
+    }
+    size_t slot = (timer.deadline >> levelShift(level)) & (NUM_SLOTS - 1U);
+    if ((timer.deadline >> levelShift(NUM_LEVELS)) != (mNow >> levelShift(NUM_LEVELS)))
+    {
+        // beyond the last level, wait for its next slot and be placed again from there
+        slot = ((mNow >> levelShift(level)) + 1U) & (NUM_SLOTS - 1U);
+    }
+
+    timer.slot = static_cast<uint32_t>(level * NUM_SLOTS + slot);
+    timer.prev = NIL;
+    timer.next = mSlots[timer.slot];
+    if (timer.next != NIL)
+    {
+        mTimers[timer.next].prev = aIndex;
+    }
+    mSlots[timer.slot] = aIndex;
+    mOccupied[level] |= (1ULL << slot);
+}
+
+void TimerWheel::unlink(const uint32_t aIndex)
+{
+    Timer_t& timer = mTimers[aIndex];
+    if (timer.prev != NIL)
+    {
+        mTimers[timer.prev].next = timer.next;
+    }
+    else
+    {
+        mSlots[timer.slot] = timer.next;
+        if (timer.next == NIL)
+        {
+            mOccupied[timer.slot / NUM_SLOTS] &= ~(1ULL << (timer.slot % NUM_SLOTS));
+        }
+    }
+    if (timer.next != NIL)
+    {
+        mTimers[timer.next].prev = timer.prev;
+    }
+    timer.slot = NIL;
+}
+
+uint64_t TimerWheel::nextEvent() const
+{
+    // the slots of a level are all after its current slot (but for a deadline beyond the last level),
+    // and the lower levels are reached first
+    for (size_t level = 0U; level < NUM_LEVELS; ++level)
+    {
+        if (mOccupied[level] == 0U)
+        {
+            continue;
+        }
+        const uint64_t current = (mNow >> levelShift(level)) & (NUM_SLOTS - 1U);
+        const uint64_t ahead = (current == NUM_SLOTS - 1U) ? 0U : (mOccupied[level] & (~0ULL << (current + 1U)));
+        uint64_t revolution = mNow >> levelShift(level + 1U);
+        if (ahead == 0U)
+        {
+            // wrapped around, next revolution
+            ++revolution;
+        }
+        const uint64_t slot = __builtin_ctzll(ahead != 0U ? ahead : mOccupied[level]);
+        return (revolution << levelShift(level + 1U)) + (slot << levelShift(level));
+    }
+    return UINT64_MAX;
+}
+
+void TimerWheel::advance(const uint64_t aNow, std::vector<uint64_t>& aExpired)
+{
+    uint64_t tick = nextEvent();
+    while (tick <= aNow)
+    {
+        mNow = tick;
+        // higher levels first, their timers may land in the slot of a lower level reached at the same tick
+        for (size_t level = NUM_LEVELS - 1U; level > 0U; --level)
+        {
+            if ((mNow & ((1ULL << levelShift(level)) - 1U)) != 0U)
+            {
+                continue;
+            }
+            const size_t slot = level * NUM_SLOTS + ((mNow >> levelShift(level)) & (NUM_SLOTS - 1U));
+            uint32_t index = mSlots[slot];
+            mSlots[slot] = NIL;
+            mOccupied[level] &= ~(1ULL << (slot % NUM_SLOTS));
+            while (index != NIL)
+            {
+                const uint32_t next = mTimers[index].next;
+                link(index);
+                index = next;
+            }
+        }
+
+        const size_t slot = mNow & (NUM_SLOTS - 1U);
+        uint32_t index = mSlots[slot];
+        mSlots[slot] = NIL;
+        mOccupied[0] &= ~(1ULL << slot);
+        while (index != NIL)
+        {
+            Timer_t& timer = mTimers[index];
+            const uint32_t next = timer.next;
+            aExpired.push_back(timer.payload);
+            timer.slot = NIL;
+            ++timer.generation;
+            timer.next = mFreeList;
+            mFreeList = index;
+            --mSize;
+            index = next;
+        }
+        tick = nextEvent();
+    }
+    if (aNow > mNow)
+    {
+        mNow = aNow;
+    }
+}
+
+uint64_t TimerWheel::getNextDeadline() const
+{
+    return nextEvent();
+}
+
+uint64_t TimerWheel::getNow() const
+{
+    return mNow;
+}
+
+size_t TimerWheel::size() const
+{
+    return mSize;
+}
@@ -0,0 +1,175 @@
+/**
+ * Project: catan
+ * @file tournament.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "tournament.hpp"
+#include "logger.hpp"
+
+namespace
+{
+
+// TrueSkill defaults
+constexpr double TRUESKILL_MU = 25.0;
+constexpr double TRUESKILL_SIGMA = TRUESKILL_MU / 3.0;
+constexpr double TRUESKILL_BETA = TRUESKILL_SIGMA / 2.0;    // skill difference for ~76% chance to win
+constexpr double TRUESKILL_TAU = TRUESKILL_SIGMA / 100.0;   // dynamics, keeps sigma from collapsing
+constexpr double SQRT_2_PI = 2.50662827463100050242;
+
+inline double normalPdf(const double aValue)
+{
+    return std::exp(-0.5 * std::pow(aValue, 2)) / SQRT_2_PI;
+}
+
+inline double normalCdf(const double aValue)
+{
+    return 0.5 * std::erfc(-aValue / std::sqrt(2.0));
+}
+
+void rateTrueSkill(TournamentRating_t& aWinner, TournamentRating_t& aLoser)
+{
+    const double winnerVariance = std::pow(aWinner.sigma, 2) + TRUESKILL_TAU * TRUESKILL_TAU;
+    const double loserVariance = std::pow(aLoser.sigma, 2) + TRUESKILL_TAU * TRUESKILL_TAU;
+    const double c = std::sqrt(2.0 * TRUESKILL_BETA * TRUESKILL_BETA + winnerVariance + loserVariance);
+    const double t = (aWinner.mu - aLoser.mu) / c;
+    const double v = normalPdf(t) / std::max(normalCdf(t), 1e-300);
+    const double w = v * (v + t);
+    aWinner.mu += winnerVariance / c * v;
+    aLoser.mu -= loserVariance / c * v;
+    aWinner.sigma = std::sqrt(winnerVariance * std::max(1.0 - winnerVariance / (c * c) * w, 1e-6));
+    aLoser.sigma = std::sqrt(loserVariance * std::max(1.0 - loserVariance / (c * c) * w, 1e-6));
+}
+
+// aScore: 1 the first won, 0.5 draw, 0 the second won
+void rateElo(TournamentRating_t& aFirst, TournamentRating_t& aSecond, const double aScore)
+{
+    const double expected = 1.0 / (1.0 + std::pow(10.0, (aSecond.elo - aFirst.elo) / 400.0));
+    aFirst.elo += Tournament::ELO_K * (aScore - expected);
+    aSecond.elo -= Tournament::ELO_K * (aScore - expected);
+}
+
+} // namespace
+
+constexpr double Tournament::ELO_INITIAL;
+constexpr double Tournament::ELO_K;
+
+Tournament::Tournament(const GameRules& aRules, const std::vector<std::string>& aAgentNames) :
+    mRules(aRules),
+    mAgentNames(aAgentNames),
+    mNumTurns(0U)
+{
+    for (size_t first = 0U; first < mAgentNames.size(); ++first)
+    {
+        for (size_t second = first + 1U; second < mAgentNames.size(); ++second)
+        {
+            mPairs.emplace_back(first, second);
+        }
+    }
+}
+
+int Tournament::run(const size_t aGamesPerPair, const uint64_t aSeed, WorkStealingPool& aPool)
+{
+    // agents are not thread-safe, every worker has its own
+    std::vector<std::vector<std::unique_ptr<Agent> > > agents(aPool.getNumWorkers());
+    std::vector<std::vector<GameAction_t> > actions(aPool.getNumWorkers());
+    for (size_t worker = 0U; worker < aPool.getNumWorkers(); ++worker)
+    {
+        for (const std::string& name : mAgentNames)
+        {
+            agents[worker].push_back(Agent::create(name));
+            if (!agents[worker].back())
+            {
+                WARN_LOG("Unknown agent: " + name);
+                return 1;
+            }
+        }
+        actions[worker].reserve(GameRules::MAX_LEGAL_ACTIONS);
+    }
+
+    mResults.assign(mPairs.size() * aGamesPerPair, GameResult_t{NO_PLAYER, 0U});
+    aPool.run(mResults.size(), [&](const size_t aGameIndex, const size_t aWorker) {
+            playGame(aGameIndex, aSeed, aGamesPerPair, agents[aWorker], actions[aWorker]);
+        });
+    rate(aGamesPerPair);
+    return 0;
+}
+
+void Tournament::playGame(const size_t aGameIndex, const uint64_t aSeed, const size_t aGamesPerPair,
+                          std::vector<std::unique_ptr<Agent> >& aAgents, std::vector<GameAction_t>& aActions)
+{
+    // the seats alternate, the first of the pair moves first in even games
+    const std::pair<size_t, size_t>& pair = mPairs[aGameIndex / aGamesPerPair];
+    const bool isSwapped = ((aGameIndex % aGamesPerPair) % 2U == 1U);
+    const std::array<size_t, 2U> seatAgent = {isSwapped ? pair.second : pair.first, isSwapped ? pair.first : pair.second};
+
+    RandomEngine engine(aSeed + aGameIndex);
+    GameState_t state;
+    mRules.newGame(state, 2U, engine);
+    mRules.getLegalActions(state, aActions);
+    while (!aActions.empty())
+    {
+        Agent& agent = *aAgents[seatAgent[state.currentPlayer]];
+        mRules.applyAction(state, aActions[agent.chooseAction(mRules, state, aActions, engine)], engine);
+        mRules.getLegalActions(state, aActions);
+    }
+    mResults[aGameIndex].winner = (state.winner == NO_PLAYER) ? NO_PLAYER : static_cast<uint8_t>(seatAgent[state.winner]);
+    mResults[aGameIndex].turns = state.turn;
+}
+
+void Tournament::rate(const size_t aGamesPerPair)
+{
+    mRatings.assign(mAgentNames.size(), TournamentRating_t{0U, 0U, 0U, ELO_INITIAL, TRUESKILL_MU, TRUESKILL_SIGMA});
+    mWins.assign(mAgentNames.size(), std::vector<size_t>(mAgentNames.size(), 0U));
+    mNumTurns = 0U;
+    for (size_t gameIndex = 0U; gameIndex < mResults.size(); ++gameIndex)
+    {
+        const GameResult_t& result = mResults[gameIndex];
+        const std::pair<size_t, size_t>& pair = mPairs[gameIndex / aGamesPerPair];
+        TournamentRating_t& first = mRatings[pair.first];
+        TournamentRating_t& second = mRatings[pair.second];
+        mNumTurns += result.turns;
+        ++first.numGames;
+        ++second.numGames;
+        if (result.winner == NO_PLAYER)
+        {
+            ++first.numDraws;
+            ++second.numDraws;
+            rateElo(first, second, 0.5);
+            continue;
+        }
+
+        const bool isFirstWinner = (result.winner == pair.first);
+        TournamentRating_t& winner = isFirstWinner ? first : second;
+        TournamentRating_t& loser = isFirstWinner ? second : first;
+        ++winner.numWins;
+        ++mWins[result.winner][isFirstWinner ? pair.second : pair.first];
+        rateElo(first, second, isFirstWinner ? 1.0 : 0.0);
+        rateTrueSkill(winner, loser);
+    }
+}
+
+size_t Tournament::getNumGames() const
+{
+    return mResults.size();
+}
+
+size_t Tournament::getNumTurns() const
+{
+    return mNumTurns;
+}
+
+const std::vector<TournamentRating_t>& Tournament::getRatings() const
+{
+    return mRatings;
+}
+
+size_t Tournament::getNumWins(const size_t aWinner, const size_t aLoser) const
+{
+    return mWins.at(aWinner).at(aLoser);
+}
@@ -8,17 +8,15 @@
  */
 
 #include "logger.hpp"
-#include "game_map.hpp"
+#include "board_layout.hpp"
 #include "vertex.hpp"
 #include "edge.hpp"
 #include "blank.hpp"
 #include "utility.hpp"
 
-int Vertex::populateAdjacencies(GameMap& aMap)
+int Vertex::populateAdjacencies(BoardLayout& aLayout)
 {
     // reset vertex
-    mOwner = -1;
-    mColony = ColonyType::NONE;
     mIsCoastal = false;
     mHarbour = nullptr;
     mAdjacentVertices.clear();
@@ -27,12 +25,12 @@ int Vertex::populateAdjacencies(GameMap& aMap)
     int rc = 0;
 
     // no need to add {x, y+1} & {x,y-1}, because we don't have vertical edge
-    rc |= addAdjacency(aMap, mTopLeft.x - 1, mTopLeft.y);
-    rc |= addAdjacency(aMap, mTopLeft.x - 1, mTopLeft.y - 1);
-    rc |= addAdjacency(aMap, mTopLeft.x + 1, mTopLeft.y - 1);
-    rc |= addAdjacency(aMap, mTopLeft.x + 1, mTopLeft.y);
-    rc |= addAdjacency(aMap, mTopLeft.x + 1, mTopLeft.y + 1);
-    rc |= addAdjacency(aMap, mTopLeft.x - 1, mTopLeft.y + 1);
+    rc |= addAdjacency(aLayout, mTopLeft.x - 1, mTopLeft.y);
+    rc |= addAdjacency(aLayout, mTopLeft.x - 1, mTopLeft.y - 1);
+    rc |= addAdjacency(aLayout, mTopLeft.x + 1, mTopLeft.y - 1);
+    rc |= addAdjacency(aLayout, mTopLeft.x + 1, mTopLeft.y);
+    rc |= addAdjacency(aLayout, mTopLeft.x + 1, mTopLeft.y + 1);
+    rc |= addAdjacency(aLayout, mTopLeft.x - 1, mTopLeft.y + 1);
 
     if (mAdjacentVertices.size() == 0 || mAdjacentVertices.size() == 0)
     {
@@ -50,14 +48,14 @@ int Vertex::populateAdjacencies(GameMap& aMap)
     return rc;
 }
 
-int Vertex::addAdjacency(GameMap& aMap, const size_t aPointX, const size_t aPointY)
+int Vertex::addAdjacency(BoardLayout& aLayout, const size_t aPointX, const size_t aPointY)
 {
-    const Terrain* const pTerrain = aMap.getTerrain(aPointX, aPointY);
+    const Terrain* const pTerrain = aLayout.getTerrain(aPointX, aPointY);
     if (const Edge* const pEdge = dynamic_cast<const Edge*>(pTerrain))
     {
         // is edge
         mAdjacentEdges.emplace(pEdge);
-        const Vertex* const pAdjacentVertex = pEdge->getOtherVertex(aMap, *this);
+        const Vertex* const pAdjacentVertex = pEdge->getOtherVertex(aLayout, *this);
         if (!pAdjacentVertex)
         {
             WARN_LOG("Error when adding adjacent vertex for " + getStringId() \
@@ -78,6 +76,11 @@ const std::set<const Vertex*>& Vertex::getAdjacentVertices() const
     return mAdjacentVertices;
 }
 
+const std::set<const Edge*>& Vertex::getAdjacentEdges() const
+{
+    return mAdjacentEdges;
+}
+
 std::set<const Edge*> Vertex::getOtherEdges(const Edge& aEdge) const
 {
     if (mAdjacentEdges.count(&aEdge) != 1)
@@ -90,30 +93,21 @@ std::set<const Edge*> Vertex::getOtherEdges(const Edge& aEdge) const
     return otherEdges;
 }
 
-int Vertex::setOwner(int aPlayerId, ColonyType aColony)
-{
-    mOwner = aPlayerId;
-    mColony = aColony;
-    mColorIndex = static_cast<ColorPairIndex>(mOwner + ColorPairIndex::PLAYER_START);
-    INFO_LOG("Successfully set " + colonyTypesToStr(aColony) + " for Player#", mOwner, " for " + getStringId());
-    return 0;
-}
-
-int Vertex::getOwner() const
+int Vertex::getOwner(const BoardState_t& aState) const
 {
-    return mOwner;
+    return aState.vertexOwner[mId];
 }
 
-ColonyType Vertex::getColonyType() const
+ColonyType Vertex::getColonyType(const BoardState_t& aState) const
 {
-    return mColony;
+    return static_cast<ColonyType>(aState.colony[mId]);
 }
 
-bool Vertex::isAvailable() const
+bool Vertex::isAvailable(const BoardState_t& aState) const
 {
     for (const Vertex* const pAdjVertex : mAdjacentVertices)
     {
-        if (pAdjVertex->getOwner() != -1)
+        if (pAdjVertex->getOwner(aState) != -1)
         {
             return false;
         }
@@ -121,12 +115,12 @@ bool Vertex::isAvailable() const
     return true;
 }
 
-bool Vertex::isConnected(const int aPlayerId) const
+bool Vertex::isConnected(const BoardState_t& aState, const int aPlayerId) const
 {
     // at least 1 edge need to be owner by aPlayerId
     for (const Edge* const pAdjEdge : mAdjacentEdges)
     {
-        if (pAdjEdge->getOwner() == aPlayerId)
+        if (pAdjEdge->getOwner(aState) == aPlayerId)
         {
             return true;
         }
@@ -144,6 +138,11 @@ bool Vertex::hasHarbour() const
     return (mHarbour != nullptr);
 }
 
+const Harbour* Vertex::getHarbour() const
+{
+    return mHarbour;
+}
+
 int Vertex::setHarbour(Harbour* const aHarbour)
 {
     if (aHarbour == nullptr)
@@ -160,13 +159,13 @@ int Vertex::setHarbour(Harbour* const aHarbour)
     return 0;
 }
 
-char Vertex::getCharRepresentation(const size_t aPointX, const size_t aPointY, const bool aUseId) const
+char Vertex::getCharRepresentation(const size_t aPointX, const size_t aPointY, const BoardState_t& aState, const bool aUseId) const
 {
     if (aUseId)
     {
         return static_cast<char>(mId % 10) + '0';
     }
-    switch (mColony)
+    switch (getColonyType(aState))
     {
     case ColonyType::SETTLEMENT:
         return 'S';
@@ -178,6 +177,13 @@ char Vertex::getCharRepresentation(const size_t aPointX, const size_t aPointY, c
     }
 }
 
+ColorPairIndex Vertex::getColorIndex(const BoardState_t& aState) const
+{
+    // -1: no owner
+    const int owner = getOwner(aState);
+    return (owner < 0) ? mColorIndex : static_cast<ColorPairIndex>(owner + ColorPairIndex::PLAYER_START);
+}
+
 std::string Vertex::getStringId() const
 {
     return Logger::formatString("Vertex#", mId);
@@ -186,9 +192,7 @@ std::string Vertex::getStringId() const
 Vertex::Vertex(const int aId, const Point_t aTopLeft) :
     Terrain(aId, aTopLeft),
     mIsCoastal(false),
-    mHarbour(nullptr),
-    mOwner(-1),
-    mColony(ColonyType::NONE)
+    mHarbour(nullptr)
 {
     // empty
 }
@@ -0,0 +1,155 @@
+/**
+ * Project: catan
+ * @file work_stealing_pool.cpp
+ *
+ * @author Zonghao Huang <kyle0923@qq.com>
+ *
+ * All right reserved.
+ */
+
+#include <algorithm>
+#include "work_stealing_pool.hpp"
+
+WorkStealingPool::WorkStealingPool(const size_t aNumWorkers) :
+    mTask(nullptr),
+    mGeneration(0U),
+    mNumBusy(0U),
+    mIsStopping(false),
+    mNumSteals(0U)
+{
+    const size_t numWorkers = (aNumWorkers == 0U) ? std::max(std::thread::hardware_concurrency(), 1U) : aNumWorkers;
+    for (size_t worker = 0U; worker < numWorkers; ++worker)
+    {
+        mQueues.push_back(std::make_unique<WorkerQueue_t>());
+    }
+    for (size_t worker = 1U; worker < numWorkers; ++worker)
+    {
+        mThreads.emplace_back(&WorkStealingPool::workerLoop, this, worker);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mIsStopping = true;
+    }
+    mStartCondition.notify_all();
+    for (std::thread& thread : mThreads)
+    {
+        thread.join();
+    }
+}
+
+bool WorkStealingPool::popOwn(const size_t aWorker, size_t& aTask)
+{
+    WorkerQueue_t& queue = *mQueues[aWorker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+    aTask = queue.tasks.back();
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(const size_t aWorker, size_t& aTask)
+{
+    // the victims in turn, starting from the next worker, so that thieves do not all pile on worker 0
+    for (size_t offset = 1U; offset < mQueues.size(); ++offset)
+    {
+        WorkerQueue_t& queue = *mQueues[(aWorker + offset) % mQueues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            // the front is the farthest from what the owner works on
+            aTask = queue.tasks.front();
+            queue.tasks.pop_front();
+            mNumSteals.fetch_add(1U, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::drain(const size_t aWorker)
+{
+    // no task is added during a run, the run is over for this worker once every deque is empty
+    size_t task = 0U;
+    while (popOwn(aWorker, task) || steal(aWorker, task))
+    {
+        (*mTask)(task, aWorker);
+    }
+}
+
+void WorkStealingPool::workerLoop(const size_t aWorker)
+{
+    size_t generation = 0U;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mStartCondition.wait(lock, [this, generation]() {
+                    return mIsStopping || mGeneration != generation;
+                });
+            if (mIsStopping)
+            {
+                return;
+            }
+            generation = mGeneration;
+        }
+        drain(aWorker);
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            --mNumBusy;
+        }
+        mDoneCondition.notify_one();
+    }
+}
+
+void WorkStealingPool::run(const size_t aNumTasks, const Task_t& aTask)
+{
+    if (aNumTasks == 0U)
+    {
+        return;
+    }
+
+    // contiguous blocks, the owner pops from the back, i.e., each worker walks its block backwards
+    const size_t numWorkers = mQueues.size();
+    const size_t blockSize = (aNumTasks + numWorkers - 1U) / numWorkers;
+    for (size_t worker = 0U; worker < numWorkers; ++worker)
+    {
+        WorkerQueue_t& queue = *mQueues[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (size_t task = worker * blockSize; task < std::min(aNumTasks, (worker + 1U) * blockSize); ++task)
+        {
+            queue.tasks.push_back(task);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTask = &aTask;
+        mNumBusy = mThreads.size();
+        ++mGeneration;
+    }
+    mStartCondition.notify_all();
+    drain(0U);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDoneCondition.wait(lock, [this]() {
+            return mNumBusy == 0U;
+        });
+    mTask = nullptr;
+}
+
+size_t WorkStealingPool::getNumWorkers() const
+{
+    return mQueues.size();
+}
+
+size_t WorkStealingPool::getNumSteals() const
+{
+    return mNumSteals.load(std::memory_order_relaxed);
+}